@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compares sampling animation curves with sampling baked animation curves, forward and at random times.
+
+#include "benchmark.hpp"
+#include <engine/animation/animation-curve.hpp>
+#include <engine/animation/baked-animation-curve.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main()
+{
+	constexpr std::size_t keyframe_count = 240;
+	constexpr std::size_t sample_count = 100000;
+	constexpr std::size_t run_count = 21;
+	
+	// Build a curve with irregularly-spaced keyframes
+	std::mt19937 random_engine(1);
+	std::uniform_real_distribution<float> spacing_distribution(0.5f, 1.5f);
+	animation_curve curve;
+	float keyframe_time = 0.0f;
+	for (std::size_t i = 0; i < keyframe_count; ++i)
+	{
+		curve.keyframes().emplace(keyframe_time, std::sin(keyframe_time));
+		keyframe_time += spacing_distribution(random_engine) / 30.0f;
+	}
+	const baked_animation_curve baked_curve(curve);
+	const float duration = baked_curve.duration();
+	
+	// Forward playback samples at a fixed rate, spanning the curve
+	std::vector<float> forward_times(sample_count);
+	for (std::size_t i = 0; i < sample_count; ++i)
+	{
+		forward_times[i] = duration * static_cast<float>(i) / static_cast<float>(sample_count);
+	}
+	
+	// Random samples defeat the cursor
+	std::uniform_real_distribution<float> time_distribution(0.0f, duration);
+	std::vector<float> random_times(sample_count);
+	for (auto& time: random_times)
+	{
+		time = time_distribution(random_engine);
+	}
+	
+	// Baked curves must match the curves they were baked from
+	std::size_t cursor = 0;
+	for (const float time: forward_times)
+	{
+		if (baked_curve.evaluate(time, cursor) != curve.evaluate(time))
+		{
+			std::cerr << "Baked curve does not match animation curve\n";
+			return EXIT_FAILURE;
+		}
+	}
+	
+	const auto measure_samples = [&](const std::vector<float>& times, auto&& evaluate)
+	{
+		return benchmark::measure
+		(
+			run_count,
+			[&]()
+			{
+				float sum = 0.0f;
+				for (const float time: times)
+				{
+					sum += evaluate(time);
+				}
+				benchmark::consume(sum);
+			}
+		);
+	};
+	
+	benchmark::report
+	(
+		"animation_curve, forward",
+		measure_samples(forward_times, [&](float time){return curve.evaluate(time);}),
+		sample_count
+	);
+	benchmark::report
+	(
+		"baked_animation_curve, forward, cursor",
+		measure_samples(forward_times, [&, cursor = std::size_t{0}](float time) mutable {return baked_curve.evaluate(time, cursor);}),
+		sample_count
+	);
+	benchmark::report
+	(
+		"baked_animation_curve, forward, no cursor",
+		measure_samples(forward_times, [&](float time){return baked_curve.evaluate(time);}),
+		sample_count
+	);
+	benchmark::report
+	(
+		"animation_curve, random",
+		measure_samples(random_times, [&](float time){return curve.evaluate(time);}),
+		sample_count
+	);
+	benchmark::report
+	(
+		"baked_animation_curve, random, cursor",
+		measure_samples(random_times, [&, cursor = std::size_t{0}](float time) mutable {return baked_curve.evaluate(time, cursor);}),
+		sample_count
+	);
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_BENCHMARKS_BENCHMARK_HPP
+#define ANTKEEPER_BENCHMARKS_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+/// Helpers shared by benchmarks.
+namespace benchmark {
+
+/**
+ * Measures the median wall-clock duration of a function.
+ *
+ * @param run_count Number of timed runs. The function is additionally run once, untimed, to warm up caches.
+ * @param function Function to measure.
+ *
+ * @return Median duration of a run.
+ */
+template <class Function>
+[[nodiscard]] std::chrono::nanoseconds measure(std::size_t run_count, Function&& function)
+{
+	function();
+	
+	std::vector<std::chrono::nanoseconds> durations(std::max<std::size_t>(run_count, 1));
+	for (auto& duration: durations)
+	{
+		const auto t0 = std::chrono::steady_clock::now();
+		function();
+		duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+	}
+	
+	const auto median = durations.begin() + durations.size() / 2;
+	std::nth_element(durations.begin(), median, durations.end());
+	return *median;
+}
+
+/**
+ * Prints the result of a measurement.
+ *
+ * @param name Name of the measurement.
+ * @param duration Duration of a run.
+ * @param item_count Number of items processed by each run.
+ */
+inline void report(std::string_view name, std::chrono::nanoseconds duration, std::size_t item_count = 1)
+{
+	const double milliseconds = static_cast<double>(duration.count()) / 1e6;
+	const double nanoseconds_per_item = static_cast<double>(duration.count()) / static_cast<double>(std::max<std::size_t>(item_count, 1));
+	std::cout << std::format("{:<48}{:>12.3f} ms{:>14.2f} ns/item\n", name, milliseconds, nanoseconds_per_item);
+}
+
+/// Variable into which consumed values are written.
+template <class T>
+inline volatile T sink{};
+
+/**
+ * Consumes a value, such that its computation is not optimized away.
+ *
+ * @param value Value to consume.
+ */
+template <class T>
+inline void consume(const T& value)
+{
+	sink<T> = value;
+}
+
+} // namespace benchmark
+
+#endif // ANTKEEPER_BENCHMARKS_BENCHMARK_HPP
@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compares the time per glyph of rasterizing and packing 3,000 CJK glyphs into an empty font in parallel batches with rasterizing them one at a time, headless with the null OpenGL backend.
+//
+// Usage: glyph-cache-benchmark <data path> [typeface path]
+
+#include "benchmark.hpp"
+#include <engine/gl/null-backend.hpp>
+#include <engine/resources/resource-manager.hpp>
+#include <engine/type/font.hpp>
+#include <engine/type/typeface.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+/**
+ * Typeface which forwards to another typeface, but loads multiple glyphs one at a time with the default implementation of typeface::get_glyphs().
+ */
+class serial_typeface: public type::typeface
+{
+public:
+	explicit serial_typeface(std::shared_ptr<type::typeface> face):
+		m_face(std::move(face))
+	{
+		m_has_horizontal = m_face->has_horizontal();
+		m_has_vertical = m_face->has_vertical();
+		m_has_kerning = m_face->has_kerning();
+		m_is_scalable = m_face->is_scalable();
+	}
+	
+	[[nodiscard]] type::font_metrics get_font_metrics(float size) const override
+	{
+		return m_face->get_font_metrics(size);
+	}
+	
+	[[nodiscard]] bool has_glyph(char32_t code) const override
+	{
+		return m_face->has_glyph(code);
+	}
+	
+	[[nodiscard]] type::glyph get_glyph(char32_t code, float size, bool sdf) const override
+	{
+		return m_face->get_glyph(code, size, sdf);
+	}
+	
+	[[nodiscard]] std::array<float, 2> get_kerning(float size, char32_t first, char32_t second) const override
+	{
+		return m_face->get_kerning(size, first, second);
+	}
+	
+private:
+	std::shared_ptr<type::typeface> m_face;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	constexpr std::size_t glyph_count = 3000;
+	constexpr std::size_t run_count = 5;
+	constexpr float font_size = 32.0f;
+	
+	if (argc < 2)
+	{
+		std::cerr << "Usage: glyph-cache-benchmark <data path> [typeface path]\n";
+		return EXIT_FAILURE;
+	}
+	const std::string typeface_path = argc > 2 ? argv[2] : "fonts/noto-sans-sc-regular.otf";
+	
+	if (!gl::load_null_backend(1920, 1080))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	resource_manager resources;
+	if (!resources.mount(argv[1]))
+	{
+		std::cerr << std::format("Failed to mount data path \"{}\"\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	
+	const auto face = resources.load<type::typeface>(typeface_path);
+	if (!face)
+	{
+		std::cerr << std::format("Failed to load typeface \"{}\"\n", typeface_path);
+		return EXIT_FAILURE;
+	}
+	const auto serial_face = std::make_shared<serial_typeface>(face);
+	
+	// Collect the first CJK unified ideographs contained in the typeface
+	std::u32string text;
+	for (char32_t code = U'\u4E00'; code <= U'\u9FFF' && text.size() < glyph_count; ++code)
+	{
+		if (face->has_glyph(code))
+		{
+			text.push_back(code);
+		}
+	}
+	if (text.size() < glyph_count)
+	{
+		std::cerr << std::format("Typeface \"{}\" contains only {} CJK unified ideographs\n", typeface_path, text.size());
+		return EXIT_FAILURE;
+	}
+	
+	// Both paths should cache every glyph at the same size
+	type::font parallel_font(face, font_size);
+	type::font serial_font(serial_face, font_size);
+	if (parallel_font.cache_glyphs(text) != glyph_count || serial_font.cache_glyphs(text) != glyph_count)
+	{
+		std::cerr << "Glyphs not cached\n";
+		return EXIT_FAILURE;
+	}
+	for (const char32_t code: text)
+	{
+		const auto parallel_glyph = parallel_font.get_cached_glyph(code);
+		const auto serial_glyph = serial_font.get_cached_glyph(code);
+		if (!parallel_glyph || !serial_glyph || parallel_glyph->bitmap_dimensions != serial_glyph->bitmap_dimensions)
+		{
+			std::cerr << std::format("Glyph U+{:04X} differs between parallel and serial rasterization\n", static_cast<std::uint32_t>(code));
+			return EXIT_FAILURE;
+		}
+	}
+	
+	// Measure populating an empty font, including atlas growth and texture uploads
+	const auto measure = [&](std::string_view name, const std::shared_ptr<type::typeface>& typeface)
+	{
+		benchmark::report
+		(
+			std::format("{}, {} glyphs", name, glyph_count),
+			benchmark::measure
+			(
+				run_count,
+				[&]()
+				{
+					type::font font(typeface, font_size);
+					benchmark::consume(font.cache_glyphs(text));
+				}
+			),
+			glyph_count
+		);
+	};
+	measure("cache_glyphs, parallel", face);
+	measure("cache_glyphs, serial", serial_face);
+	
+	return EXIT_SUCCESS;
+}
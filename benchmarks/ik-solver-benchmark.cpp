@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compares the time per chain and convergence of the two-bone and FABRIK IK solvers with the CCD IK solver, on random reachable goals.
+
+#include "benchmark.hpp"
+#include <engine/animation/ik/ik-rig.hpp>
+#include <engine/animation/ik/solvers/ccd-ik-solver.hpp>
+#include <engine/animation/ik/solvers/fabrik-ik-solver.hpp>
+#include <engine/animation/ik/solvers/two-bone-ik-solver.hpp>
+#include <engine/animation/skeleton.hpp>
+#include <engine/math/quaternion.hpp>
+#include <engine/math/vector.hpp>
+#include <engine/render/model.hpp>
+#include <engine/scene/skeletal-mesh.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Number of bones in the chain, excluding the root bone, which is the chain length of a leg from coxa to tibia.
+constexpr std::size_t chain_bone_count = 3;
+
+/// Length of each bone in the chain.
+constexpr float bone_length = 1.0f;
+
+/**
+ * Builds a skeleton with a root bone followed by a slightly bent chain of bones along the x-axis.
+ */
+[[nodiscard]] std::shared_ptr<skeleton> build_chain_skeleton()
+{
+	auto chain_skeleton = std::make_shared<skeleton>(chain_bone_count + 1);
+	for (std::size_t i = 1; i <= chain_bone_count; ++i)
+	{
+		chain_skeleton->bones()[i].reparent(&chain_skeleton->bones()[i - 1]);
+		
+		auto transform = math::identity<math::transform<float>>;
+		if (i > 1)
+		{
+			transform.translation = {bone_length, 0.0f, 0.0f};
+			transform.rotation = math::fquat::rotate_z(0.3f);
+		}
+		chain_skeleton->rest_pose().set_relative_transform(i, transform);
+	}
+	
+	return chain_skeleton;
+}
+
+/**
+ * Generates random goals within reach of a chain.
+ *
+ * @param count Number of goals.
+ * @param origin Position of the first joint of the chain.
+ * @param reach Length of the chain.
+ */
+[[nodiscard]] std::vector<math::fvec3> generate_goals(std::size_t count, const math::fvec3& origin, float reach)
+{
+	std::mt19937 random_engine(1);
+	std::normal_distribution<float> direction_distribution;
+	std::uniform_real_distribution<float> distance_distribution(0.2f * reach, 0.95f * reach);
+	
+	std::vector<math::fvec3> goals(count);
+	for (auto& goal: goals)
+	{
+		const auto direction = math::normalize(math::fvec3{direction_distribution(random_engine), direction_distribution(random_engine), direction_distribution(random_engine)});
+		goal = origin + direction * distance_distribution(random_engine);
+	}
+	
+	return goals;
+}
+
+} // namespace
+
+int main()
+{
+	constexpr std::size_t goal_count = 6000;
+	constexpr std::size_t run_count = 11;
+	constexpr std::size_t max_iterations = 10;
+	constexpr float goal_radius = 1e-3f;
+	
+	// Build a skeletal mesh from a model which only has a skeleton
+	auto model = std::make_shared<render::model>();
+	model->skeleton() = build_chain_skeleton();
+	scene::skeletal_mesh skeletal_mesh(model);
+	const auto& rest_pose = model->skeleton()->rest_pose();
+	ik_rig rig(skeletal_mesh);
+	
+	// Effector at the end of the last bone
+	const std::size_t tip_bone = chain_bone_count;
+	const math::fvec3 effector_position{bone_length, 0.0f, 0.0f};
+	
+	// Find the first joints of the two-bone and three-bone chains
+	skeletal_mesh.get_pose() = rest_pose;
+	const auto two_bone_goals = generate_goals(goal_count, skeletal_mesh.get_pose().get_absolute_transform(tip_bone - 1).translation, bone_length * 2.0f);
+	const auto three_bone_goals = generate_goals(goal_count, skeletal_mesh.get_pose().get_absolute_transform(tip_bone - 2).translation, bone_length * 3.0f);
+	
+	// Solves each goal from the rest pose, then measures the mean distance between the effector and the goal
+	const auto compare = [&](std::string_view name, auto& solver, const std::vector<math::fvec3>& goals)
+	{
+		solver.set_effector_position(effector_position);
+		solver.set_goal_radius(goal_radius);
+		
+		const auto solve_goals = [&]()
+		{
+			for (const auto& goal: goals)
+			{
+				skeletal_mesh.get_pose() = rest_pose;
+				solver.set_goal_center(goal);
+				solver.solve();
+			}
+		};
+		
+		benchmark::report(name, benchmark::measure(run_count, solve_goals), goals.size());
+		
+		double error_sum = 0.0;
+		for (const auto& goal: goals)
+		{
+			skeletal_mesh.get_pose() = rest_pose;
+			solver.set_goal_center(goal);
+			solver.solve();
+			error_sum += math::distance(skeletal_mesh.get_pose().get_absolute_transform(tip_bone) * effector_position, goal);
+		}
+		std::cout << std::format("{:<48}{:>12.6f} mean error\n", name, error_sum / static_cast<double>(goals.size()));
+	};
+	
+	two_bone_ik_solver two_bone_solver(rig, tip_bone - 1, tip_bone);
+	ccd_ik_solver two_bone_ccd_solver(rig, tip_bone - 1, tip_bone);
+	two_bone_ccd_solver.set_max_iterations(max_iterations);
+	compare("two_bone_ik_solver, 2 bones", two_bone_solver, two_bone_goals);
+	compare("ccd_ik_solver, 2 bones", two_bone_ccd_solver, two_bone_goals);
+	
+	fabrik_ik_solver fabrik_solver(rig, tip_bone - 2, tip_bone);
+	fabrik_solver.set_max_iterations(max_iterations);
+	ccd_ik_solver three_bone_ccd_solver(rig, tip_bone - 2, tip_bone);
+	three_bone_ccd_solver.set_max_iterations(max_iterations);
+	compare("fabrik_ik_solver, 3 bones", fabrik_solver, three_bone_goals);
+	compare("ccd_ik_solver, 3 bones", three_bone_ccd_solver, three_bone_goals);
+	
+	return EXIT_SUCCESS;
+}
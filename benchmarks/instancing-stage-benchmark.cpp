@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Measures the CPU time of the instancing stage on 10,000 render operations which share varying numbers of meshes, headless with the null OpenGL backend, and the number of operations which remain after instancing.
+
+#include "benchmark.hpp"
+#include <engine/gl/null-backend.hpp>
+#include <engine/gl/shader-template.hpp>
+#include <engine/gl/stream-buffer.hpp>
+#include <engine/gl/vertex-array.hpp>
+#include <engine/math/matrix.hpp>
+#include <engine/math/vector.hpp>
+#include <engine/render/context.hpp>
+#include <engine/render/material.hpp>
+#include <engine/render/operation.hpp>
+#include <engine/render/stages/instancing-stage.hpp>
+#include <engine/render/vertex-attribute-location.hpp>
+#include <engine/utility/text-file.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+int main()
+{
+	constexpr std::size_t operation_count = 10000;
+	constexpr std::size_t run_count = 21;
+	
+	if (!gl::load_null_backend(1920, 1080))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	// Build a material whose shader template supports instancing
+	text_file shader_source;
+	shader_source.lines =
+	{
+		"#version 330 core",
+		"#pragma define VERTEX_INSTANCE_TRANSFORM",
+		"void main() {}"
+	};
+	auto material = std::make_shared<render::material>();
+	material->set_shader_template(std::make_shared<gl::shader_template>(std::move(shader_source)));
+	
+	const gl::vertex_input_attribute position_attribute
+	{
+		.location = render::vertex_attribute_location::position,
+		.binding = 0,
+		.format = gl::format::r32g32b32_sfloat,
+		.offset = 0
+	};
+	
+	gl::stream_buffer stream_buffer(std::size_t{1} << 22);
+	
+	for (const std::size_t mesh_count: {std::size_t{10}, std::size_t{100}, std::size_t{1000}})
+	{
+		// Build meshes
+		std::vector<std::unique_ptr<gl::vertex_array>> vertex_arrays(mesh_count);
+		for (auto& vertex_array: vertex_arrays)
+		{
+			vertex_array = std::make_unique<gl::vertex_array>(std::span{&position_attribute, 1});
+		}
+		
+		// Build operations which draw the meshes in turn, at different positions
+		std::vector<render::operation> operations(operation_count);
+		std::vector<const render::operation*> queued_operations(operation_count);
+		for (std::size_t i = 0; i < operation_count; ++i)
+		{
+			auto& operation = operations[i];
+			operation.vertex_array = vertex_arrays[i % mesh_count].get();
+			operation.vertex_stride = sizeof(math::fvec3);
+			operation.vertex_count = 36;
+			operation.material = material;
+			operation.transform = math::translate(math::fvec3{static_cast<float>(i), 0.0f, 0.0f});
+			operation.depth = static_cast<float>(i);
+			queued_operations[i] = &operation;
+		}
+		
+		render::instancing_stage stage;
+		render::context ctx{};
+		ctx.stream_buffer = &stream_buffer;
+		
+		benchmark::report
+		(
+			std::format("instancing_stage, {} meshes", mesh_count),
+			benchmark::measure
+			(
+				run_count,
+				[&]()
+				{
+					ctx.operations = queued_operations;
+					stage.execute(ctx);
+					stream_buffer.fence();
+				}
+			),
+			operation_count
+		);
+		
+		std::cout << std::format("{:<48}{:>12} operations\n", std::format("instancing_stage, {} meshes", mesh_count), ctx.operations.size());
+	}
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Measures the CPU time per frame of each renderer stage on a nest scene populated by a configurable number of worker ants, headless with the null OpenGL backend.
+//
+// Usage: nest-scene-benchmark <data path> [ant count] [frame count]
+
+#include "benchmark.hpp"
+#include "game/ant/ant-caste-type.hpp"
+#include "game/ant/ant-cladogenesis.hpp"
+#include "game/ant/ant-genome.hpp"
+#include "game/ant/ant-morphogenesis.hpp"
+#include "game/ant/ant-phenome.hpp"
+#include "game/ecoregion.hpp"
+#include <engine/gl/framebuffer.hpp>
+#include <engine/gl/image.hpp>
+#include <engine/gl/image-view.hpp>
+#include <engine/gl/null-backend.hpp>
+#include <engine/gl/pipeline.hpp>
+#include <engine/gl/texture.hpp>
+#include <engine/math/vector.hpp>
+#include <engine/render/compositor.hpp>
+#include <engine/render/model.hpp>
+#include <engine/render/passes/clear-pass.hpp>
+#include <engine/render/passes/material-pass.hpp>
+#include <engine/render/renderer.hpp>
+#include <engine/resources/resource-manager.hpp>
+#include <engine/scene/camera.hpp>
+#include <engine/scene/collection.hpp>
+#include <engine/scene/directional-light.hpp>
+#include <engine/scene/skeletal-mesh.hpp>
+#include <engine/scene/static-mesh.hpp>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Parses a positive count from a command line argument.
+[[nodiscard]] bool parse_count(std::string_view argument, std::size_t& count)
+{
+	const auto [ptr, ec] = std::from_chars(argument.data(), argument.data() + argument.size(), count);
+	return ec == std::errc{} && ptr == argument.data() + argument.size() && count;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	constexpr std::uint32_t viewport_width = 1920;
+	constexpr std::uint32_t viewport_height = 1080;
+	constexpr std::uint32_t shadow_map_resolution = 4096;
+	constexpr std::size_t warmup_frame_count = 10;
+	constexpr float ant_spacing = 0.5f;
+	
+	std::size_t ant_count = 100;
+	std::size_t frame_count = 100;
+	if (argc < 2 ||
+		(argc > 2 && !parse_count(argv[2], ant_count)) ||
+		(argc > 3 && !parse_count(argv[3], frame_count)))
+	{
+		std::cerr << "Usage: nest-scene-benchmark <data path> [ant count] [frame count]\n";
+		return EXIT_FAILURE;
+	}
+	
+	if (!gl::load_null_backend(viewport_width, viewport_height))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	resource_manager resources;
+	if (!resources.mount(argv[1]))
+	{
+		std::cerr << std::format("Failed to mount data path \"{}\"\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	
+	gl::pipeline pipeline;
+	render::renderer renderer(pipeline, resources);
+	
+	// Build compositor which clears and draws to the default framebuffer
+	render::clear_pass clear_pass(&pipeline, nullptr);
+	clear_pass.set_clear_mask(gl::color_clear_bit | gl::depth_clear_bit | gl::stencil_clear_bit);
+	clear_pass.set_clear_value({{0.0f, 0.0f, 0.0f, 0.0f}, 0.0f, 0});
+	render::material_pass material_pass(&pipeline, nullptr, &resources);
+	render::compositor compositor;
+	compositor.add_pass(&clear_pass);
+	compositor.add_pass(&material_pass);
+	
+	scene::collection collection;
+	
+	// Add nest
+	scene::static_mesh nest(resources.load<render::model>("soil-nest.mdl"));
+	collection.add_object(nest);
+	
+	// Generate worker model
+	const auto active_ecoregion = resources.load<::ecoregion>("debug.eco");
+	std::mt19937 random_engine(1);
+	const auto genome = ant_cladogenesis(active_ecoregion->gene_pools[0], random_engine);
+	const ant_phenome worker_phenome(*genome, ant_caste_type::worker);
+	const std::shared_ptr<render::model> worker_model = ant_morphogenesis(worker_phenome);
+	
+	// Add workers in a square grid centered on the nest
+	const std::size_t grid_size = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(ant_count))));
+	const float grid_offset = static_cast<float>(grid_size - 1) * ant_spacing * 0.5f;
+	std::vector<std::unique_ptr<scene::skeletal_mesh>> workers(ant_count);
+	for (std::size_t i = 0; i < ant_count; ++i)
+	{
+		auto& worker = workers[i];
+		worker = std::make_unique<scene::skeletal_mesh>(worker_model);
+		worker->get_pose() = worker_model->skeleton()->rest_pose();
+		worker->set_translation({static_cast<float>(i % grid_size) * ant_spacing - grid_offset, 0.0f, static_cast<float>(i / grid_size) * ant_spacing - grid_offset});
+		collection.add_object(*worker);
+	}
+	
+	// Add shadow-casting sun
+	auto shadow_map_image_view = std::make_shared<gl::image_view_2d>(std::make_shared<gl::image_2d>(gl::format::d32_sfloat, shadow_map_resolution, shadow_map_resolution));
+	const gl::framebuffer_attachment shadow_map_attachments[1] = {{gl::depth_attachment_bit, shadow_map_image_view, 0}};
+	scene::directional_light sun;
+	sun.set_illuminance(100000.0f);
+	sun.set_shadow_caster(true);
+	sun.set_shadow_framebuffer(std::make_shared<gl::framebuffer>(shadow_map_attachments, shadow_map_resolution, shadow_map_resolution));
+	sun.set_shadow_max_distance(20.0f);
+	sun.set_shadow_fade_range(5.0f);
+	sun.set_shadow_cascade_count(4);
+	sun.set_shadow_cascade_distribution(0.8f);
+	sun.look_at({0.0f, 0.0f, 0.0f}, {-1.0f, -2.0f, -1.0f}, {0.0f, 1.0f, 0.0f});
+	collection.add_object(sun);
+	
+	// Add camera which views the whole grid
+	scene::camera camera;
+	camera.set_perspective(math::radians<float>(45.0f), static_cast<float>(viewport_width) / static_cast<float>(viewport_height), 0.1f);
+	camera.set_compositor(&compositor);
+	camera.set_composite_index(0);
+	camera.look_at({0.0f, grid_offset + 2.0f, grid_offset + 4.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+	collection.add_object(camera);
+	
+	// Render warmup frames, which compile shaders and fill caches
+	const float dt = 1.0f / 60.0f;
+	float t = 0.0f;
+	for (std::size_t i = 0; i < warmup_frame_count; ++i, t += dt)
+	{
+		renderer.render(t, dt, 1.0f, collection);
+	}
+	
+	// Sum the statistics of each measured frame
+	render::renderer_statistics sum;
+	for (std::size_t i = 0; i < frame_count; ++i, t += dt)
+	{
+		renderer.render(t, dt, 1.0f, collection);
+		
+		const auto& frame = renderer.get_statistics();
+		sum.cpu_time += frame.cpu_time;
+		sum.light_probe_stage_cpu_time += frame.light_probe_stage_cpu_time;
+		sum.culling_stage_cpu_time += frame.culling_stage_cpu_time;
+		sum.skinning_stage_cpu_time += frame.skinning_stage_cpu_time;
+		sum.cascaded_shadow_map_stage_cpu_time += frame.cascaded_shadow_map_stage_cpu_time;
+		sum.queue_stage_cpu_time += frame.queue_stage_cpu_time;
+		sum.batching_stage_cpu_time += frame.batching_stage_cpu_time;
+		sum.instancing_stage_cpu_time += frame.instancing_stage_cpu_time;
+		sum.compositor_cpu_time += frame.compositor_cpu_time;
+		sum.pipeline = sum.pipeline + frame.pipeline;
+		sum.object_count += frame.object_count;
+		sum.operation_count += frame.operation_count;
+	}
+	
+	// Report the mean CPU time per frame of each stage, per ant
+	const auto report = [&](std::string_view stage, std::chrono::steady_clock::duration duration)
+	{
+		benchmark::report(std::format("{}, {} ants", stage, ant_count), std::chrono::duration_cast<std::chrono::nanoseconds>(duration) / frame_count, ant_count);
+	};
+	report("frame", sum.cpu_time);
+	report("light_probe_stage", sum.light_probe_stage_cpu_time);
+	report("culling_stage", sum.culling_stage_cpu_time);
+	report("skinning_stage", sum.skinning_stage_cpu_time);
+	report("cascaded_shadow_map_stage", sum.cascaded_shadow_map_stage_cpu_time);
+	report("queue_stage", sum.queue_stage_cpu_time);
+	report("batching_stage", sum.batching_stage_cpu_time);
+	report("instancing_stage", sum.instancing_stage_cpu_time);
+	report("compositor", sum.compositor_cpu_time);
+	
+	std::cout << std::format("{:<48}{:>12} objects\n", "frame", sum.object_count / frame_count);
+	std::cout << std::format("{:<48}{:>12} operations\n", "frame", sum.operation_count / frame_count);
+	std::cout << std::format("{:<48}{:>12} draws\n", "frame", sum.pipeline.draw_count / frame_count);
+	std::cout << std::format("{:<48}{:>12} state changes\n", "frame", sum.pipeline.state_change_count / frame_count);
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compares sorting render operations with operation_sorter and with std::stable_sort, on random sort keys.
+
+#include "benchmark.hpp"
+#include <engine/render/operation.hpp>
+#include <engine/render/operation-sorter.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main()
+{
+	constexpr std::size_t run_count = 21;
+	
+	std::mt19937_64 random_engine(1);
+	render::operation_sorter sorter;
+	
+	for (const std::size_t operation_count: {std::size_t{10000}, std::size_t{100000}})
+	{
+		// Generate operations with random sort keys, in their unsorted order
+		std::vector<render::operation> operations(operation_count);
+		std::vector<const render::operation*> unsorted_operations(operation_count);
+		for (std::size_t i = 0; i < operation_count; ++i)
+		{
+			operations[i].sort_key = random_engine();
+			unsorted_operations[i] = &operations[i];
+		}
+		
+		const auto key = [](const render::operation& operation) -> std::uint64_t
+		{
+			return operation.sort_key;
+		};
+		
+		// Both sorts are stable, so they must produce the same order
+		auto radix_sorted_operations = unsorted_operations;
+		sorter.sort(radix_sorted_operations, key);
+		auto stable_sorted_operations = unsorted_operations;
+		std::stable_sort
+		(
+			stable_sorted_operations.begin(),
+			stable_sorted_operations.end(),
+			[](const render::operation* lhs, const render::operation* rhs)
+			{
+				return lhs->sort_key < rhs->sort_key;
+			}
+		);
+		if (radix_sorted_operations != stable_sorted_operations)
+		{
+			std::cerr << "operation_sorter order does not match std::stable_sort\n";
+			return EXIT_FAILURE;
+		}
+		
+		// Each run sorts a copy of the unsorted operations
+		std::vector<const render::operation*> sorted_operations;
+		
+		benchmark::report
+		(
+			std::format("operation_sorter, {} operations", operation_count),
+			benchmark::measure
+			(
+				run_count,
+				[&]()
+				{
+					sorted_operations = unsorted_operations;
+					sorter.sort(sorted_operations, key);
+					benchmark::consume(sorted_operations.front());
+				}
+			),
+			operation_count
+		);
+		benchmark::report
+		(
+			std::format("std::stable_sort, {} operations", operation_count),
+			benchmark::measure
+			(
+				run_count,
+				[&]()
+				{
+					sorted_operations = unsorted_operations;
+					std::stable_sort
+					(
+						sorted_operations.begin(),
+						sorted_operations.end(),
+						[](const render::operation* lhs, const render::operation* rhs)
+						{
+							return lhs->sort_key < rhs->sort_key;
+						}
+					);
+					benchmark::consume(sorted_operations.front());
+				}
+			),
+			operation_count
+		);
+	}
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Measures the CPU time per skeletal mesh of building skinning palettes, from pose evaluation in the skinning stage to packing and writing palettes into the stream buffer, for posed and unchanged poses, headless with the null OpenGL backend.
+
+#include "benchmark.hpp"
+#include <engine/animation/skeleton.hpp>
+#include <engine/gl/null-backend.hpp>
+#include <engine/gl/stream-buffer.hpp>
+#include <engine/math/quaternion.hpp>
+#include <engine/render/context.hpp>
+#include <engine/render/model.hpp>
+#include <engine/render/stages/skinning-stage.hpp>
+#include <engine/render/uniform-blocks.hpp>
+#include <engine/scene/camera.hpp>
+#include <engine/scene/skeletal-mesh.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Number of bones in the skeleton, which is about the number of bones in a worker ant.
+constexpr std::size_t bone_count = 40;
+
+/**
+ * Builds a skeleton whose bones form a binary tree.
+ */
+[[nodiscard]] std::shared_ptr<skeleton> build_tree_skeleton()
+{
+	auto tree_skeleton = std::make_shared<skeleton>(bone_count);
+	for (std::size_t i = 1; i < bone_count; ++i)
+	{
+		tree_skeleton->bones()[i].reparent(&tree_skeleton->bones()[(i - 1) / 2]);
+		
+		auto transform = math::identity<math::transform<float>>;
+		transform.translation = {0.1f, 0.0f, 0.0f};
+		transform.rotation = math::fquat::rotate_z(0.3f);
+		tree_skeleton->rest_pose().set_relative_transform(i, transform);
+	}
+	
+	return tree_skeleton;
+}
+
+} // namespace
+
+int main()
+{
+	constexpr std::size_t mesh_count = 1000;
+	constexpr std::size_t run_count = 21;
+	constexpr std::size_t uniform_buffer_offset_alignment = 256;
+	
+	if (!gl::load_null_backend(1920, 1080))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	// Build skeletal meshes from a model which only has a skeleton
+	auto model = std::make_shared<render::model>();
+	model->skeleton() = build_tree_skeleton();
+	std::vector<std::unique_ptr<scene::skeletal_mesh>> meshes(mesh_count);
+	for (auto& mesh: meshes)
+	{
+		mesh = std::make_unique<scene::skeletal_mesh>(model);
+		mesh->get_pose() = model->skeleton()->rest_pose();
+	}
+	
+	scene::camera camera;
+	camera.set_perspective(1.0f, 16.0f / 9.0f, 0.1f);
+	
+	gl::stream_buffer stream_buffer(std::size_t{1} << 26);
+	
+	render::context ctx{};
+	ctx.camera = &camera;
+	ctx.stream_buffer = &stream_buffer;
+	ctx.uniform_buffer_offset_alignment = uniform_buffer_offset_alignment;
+	for (const auto& mesh: meshes)
+	{
+		ctx.objects.emplace_back(mesh.get());
+	}
+	
+	render::skinning_stage stage;
+	
+	// Changes one bone of each pose, which outdates its skinning matrices and palette
+	float angle = 0.0f;
+	const auto pose_meshes = [&]()
+	{
+		angle += 0.01f;
+		for (auto& mesh: meshes)
+		{
+			mesh->get_pose().set_relative_rotation(1, math::fquat::rotate_z(angle));
+		}
+	};
+	
+	// Evaluates poses and writes the skinning palette of each mesh into the stream buffer, as a frame would
+	const auto render_frame = [&]()
+	{
+		++ctx.frame;
+		ctx.operations.clear();
+		stage.execute(ctx);
+		for (const auto& mesh: meshes)
+		{
+			mesh->render(ctx);
+		}
+	};
+	
+	// Each mesh should write one full skinning block per frame
+	pose_meshes();
+	render_frame();
+	if (stream_buffer.get_frame_size() < mesh_count * render::skinning_block_offsets.size)
+	{
+		std::cerr << std::format("Skinning palettes not written: {} bytes allocated\n", stream_buffer.get_frame_size());
+		return EXIT_FAILURE;
+	}
+	stream_buffer.fence();
+	
+	benchmark::report
+	(
+		std::format("skinning_stage, {} bones, posed", bone_count),
+		benchmark::measure
+		(
+			run_count,
+			[&]()
+			{
+				pose_meshes();
+				stage.execute(ctx);
+			}
+		),
+		mesh_count
+	);
+	
+	benchmark::report
+	(
+		std::format("skinning palette, {} bones, posed", bone_count),
+		benchmark::measure
+		(
+			run_count,
+			[&]()
+			{
+				pose_meshes();
+				render_frame();
+				stream_buffer.fence();
+			}
+		),
+		mesh_count
+	);
+	
+	benchmark::report
+	(
+		std::format("skinning palette, {} bones, unchanged", bone_count),
+		benchmark::measure
+		(
+			run_count,
+			[&]()
+			{
+				render_frame();
+				stream_buffer.fence();
+			}
+		),
+		mesh_count
+	);
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_ANIMATION_BINDING_TYPE_HPP
+#define ANTKEEPER_ANIMATION_ANIMATION_BINDING_TYPE_HPP
+
+#include <cstdint>
+
+/** Types of properties to which animation tracks can be bound. */
+enum class animation_binding_type: std::uint8_t
+{
+	/** Track is unbound, samples are passed to the track output function. */
+	none,
+
+	/** Relative translation of a bone, from three channels. */
+	bone_translation,
+
+	/** Relative rotation of a bone, from four quaternion channels (w, x, y, z). */
+	bone_rotation_quaternion,
+
+	/** Relative rotation of a bone, from three XYZ Euler angle channels. */
+	bone_rotation_euler,
+
+	/** Relative scale of a bone, from three channels. */
+	bone_scale
+};
+
+#endif // ANTKEEPER_ANIMATION_ANIMATION_BINDING_TYPE_HPP
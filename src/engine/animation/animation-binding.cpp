@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/animation-binding.hpp>
+#include <engine/animation/skeleton-pose.hpp>
+#include <engine/math/euler-angles.hpp>
+#include <engine/math/quaternion.hpp>
+
+std::size_t animation_binding::channel_count() const noexcept
+{
+	switch (type)
+	{
+		case animation_binding_type::bone_translation:
+		case animation_binding_type::bone_rotation_euler:
+		case animation_binding_type::bone_scale:
+			return 3;
+
+		case animation_binding_type::bone_rotation_quaternion:
+			return 4;
+
+		case animation_binding_type::none:
+		default:
+			return 0;
+	}
+}
+
+void write_animation_binding(const animation_binding& binding, std::span<const float> samples, animation_context& context)
+{
+	switch (binding.type)
+	{
+		case animation_binding_type::bone_translation:
+			if (context.pose)
+			{
+				context.pose->set_relative_translation(binding.index, {samples[0], samples[1], samples[2]});
+			}
+			break;
+
+		case animation_binding_type::bone_rotation_quaternion:
+			if (context.pose)
+			{
+				context.pose->set_relative_rotation(binding.index, math::normalize(math::fquat{samples[0], samples[1], samples[2], samples[3]}));
+			}
+			break;
+
+		case animation_binding_type::bone_rotation_euler:
+			if (context.pose)
+			{
+				context.pose->set_relative_rotation(binding.index, math::euler_xyz_to_quat(math::fvec3{samples[0], samples[1], samples[2]}));
+			}
+			break;
+
+		case animation_binding_type::bone_scale:
+			if (context.pose)
+			{
+				context.pose->set_relative_scale(binding.index, {samples[0], samples[1], samples[2]});
+			}
+			break;
+
+		case animation_binding_type::none:
+		default:
+			break;
+	}
+}
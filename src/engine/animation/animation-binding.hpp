@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_ANIMATION_BINDING_HPP
+#define ANTKEEPER_ANIMATION_ANIMATION_BINDING_HPP
+
+#include <engine/animation/animation-binding-type.hpp>
+#include <engine/animation/animation-context.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * Typed target of an animation track, resolved once from a track path.
+ */
+struct animation_binding
+{
+	/** Type of the bound property. */
+	animation_binding_type type{animation_binding_type::none};
+
+	/** Index of the bound bone. */
+	std::uint32_t index{0};
+
+	/** Returns the number of channels required by the binding. */
+	[[nodiscard]] std::size_t channel_count() const noexcept;
+
+	/**
+	 * Returns `true` if writing the binding only modifies the animation context's own pose, and can therefore happen concurrently with writes from other animation contexts.
+	 */
+	[[nodiscard]] inline constexpr bool is_context_local() const noexcept
+	{
+		return type != animation_binding_type::none;
+	}
+};
+
+/**
+ * Writes track samples to a bound property.
+ *
+ * @param binding Animation binding.
+ * @param samples Track samples. Must contain at least `binding.channel_count()` elements.
+ * @param context Animation context, the pose of which is modified by bone bindings.
+ */
+void write_animation_binding(const animation_binding& binding, std::span<const float> samples, animation_context& context);
+
+#endif // ANTKEEPER_ANIMATION_ANIMATION_BINDING_HPP
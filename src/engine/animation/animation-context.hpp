@@ -6,13 +6,18 @@
 
 #include <entt/entt.hpp>
 
+class skeleton_pose;
+
 /**
- * Context for animation track output functions.
+ * Context for animation track output functions and bindings.
  */
 struct animation_context
 {
 	/** Handle to the entity being animated. */
 	entt::handle handle;
+
+	/** Pose to which bone bindings are written. */
+	skeleton_pose* pose{nullptr};
 };
 
 #endif // ANTKEEPER_ANIMATION_ANIMATION_CONTEXT_HPP
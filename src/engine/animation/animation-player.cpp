@@ -44,25 +44,26 @@ void animation_player::advance(float seconds)
 		}
 	}
 
-	for (const auto& [path, track]: m_sequence->tracks())
+	// Sample compiled tracks
+	for (const auto& compiled_track: m_compiled_tracks)
 	{
-		if (!track.output())
+		const auto& track = *compiled_track.track;
+		const auto samples = std::span<float>(m_sample_buffer).first(compiled_track.channel_count);
+		const auto cursors = std::span<std::size_t>(m_cursors).subspan(compiled_track.first_cursor, compiled_track.channel_count);
+
+		// Sample track
+		track.sample(m_position, samples, cursors);
+
+		if (track.binding().type != animation_binding_type::none)
 		{
-			// Ignore tracks with no output functions
-			continue;
+			// Write samples directly to bound property
+			write_animation_binding(track.binding(), samples, m_context);
 		}
-
-		if (m_sample_buffer.size() < track.channels().size())
+		else
 		{
-			// Grow sample buffer to accommodate track channels
-			m_sample_buffer.resize(track.channels().size());
+			// Pass sample buffer and animation context to track output function
+			track.output()(m_sample_buffer, m_context);
 		}
-
-		// Sample track
-		track.sample(m_position, m_sample_buffer);
-
-		// Pass sample buffer and animation context to track output function
-		track.output()(m_sample_buffer, m_context);
 	}
 
 	if (loop_count)
@@ -100,6 +101,9 @@ void animation_player::play(std::shared_ptr<animation_sequence> sequence)
 		m_sequence_duration = 0.0f;
 	}
 
+	// Resolve tracks
+	compile_tracks();
+
 	m_state = animation_player_state::playing;
 }
 
@@ -133,3 +137,54 @@ void animation_player::loop(bool enabled)
 {
 	m_looping = enabled;
 }
+
+bool animation_player::can_advance_concurrently() const noexcept
+{
+	return m_concurrent_tracks && (!m_sequence || m_sequence->cues().empty());
+}
+
+void animation_player::compile_tracks()
+{
+	m_compiled_tracks.clear();
+	m_concurrent_tracks = true;
+
+	if (!m_sequence)
+	{
+		m_cursors.clear();
+		return;
+	}
+
+	std::size_t cursor_count = 0;
+	std::size_t max_channel_count = 0;
+	for (const auto& [path, track]: m_sequence->tracks())
+	{
+		const auto channel_count = track.channels().size();
+
+		// Ignore tracks with no binding and no output function
+		if (track.binding().type == animation_binding_type::none && !track.output())
+		{
+			continue;
+		}
+
+		// Ignore bound tracks with an invalid binding or too few channels
+		if (track.binding().type != animation_binding_type::none && (!track.binding().channel_count() || channel_count < track.binding().channel_count()))
+		{
+			continue;
+		}
+
+		m_compiled_tracks.emplace_back(&track, cursor_count, channel_count);
+		m_concurrent_tracks = m_concurrent_tracks && track.binding().is_context_local();
+
+		cursor_count += channel_count;
+		max_channel_count = std::max(max_channel_count, channel_count);
+	}
+
+	// Reset keyframe cursors
+	m_cursors.assign(cursor_count, 0);
+
+	if (m_sample_buffer.size() < max_channel_count)
+	{
+		// Grow sample buffer to accommodate track channels
+		m_sample_buffer.resize(max_channel_count);
+	}
+}
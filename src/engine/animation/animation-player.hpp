@@ -31,6 +31,8 @@ public:
 	 * Starts playing an animation sequence.
 	 *
 	 * @param sequence Animation sequence to play.
+	 *
+	 * @note The tracks of the sequence are resolved when this function is called. Tracks added to or removed from the sequence afterwards are not taken into account until the sequence is played again.
 	 */
 	void play(std::shared_ptr<animation_sequence> sequence);
 
@@ -96,6 +98,11 @@ public:
 		return m_looping;
 	}
 
+	/**
+	 * Returns `true` if advancing the player only writes to its own animation context, and can therefore happen concurrently with other players, `false` if it may call track output functions or cues.
+	 */
+	[[nodiscard]] bool can_advance_concurrently() const noexcept;
+
 	/** Returns a reference to the animation context of the player. */
 	[[nodiscard]] inline constexpr auto& context() noexcept
 	{
@@ -109,12 +116,26 @@ public:
 	}
 
 private:
+	/// Track of the current sequence, resolved for sampling.
+	struct compiled_track
+	{
+		const animation_track* track;
+		std::size_t first_cursor;
+		std::size_t channel_count;
+	};
+
+	/// Resolves the tracks of the current sequence.
+	void compile_tracks();
+
 	std::shared_ptr<animation_sequence> m_sequence;
 	float m_sequence_duration{};
 	animation_player_state m_state{animation_player_state::stopped};
 	float m_position{};
 	bool m_looping{};
 	std::vector<float> m_sample_buffer;
+	std::vector<std::size_t> m_cursors;
+	std::vector<compiled_track> m_compiled_tracks;
+	bool m_concurrent_tracks{true};
 	animation_context m_context{};
 };
 
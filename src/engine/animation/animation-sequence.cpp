@@ -27,6 +27,14 @@ void animation_sequence::trigger_cues(float start_time, float end_time, animatio
 	}
 }
 
+void animation_sequence::bake()
+{
+	for (auto& [path, track]: m_tracks)
+	{
+		track.bake();
+	}
+}
+
 float animation_sequence::duration() const
 {
 	float max_duration = 0.0f;
@@ -111,6 +119,9 @@ void deserializer<animation_sequence>::deserialize(animation_sequence& sequence,
 		// Add track to sequence
 		sequence.tracks().emplace(track_path, std::move(track));
 	}
+
+	// Bake tracks for sampling
+	sequence.bake();
 }
 
 template <>
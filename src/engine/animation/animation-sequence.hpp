@@ -26,6 +26,13 @@ public:
 	 */
 	void trigger_cues(float start_time, float end_time, animation_context& context) const;
 
+	/**
+	 * Bakes all tracks of the sequence.
+	 *
+	 * @see animation_track::bake()
+	 */
+	void bake();
+
 	/** Returns a reference to the name of the sequence. */
 	[[nodiscard]] inline constexpr auto& name() noexcept
 	{
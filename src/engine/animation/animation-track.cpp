@@ -29,6 +29,33 @@ void animation_track::sample(float time, std::size_t first_channel, std::span<fl
 	}
 }
 
+void animation_track::sample(float time, std::span<float> samples, std::span<std::size_t> cursors) const
+{
+	if (!m_baked)
+	{
+		sample(time, samples);
+		return;
+	}
+
+	const auto min_size = std::min({m_baked_channels.size(), samples.size(), cursors.size()});
+	for (std::size_t i = 0; i < min_size; ++i)
+	{
+		samples[i] = m_baked_channels[i].evaluate(time, cursors[i]);
+	}
+}
+
+void animation_track::bake()
+{
+	m_baked_channels.clear();
+	m_baked_channels.reserve(m_channels.size());
+	for (const auto& channel: m_channels)
+	{
+		m_baked_channels.emplace_back(channel);
+	}
+
+	m_baked = true;
+}
+
 float animation_track::duration() const
 {
 	float max_duration = 0.0f;
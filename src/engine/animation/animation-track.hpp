@@ -5,7 +5,9 @@
 #define ANTKEEPER_ANIMATION_ANIMATION_TRACK_HPP
 
 #include <engine/animation/animation-curve.hpp>
+#include <engine/animation/baked-animation-curve.hpp>
 #include <engine/animation/animation-context.hpp>
+#include <engine/animation/animation-binding.hpp>
 #include <functional>
 #include <span>
 #include <vector>
@@ -40,6 +42,38 @@ public:
 	 */
 	void sample(float time, std::span<float> samples) const;
 
+	/**
+	 * Evaluates the baked channels of the track at a given time, storing the resulting values in a buffer.
+	 *
+	 * @param[in] time Time at which to sample the track.
+	 * @param[out] samples Buffer to store the evaluated values of the channels. The number of channels sampled is limited by the size of the buffer.
+	 * @param[in,out] cursors Keyframe cursors of each channel, updated as the channels are sampled. Must contain at least as many elements as @p samples.
+	 *
+	 * @note If the track has not been baked, the channels will be sampled instead and @p cursors left unmodified.
+	 *
+	 * @see baked_animation_curve::evaluate(float, std::size_t&) const
+	 */
+	void sample(float time, std::span<float> samples, std::span<std::size_t> cursors) const;
+
+	/**
+	 * Bakes the channels of the track into contiguous keyframe arrays for faster sampling.
+	 *
+	 * @warning The track must be re-baked after its channels are modified.
+	 */
+	void bake();
+
+	/** Returns `true` if the track has been baked, `false` otherwise. */
+	[[nodiscard]] inline constexpr bool is_baked() const noexcept
+	{
+		return m_baked;
+	}
+
+	/** Returns the baked channels of the track. */
+	[[nodiscard]] inline constexpr const auto& baked_channels() const noexcept
+	{
+		return m_baked_channels;
+	}
+
 	/** Returns a reference to the channels of the track. */
 	[[nodiscard]] inline constexpr auto& channels() noexcept
 	{
@@ -52,6 +86,22 @@ public:
 		return m_channels;
 	}
 
+	/**
+	 * Returns a reference to the binding of the track.
+	 *
+	 * Bound tracks write their samples directly to the bound property, and their output functions are ignored.
+	 */
+	[[nodiscard]] inline constexpr auto& binding() noexcept
+	{
+		return m_binding;
+	}
+
+	/** @copydoc binding() */
+	[[nodiscard]] inline constexpr const auto& binding() const noexcept
+	{
+		return m_binding;
+	}
+
 	/** Returns a reference to the output function of the track. */
 	[[nodiscard]] inline constexpr auto& output() noexcept
 	{
@@ -69,6 +119,9 @@ public:
 
 private:
 	std::vector<animation_curve> m_channels;
+	std::vector<baked_animation_curve> m_baked_channels;
+	bool m_baked{false};
+	animation_binding m_binding;
 	output_function_type m_output_function;
 };
 
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/baked-animation-curve.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+using keyframe_interpolator_pointer = float(*)(const keyframe&, const keyframe&, float) noexcept;
+using keyframe_extrapolator_pointer = float(*)(const keyframe_container&, float);
+
+/// Maximum number of segments a cursor steps forward before falling back to a binary search.
+inline constexpr std::size_t max_cursor_steps = 4;
+
+} // namespace
+
+baked_animation_curve::baked_animation_curve(const animation_curve& curve)
+{
+	// Copy keyframes into contiguous arrays
+	m_times.reserve(curve.keyframes().size());
+	m_values.reserve(curve.keyframes().size());
+	for (const auto& keyframe: curve.keyframes())
+	{
+		m_times.emplace_back(keyframe.time);
+		m_values.emplace_back(keyframe.value);
+	}
+
+	// Determine interpolation mode
+	const auto interpolator = curve.interpolator().target<keyframe_interpolator_pointer>();
+	if (interpolator && *interpolator == interpolate_keyframes_linear)
+	{
+		m_interpolation_mode = interpolation_mode::linear;
+	}
+	else if (interpolator && *interpolator == interpolate_keyframes_constant)
+	{
+		m_interpolation_mode = interpolation_mode::constant;
+	}
+	else
+	{
+		m_interpolation_mode = interpolation_mode::other;
+		m_interpolator = curve.interpolator();
+	}
+
+	// Determine extrapolation mode
+	const auto extrapolator = curve.extrapolator().target<keyframe_extrapolator_pointer>();
+	m_clamp_extrapolation = (extrapolator && *extrapolator == extrapolate_keyframes_clamp && !m_times.empty());
+	if (!m_clamp_extrapolation)
+	{
+		m_extrapolator = curve.extrapolator();
+		m_extrapolator_keyframes = curve.keyframes();
+	}
+}
+
+float baked_animation_curve::evaluate(float time, std::size_t& cursor) const
+{
+	// Check if time is outside keyframe range
+	if (m_times.empty() || time < m_times.front() || time > m_times.back())
+	{
+		// Extrapolate outside keyframe range
+		return extrapolate(time);
+	}
+
+	// Check if time coincides with the first keyframe
+	if (time <= m_times.front())
+	{
+		cursor = 0;
+		return m_values.front();
+	}
+
+	// Find segment `i` such that `m_times[i] < time <= m_times[i + 1]`
+	if (cursor + 1 >= m_times.size() || !(m_times[cursor] < time))
+	{
+		// Cursor is invalid or ahead of time, find segment with a binary search
+		cursor = static_cast<std::size_t>(std::distance(m_times.begin(), std::lower_bound(m_times.begin(), m_times.end(), time))) - 1;
+	}
+	else
+	{
+		// Step cursor forward
+		for (std::size_t i = 0; time > m_times[cursor + 1]; ++i)
+		{
+			if (i == max_cursor_steps)
+			{
+				// Time is too far ahead, find segment with a binary search
+				cursor = static_cast<std::size_t>(std::distance(m_times.begin(), std::lower_bound(m_times.begin() + cursor + 1, m_times.end(), time))) - 1;
+				break;
+			}
+
+			++cursor;
+		}
+	}
+
+	// Interpolate between keyframes
+	switch (m_interpolation_mode)
+	{
+		case interpolation_mode::linear:
+		{
+			const auto t = (time - m_times[cursor]) / (m_times[cursor + 1] - m_times[cursor]);
+			return (m_values[cursor + 1] - m_values[cursor]) * t + m_values[cursor];
+		}
+
+		case interpolation_mode::constant:
+			return m_values[cursor];
+
+		case interpolation_mode::other:
+		default:
+			return m_interpolator({m_times[cursor], m_values[cursor]}, {m_times[cursor + 1], m_values[cursor + 1]}, time);
+	}
+}
+
+float baked_animation_curve::evaluate(float time) const
+{
+	std::size_t cursor = 0;
+	return evaluate(time, cursor);
+}
+
+float baked_animation_curve::duration() const noexcept
+{
+	if (m_times.empty())
+	{
+		return 0.0f;
+	}
+
+	return std::max(0.0f, m_times.back());
+}
+
+float baked_animation_curve::extrapolate(float time) const
+{
+	// Curves without keyframes, such as default-constructed curves, have no values to extrapolate
+	if (m_times.empty())
+	{
+		return 0.0f;
+	}
+
+	if (m_clamp_extrapolation)
+	{
+		return (time < m_times.front()) ? m_values.front() : m_values.back();
+	}
+
+	return m_extrapolator(m_extrapolator_keyframes, time);
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_BAKED_ANIMATION_CURVE_HPP
+#define ANTKEEPER_ANIMATION_BAKED_ANIMATION_CURVE_HPP
+
+#include <engine/animation/animation-curve.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Read-only animation curve with keyframes stored in contiguous time and value arrays.
+ *
+ * Baked curves are sampled with a cursor which caches the most recently evaluated keyframe segment, such that sampling with monotonically increasing times is amortized O(1).
+ */
+class baked_animation_curve
+{
+public:
+	/**
+	 * Bakes an animation curve.
+	 *
+	 * @param curve Animation curve to bake.
+	 *
+	 * @note Linear and constant interpolation, and clamp extrapolation, are evaluated inline. Other interpolator and extrapolator functions are copied and called as needed.
+	 */
+	explicit baked_animation_curve(const animation_curve& curve);
+
+	/** Constructs an empty baked animation curve. */
+	baked_animation_curve() = default;
+
+	/**
+	 * Evaluates the curve at a given time.
+	 *
+	 * @param[in] time Time at which to evaluate the curve.
+	 * @param[in,out] cursor Index of the keyframe segment at which to begin searching. Updated to the index of the keyframe segment containing @p time.
+	 *
+	 * @return Value of the curve at @p time, or `0` if the curve has no keyframes.
+	 */
+	[[nodiscard]] float evaluate(float time, std::size_t& cursor) const;
+
+	/**
+	 * Evaluates the curve at a given time.
+	 *
+	 * @param time Time at which to evaluate the curve.
+	 *
+	 * @return Value of the curve at @p time, or `0` if the curve has no keyframes.
+	 */
+	[[nodiscard]] float evaluate(float time) const;
+
+	/** Returns the keyframe times of the curve, in ascending order. */
+	[[nodiscard]] inline constexpr const auto& times() const noexcept
+	{
+		return m_times;
+	}
+
+	/** Returns the keyframe values of the curve. */
+	[[nodiscard]] inline constexpr const auto& values() const noexcept
+	{
+		return m_values;
+	}
+
+	/** Returns the non-negative duration of the curve, in seconds. */
+	[[nodiscard]] float duration() const noexcept;
+
+private:
+	/// Interpolation modes which can be evaluated without calling the interpolator function.
+	enum class interpolation_mode: std::uint8_t
+	{
+		linear,
+		constant,
+		other
+	};
+
+	[[nodiscard]] float extrapolate(float time) const;
+
+	std::vector<float> m_times;
+	std::vector<float> m_values;
+	interpolation_mode m_interpolation_mode{interpolation_mode::linear};
+	bool m_clamp_extrapolation{true};
+	animation_curve::keyframe_interpolator_type m_interpolator;
+	animation_curve::keyframe_extrapolator_type m_extrapolator;
+	keyframe_container m_extrapolator_keyframes;
+};
+
+#endif // ANTKEEPER_ANIMATION_BAKED_ANIMATION_CURVE_HPP
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/bone-mask.hpp>
+#include <engine/animation/skeleton.hpp>
+#include <engine/animation/bone.hpp>
+#include <algorithm>
+
+bone_mask::bone_mask(const skeleton& skeleton, float weight):
+	m_weights(skeleton.bones().size(), weight)
+{
+	if (weight != 0.0f)
+	{
+		m_bones.resize(m_weights.size());
+		for (std::size_t i = 0; i < m_bones.size(); ++i)
+		{
+			m_bones[i] = static_cast<std::uint32_t>(i);
+		}
+	}
+}
+
+void bone_mask::set_weight(std::size_t index, float weight)
+{
+	m_weights[index] = weight;
+
+	// Keep the indices of weighted bones sorted
+	const auto bone_index = static_cast<std::uint32_t>(index);
+	const auto it = std::lower_bound(m_bones.begin(), m_bones.end(), bone_index);
+	const bool listed = (it != m_bones.end() && *it == bone_index);
+	if (weight != 0.0f && !listed)
+	{
+		m_bones.insert(it, bone_index);
+	}
+	else if (weight == 0.0f && listed)
+	{
+		m_bones.erase(it);
+	}
+}
+
+void bone_mask::set_hierarchy_weight(const bone& root, float weight)
+{
+	set_weight(root.index(), weight);
+	for (const bone* child: root.children())
+	{
+		set_hierarchy_weight(*child, weight);
+	}
+}
+
+void bone_mask::set_chain_weight(const bone& tip, std::size_t length, float weight)
+{
+	for (const bone* bone = &tip; bone && length; bone = bone->parent(), --length)
+	{
+		set_weight(bone->index(), weight);
+	}
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_BONE_MASK_HPP
+#define ANTKEEPER_ANIMATION_BONE_MASK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class skeleton;
+class bone;
+
+/**
+ * Per-bone blend weights of a skeleton.
+ *
+ * Bone masks restrict pose blend layers to a subset of the bones of a skeleton, such as a single leg or the upper body. Alongside the weights, a mask keeps the indices of its bones with nonzero weight, such that blend kernels can skip the bones outside of the mask.
+ */
+class bone_mask
+{
+public:
+	/**
+	 * Constructs a bone mask.
+	 *
+	 * @param skeleton Skeleton with which to associate the mask.
+	 * @param weight Initial weight of every bone.
+	 */
+	explicit bone_mask(const skeleton& skeleton, float weight = 0.0f);
+
+	/** Constructs an empty bone mask. */
+	bone_mask() noexcept = default;
+
+	/**
+	 * Sets the weight of a single bone.
+	 *
+	 * @param index Index of a bone.
+	 * @param weight Bone weight, on `[0, 1]`.
+	 */
+	void set_weight(std::size_t index, float weight);
+
+	/**
+	 * Sets the weight of a bone and all of its descendants.
+	 *
+	 * @param root Root bone of the hierarchy.
+	 * @param weight Bone weight, on `[0, 1]`.
+	 */
+	void set_hierarchy_weight(const bone& root, float weight);
+
+	/**
+	 * Sets the weight of a bone and a number of its ancestors.
+	 *
+	 * @param tip Bone at the end of the chain.
+	 * @param length Number of bones in the chain, including @p tip.
+	 * @param weight Bone weight, on `[0, 1]`.
+	 */
+	void set_chain_weight(const bone& tip, std::size_t length, float weight);
+
+	/** Returns the weight of each bone, indexed by bone index. */
+	[[nodiscard]] inline constexpr const std::vector<float>& weights() const noexcept
+	{
+		return m_weights;
+	}
+
+	/** Returns the indices of the bones with nonzero weight, in ascending order. */
+	[[nodiscard]] inline constexpr const std::vector<std::uint32_t>& bones() const noexcept
+	{
+		return m_bones;
+	}
+
+private:
+	std::vector<float> m_weights;
+	std::vector<std::uint32_t> m_bones;
+};
+
+#endif // ANTKEEPER_ANIMATION_BONE_MASK_HPP
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/ik/ik-chain-solver.hpp>
+#include <engine/animation/ik/ik-rig.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+ik_chain_solver::ik_chain_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index):
+	m_ik_rig{&ik_rig}
+{
+	// Get reference to skeleton
+	const auto& skeleton = *m_ik_rig->get_skeletal_mesh().get_pose().get_skeleton();
+	
+	// Validate bone chain and store bone indices, from tip to root
+	m_bone_indices.emplace_back(effector_bone_index);
+	while (m_bone_indices.back() != root_bone_index)
+	{
+		const auto parent_bone = skeleton.bones()[m_bone_indices.back()].parent();
+		if (!parent_bone)
+		{
+			throw std::invalid_argument("Invalid bone chain");
+		}
+		
+		m_bone_indices.emplace_back(parent_bone->index());
+	}
+	
+	// Reorder bone indices from root to tip
+	std::reverse(m_bone_indices.begin(), m_bone_indices.end());
+	
+	// Allocate joint buffers
+	m_joint_positions.resize(m_bone_indices.size() + 1);
+	m_gathered_positions.resize(m_bone_indices.size() + 1);
+	m_gathered_rotations.resize(m_bone_indices.size());
+}
+
+void ik_chain_solver::solve()
+{
+	gather();
+	solve_local();
+	scatter();
+}
+
+void ik_chain_solver::gather()
+{
+	const auto& skeletal_mesh = m_ik_rig->get_skeletal_mesh();
+	const auto& pose = skeletal_mesh.get_pose();
+	
+	// Gather pose-space transforms of chain bones
+	for (std::size_t i = 0; i < m_bone_indices.size(); ++i)
+	{
+		const auto& ps_bone_transform = pose.get_absolute_transform(m_bone_indices[i]);
+		m_gathered_positions[i] = ps_bone_transform.translation;
+		m_gathered_rotations[i] = ps_bone_transform.rotation;
+	}
+	m_gathered_positions.back() = pose.get_absolute_transform(m_bone_indices.back()) * m_effector_position;
+	
+	// Gather pose-space rotation of the root bone's parent
+	const auto root_parent = pose.get_skeleton()->bones()[m_bone_indices.front()].parent();
+	m_parent_rotation = root_parent ? pose.get_absolute_transform(root_parent->index()).rotation : math::identity<math::fquat>;
+	
+	// Transform goal position into pose-space
+	m_ps_goal_center = m_goal_center * skeletal_mesh.get_transform();
+	
+	m_joint_positions = m_gathered_positions;
+}
+
+void ik_chain_solver::scatter()
+{
+	auto& pose = m_ik_rig->get_skeletal_mesh().get_pose();
+	
+	// Rotation applied to the parent of the current bone by the solution
+	math::fquat parent_delta = math::identity<math::fquat>;
+	math::fquat parent_rotation = m_parent_rotation;
+	
+	for (std::size_t i = 0; i < m_bone_indices.size(); ++i)
+	{
+		// Find direction of the bone segment, after inheriting the rotation of its parent
+		const auto inherited_rotation = math::normalize(parent_delta * m_gathered_rotations[i]);
+		const auto old_segment = m_gathered_positions[i + 1] - m_gathered_positions[i];
+		const auto new_segment = m_joint_positions[i + 1] - m_joint_positions[i];
+		
+		// Rotate bone to align its segment with the solution
+		auto rotation = inherited_rotation;
+		if (math::sqr_length(old_segment) > 0.0f && math::sqr_length(new_segment) > 0.0f)
+		{
+			const auto inherited_direction = math::normalize(parent_delta * old_segment);
+			rotation = math::normalize(math::rotation(inherited_direction, math::normalize(new_segment), 1e-5f) * inherited_rotation);
+		}
+		
+		// Convert to bone-space rotation
+		const auto bone_index = m_bone_indices[i];
+		auto bone_rotation = math::normalize(math::conjugate(parent_rotation) * rotation);
+		
+		// Apply bone constraints to rotation
+		if (auto* constraint = m_ik_rig->get_constraint(bone_index))
+		{
+			constraint->solve(bone_rotation);
+			rotation = math::normalize(parent_rotation * bone_rotation);
+		}
+		
+		// Rotate bone
+		pose.set_relative_rotation(bone_index, bone_rotation);
+		
+		parent_delta = math::normalize(rotation * math::conjugate(m_gathered_rotations[i]));
+		parent_rotation = rotation;
+	}
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_IK_CHAIN_SOLVER_HPP
+#define ANTKEEPER_ANIMATION_IK_CHAIN_SOLVER_HPP
+
+#include <engine/animation/ik/ik-solver.hpp>
+#include <engine/math/vector.hpp>
+#include <engine/math/quaternion.hpp>
+#include <span>
+#include <vector>
+
+class ik_rig;
+
+/**
+ * Abstract base class for IK solvers which move the joints of a bone chain in a local buffer.
+ *
+ * The pose-space joint positions and rotations of the chain are gathered once, moved by the derived solver without touching the pose, then converted to relative bone rotations and written back to the pose once per bone.
+ */
+class ik_chain_solver: public ik_solver
+{
+public:
+	/**
+	 * Constructs an IK chain solver.
+	 *
+	 * @param ik_rig IK rig with which to associate this IK solver.
+	 * @param root_bone_index Index of the first bone in the bone chain.
+	 * @param effector_bone_index Index of the last bone in the bone chain.
+	 *
+	 * @exception std::invalid_argument Invalid bone chain.
+	 */
+	ik_chain_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index);
+	
+	/** Destructs an IK chain solver. */
+	~ik_chain_solver() override = default;
+	
+	/// @name Solving
+	/// @{
+	
+	void solve() override;
+	
+	[[nodiscard]] inline bool is_batchable() const noexcept override
+	{
+		return true;
+	}
+	
+	[[nodiscard]] inline std::span<const std::size_t> get_bone_indices() const noexcept override
+	{
+		return m_bone_indices;
+	}
+	
+	void gather() override;
+	void scatter() override;
+	
+	/// @}
+	
+	/// @name Effector
+	/// @{
+	
+	/**
+	 * Sets the position of the end effector.
+	 *
+	 * @param position Position of the end effector, relative to the tip bone.
+	 */
+	inline void set_effector_position(const math::fvec3& position) noexcept
+	{
+		m_effector_position = position;
+	}
+	
+	/// Returns the position of the end effector, relative to the tip bone.
+	[[nodiscard]] inline const math::fvec3& get_effector_position() const
+	{
+		return m_effector_position;
+	}
+	
+	/// @}
+	
+	/// @name Goal
+	/// @{
+	
+	/**
+	 * Sets the center of the IK goal.
+	 *
+	 * @param center IK goal center, in world-space.
+	 */
+	inline void set_goal_center(const math::fvec3& center) noexcept
+	{
+		m_goal_center = center;
+	}
+	
+	/**
+	 * Sets the radius of the IK goal.
+	 *
+	 * @param radius IK goal radius.
+	 */
+	inline void set_goal_radius(float radius) noexcept
+	{
+		m_sqr_goal_radius = radius * radius;
+	}
+	
+	/// Returns the center of the IK goal, in world-space.
+	[[nodiscard]] inline const math::fvec3& get_goal_center() const
+	{
+		return m_goal_center;
+	}
+	
+	/// @}
+	
+protected:
+	/// Indices of the bones in the chain, from root to tip.
+	std::vector<std::size_t> m_bone_indices;
+	
+	/// Pose-space positions of the chain joints, from root to end effector. Moved by solve_local().
+	std::vector<math::fvec3> m_joint_positions;
+	
+	/// Pose-space goal center, updated by gather().
+	math::fvec3 m_ps_goal_center{0.0f, 0.0f, 0.0f};
+	
+	/// Squared radius of the IK goal.
+	float m_sqr_goal_radius{1e-5f};
+	
+private:
+	ik_rig* m_ik_rig{nullptr};
+	math::fvec3 m_effector_position{0.0f, 0.0f, 0.0f};
+	math::fvec3 m_goal_center{0.0f, 0.0f, 0.0f};
+	
+	/// Gathered pose-space joint positions and bone rotations, and the pose-space rotation of the root bone's parent.
+	std::vector<math::fvec3> m_gathered_positions;
+	std::vector<math::fquat> m_gathered_rotations;
+	math::fquat m_parent_rotation{math::identity<math::fquat>};
+};
+
+#endif // ANTKEEPER_ANIMATION_IK_CHAIN_SOLVER_HPP
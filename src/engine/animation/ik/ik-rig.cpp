@@ -2,6 +2,34 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <engine/animation/ik/ik-rig.hpp>
+#include <engine/debug/log.hpp>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Checks whether a bone chain shares a bone with, or depends on, another bone chain.
+ *
+ * @param skeleton Skeleton of the bone chains.
+ * @param chain Bone chain, from root to tip.
+ * @param other_chain Other bone chain, from root to tip.
+ *
+ * @return `true` if the root bone of @p chain, or any of its ancestors, is a bone of @p other_chain, `false` otherwise.
+ */
+[[nodiscard]] bool depends_on(const skeleton& skeleton, std::span<const std::size_t> chain, std::span<const std::size_t> other_chain)
+{
+	for (auto bone = &skeleton.bones()[chain.front()]; bone; bone = bone->parent())
+	{
+		if (std::find(other_chain.begin(), other_chain.end(), bone->index()) != other_chain.end())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // namespace
 
 ik_rig::ik_rig(scene::skeletal_mesh& skeletal_mesh):
 	m_skeletal_mesh(&skeletal_mesh),
@@ -31,10 +59,35 @@ void ik_rig::solve()
 
 void ik_rig::add_solver(std::shared_ptr<ik_solver> solver)
 {
+	if (m_batchable)
+	{
+		const auto chain = solver->get_bone_indices();
+		if (!solver->is_batchable() || chain.empty())
+		{
+			m_batchable = false;
+		}
+		else
+		{
+			// Chains which overlap or depend on each other must be solved in order
+			const auto& skeleton = *m_skeletal_mesh->get_pose().get_skeleton();
+			for (const auto& other_solver: m_solvers)
+			{
+				const auto other_chain = other_solver->get_bone_indices();
+				if (depends_on(skeleton, chain, other_chain) || depends_on(skeleton, other_chain, chain))
+				{
+					debug::log_debug("IK chains ending at bones {} and {} overlap, IK rig will be solved in order", chain.back(), other_chain.back());
+					m_batchable = false;
+					break;
+				}
+			}
+		}
+	}
+
 	m_solvers.emplace_back(std::move(solver));
 }
 
 void ik_rig::remove_solvers()
 {
 	m_solvers.clear();
+	m_batchable = true;
 }
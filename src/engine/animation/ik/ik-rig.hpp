@@ -73,13 +73,15 @@ public:
 	/// @{
 	
 	/**
-	 * Solves each solver in the IK rig.
+	 * Solves each solver in the IK rig, in the order in which they were added.
 	 */
 	void solve();
 	
 	/**
 	 * Adds a solver to the IK rig.
 	 *
+	 * If the solver is not batchable, or its bone chain overlaps or depends on the chain of another solver, the IK rig is no longer batchable.
+	 *
 	 * @param solver IK solver to add.
 	 */
 	void add_solver(std::shared_ptr<ik_solver> solver);
@@ -89,12 +91,29 @@ public:
 	 */
 	void remove_solvers();
 	
+	/// Returns the solvers of the IK rig.
+	[[nodiscard]] inline const std::vector<std::shared_ptr<ik_solver>>& get_solvers() const noexcept
+	{
+		return m_solvers;
+	}
+	
+	/**
+	 * Returns `true` if the solvers of the IK rig can be solved in batches, `false` if they must be solved in order with solve().
+	 *
+	 * An IK rig is batchable if all of its solvers are batchable, and no bone chain of a solver shares a bone with, or contains an ancestor of, the bone chain of another solver.
+	 */
+	[[nodiscard]] inline bool is_batchable() const noexcept
+	{
+		return m_batchable;
+	}
+	
 	/// @}
 	
 private:
 	scene::skeletal_mesh* m_skeletal_mesh{nullptr};
 	std::vector<std::shared_ptr<ik_constraint>> m_constraints;
 	std::vector<std::shared_ptr<ik_solver>> m_solvers;
+	bool m_batchable{true};
 };
 
 #endif // ANTKEEPER_ANIMATION_IK_RIG_HPP
@@ -4,6 +4,9 @@
 #ifndef ANTKEEPER_ANIMATION_IK_SOLVER_HPP
 #define ANTKEEPER_ANIMATION_IK_SOLVER_HPP
 
+#include <cstddef>
+#include <span>
+
 /**
  * Abstract base class for IK solvers.
  */
@@ -17,6 +20,51 @@ public:
 	 * Transforms bones to find an inverse kinematic solution for an end effector.
 	 */
 	virtual void solve() = 0;
+
+	/// @name Batched solving
+	/// Batchable solvers split solve() into gather, local solve, and scatter phases, such that the local solves of many solvers can run concurrently.
+	///
+	/// Gathering every solver of a pose before scattering any of them is only equivalent to solving them in order if their bone chains are independent. An IK rig is therefore only solved in batches if none of its chains share a bone, or contain an ancestor of a bone in another chain.
+	/// @{
+
+	/** Returns `true` if the solver supports batched solving, `false` otherwise. */
+	[[nodiscard]] virtual bool is_batchable() const noexcept
+	{
+		return false;
+	}
+
+	/**
+	 * Returns the indices of the bones transformed by the solver, from root to tip.
+	 *
+	 * @note Batchable solvers must return their bone chain, such that the independence of the chains of an IK rig can be checked.
+	 */
+	[[nodiscard]] virtual std::span<const std::size_t> get_bone_indices() const noexcept
+	{
+		return {};
+	}
+
+	/**
+	 * Reads the bone transforms required to solve from the pose.
+	 *
+	 * @warning Lazily updates the pose, so solvers of the same pose should gather serially.
+	 */
+	virtual void gather() {}
+
+	/**
+	 * Solves using only the state read by gather().
+	 *
+	 * @note Local solves of different solvers can run concurrently.
+	 */
+	virtual void solve_local() {}
+
+	/**
+	 * Writes the local solution into the pose.
+	 *
+	 * @warning Modifies the pose, so solvers of the same pose should scatter serially.
+	 */
+	virtual void scatter() {}
+
+	/// @}
 };
 
 #endif // ANTKEEPER_ANIMATION_IK_SOLVER_HPP
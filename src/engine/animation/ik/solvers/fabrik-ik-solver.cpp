@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/ik/solvers/fabrik-ik-solver.hpp>
+#include <cmath>
+
+fabrik_ik_solver::fabrik_ik_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index):
+	ik_chain_solver(ik_rig, root_bone_index, effector_bone_index),
+	m_segment_lengths(m_bone_indices.size())
+{}
+
+void fabrik_ik_solver::solve_local()
+{
+	auto& joints = m_joint_positions;
+	const auto segment_count = m_segment_lengths.size();
+	
+	// Measure segment lengths and total reach of the chain
+	float reach = 0.0f;
+	for (std::size_t i = 0; i < segment_count; ++i)
+	{
+		m_segment_lengths[i] = math::distance(joints[i], joints[i + 1]);
+		reach += m_segment_lengths[i];
+	}
+	
+	const auto root = joints.front();
+	
+	// If goal is out of reach, stretch chain towards goal
+	if (const auto sqr_goal_distance = math::sqr_distance(root, m_ps_goal_center); sqr_goal_distance >= reach * reach)
+	{
+		// A chain of zero reach with its goal at the root has no direction in which to stretch, leave joints as they are
+		if (sqr_goal_distance > 0.0f)
+		{
+			const auto direction = (m_ps_goal_center - root) / std::sqrt(sqr_goal_distance);
+			for (std::size_t i = 0; i < segment_count; ++i)
+			{
+				joints[i + 1] = joints[i] + direction * m_segment_lengths[i];
+			}
+		}
+		
+		return;
+	}
+	
+	for (std::size_t i = 0; i < m_max_iterations; ++i)
+	{
+		// Check if end effector is within goal radius
+		if (math::sqr_distance(joints.back(), m_ps_goal_center) <= m_sqr_goal_radius)
+		{
+			return;
+		}
+		
+		// Backward pass: move end effector to goal, then drag joints towards it
+		joints.back() = m_ps_goal_center;
+		for (std::size_t j = segment_count; j > 0; --j)
+		{
+			const auto segment = joints[j - 1] - joints[j];
+			if (const auto sqr_segment_length = math::sqr_length(segment); sqr_segment_length > 0.0f)
+			{
+				joints[j - 1] = joints[j] + segment * (m_segment_lengths[j - 1] / std::sqrt(sqr_segment_length));
+			}
+		}
+		
+		// Forward pass: move root back to its origin, then drag joints towards it
+		joints.front() = root;
+		for (std::size_t j = 0; j < segment_count; ++j)
+		{
+			const auto segment = joints[j + 1] - joints[j];
+			if (const auto sqr_segment_length = math::sqr_length(segment); sqr_segment_length > 0.0f)
+			{
+				joints[j + 1] = joints[j] + segment * (m_segment_lengths[j] / std::sqrt(sqr_segment_length));
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_FABRIK_IK_SOLVER_HPP
+#define ANTKEEPER_ANIMATION_FABRIK_IK_SOLVER_HPP
+
+#include <engine/animation/ik/ik-chain-solver.hpp>
+#include <vector>
+
+/**
+ * Forward And Backward Reaching Inverse Kinematics (FABRIK) IK solver.
+ */
+class fabrik_ik_solver: public ik_chain_solver
+{
+public:
+	/**
+	 * Constructs a FABRIK IK solver.
+	 *
+	 * @param ik_rig IK rig with which to associate this IK solver.
+	 * @param root_bone_index Index of the first bone in the bone chain.
+	 * @param effector_bone_index Index of the last bone in the bone chain.
+	 *
+	 * @exception std::invalid_argument Invalid bone chain.
+	 */
+	fabrik_ik_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index);
+	
+	/** Destructs a FABRIK IK solver. */
+	~fabrik_ik_solver() override = default;
+	
+	/// @name Solving
+	/// @{
+	
+	void solve_local() override;
+	
+	/**
+	 * Sets the maximum number of solving iterations.
+	 *
+	 * @param iterations Maximum number of solving iterations.
+	 */
+	inline void set_max_iterations(std::size_t iterations) noexcept
+	{
+		m_max_iterations = iterations;
+	}
+	
+	/// Returns the maximum number of solving iterations.
+	[[nodiscard]] inline std::size_t get_max_iterations() const noexcept
+	{
+		return m_max_iterations;
+	}
+	
+	/// @}
+	
+private:
+	std::size_t m_max_iterations{10};
+	std::vector<float> m_segment_lengths;
+};
+
+#endif // ANTKEEPER_ANIMATION_FABRIK_IK_SOLVER_HPP
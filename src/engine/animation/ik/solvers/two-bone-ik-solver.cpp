@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/ik/solvers/two-bone-ik-solver.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+two_bone_ik_solver::two_bone_ik_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index):
+	ik_chain_solver(ik_rig, root_bone_index, effector_bone_index)
+{
+	if (m_bone_indices.size() != 2)
+	{
+		throw std::invalid_argument("Two-bone IK chain must contain exactly two bones");
+	}
+}
+
+void two_bone_ik_solver::solve_local()
+{
+	const auto& a = m_joint_positions[0];
+	auto& b = m_joint_positions[1];
+	auto& c = m_joint_positions[2];
+	
+	// Check if end effector is within goal radius
+	if (math::sqr_distance(c, m_ps_goal_center) <= m_sqr_goal_radius)
+	{
+		return;
+	}
+	
+	// Find bone lengths
+	const auto length_ab = math::distance(a, b);
+	const auto length_bc = math::distance(b, c);
+	
+	// Find direction to goal, and clamp distance to goal to the reach of the chain
+	const auto ac = m_ps_goal_center - a;
+	const auto distance_ac = math::length(ac);
+	if (distance_ac <= 0.0f || length_ab <= 0.0f || length_bc <= 0.0f)
+	{
+		return;
+	}
+	const auto direction_ac = ac / distance_ac;
+	const auto reach = std::clamp(distance_ac, std::abs(length_ab - length_bc) + 1e-5f, length_ab + length_bc - 1e-5f);
+	
+	// Find bend direction, perpendicular to the goal direction in the current plane of the chain
+	auto bend = (b - a) - direction_ac * math::dot(b - a, direction_ac);
+	if (math::sqr_length(bend) <= 1e-10f)
+	{
+		// Chain is straight, bend about an arbitrary perpendicular axis
+		bend = math::cross(direction_ac, std::abs(direction_ac.x()) < 0.9f ? math::fvec3{1, 0, 0} : math::fvec3{0, 1, 0});
+	}
+	bend = math::normalize(bend);
+	
+	// Place middle joint with the law of cosines
+	const auto cos_a = std::clamp((length_ab * length_ab + reach * reach - length_bc * length_bc) / (2.0f * length_ab * reach), -1.0f, 1.0f);
+	const auto sin_a = std::sqrt(1.0f - cos_a * cos_a);
+	b = a + direction_ac * (length_ab * cos_a) + bend * (length_ab * sin_a);
+	c = a + direction_ac * reach;
+}
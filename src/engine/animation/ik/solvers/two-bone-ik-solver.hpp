@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_TWO_BONE_IK_SOLVER_HPP
+#define ANTKEEPER_ANIMATION_TWO_BONE_IK_SOLVER_HPP
+
+#include <engine/animation/ik/ik-chain-solver.hpp>
+
+/**
+ * Analytic two-bone IK solver.
+ *
+ * Solves a chain of two bones in closed form with the law of cosines, keeping the chain bent in its current plane.
+ */
+class two_bone_ik_solver: public ik_chain_solver
+{
+public:
+	/**
+	 * Constructs a two-bone IK solver.
+	 *
+	 * @param ik_rig IK rig with which to associate this IK solver.
+	 * @param root_bone_index Index of the first bone in the bone chain.
+	 * @param effector_bone_index Index of the second bone in the bone chain, which must be a child of the first bone.
+	 *
+	 * @exception std::invalid_argument Invalid bone chain.
+	 */
+	two_bone_ik_solver(ik_rig& ik_rig, std::size_t root_bone_index, std::size_t effector_bone_index);
+	
+	/** Destructs a two-bone IK solver. */
+	~two_bone_ik_solver() override = default;
+	
+	void solve_local() override;
+};
+
+#endif // ANTKEEPER_ANIMATION_TWO_BONE_IK_SOLVER_HPP
@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_STEP_KEYPOSE_HPP
+#define ANTKEEPER_ANIMATION_STEP_KEYPOSE_HPP
+
+#include <engine/animation/skeleton-pose.hpp>
+#include <memory>
+
+/**
+ * Limb pose at a phase of a step.
+ *
+ * Limb poses between keyposes are blended from the adjacent keyposes.
+ */
+struct step_keypose
+{
+	/// Step phase, on `[-1, 1]`, at which the limb reaches the pose. Negative phases are in the stance phase, non-negative phases are in the swing phase.
+	float phase{};
+
+	/// Limb pose.
+	std::shared_ptr<skeleton_pose> pose;
+};
+
+#endif // ANTKEEPER_ANIMATION_STEP_KEYPOSE_HPP
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_POSE_BLEND_MODE_HPP
+#define ANTKEEPER_ANIMATION_POSE_BLEND_MODE_HPP
+
+#include <cstdint>
+
+/** Modes by which a pose blend layer is combined with its base pose. */
+enum class pose_blend_mode: std::uint8_t
+{
+	/** Layer pose replaces the base pose. */
+	override,
+
+	/** Difference between the layer pose and the skeleton rest pose is added to the base pose. */
+	additive
+};
+
+#endif // ANTKEEPER_ANIMATION_POSE_BLEND_MODE_HPP
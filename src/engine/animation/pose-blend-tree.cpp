@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/pose-blend-tree.hpp>
+#include <engine/animation/pose-blend.hpp>
+#include <engine/animation/skeleton.hpp>
+#include <engine/animation/skeleton-pose.hpp>
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+pose_blend_tree::pose_blend_tree(const skeleton& skeleton):
+	m_skeleton{&skeleton}
+{}
+
+std::size_t pose_blend_tree::add_pose_node(const skeleton_pose* pose)
+{
+	auto& node = m_nodes.emplace_back();
+	node.type = node_type::pose;
+	node.pose = pose;
+
+	return m_nodes.size() - 1;
+}
+
+std::size_t pose_blend_tree::add_blend_node(std::span<const std::size_t> children, std::shared_ptr<const bone_mask> mask)
+{
+	for (const auto child: children)
+	{
+		if (child >= m_nodes.size())
+		{
+			throw std::invalid_argument(std::format("Pose blend tree has no node with index {}.", child));
+		}
+	}
+
+	for (const auto child: children)
+	{
+		++m_nodes[child].parent_count;
+	}
+
+	auto& node = m_nodes.emplace_back();
+	node.type = node_type::blend;
+	node.children.assign(children.begin(), children.end());
+	node.mask = std::move(mask);
+
+	// Bones outside of the mask are never written, and keep the rest pose
+	const auto& rest_transforms = m_skeleton->rest_pose().get_relative_transforms();
+	node.transforms.assign(rest_transforms.begin(), rest_transforms.end());
+
+	return m_nodes.size() - 1;
+}
+
+std::size_t pose_blend_tree::add_layer_node(std::size_t base, std::size_t layer, pose_blend_mode mode, std::shared_ptr<const bone_mask> mask)
+{
+	if (base >= m_nodes.size() || layer >= m_nodes.size())
+	{
+		throw std::invalid_argument(std::format("Pose blend tree has no node with index {}.", std::max(base, layer)));
+	}
+
+	++m_nodes[base].parent_count;
+	++m_nodes[layer].parent_count;
+
+	auto& node = m_nodes.emplace_back();
+	node.type = node_type::layer;
+	node.mode = mode;
+	node.children = {base, layer};
+	node.mask = std::move(mask);
+	node.transforms.resize(m_skeleton->bones().size());
+
+	return m_nodes.size() - 1;
+}
+
+void pose_blend_tree::clear()
+{
+	m_nodes.clear();
+}
+
+void pose_blend_tree::evaluate(skeleton_pose& pose)
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// Children precede their parents, so each node's inputs are final by the time it is reached
+	for (auto& node: m_nodes)
+	{
+		switch (node.type)
+		{
+			case node_type::blend:
+				evaluate_blend_node(node);
+				break;
+
+			case node_type::layer:
+				evaluate_layer_node(node);
+				break;
+
+			case node_type::pose:
+			default:
+				break;
+		}
+	}
+
+	pose.set_relative_transforms(output(m_nodes.size() - 1));
+}
+
+std::span<const math::transform<float>> pose_blend_tree::output(std::size_t index) const noexcept
+{
+	const auto& node = m_nodes[index];
+	if (node.type != node_type::pose)
+	{
+		return node.transforms;
+	}
+
+	return node.pose ? node.pose->get_relative_transforms() : m_skeleton->rest_pose().get_relative_transforms();
+}
+
+void pose_blend_tree::evaluate_blend_node(node& node)
+{
+	// Sum child weights
+	float total_weight = 0.0f;
+	std::size_t weighted_child_count = 0;
+	std::size_t weighted_child = 0;
+	for (const auto child: node.children)
+	{
+		if (const float weight = m_nodes[child].weight; weight > 0.0f)
+		{
+			total_weight += weight;
+			weighted_child = child;
+			++weighted_child_count;
+		}
+	}
+
+	// Copies transforms into the node, restricted to the bones of the mask
+	const auto copy_transforms = [&](std::span<const math::transform<float>> transforms)
+	{
+		if (node.mask)
+		{
+			for (const auto i: node.mask->bones())
+			{
+				node.transforms[i] = transforms[i];
+			}
+		}
+		else
+		{
+			std::copy(transforms.begin(), transforms.end(), node.transforms.begin());
+		}
+	};
+
+	// Without weighted children, output the rest pose
+	if (!weighted_child_count)
+	{
+		copy_transforms(m_skeleton->rest_pose().get_relative_transforms());
+		return;
+	}
+
+	// With a single weighted child, output the child pose
+	if (weighted_child_count == 1)
+	{
+		copy_transforms(output(weighted_child));
+		return;
+	}
+
+	// Average weighted child poses
+	const math::transform<float> zero_transform{math::fvec3{}, math::fquat{0.0f, {}}, math::fvec3{}};
+	if (node.mask)
+	{
+		const std::span<const std::uint32_t> bones = node.mask->bones();
+		for (const auto i: bones)
+		{
+			node.transforms[i] = zero_transform;
+		}
+		for (const auto child: node.children)
+		{
+			if (const float weight = m_nodes[child].weight; weight > 0.0f)
+			{
+				accumulate_transforms(output(child), weight, bones, node.transforms);
+			}
+		}
+		normalize_transforms(node.transforms, total_weight, bones);
+	}
+	else
+	{
+		std::fill(node.transforms.begin(), node.transforms.end(), zero_transform);
+		for (const auto child: node.children)
+		{
+			if (const float weight = m_nodes[child].weight; weight > 0.0f)
+			{
+				accumulate_transforms(output(child), weight, node.transforms);
+			}
+		}
+		normalize_transforms(node.transforms, total_weight);
+	}
+}
+
+void pose_blend_tree::evaluate_layer_node(node& node)
+{
+	auto& base_node = m_nodes[node.children[0]];
+	const auto layer_transforms = output(node.children[1]);
+	const float weight = m_nodes[node.children[1]].weight;
+
+	if (!node.mask)
+	{
+		const auto base_transforms = output(node.children[0]);
+		if (weight <= 0.0f)
+		{
+			std::copy(base_transforms.begin(), base_transforms.end(), node.transforms.begin());
+		}
+		else if (node.mode == pose_blend_mode::additive)
+		{
+			add_transforms(base_transforms, layer_transforms, m_skeleton->rest_pose().get_relative_transforms(), weight, {}, node.transforms);
+		}
+		else
+		{
+			blend_transforms(base_transforms, layer_transforms, weight, {}, node.transforms);
+		}
+		return;
+	}
+
+	// Bones outside of the mask output the base transforms. Take over the transforms of a base node which has no other parent and writes every bone, otherwise copy them.
+	if (base_node.parent_count == 1 && (base_node.type == node_type::layer || (base_node.type == node_type::blend && !base_node.mask)))
+	{
+		std::swap(node.transforms, base_node.transforms);
+	}
+	else
+	{
+		const auto base_transforms = output(node.children[0]);
+		std::copy(base_transforms.begin(), base_transforms.end(), node.transforms.begin());
+	}
+
+	if (weight <= 0.0f)
+	{
+		return;
+	}
+
+	// Combine the layer with the base, in place, for the bones of the mask
+	const std::span<const float> mask = node.mask->weights();
+	const std::span<const std::uint32_t> bones = node.mask->bones();
+	if (node.mode == pose_blend_mode::additive)
+	{
+		add_transforms(node.transforms, layer_transforms, m_skeleton->rest_pose().get_relative_transforms(), weight, mask, bones, node.transforms);
+	}
+	else
+	{
+		blend_transforms(node.transforms, layer_transforms, weight, mask, bones, node.transforms);
+	}
+}
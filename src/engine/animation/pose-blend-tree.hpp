@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_POSE_BLEND_TREE_HPP
+#define ANTKEEPER_ANIMATION_POSE_BLEND_TREE_HPP
+
+#include <engine/animation/bone-mask.hpp>
+#include <engine/animation/pose-blend-mode.hpp>
+#include <engine/math/transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+class skeleton;
+class skeleton_pose;
+
+/**
+ * Blends skeleton poses according to a tree of weighted blend nodes.
+ *
+ * Leaves of the tree sample source poses. Blend nodes average their children by weight, and layer nodes combine a layer on top of a base, optionally restricted by a bone mask. Nodes are referenced by index, and children must be added before their parents, such that the tree can be evaluated in a single pass in order of index.
+ *
+ * Masked nodes only evaluate the bones of their mask. A masked layer node whose base is an unmasked blend node or a layer node, with no other parent, takes over the transforms of its base rather than copying them, such that a chain of masked layers, one per limb, evaluates each limb without touching the rest of the skeleton.
+ *
+ * The weight of each node determines its contribution to its parent. Node weights and source poses can be changed between evaluations without rebuilding the tree.
+ */
+class pose_blend_tree
+{
+public:
+	/**
+	 * Constructs a pose blend tree.
+	 *
+	 * @param skeleton Skeleton of the blended poses.
+	 */
+	explicit pose_blend_tree(const skeleton& skeleton);
+
+	/** Constructs an empty pose blend tree. */
+	pose_blend_tree() noexcept = default;
+
+	/**
+	 * Adds a node which samples a skeleton pose.
+	 *
+	 * @param pose Pose to sample. If `nullptr`, the skeleton rest pose will be sampled.
+	 *
+	 * @return Index of the node.
+	 */
+	std::size_t add_pose_node(const skeleton_pose* pose);
+
+	/**
+	 * Adds a node which blends the weighted average of its children.
+	 *
+	 * @param children Indices of the child nodes.
+	 * @param mask Bone mask of the node. If not `nullptr`, only the bones of the mask are blended, and the remaining bones output the rest pose. Mask weights are not applied.
+	 *
+	 * @return Index of the node.
+	 *
+	 * @exception std::invalid_argument Invalid child node index.
+	 */
+	std::size_t add_blend_node(std::span<const std::size_t> children, std::shared_ptr<const bone_mask> mask = nullptr);
+
+	/**
+	 * Adds a node which blends a layer on top of a base, by the weight of the layer.
+	 *
+	 * @param base Index of the base node.
+	 * @param layer Index of the layer node.
+	 * @param mode Mode by which the layer is combined with the base.
+	 * @param mask Bone mask of the layer. If `nullptr`, all bones are included in the layer.
+	 *
+	 * @return Index of the node.
+	 *
+	 * @exception std::invalid_argument Invalid child node index.
+	 */
+	std::size_t add_layer_node(std::size_t base, std::size_t layer, pose_blend_mode mode, std::shared_ptr<const bone_mask> mask = nullptr);
+
+	/**
+	 * Removes all nodes from the tree.
+	 */
+	void clear();
+
+	/**
+	 * Evaluates the tree and sets the relative transforms of a pose to the result.
+	 *
+	 * @param pose Pose in which to store the result. May be sampled by a pose node of the tree.
+	 *
+	 * @note The root of the tree is its most recently added node.
+	 */
+	void evaluate(skeleton_pose& pose);
+
+	/**
+	 * Sets the pose sampled by a pose node.
+	 *
+	 * @param node Index of a pose node.
+	 * @param pose Pose to sample. If `nullptr`, the skeleton rest pose will be sampled.
+	 */
+	inline void set_pose(std::size_t node, const skeleton_pose* pose) noexcept
+	{
+		m_nodes[node].pose = pose;
+	}
+
+	/**
+	 * Sets the weight of a node.
+	 *
+	 * @param node Index of a node.
+	 * @param weight Contribution of the node to its parent.
+	 */
+	inline void set_weight(std::size_t node, float weight) noexcept
+	{
+		m_nodes[node].weight = weight;
+	}
+
+	/** Returns the weight of a node. */
+	[[nodiscard]] inline float get_weight(std::size_t node) const noexcept
+	{
+		return m_nodes[node].weight;
+	}
+
+	/** Returns the number of nodes in the tree. */
+	[[nodiscard]] inline std::size_t size() const noexcept
+	{
+		return m_nodes.size();
+	}
+
+	/** Returns `true` if the tree has no nodes, `false` otherwise. */
+	[[nodiscard]] inline bool empty() const noexcept
+	{
+		return m_nodes.empty();
+	}
+
+private:
+	/// Pose blend tree node types.
+	enum class node_type: std::uint8_t
+	{
+		pose,
+		blend,
+		layer
+	};
+
+	/// Pose blend tree node.
+	struct node
+	{
+		node_type type{node_type::pose};
+		pose_blend_mode mode{pose_blend_mode::override};
+		float weight{1.0f};
+		const skeleton_pose* pose{};
+		std::vector<std::size_t> children;
+		std::shared_ptr<const bone_mask> mask;
+
+		/// Number of nodes of which this node is a child.
+		std::size_t parent_count{0};
+
+		/// Blended relative transforms of blend and layer nodes.
+		std::vector<math::transform<float>> transforms;
+	};
+
+	/// Returns the relative transforms output by a node.
+	[[nodiscard]] std::span<const math::transform<float>> output(std::size_t index) const noexcept;
+
+	void evaluate_blend_node(node& node);
+	void evaluate_layer_node(node& node);
+
+	const skeleton* m_skeleton{nullptr};
+	std::vector<node> m_nodes;
+};
+
+#endif // ANTKEEPER_ANIMATION_POSE_BLEND_TREE_HPP
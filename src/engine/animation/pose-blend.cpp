@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/pose-blend.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * Blends between two SRT transforms, component-wise.
+ *
+ * Equivalent to lerping translation and scale and nlerping rotation, but written in terms of scalar components only so that loops calling it can be vectorized.
+ */
+[[nodiscard]] inline math::transform<float> blend(const math::transform<float>& a, const math::transform<float>& b, float t) noexcept
+{
+	math::transform<float> c;
+
+	// Lerp translation
+	c.translation[0] = a.translation[0] + (b.translation[0] - a.translation[0]) * t;
+	c.translation[1] = a.translation[1] + (b.translation[1] - a.translation[1]) * t;
+	c.translation[2] = a.translation[2] + (b.translation[2] - a.translation[2]) * t;
+
+	// Nlerp rotation along the shortest arc
+	const float cos_theta = a.rotation.r * b.rotation.r + a.rotation.i[0] * b.rotation.i[0] + a.rotation.i[1] * b.rotation.i[1] + a.rotation.i[2] * b.rotation.i[2];
+	const float s = 1.0f - t;
+	const float u = std::copysign(t, cos_theta);
+	const float rw = a.rotation.r * s + b.rotation.r * u;
+	const float rx = a.rotation.i[0] * s + b.rotation.i[0] * u;
+	const float ry = a.rotation.i[1] * s + b.rotation.i[1] * u;
+	const float rz = a.rotation.i[2] * s + b.rotation.i[2] * u;
+	const float inverse_length = 1.0f / std::sqrt(rw * rw + rx * rx + ry * ry + rz * rz);
+	c.rotation.r = rw * inverse_length;
+	c.rotation.i[0] = rx * inverse_length;
+	c.rotation.i[1] = ry * inverse_length;
+	c.rotation.i[2] = rz * inverse_length;
+
+	// Lerp scale
+	c.scale[0] = a.scale[0] + (b.scale[0] - a.scale[0]) * t;
+	c.scale[1] = a.scale[1] + (b.scale[1] - a.scale[1]) * t;
+	c.scale[2] = a.scale[2] + (b.scale[2] - a.scale[2]) * t;
+
+	return c;
+}
+
+/**
+ * Adds the weighted difference between an additive and reference SRT transform to a base transform, component-wise.
+ */
+[[nodiscard]] inline math::transform<float> add(const math::transform<float>& base, const math::transform<float>& additive, const math::transform<float>& reference, float t) noexcept
+{
+	math::transform<float> c;
+
+	// Add translation difference
+	c.translation[0] = base.translation[0] + (additive.translation[0] - reference.translation[0]) * t;
+	c.translation[1] = base.translation[1] + (additive.translation[1] - reference.translation[1]) * t;
+	c.translation[2] = base.translation[2] + (additive.translation[2] - reference.translation[2]) * t;
+
+	// Find rotation difference, `conjugate(reference) * additive`
+	const float pw = reference.rotation.r;
+	const float px = -reference.rotation.i[0];
+	const float py = -reference.rotation.i[1];
+	const float pz = -reference.rotation.i[2];
+	float dw = pw * additive.rotation.r - px * additive.rotation.i[0] - py * additive.rotation.i[1] - pz * additive.rotation.i[2];
+	float dx = pw * additive.rotation.i[0] + px * additive.rotation.r + py * additive.rotation.i[2] - pz * additive.rotation.i[1];
+	float dy = pw * additive.rotation.i[1] - px * additive.rotation.i[2] + py * additive.rotation.r + pz * additive.rotation.i[0];
+	float dz = pw * additive.rotation.i[2] + px * additive.rotation.i[1] - py * additive.rotation.i[0] + pz * additive.rotation.r;
+
+	// Nlerp rotation difference from identity along the shortest arc
+	const float u = std::copysign(t, dw);
+	dw = (1.0f - t) + dw * u;
+	dx *= u;
+	dy *= u;
+	dz *= u;
+	const float inverse_length = 1.0f / std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+	dw *= inverse_length;
+	dx *= inverse_length;
+	dy *= inverse_length;
+	dz *= inverse_length;
+
+	// Apply rotation difference, `base * difference`
+	const float qw = base.rotation.r;
+	const float qx = base.rotation.i[0];
+	const float qy = base.rotation.i[1];
+	const float qz = base.rotation.i[2];
+	c.rotation.r = qw * dw - qx * dx - qy * dy - qz * dz;
+	c.rotation.i[0] = qw * dx + qx * dw + qy * dz - qz * dy;
+	c.rotation.i[1] = qw * dy - qx * dz + qy * dw + qz * dx;
+	c.rotation.i[2] = qw * dz + qx * dy - qy * dx + qz * dw;
+
+	// Apply scale ratio
+	c.scale[0] = base.scale[0] * (1.0f + (additive.scale[0] / reference.scale[0] - 1.0f) * t);
+	c.scale[1] = base.scale[1] * (1.0f + (additive.scale[1] / reference.scale[1] - 1.0f) * t);
+	c.scale[2] = base.scale[2] * (1.0f + (additive.scale[2] / reference.scale[2] - 1.0f) * t);
+
+	return c;
+}
+
+/**
+ * Adds a weighted SRT transform to a sum of weighted transform components.
+ */
+inline void accumulate(const math::transform<float>& x, float weight, math::transform<float>& sum) noexcept
+{
+	sum.translation[0] += x.translation[0] * weight;
+	sum.translation[1] += x.translation[1] * weight;
+	sum.translation[2] += x.translation[2] * weight;
+
+	// Accumulate rotation in the same hemisphere as the sum
+	const float cos_theta = sum.rotation.r * x.rotation.r + sum.rotation.i[0] * x.rotation.i[0] + sum.rotation.i[1] * x.rotation.i[1] + sum.rotation.i[2] * x.rotation.i[2];
+	const float u = std::copysign(weight, cos_theta);
+	sum.rotation.r += x.rotation.r * u;
+	sum.rotation.i[0] += x.rotation.i[0] * u;
+	sum.rotation.i[1] += x.rotation.i[1] * u;
+	sum.rotation.i[2] += x.rotation.i[2] * u;
+
+	sum.scale[0] += x.scale[0] * weight;
+	sum.scale[1] += x.scale[1] * weight;
+	sum.scale[2] += x.scale[2] * weight;
+}
+
+/**
+ * Converts a sum of weighted transform components into a weighted average.
+ */
+inline void normalize(math::transform<float>& sum, float inverse_total_weight) noexcept
+{
+	sum.translation[0] *= inverse_total_weight;
+	sum.translation[1] *= inverse_total_weight;
+	sum.translation[2] *= inverse_total_weight;
+
+	const float inverse_length = 1.0f / std::sqrt(sum.rotation.r * sum.rotation.r + sum.rotation.i[0] * sum.rotation.i[0] + sum.rotation.i[1] * sum.rotation.i[1] + sum.rotation.i[2] * sum.rotation.i[2]);
+	sum.rotation.r *= inverse_length;
+	sum.rotation.i[0] *= inverse_length;
+	sum.rotation.i[1] *= inverse_length;
+	sum.rotation.i[2] *= inverse_length;
+
+	sum.scale[0] *= inverse_total_weight;
+	sum.scale[1] *= inverse_total_weight;
+	sum.scale[2] *= inverse_total_weight;
+}
+
+} // namespace
+
+void blend_transforms(std::span<const math::transform<float>> a, std::span<const math::transform<float>> b, float t, std::span<const float> mask, std::span<math::transform<float>> output) noexcept
+{
+	const std::size_t count = std::min({a.size(), b.size(), output.size()});
+
+	if (mask.empty())
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			output[i] = blend(a[i], b[i], t);
+		}
+	}
+	else
+	{
+		const std::size_t masked_count = std::min(count, mask.size());
+		for (std::size_t i = 0; i < masked_count; ++i)
+		{
+			output[i] = blend(a[i], b[i], t * mask[i]);
+		}
+	}
+}
+
+void add_transforms(std::span<const math::transform<float>> base, std::span<const math::transform<float>> additive, std::span<const math::transform<float>> reference, float t, std::span<const float> mask, std::span<math::transform<float>> output) noexcept
+{
+	const std::size_t count = std::min({base.size(), additive.size(), reference.size(), output.size()});
+
+	if (mask.empty())
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			output[i] = add(base[i], additive[i], reference[i], t);
+		}
+	}
+	else
+	{
+		const std::size_t masked_count = std::min(count, mask.size());
+		for (std::size_t i = 0; i < masked_count; ++i)
+		{
+			output[i] = add(base[i], additive[i], reference[i], t * mask[i]);
+		}
+	}
+}
+
+void blend_transforms(std::span<const math::transform<float>> a, std::span<const math::transform<float>> b, float t, std::span<const float> mask, std::span<const std::uint32_t> bones, std::span<math::transform<float>> output) noexcept
+{
+	if (mask.empty())
+	{
+		for (const auto i: bones)
+		{
+			output[i] = blend(a[i], b[i], t);
+		}
+	}
+	else
+	{
+		for (const auto i: bones)
+		{
+			output[i] = blend(a[i], b[i], t * mask[i]);
+		}
+	}
+}
+
+void add_transforms(std::span<const math::transform<float>> base, std::span<const math::transform<float>> additive, std::span<const math::transform<float>> reference, float t, std::span<const float> mask, std::span<const std::uint32_t> bones, std::span<math::transform<float>> output) noexcept
+{
+	if (mask.empty())
+	{
+		for (const auto i: bones)
+		{
+			output[i] = add(base[i], additive[i], reference[i], t);
+		}
+	}
+	else
+	{
+		for (const auto i: bones)
+		{
+			output[i] = add(base[i], additive[i], reference[i], t * mask[i]);
+		}
+	}
+}
+
+void accumulate_transforms(std::span<const math::transform<float>> transforms, float weight, std::span<math::transform<float>> accumulator) noexcept
+{
+	const std::size_t count = std::min(transforms.size(), accumulator.size());
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		accumulate(transforms[i], weight, accumulator[i]);
+	}
+}
+
+void accumulate_transforms(std::span<const math::transform<float>> transforms, float weight, std::span<const std::uint32_t> bones, std::span<math::transform<float>> accumulator) noexcept
+{
+	for (const auto i: bones)
+	{
+		accumulate(transforms[i], weight, accumulator[i]);
+	}
+}
+
+void normalize_transforms(std::span<math::transform<float>> accumulator, float total_weight) noexcept
+{
+	const float inverse_total_weight = 1.0f / total_weight;
+
+	for (auto& sum: accumulator)
+	{
+		normalize(sum, inverse_total_weight);
+	}
+}
+
+void normalize_transforms(std::span<math::transform<float>> accumulator, float total_weight, std::span<const std::uint32_t> bones) noexcept
+{
+	const float inverse_total_weight = 1.0f / total_weight;
+
+	for (const auto i: bones)
+	{
+		normalize(accumulator[i], inverse_total_weight);
+	}
+}
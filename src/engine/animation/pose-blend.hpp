@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_POSE_BLEND_HPP
+#define ANTKEEPER_ANIMATION_POSE_BLEND_HPP
+
+#include <engine/math/transform.hpp>
+#include <cstdint>
+#include <span>
+
+/**
+ * @name Pose blending
+ *
+ * Kernels which blend arrays of relative bone transforms, indexed by bone index.
+ *
+ * Each kernel is a single loop over bones, written in terms of scalar transform components, such that it can be vectorized across bones. Rotations are blended along the shortest arc and renormalized.
+ *
+ * Each kernel has an overload which only processes the bones in a list of bone indices, such as the bones of a bone mask, and leaves the remaining output transforms untouched.
+ */
+/// @{
+
+/**
+ * Blends between two sets of bone transforms.
+ *
+ * @param[in] a Transforms to blend from.
+ * @param[in] b Transforms to blend to.
+ * @param[in] t Blend factor, on `[0, 1]`.
+ * @param[in] mask Per-bone weights by which @p t is multiplied. If empty, all bones are weighted `1`.
+ * @param[out] output Blended transforms. May alias @p a or @p b.
+ */
+void blend_transforms(std::span<const math::transform<float>> a, std::span<const math::transform<float>> b, float t, std::span<const float> mask, std::span<math::transform<float>> output) noexcept;
+
+/**
+ * Blends between two sets of bone transforms, for a subset of bones.
+ *
+ * @param[in] a Transforms to blend from.
+ * @param[in] b Transforms to blend to.
+ * @param[in] t Blend factor, on `[0, 1]`.
+ * @param[in] mask Per-bone weights by which @p t is multiplied. If empty, all bones are weighted `1`.
+ * @param[in] bones Indices of the bones to blend. Must be less than the sizes of @p a, @p b, @p output, and @p mask if it's not empty.
+ * @param[out] output Blended transforms. May alias @p a or @p b.
+ */
+void blend_transforms(std::span<const math::transform<float>> a, std::span<const math::transform<float>> b, float t, std::span<const float> mask, std::span<const std::uint32_t> bones, std::span<math::transform<float>> output) noexcept;
+
+/**
+ * Adds the difference between two sets of bone transforms to a base set of bone transforms.
+ *
+ * @param[in] base Transforms to which the difference is added.
+ * @param[in] additive Transforms from which @p reference is subtracted.
+ * @param[in] reference Transforms which are subtracted from @p additive, typically the rest pose.
+ * @param[in] t Blend factor, on `[0, 1]`.
+ * @param[in] mask Per-bone weights by which @p t is multiplied. If empty, all bones are weighted `1`.
+ * @param[out] output Resulting transforms. May alias @p base.
+ */
+void add_transforms(std::span<const math::transform<float>> base, std::span<const math::transform<float>> additive, std::span<const math::transform<float>> reference, float t, std::span<const float> mask, std::span<math::transform<float>> output) noexcept;
+
+/**
+ * Adds the difference between two sets of bone transforms to a base set of bone transforms, for a subset of bones.
+ *
+ * @param[in] base Transforms to which the difference is added.
+ * @param[in] additive Transforms from which @p reference is subtracted.
+ * @param[in] reference Transforms which are subtracted from @p additive, typically the rest pose.
+ * @param[in] t Blend factor, on `[0, 1]`.
+ * @param[in] mask Per-bone weights by which @p t is multiplied. If empty, all bones are weighted `1`.
+ * @param[in] bones Indices of the bones to add. Must be less than the sizes of @p base, @p additive, @p reference, @p output, and @p mask if it's not empty.
+ * @param[out] output Resulting transforms. May alias @p base.
+ */
+void add_transforms(std::span<const math::transform<float>> base, std::span<const math::transform<float>> additive, std::span<const math::transform<float>> reference, float t, std::span<const float> mask, std::span<const std::uint32_t> bones, std::span<math::transform<float>> output) noexcept;
+
+/**
+ * Adds a weighted set of bone transforms to an accumulator.
+ *
+ * @param[in] transforms Transforms to accumulate.
+ * @param[in] weight Weight of @p transforms.
+ * @param[in,out] accumulator Sum of weighted transform components. Should be zero-initialized before the first accumulation.
+ *
+ * @see normalize_transforms()
+ */
+void accumulate_transforms(std::span<const math::transform<float>> transforms, float weight, std::span<math::transform<float>> accumulator) noexcept;
+
+/**
+ * Adds a weighted set of bone transforms to an accumulator, for a subset of bones.
+ *
+ * @param[in] transforms Transforms to accumulate.
+ * @param[in] weight Weight of @p transforms.
+ * @param[in] bones Indices of the bones to accumulate. Must be less than the sizes of @p transforms and @p accumulator.
+ * @param[in,out] accumulator Sum of weighted transform components. The transforms of @p bones should be zero-initialized before the first accumulation.
+ */
+void accumulate_transforms(std::span<const math::transform<float>> transforms, float weight, std::span<const std::uint32_t> bones, std::span<math::transform<float>> accumulator) noexcept;
+
+/**
+ * Converts sums of weighted transform components into weighted averages.
+ *
+ * @param[in,out] accumulator Sum of weighted transform components.
+ * @param[in] total_weight Sum of the weights of all accumulated transforms. Must be greater than zero.
+ *
+ * @see accumulate_transforms()
+ */
+void normalize_transforms(std::span<math::transform<float>> accumulator, float total_weight) noexcept;
+
+/**
+ * Converts sums of weighted transform components into weighted averages, for a subset of bones.
+ *
+ * @param[in,out] accumulator Sum of weighted transform components.
+ * @param[in] total_weight Sum of the weights of all accumulated transforms. Must be greater than zero.
+ * @param[in] bones Indices of the bones to normalize. Must be less than the size of @p accumulator.
+ */
+void normalize_transforms(std::span<math::transform<float>> accumulator, float total_weight, std::span<const std::uint32_t> bones) noexcept;
+
+/// @}
+
+#endif // ANTKEEPER_ANIMATION_POSE_BLEND_HPP
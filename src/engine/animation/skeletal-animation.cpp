@@ -4,10 +4,6 @@
 #include <engine/animation/skeletal-animation.hpp>
 #include <engine/animation/animation-sequence.hpp>
 #include <engine/animation/skeleton.hpp>
-#include <engine/math/euler-angles.hpp>
-#include <engine/debug/log.hpp>
-#include <engine/scene/skeletal-mesh.hpp>
-#include "game/components/scene-component.hpp"
 #include <filesystem>
 #include <format>
 #include <stdexcept>
@@ -43,59 +39,35 @@ void bind_skeletal_animation([[maybe_unused]] animation_sequence& sequence, [[ma
 			throw std::runtime_error("Failed to bind animation track to bone: invalid data path.");
 		}
 
-		// Set track output function according to bone and property
+		// Set track binding according to bone and property
+		track.binding() = {};
+		track.binding().index = static_cast<std::uint32_t>(bone_index);
 		if (property_name == "translation")
 		{
-			track.output() = [bone_index](auto samples, auto& context)
-			{
-				auto& scene_object = *(context.handle.get<scene_component>().object);
-				auto& skeletal_mesh = static_cast<scene::skeletal_mesh&>(scene_object);
-
-				const auto translation = math::fvec3{samples[0], samples[1], samples[2]};
-
-				skeletal_mesh.get_pose().set_relative_translation(bone_index, translation);
-			};
+			track.binding().type = animation_binding_type::bone_translation;
 		}
 		else if (property_name == "rotation_quaternion")
 		{
-			track.output() = [bone_index](auto samples, auto& context)
-			{
-				auto& scene_object = *(context.handle.get<scene_component>().object);
-				auto& skeletal_mesh = static_cast<scene::skeletal_mesh&>(scene_object);
-
-				const auto rotation = math::normalize(math::fquat{samples[0], samples[1], samples[2], samples[3]});
-
-				skeletal_mesh.get_pose().set_relative_rotation(bone_index, rotation);
-			};
+			track.binding().type = animation_binding_type::bone_rotation_quaternion;
 		}
 		else if (property_name == "rotation_euler")
 		{
-			track.output() = [bone_index](auto samples, auto& context)
-			{
-				auto& scene_object = *(context.handle.get<scene_component>().object);
-				auto& skeletal_mesh = static_cast<scene::skeletal_mesh&>(scene_object);
-
-				const auto rotation = math::euler_xyz_to_quat(math::fvec3{samples[0], samples[1], samples[2]});
-
-				skeletal_mesh.get_pose().set_relative_rotation(bone_index, rotation);
-			};
+			track.binding().type = animation_binding_type::bone_rotation_euler;
 		}
 		else if (property_name == "scale")
 		{
-			track.output() = [bone_index](auto samples, auto& context)
-			{
-				auto& scene_object = *(context.handle.get<scene_component>().object);
-				auto& skeletal_mesh = static_cast<scene::skeletal_mesh&>(scene_object);
-
-				const auto scale = math::fvec3{samples[0], samples[1], samples[2]};
-
-				skeletal_mesh.get_pose().set_relative_scale(bone_index, scale);
-			};
+			track.binding().type = animation_binding_type::bone_scale;
 		}
 		else
 		{
 			throw std::runtime_error(std::format("Failed to bind animation track to bone: unsupported property \"{}\".", property_name));
 		}
+
+		// Check track has enough channels for the bound property
+		if (track.channels().size() < track.binding().channel_count())
+		{
+			throw std::runtime_error(std::format("Failed to bind animation track to bone: property \"{}\" of bone \"{}\" requires {} channels.", property_name, bone_name, track.binding().channel_count()));
+		}
 	}
 }
 
@@ -10,8 +10,12 @@ class skeleton;
 /**
  * Binds an animation sequence to a skeleton.
  *
+ * Each track path is resolved once into a bone binding, which writes samples directly to the pose of the animation context.
+ *
  * @param sequence Animation sequence to bind.
  * @param skeleton Skeleton to which the sequence should be bound.
+ *
+ * @exception std::runtime_error Failed to bind animation track to bone.
  */
 void bind_skeletal_animation(animation_sequence& sequence, const ::skeleton& skeleton);
 
@@ -0,0 +1,327 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/animation/skeleton-pose-evaluator.hpp>
+#include <engine/animation/skeleton-pose.hpp>
+#include <engine/animation/skeleton.hpp>
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <unordered_map>
+
+namespace {
+
+/// Sentinel parent slot of root bones.
+inline constexpr std::uint32_t root_slot = ~std::uint32_t{0};
+
+/**
+ * Composes two SRT transforms, component-wise.
+ *
+ * Equivalent to `math::mul(x, y)`, but written in terms of scalar components only so that loops calling it can be vectorized.
+ */
+[[nodiscard]] inline math::transform<float> compose(const math::transform<float>& x, const math::transform<float>& y) noexcept
+{
+	math::transform<float> z;
+
+	// Scale child translation by parent scale
+	const float vx = x.scale[0] * y.translation[0];
+	const float vy = x.scale[1] * y.translation[1];
+	const float vz = x.scale[2] * y.translation[2];
+
+	// Rotate scaled child translation by parent rotation
+	const float qw = x.rotation.r;
+	const float qx = x.rotation.i[0];
+	const float qy = x.rotation.i[1];
+	const float qz = x.rotation.i[2];
+	const float tx = (qy * vz - qz * vy) * 2.0f;
+	const float ty = (qz * vx - qx * vz) * 2.0f;
+	const float tz = (qx * vy - qy * vx) * 2.0f;
+	z.translation[0] = x.translation[0] + vx + qw * tx + (qy * tz - qz * ty);
+	z.translation[1] = x.translation[1] + vy + qw * ty + (qz * tx - qx * tz);
+	z.translation[2] = x.translation[2] + vz + qw * tz + (qx * ty - qy * tx);
+
+	// Multiply rotations
+	const float rw = qw * y.rotation.r - qx * y.rotation.i[0] - qy * y.rotation.i[1] - qz * y.rotation.i[2];
+	const float rx = qw * y.rotation.i[0] + qx * y.rotation.r + qy * y.rotation.i[2] - qz * y.rotation.i[1];
+	const float ry = qw * y.rotation.i[1] - qx * y.rotation.i[2] + qy * y.rotation.r + qz * y.rotation.i[0];
+	const float rz = qw * y.rotation.i[2] + qx * y.rotation.i[1] - qy * y.rotation.i[0] + qz * y.rotation.r;
+
+	// Normalize rotation
+	const float inverse_length = 1.0f / std::sqrt(rw * rw + rx * rx + ry * ry + rz * rz);
+	z.rotation.r = rw * inverse_length;
+	z.rotation.i[0] = rx * inverse_length;
+	z.rotation.i[1] = ry * inverse_length;
+	z.rotation.i[2] = rz * inverse_length;
+
+	// Multiply scales
+	z.scale[0] = x.scale[0] * y.scale[0];
+	z.scale[1] = x.scale[1] * y.scale[1];
+	z.scale[2] = x.scale[2] * y.scale[2];
+
+	return z;
+}
+
+/**
+ * Converts an SRT transform to a matrix, component-wise.
+ *
+ * Equivalent to `math::transform<float>::matrix()`.
+ */
+inline void to_matrix(const math::transform<float>& t, math::fmat4& m) noexcept
+{
+	const float x = t.rotation.i[0];
+	const float y = t.rotation.i[1];
+	const float z = t.rotation.i[2];
+	const float w = t.rotation.r;
+
+	const float xx = x * x;
+	const float xy = x * y;
+	const float xz = x * z;
+	const float xw = x * w;
+	const float yy = y * y;
+	const float yz = y * z;
+	const float yw = y * w;
+	const float zz = z * z;
+	const float zw = z * w;
+
+	m[0][0] = (1.0f - (yy + zz) * 2.0f) * t.scale[0];
+	m[0][1] = ((xy + zw) * 2.0f) * t.scale[0];
+	m[0][2] = ((xz - yw) * 2.0f) * t.scale[0];
+	m[0][3] = 0.0f;
+
+	m[1][0] = ((xy - zw) * 2.0f) * t.scale[1];
+	m[1][1] = (1.0f - (xx + zz) * 2.0f) * t.scale[1];
+	m[1][2] = ((yz + xw) * 2.0f) * t.scale[1];
+	m[1][3] = 0.0f;
+
+	m[2][0] = ((xz + yw) * 2.0f) * t.scale[2];
+	m[2][1] = ((yz - xw) * 2.0f) * t.scale[2];
+	m[2][2] = (1.0f - (xx + yy) * 2.0f) * t.scale[2];
+	m[2][3] = 0.0f;
+
+	m[3][0] = t.translation[0];
+	m[3][1] = t.translation[1];
+	m[3][2] = t.translation[2];
+	m[3][3] = 1.0f;
+}
+
+} // namespace
+
+void skeleton_pose_evaluator::transform_array::resize(std::size_t size)
+{
+	for (auto* array: {&tx, &ty, &tz, &qw, &qx, &qy, &qz, &sx, &sy, &sz})
+	{
+		array->resize(size);
+	}
+}
+
+void skeleton_pose_evaluator::transform_array::store(std::size_t index, const math::transform<float>& transform) noexcept
+{
+	tx[index] = transform.translation[0];
+	ty[index] = transform.translation[1];
+	tz[index] = transform.translation[2];
+	qw[index] = transform.rotation.r;
+	qx[index] = transform.rotation.i[0];
+	qy[index] = transform.rotation.i[1];
+	qz[index] = transform.rotation.i[2];
+	sx[index] = transform.scale[0];
+	sy[index] = transform.scale[1];
+	sz[index] = transform.scale[2];
+}
+
+math::transform<float> skeleton_pose_evaluator::transform_array::load(std::size_t index) const noexcept
+{
+	return
+	{
+		{tx[index], ty[index], tz[index]},
+		{qw[index], {qx[index], qy[index], qz[index]}},
+		{sx[index], sy[index], sz[index]}
+	};
+}
+
+void skeleton_pose_evaluator::evaluate(std::span<const skeleton_pose* const> poses)
+{
+	// Map of skeletons to the index of their most recent batch
+	std::unordered_map<const ::skeleton*, std::size_t> open_batches;
+
+	// Sort outdated poses into batches
+	m_batch_count = 0;
+	for (const skeleton_pose* pose: poses)
+	{
+		if (!pose || !pose->m_skeleton)
+		{
+			continue;
+		}
+
+		// Skip rest poses, their skinning matrices are always identity
+		const ::skeleton* skeleton = pose->m_skeleton;
+		if (pose == &skeleton->rest_pose())
+		{
+			continue;
+		}
+
+		// Skip poses with up-to-date skinning matrices
+		if (std::none_of(pose->m_bone_flags.begin(), pose->m_bone_flags.end(), [](auto flags){return flags & skeleton_pose::skinning_matrix_outdated_flag;}))
+		{
+			continue;
+		}
+
+		// Open a new batch if the skeleton has no batch or its batch is full
+		auto [it, inserted] = open_batches.try_emplace(skeleton, m_batch_count);
+		if (inserted || m_batches[it->second].poses.size() >= m_max_batch_size)
+		{
+			if (m_batch_count == m_batches.size())
+			{
+				m_batches.emplace_back();
+			}
+
+			auto& batch = m_batches[m_batch_count];
+			batch.skeleton = skeleton;
+			batch.poses.clear();
+
+			it->second = m_batch_count;
+			++m_batch_count;
+		}
+
+		m_batches[it->second].poses.emplace_back(pose);
+	}
+
+	// Build bone orders. Rest pose inverse transforms are lazily updated, so this is done serially.
+	std::for_each
+	(
+		std::execution::seq,
+		m_batches.begin(),
+		m_batches.begin() + m_batch_count,
+		[&](auto& batch)
+		{
+			build_batch(batch);
+		}
+	);
+
+	// Evaluate batches
+	std::for_each
+	(
+		std::execution::par,
+		m_batches.begin(),
+		m_batches.begin() + m_batch_count,
+		[](auto& batch)
+		{
+			evaluate_batch(batch);
+		}
+	);
+}
+
+void skeleton_pose_evaluator::build_batch(batch& batch) const
+{
+	const auto& bones = batch.skeleton->bones();
+	const auto& inverse_rest_transforms = batch.skeleton->rest_pose().get_inverse_absolute_transforms();
+	const std::size_t bone_count = bones.size();
+
+	// Breadth-first traversal of the bone hierarchy, starting at the root bones
+	batch.bone_order.clear();
+	for (const auto& bone: bones)
+	{
+		if (!bone.parent())
+		{
+			batch.bone_order.emplace_back(static_cast<std::uint32_t>(bone.index()));
+		}
+	}
+	for (std::size_t i = 0; i < batch.bone_order.size(); ++i)
+	{
+		for (const auto& child: bones[batch.bone_order[i]].children())
+		{
+			batch.bone_order.emplace_back(static_cast<std::uint32_t>(child->index()));
+		}
+	}
+
+	// Map bone indices to batch slots
+	std::vector<std::uint32_t> bone_slots(bone_count);
+	for (std::size_t i = 0; i < bone_count; ++i)
+	{
+		bone_slots[batch.bone_order[i]] = static_cast<std::uint32_t>(i);
+	}
+
+	// Find parent slots and inverse rest transforms of each slot
+	batch.parent_slots.resize(bone_count);
+	batch.inverse_rest_transforms.resize(bone_count);
+	for (std::size_t i = 0; i < bone_count; ++i)
+	{
+		const auto& bone = bones[batch.bone_order[i]];
+		batch.parent_slots[i] = bone.parent() ? bone_slots[bone.parent()->index()] : root_slot;
+		batch.inverse_rest_transforms[i] = inverse_rest_transforms[bone.index()];
+	}
+
+	// Allocate transform arrays
+	const std::size_t pose_count = batch.poses.size();
+	batch.relative_transforms.resize(bone_count * pose_count);
+	batch.absolute_transforms.resize(bone_count * pose_count);
+	batch.skinning_transforms.resize(pose_count);
+}
+
+void skeleton_pose_evaluator::evaluate_batch(batch& batch)
+{
+	const std::size_t bone_count = batch.bone_order.size();
+	const std::size_t pose_count = batch.poses.size();
+	auto& relative = batch.relative_transforms;
+	auto& absolute = batch.absolute_transforms;
+	auto& skinning = batch.skinning_transforms;
+
+	// Gather relative transforms
+	for (std::size_t i = 0; i < bone_count; ++i)
+	{
+		const std::size_t bone_index = batch.bone_order[i];
+		const std::size_t offset = i * pose_count;
+
+		for (std::size_t j = 0; j < pose_count; ++j)
+		{
+			relative.store(offset + j, batch.poses[j]->m_relative_transforms[bone_index]);
+		}
+	}
+
+	// Parents precede children, so each bone's parent transforms are final by the time it is reached
+	for (std::size_t i = 0; i < bone_count; ++i)
+	{
+		const std::size_t bone_index = batch.bone_order[i];
+		const std::size_t offset = i * pose_count;
+
+		// Compose absolute transforms
+		if (const auto parent_slot = batch.parent_slots[i]; parent_slot != root_slot)
+		{
+			const std::size_t parent_offset = parent_slot * pose_count;
+			for (std::size_t j = 0; j < pose_count; ++j)
+			{
+				absolute.store(offset + j, compose(absolute.load(parent_offset + j), relative.load(offset + j)));
+			}
+		}
+		else
+		{
+			for (std::size_t j = 0; j < pose_count; ++j)
+			{
+				absolute.store(offset + j, relative.load(offset + j));
+			}
+		}
+
+		// Compose skinning transforms
+		const auto& inverse_rest_transform = batch.inverse_rest_transforms[i];
+		for (std::size_t j = 0; j < pose_count; ++j)
+		{
+			skinning.store(j, compose(absolute.load(offset + j), inverse_rest_transform));
+		}
+
+		// Scatter absolute transforms and skinning matrices
+		for (std::size_t j = 0; j < pose_count; ++j)
+		{
+			const skeleton_pose& pose = *batch.poses[j];
+			pose.m_absolute_transforms[bone_index] = absolute.load(offset + j);
+			to_matrix(skinning.load(j), pose.m_skinning_matrices[bone_index]);
+		}
+	}
+
+	// Clear absolute transform and skinning matrix outdated flags
+	for (const skeleton_pose* pose: batch.poses)
+	{
+		for (auto& flags: pose->m_bone_flags)
+		{
+			flags &= ~(skeleton_pose::absolute_transform_outdated_flag | skeleton_pose::skinning_matrix_outdated_flag);
+		}
+	}
+}
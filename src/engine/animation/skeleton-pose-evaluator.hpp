@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_ANIMATION_SKELETON_POSE_EVALUATOR_HPP
+#define ANTKEEPER_ANIMATION_SKELETON_POSE_EVALUATOR_HPP
+
+#include <engine/math/transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class skeleton;
+class skeleton_pose;
+
+/**
+ * Evaluates the absolute transforms and skinning matrices of many skeleton poses at once.
+ *
+ * Poses are grouped into batches by skeleton. Within a batch, transforms are stored in structure-of-arrays form, with bones sorted in parent-before-child order and the poses of each bone stored contiguously, such that transform composition and matrix conversion can be vectorized across poses. Batches are evaluated in parallel.
+ */
+class skeleton_pose_evaluator
+{
+public:
+	/**
+	 * Updates all outdated absolute transforms and skinning matrices of a set of skeleton poses.
+	 *
+	 * @param poses Skeleton poses to evaluate. Poses with no outdated skinning matrices, skeleton rest poses, and null pointers are ignored.
+	 *
+	 * @warning Each pose should appear at most once in @p poses.
+	 */
+	void evaluate(std::span<const skeleton_pose* const> poses);
+
+	/**
+	 * Sets the maximum number of poses evaluated per batch.
+	 *
+	 * @param size Maximum batch size.
+	 */
+	inline void set_max_batch_size(std::size_t size) noexcept
+	{
+		m_max_batch_size = size ? size : 1;
+	}
+
+	/// Returns the maximum number of poses evaluated per batch.
+	[[nodiscard]] inline std::size_t get_max_batch_size() const noexcept
+	{
+		return m_max_batch_size;
+	}
+
+private:
+	/// Structure-of-arrays storage of SRT transforms.
+	struct transform_array
+	{
+		std::vector<float> tx, ty, tz;
+		std::vector<float> qw, qx, qy, qz;
+		std::vector<float> sx, sy, sz;
+
+		void resize(std::size_t size);
+		void store(std::size_t index, const math::transform<float>& transform) noexcept;
+		[[nodiscard]] math::transform<float> load(std::size_t index) const noexcept;
+	};
+
+	/// Poses of a single skeleton which are evaluated together.
+	struct batch
+	{
+		const ::skeleton* skeleton{};
+		std::vector<const skeleton_pose*> poses;
+
+		/// Bone indices, in parent-before-child order.
+		std::vector<std::uint32_t> bone_order;
+
+		/// Batch slot of the parent of each bone in `bone_order`, or `~0` for root bones.
+		std::vector<std::uint32_t> parent_slots;
+
+		/// Inverse absolute rest transforms of the bones, in `bone_order`.
+		std::vector<math::transform<float>> inverse_rest_transforms;
+
+		/// Relative and absolute transforms of each bone of each pose, indexed by `slot * poses.size() + pose`.
+		transform_array relative_transforms;
+		transform_array absolute_transforms;
+
+		/// Skinning transforms for a single bone of each pose.
+		transform_array skinning_transforms;
+	};
+
+	void build_batch(batch& batch) const;
+	static void evaluate_batch(batch& batch);
+
+	std::vector<batch> m_batches;
+	std::size_t m_batch_count{0};
+	std::size_t m_max_batch_size{64};
+};
+
+#endif // ANTKEEPER_ANIMATION_SKELETON_POSE_EVALUATOR_HPP
@@ -3,7 +3,9 @@
 
 #include <engine/animation/skeleton-pose.hpp>
 #include <engine/animation/skeleton.hpp>
+#include <engine/animation/pose-blend.hpp>
 #include <algorithm>
+#include <atomic>
 
 skeleton_pose::skeleton_pose(::skeleton& skeleton):
 	m_skeleton{&skeleton},
@@ -21,6 +23,12 @@ skeleton_pose::skeleton_pose(::skeleton& skeleton, bool /* is_rest_pose */):
 	m_bone_flags(skeleton.bones().size(), 0)
 {}
 
+std::uint64_t skeleton_pose::next_generation() noexcept
+{
+	static std::atomic<std::uint64_t> generation{0};
+	return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 void skeleton_pose::update_absolute_transforms() const
 {
 	for (std::size_t i = 0; i < m_absolute_transforms.size(); ++i)
@@ -51,6 +59,8 @@ void skeleton_pose::update() const
 
 void skeleton_pose::reset()
 {
+	m_generation = next_generation();
+
 	// Get relative and absolute transforms of rest pose (automatically updating where outdated)
 	const auto& rest_relative_transforms = m_skeleton->rest_pose().get_relative_transforms();
 	const auto& rest_absolute_transforms = m_skeleton->rest_pose().get_absolute_transforms();
@@ -68,6 +78,8 @@ void skeleton_pose::reset()
 
 void skeleton_pose::set_relative_transform(std::size_t index, const math::transform<float>& transform)
 {
+	m_generation = next_generation();
+
 	m_relative_transforms[index] = transform;
 
 	if (!is_absolute_transform_outdated(index))
@@ -76,8 +88,37 @@ void skeleton_pose::set_relative_transform(std::size_t index, const math::transf
 	}
 }
 
+void skeleton_pose::set_relative_transforms(std::span<const math::transform<float>> transforms)
+{
+	m_generation = next_generation();
+
+	if (transforms.data() != m_relative_transforms.data())
+	{
+		std::copy_n(transforms.begin(), std::min(transforms.size(), m_relative_transforms.size()), m_relative_transforms.begin());
+	}
+
+	for (auto& flags: m_bone_flags)
+	{
+		flags |= absolute_transform_outdated_flag | inverse_absolute_transform_outdated_flag | skinning_matrix_outdated_flag;
+	}
+}
+
+void skeleton_pose::blend(const skeleton_pose& a, const skeleton_pose& b, float t)
+{
+	m_generation = next_generation();
+
+	blend_transforms(a.m_relative_transforms, b.m_relative_transforms, t, {}, m_relative_transforms);
+
+	for (auto& flags: m_bone_flags)
+	{
+		flags |= absolute_transform_outdated_flag | inverse_absolute_transform_outdated_flag | skinning_matrix_outdated_flag;
+	}
+}
+
 void skeleton_pose::set_relative_translation(std::size_t index, const math::fvec3& translation)
 {
+	m_generation = next_generation();
+
 	m_relative_transforms[index].translation = translation;
 
 	if (!is_absolute_transform_outdated(index))
@@ -88,6 +129,8 @@ void skeleton_pose::set_relative_translation(std::size_t index, const math::fvec
 
 void skeleton_pose::set_relative_rotation(std::size_t index, const math::fquat& rotation)
 {
+	m_generation = next_generation();
+
 	m_relative_transforms[index].rotation = rotation;
 
 	if (!is_absolute_transform_outdated(index))
@@ -98,6 +141,8 @@ void skeleton_pose::set_relative_rotation(std::size_t index, const math::fquat&
 
 void skeleton_pose::set_relative_scale(std::size_t index, const math::fvec3& scale)
 {
+	m_generation = next_generation();
+
 	m_relative_transforms[index].scale = scale;
 
 	if (!is_absolute_transform_outdated(index))
@@ -108,6 +153,8 @@ void skeleton_pose::set_relative_scale(std::size_t index, const math::fvec3& sca
 
 void skeleton_pose::set_absolute_transform(std::size_t index, const math::transform<float>& transform)
 {
+	m_generation = next_generation();
+
 	// Set absolute transform
 	m_absolute_transforms[index] = transform;
 
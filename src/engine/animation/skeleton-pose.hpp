@@ -8,6 +8,7 @@
 #include <engine/math/transform.hpp>
 #include <engine/math/matrix.hpp>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 class skeleton;
@@ -75,6 +76,24 @@ public:
 	 * @param transform Relative transform describing the bone pose.
 	 */
 	void set_relative_transform(std::size_t index, const math::transform<float>& transform);
+
+	/**
+	 * Sets the relative transforms describing all bone poses.
+	 *
+	 * @param transforms Relative transforms describing the bone poses, indexed by bone index.
+	 */
+	void set_relative_transforms(std::span<const math::transform<float>> transforms);
+
+	/**
+	 * Sets the relative transforms of all bone poses to a blend between two poses.
+	 *
+	 * @param a Pose to blend from.
+	 * @param b Pose to blend to.
+	 * @param t Blend factor, on `[0, 1]`.
+	 *
+	 * @note @p a or @p b may be this pose.
+	 */
+	void blend(const skeleton_pose& a, const skeleton_pose& b, float t);
 	
 	/**
 	 * Sets the relative translation of a bone pose.
@@ -164,6 +183,16 @@ public:
 	 */
 	[[nodiscard]] const std::vector<math::fmat4>& get_skinning_matrices() const;
 
+	/**
+	 * Returns the generation of the pose.
+	 *
+	 * The generation changes each time the pose is modified, and is unique across all poses, such that data derived from a pose can be cached by generation.
+	 */
+	[[nodiscard]] inline std::uint64_t get_generation() const noexcept
+	{
+		return m_generation;
+	}
+
 	/** Returns the skeleton with which the pose is associated. */
 	[[nodiscard]] inline skeleton* get_skeleton() noexcept
 	{
@@ -178,6 +207,7 @@ public:
 	
 protected:
 	friend class skeleton;
+	friend class skeleton_pose_evaluator;
 
 	/** @private */
 	enum bone_flags: std::uint8_t
@@ -253,12 +283,16 @@ protected:
 	 */
 	virtual void update_skinning_matrix(std::size_t index) const;
 
+	/// Returns a new, globally unique pose generation.
+	[[nodiscard]] static std::uint64_t next_generation() noexcept;
+
 	skeleton* m_skeleton{nullptr};
 	std::vector<math::transform<float>> m_relative_transforms;
 	mutable std::vector<math::transform<float>> m_absolute_transforms;
 	mutable std::vector<math::fmat4> m_skinning_matrices;
 	mutable std::vector<std::uint8_t> m_bone_flags;
 	mutable std::vector<const bone*> m_bone_traversal;
+	std::uint64_t m_generation{next_generation()};
 };
 
 #endif // ANTKEEPER_ANIMATION_SKELETON_POSE_HPP
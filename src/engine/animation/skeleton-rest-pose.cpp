@@ -19,6 +19,8 @@ void skeleton_rest_pose::update() const
 
 void skeleton_rest_pose::reset()
 {
+	m_generation = next_generation();
+
 	std::fill(m_relative_transforms.begin(), m_relative_transforms.end(), math::identity<math::transform<float>>);
 	std::fill(m_absolute_transforms.begin(), m_absolute_transforms.end(), math::identity<math::transform<float>>);
 	std::fill(m_inverse_absolute_transforms.begin(), m_inverse_absolute_transforms.end(), math::identity<math::transform<float>>);
@@ -150,16 +150,16 @@ public:
 	static constexpr node_type divider_bits = node_bits - (depth_bits + location_bits);
 	
 	/// Number of children per node.
-	static constexpr node_type children_per_node = math::compile::exp2<node_type>(N);
+	static constexpr node_type children_per_node = math::exp2<node_type>(N);
 	
 	/// Number of siblings per node.
 	static constexpr node_type siblings_per_node = children_per_node - 1;
 	
 	/// Resolution in each dimension.
-	static constexpr node_type resolution = math::compile::exp2<node_type>(max_depth);
+	static constexpr node_type resolution = math::exp2<node_type>(max_depth);
 	
 	/// Number of nodes in a full hyperoctree.
-	static constexpr std::size_t max_node_count = (math::compile::pow<std::size_t>(resolution * 2, N) - 1) / siblings_per_node;
+	static constexpr std::size_t max_node_count = (math::pow<std::size_t>(resolution * 2, N) - 1) / siblings_per_node;
 	
 	/// Node identifier of the persistent root node.
 	static constexpr node_type root = 0;
@@ -190,7 +190,7 @@ public:
 	 */
 	static inline constexpr node_type depth(node_type node) noexcept
 	{
-		constexpr node_type mask = math::compile::exp2<node_type>(depth_bits) - 1;
+		constexpr node_type mask = math::exp2<node_type>(depth_bits) - 1;
 		return node & mask;
 	}
 	
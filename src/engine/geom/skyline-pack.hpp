@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GEOM_SKYLINE_PACK_HPP
+#define ANTKEEPER_GEOM_SKYLINE_PACK_HPP
+
+#include <engine/math/vector.hpp>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace geom {
+
+/**
+ * Packs 2D rectangles incrementally, using the bottom-left skyline heuristic.
+ *
+ * Unlike rect_pack, the pack can be enlarged without moving previously-packed rectangles.
+ *
+ * @tparam T Scalar type.
+ *
+ * @see rect_pack
+ */
+template <class T>
+class skyline_pack
+{
+public:
+	/** Scalar type. */
+	using scalar_type = T;
+	
+	/** Vector type. */
+	using vector_type = math::vec2<T>;
+	
+	/**
+	 * Constructs a skyline pack.
+	 *
+	 * @param dimensions Dimensions of the packing area.
+	 */
+	explicit skyline_pack(const vector_type& dimensions = {})
+	{
+		resize(dimensions);
+	}
+	
+	/** Clears the pack, keeping its dimensions. */
+	void clear()
+	{
+		m_skyline.clear();
+		if (m_dimensions.x())
+		{
+			m_skyline.push_back({0, 0, m_dimensions.x()});
+		}
+	}
+	
+	/**
+	 * Resizes the packing area.
+	 *
+	 * If both dimensions are not less than the current dimensions, packed rectangles remain in place and the pack is extended. Otherwise the pack is cleared.
+	 *
+	 * @param dimensions New dimensions of the packing area.
+	 */
+	void resize(const vector_type& dimensions)
+	{
+		const auto old_dimensions = m_dimensions;
+		m_dimensions = dimensions;
+		
+		if (dimensions.x() < old_dimensions.x() || dimensions.y() < old_dimensions.y())
+		{
+			clear();
+		}
+		else if (dimensions.x() > old_dimensions.x())
+		{
+			// Extend the skyline across the new columns, at the bottom of the packing area
+			if (!m_skyline.empty() && m_skyline.back().y == 0)
+			{
+				m_skyline.back().width += dimensions.x() - old_dimensions.x();
+			}
+			else
+			{
+				m_skyline.push_back({old_dimensions.x(), 0, dimensions.x() - old_dimensions.x()});
+			}
+		}
+	}
+	
+	/**
+	 * Packs a rectangle.
+	 *
+	 * @param dimensions Dimensions of the rectangle.
+	 *
+	 * @return Position of the minimum corner of the packed rectangle, or `std::nullopt` if the rectangle could not be packed. Empty rectangles are positioned at the origin and occupy no space.
+	 */
+	[[nodiscard]] std::optional<vector_type> insert(const vector_type& dimensions)
+	{
+		if (!dimensions.x() || !dimensions.y())
+		{
+			return vector_type{0, 0};
+		}
+		
+		// Find the skyline segment at which the top of the rectangle would be lowest, then leftmost
+		std::size_t best_index = m_skyline.size();
+		T best_y = std::numeric_limits<T>::max();
+		for (std::size_t i = 0; i < m_skyline.size(); ++i)
+		{
+			if (const auto y = fit(i, dimensions); y && *y < best_y)
+			{
+				best_index = i;
+				best_y = *y;
+			}
+		}
+		
+		if (best_index == m_skyline.size())
+		{
+			return std::nullopt;
+		}
+		
+		const vector_type position{m_skyline[best_index].x, best_y};
+		
+		// Raise the skyline over the rectangle
+		m_skyline.insert(m_skyline.begin() + best_index, {position.x(), position.y() + dimensions.y(), dimensions.x()});
+		
+		// Shrink or remove the segments beneath the rectangle
+		const T right = position.x() + dimensions.x();
+		for (std::size_t i = best_index + 1; i < m_skyline.size();)
+		{
+			auto& segment = m_skyline[i];
+			if (segment.x >= right)
+			{
+				break;
+			}
+			
+			const T segment_right = segment.x + segment.width;
+			if (segment_right <= right)
+			{
+				m_skyline.erase(m_skyline.begin() + i);
+			}
+			else
+			{
+				segment.width = segment_right - right;
+				segment.x = right;
+				break;
+			}
+		}
+		
+		// Merge neighboring segments of equal height
+		for (std::size_t i = best_index ? best_index - 1 : 0; i + 1 < m_skyline.size() && i <= best_index + 1;)
+		{
+			if (m_skyline[i].y == m_skyline[i + 1].y)
+			{
+				m_skyline[i].width += m_skyline[i + 1].width;
+				m_skyline.erase(m_skyline.begin() + i + 1);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		
+		return position;
+	}
+	
+	/** Returns the dimensions of the packing area. */
+	[[nodiscard]] inline constexpr const vector_type& get_dimensions() const noexcept
+	{
+		return m_dimensions;
+	}
+
+private:
+	/** Horizontal segment of the skyline. */
+	struct segment
+	{
+		/** Position of the left edge of the segment. */
+		T x;
+		
+		/** Height of the skyline along the segment. */
+		T y;
+		
+		/** Width of the segment. */
+		T width;
+	};
+	
+	/**
+	 * Finds the position at which a rectangle would rest if its left edge were aligned with a skyline segment.
+	 *
+	 * @param index Index of the skyline segment.
+	 * @param dimensions Dimensions of the rectangle.
+	 *
+	 * @return Vertical position of the rectangle, or `std::nullopt` if the rectangle would exceed the packing area.
+	 */
+	[[nodiscard]] std::optional<T> fit(std::size_t index, const vector_type& dimensions) const
+	{
+		const T x = m_skyline[index].x;
+		if (dimensions.x() > m_dimensions.x() - x)
+		{
+			return std::nullopt;
+		}
+		
+		// Rest the rectangle on the highest segment beneath it
+		T y = 0;
+		T remaining_width = dimensions.x();
+		for (std::size_t i = index; remaining_width > 0; ++i)
+		{
+			y = std::max(y, m_skyline[i].y);
+			remaining_width -= std::min(remaining_width, m_skyline[i].width);
+		}
+		
+		if (dimensions.y() > m_dimensions.y() - y)
+		{
+			return std::nullopt;
+		}
+		
+		return y;
+	}
+	
+	std::vector<segment> m_skyline;
+	vector_type m_dimensions{};
+};
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_SKYLINE_PACK_HPP
@@ -62,4 +62,52 @@ std::uint32_t infer_cube_map_face_width(std::uint32_t width, std::uint32_t heigh
 	}
 }
 
+std::array<std::uint32_t, 2> get_cube_map_face_position(cube_map_layout layout, std::uint32_t face) noexcept
+{
+	// Vertical cross layout face offsets
+	constexpr std::uint32_t vcross_offsets[6][2] =
+	{
+		{2, 2}, {0, 2}, // -x, +x
+		{1, 3}, {1, 1}, // -y, +y
+		{1, 0}, {1, 2}  // -z, +z
+	};
+
+	// Horizontal cross layout face offsets
+	constexpr std::uint32_t hcross_offsets[6][2] =
+	{
+		{2, 1}, {0, 1}, // -x, +x
+		{1, 2}, {1, 0}, // -y, +y
+		{3, 1}, {1, 1}  // -z, +z
+	};
+
+	if (face >= 6)
+	{
+		return {0, 0};
+	}
+
+	switch (layout)
+	{
+		case cube_map_layout::column:
+			return {0, face};
+
+		case cube_map_layout::row:
+			return {face, 0};
+
+		case cube_map_layout::vertical_cross:
+			return {vcross_offsets[face][0], vcross_offsets[face][1]};
+
+		case cube_map_layout::horizontal_cross:
+			return {hcross_offsets[face][0], hcross_offsets[face][1]};
+
+		case cube_map_layout::equirectangular:
+			[[fallthrough]];
+		case cube_map_layout::spherical:
+			[[fallthrough]];
+		case cube_map_layout::unknown:
+			[[fallthrough]];
+		default:
+			return {0, 0};
+	}
+}
+
 } // namespace gl
@@ -4,6 +4,7 @@
 #ifndef ANTKEEPER_GL_CUBE_MAP_HPP
 #define ANTKEEPER_GL_CUBE_MAP_HPP
 
+#include <array>
 #include <cstdint>
 
 namespace gl {
@@ -54,6 +55,16 @@ enum class cube_map_layout: std::uint8_t
  */
 [[nodiscard]] std::uint32_t infer_cube_map_face_width(std::uint32_t width, std::uint32_t height, cube_map_layout layout) noexcept;
 
+/**
+ * Returns the position of a cube map face within a cube map.
+ *
+ * @param layout Cube map layout. Only column, row, vertical cross, and horizontal cross layouts are supported.
+ * @param face Index of the face, in the order -x, +x, -y, +y, -z, +z.
+ *
+ * @return Texel offset of the face, in units of face width, or `{0, 0}` if the layout is not supported.
+ */
+[[nodiscard]] std::array<std::uint32_t, 2> get_cube_map_face_position(cube_map_layout layout, std::uint32_t face) noexcept;
+
 } // namespace gl
 
 #endif // ANTKEEPER_GL_CUBE_MAP_HPP
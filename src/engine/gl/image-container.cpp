@@ -0,0 +1,736 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/gl/image-container.hpp>
+#include <engine/gl/cube-map.hpp>
+#include <engine/color/srgb.hpp>
+#include <engine/resources/serializer.hpp>
+#include <engine/resources/serialize-error.hpp>
+#include <engine/resources/deserializer.hpp>
+#include <engine/resources/deserialize-error.hpp>
+#include <engine/resources/resource-loader.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+/// Image container file signature, `"AKIM"`.
+constexpr std::uint32_t image_container_magic = 0x4d494b41;
+
+/// Image container file format version.
+constexpr std::uint32_t image_container_version = 1;
+
+/// Number of 32-bit words in an image container file header.
+constexpr std::size_t image_container_header_word_count = 10;
+
+/// Image container header flag indicating a cube image.
+constexpr std::uint32_t image_container_cube_flag = 1;
+
+/// Encodings of the components of image container formats.
+enum class component_type: std::uint8_t
+{
+	unorm8,
+	unorm16,
+	sfloat16,
+	sfloat32
+};
+
+/// Layout of the texels of an image container format.
+struct texel_layout
+{
+	/// Image format.
+	gl::format format;
+	
+	/// Encoding of each component.
+	component_type type;
+	
+	/// Number of components per texel.
+	std::uint8_t component_count;
+	
+	/// `true` if the color components are sRGB-encoded, `false` otherwise.
+	bool srgb;
+};
+
+/// Texel layouts of the formats supported by image containers.
+constexpr texel_layout texel_layouts[] =
+{
+	{gl::format::r8_unorm, component_type::unorm8, 1, false},
+	{gl::format::r8_srgb, component_type::unorm8, 1, true},
+	{gl::format::r8g8_unorm, component_type::unorm8, 2, false},
+	{gl::format::r8g8_srgb, component_type::unorm8, 2, true},
+	{gl::format::r8g8b8_unorm, component_type::unorm8, 3, false},
+	{gl::format::r8g8b8_srgb, component_type::unorm8, 3, true},
+	{gl::format::b8g8r8_unorm, component_type::unorm8, 3, false},
+	{gl::format::b8g8r8_srgb, component_type::unorm8, 3, true},
+	{gl::format::r8g8b8a8_unorm, component_type::unorm8, 4, false},
+	{gl::format::r8g8b8a8_srgb, component_type::unorm8, 4, true},
+	{gl::format::b8g8r8a8_unorm, component_type::unorm8, 4, false},
+	{gl::format::b8g8r8a8_srgb, component_type::unorm8, 4, true},
+	{gl::format::r16_unorm, component_type::unorm16, 1, false},
+	{gl::format::r16g16_unorm, component_type::unorm16, 2, false},
+	{gl::format::r16g16b16_unorm, component_type::unorm16, 3, false},
+	{gl::format::r16g16b16a16_unorm, component_type::unorm16, 4, false},
+	{gl::format::r16_sfloat, component_type::sfloat16, 1, false},
+	{gl::format::r16g16_sfloat, component_type::sfloat16, 2, false},
+	{gl::format::r16g16b16_sfloat, component_type::sfloat16, 3, false},
+	{gl::format::r16g16b16a16_sfloat, component_type::sfloat16, 4, false},
+	{gl::format::r32_sfloat, component_type::sfloat32, 1, false},
+	{gl::format::r32g32_sfloat, component_type::sfloat32, 2, false},
+	{gl::format::r32g32b32_sfloat, component_type::sfloat32, 3, false},
+	{gl::format::r32g32b32a32_sfloat, component_type::sfloat32, 4, false}
+};
+
+/// Returns the texel layout of an image format, or `nullptr` if the format is not supported by image containers.
+[[nodiscard]] const texel_layout* find_texel_layout(gl::format format) noexcept
+{
+	const auto it = std::find_if(std::begin(texel_layouts), std::end(texel_layouts), [format](const auto& layout){return layout.format == format;});
+	return it != std::end(texel_layouts) ? &*it : nullptr;
+}
+
+/// Returns the size of a texel, in bytes.
+[[nodiscard]] constexpr std::size_t get_texel_size(const texel_layout& layout) noexcept
+{
+	switch (layout.type)
+	{
+		case component_type::unorm8:
+			return layout.component_count;
+		
+		case component_type::unorm16:
+			[[fallthrough]];
+		case component_type::sfloat16:
+			return layout.component_count * std::size_t{2};
+		
+		case component_type::sfloat32:
+			return layout.component_count * std::size_t{4};
+		
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Multiplies two sizes, checking for overflow.
+ *
+ * @param a First size.
+ * @param b Second size.
+ * @param[out] product Product of the sizes, if it does not overflow.
+ *
+ * @return `true` if the product was calculated, `false` if it overflows `std::size_t`.
+ */
+[[nodiscard]] constexpr bool checked_multiply(std::size_t a, std::size_t b, std::size_t& product) noexcept
+{
+	if (b && a > std::numeric_limits<std::size_t>::max() / b)
+	{
+		return false;
+	}
+	
+	product = a * b;
+	return true;
+}
+
+/// Converts a half-precision floating-point number to single-precision.
+[[nodiscard]] float half_to_float(std::uint16_t h) noexcept
+{
+	const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+	const std::uint32_t exponent = (h >> 10) & 0x1f;
+	const std::uint32_t mantissa = h & 0x3ff;
+	
+	if (exponent == 0)
+	{
+		// Zero or subnormal
+		const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+		return sign ? -magnitude : magnitude;
+	}
+	else if (exponent == 0x1f)
+	{
+		// Infinity or NaN
+		return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+	}
+	
+	return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/// Converts a single-precision floating-point number to half-precision, rounding to nearest even.
+[[nodiscard]] std::uint16_t float_to_half(float f) noexcept
+{
+	const std::uint32_t bits = std::bit_cast<std::uint32_t>(f);
+	const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+	const std::uint32_t magnitude = bits & 0x7fffffff;
+	
+	if (magnitude >= 0x7f800000)
+	{
+		// Infinity or NaN
+		return static_cast<std::uint16_t>(sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00));
+	}
+	else if (magnitude >= 0x477ff000)
+	{
+		// Overflow to infinity
+		return static_cast<std::uint16_t>(sign | 0x7c00);
+	}
+	else if (magnitude < 0x38800000)
+	{
+		// Subnormal or zero
+		return static_cast<std::uint16_t>(sign | static_cast<std::uint16_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.0f)));
+	}
+	
+	// Normal, rebias exponent and round mantissa
+	std::uint32_t rebiased = magnitude - 0x38000000;
+	rebiased += 0xfff + ((rebiased >> 13) & 1);
+	return static_cast<std::uint16_t>(sign | (rebiased >> 13));
+}
+
+/**
+ * Decodes pixels into floating-point components.
+ *
+ * @param layout Texel layout of the pixels.
+ * @param linearize `true` if color components should be converted from sRGB to linear, `false` otherwise.
+ * @param source Encoded pixels.
+ *
+ * @return Decoded components.
+ */
+[[nodiscard]] std::vector<float> decode_pixels(const texel_layout& layout, bool linearize, std::span<const std::byte> source)
+{
+	const std::size_t component_size = get_texel_size(layout) / layout.component_count;
+	std::vector<float> components(source.size() / component_size);
+	
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		const std::byte* c = source.data() + i * component_size;
+		switch (layout.type)
+		{
+			case component_type::unorm8:
+				components[i] = static_cast<float>(std::to_integer<std::uint8_t>(*c)) / 255.0f;
+				break;
+			
+			case component_type::unorm16:
+			{
+				std::uint16_t value;
+				std::memcpy(&value, c, sizeof(value));
+				components[i] = static_cast<float>(value) / 65535.0f;
+				break;
+			}
+			
+			case component_type::sfloat16:
+			{
+				std::uint16_t value;
+				std::memcpy(&value, c, sizeof(value));
+				components[i] = half_to_float(value);
+				break;
+			}
+			
+			case component_type::sfloat32:
+				std::memcpy(&components[i], c, sizeof(float));
+				break;
+			
+			default:
+				break;
+		}
+	}
+	
+	if (linearize)
+	{
+		const std::size_t color_count = std::min<std::size_t>(layout.component_count, 3);
+		for (std::size_t i = 0; i < components.size(); i += layout.component_count)
+		{
+			const auto linear = color::srgb_eotf(math::fvec3{components[i], color_count > 1 ? components[i + 1] : 0.0f, color_count > 2 ? components[i + 2] : 0.0f});
+			for (std::size_t j = 0; j < color_count; ++j)
+			{
+				components[i + j] = linear[j];
+			}
+		}
+	}
+	
+	return components;
+}
+
+/**
+ * Encodes floating-point components into pixels.
+ *
+ * @param layout Texel layout of the pixels.
+ * @param delinearize `true` if color components should be converted from linear to sRGB, `false` otherwise.
+ * @param components Decoded components.
+ * @param destination Encoded pixels.
+ */
+void encode_pixels(const texel_layout& layout, bool delinearize, std::span<const float> components, std::span<std::byte> destination)
+{
+	const std::size_t component_size = get_texel_size(layout) / layout.component_count;
+	const std::size_t color_count = std::min<std::size_t>(layout.component_count, 3);
+	
+	for (std::size_t i = 0; i < components.size(); i += layout.component_count)
+	{
+		float texel[4];
+		std::copy_n(components.data() + i, layout.component_count, texel);
+		
+		if (delinearize)
+		{
+			const auto encoded = color::srgb_inverse_eotf(math::fvec3{std::max(texel[0], 0.0f), color_count > 1 ? std::max(texel[1], 0.0f) : 0.0f, color_count > 2 ? std::max(texel[2], 0.0f) : 0.0f});
+			for (std::size_t j = 0; j < color_count; ++j)
+			{
+				texel[j] = encoded[j];
+			}
+		}
+		
+		for (std::size_t j = 0; j < layout.component_count; ++j)
+		{
+			std::byte* c = destination.data() + (i + j) * component_size;
+			switch (layout.type)
+			{
+				case component_type::unorm8:
+					*c = static_cast<std::byte>(std::lround(std::clamp(texel[j], 0.0f, 1.0f) * 255.0f));
+					break;
+				
+				case component_type::unorm16:
+				{
+					const auto value = static_cast<std::uint16_t>(std::lround(std::clamp(texel[j], 0.0f, 1.0f) * 65535.0f));
+					std::memcpy(c, &value, sizeof(value));
+					break;
+				}
+				
+				case component_type::sfloat16:
+				{
+					const auto value = float_to_half(texel[j]);
+					std::memcpy(c, &value, sizeof(value));
+					break;
+				}
+				
+				case component_type::sfloat32:
+					std::memcpy(c, &texel[j], sizeof(float));
+					break;
+				
+				default:
+					break;
+			}
+		}
+	}
+}
+
+/**
+ * Resamples floating-point components along one axis with a box filter, weighting each source element by its coverage of the destination element.
+ *
+ * @param source Source components, laid out as `[outer_count][source_count][inner_count]`.
+ * @param inner_count Number of components per element of the resampled axis.
+ * @param source_count Number of elements along the resampled axis in the source.
+ * @param outer_count Number of rows of the resampled axis.
+ * @param destination_count Number of elements along the resampled axis in the destination.
+ *
+ * @return Destination components, laid out as `[outer_count][destination_count][inner_count]`.
+ */
+[[nodiscard]] std::vector<float> resample_axis(const std::vector<float>& source, std::size_t inner_count, std::size_t source_count, std::size_t outer_count, std::size_t destination_count)
+{
+	std::vector<float> destination(outer_count * destination_count * inner_count, 0.0f);
+	
+	const double scale = static_cast<double>(source_count) / static_cast<double>(destination_count);
+	const float normalization = static_cast<float>(1.0 / scale);
+	
+	for (std::size_t i = 0; i < destination_count; ++i)
+	{
+		// Determine source interval covered by the destination element
+		const double begin = static_cast<double>(i) * scale;
+		const double end = static_cast<double>(i + 1) * scale;
+		const auto first = static_cast<std::size_t>(begin);
+		const auto last = std::min(static_cast<std::size_t>(std::ceil(end)), source_count);
+		
+		for (std::size_t j = first; j < last; ++j)
+		{
+			const float weight = static_cast<float>(std::min(end, static_cast<double>(j + 1)) - std::max(begin, static_cast<double>(j))) * normalization;
+			if (weight <= 0.0f)
+			{
+				continue;
+			}
+			
+			for (std::size_t o = 0; o < outer_count; ++o)
+			{
+				const float* s = source.data() + (o * source_count + j) * inner_count;
+				float* d = destination.data() + (o * destination_count + i) * inner_count;
+				for (std::size_t k = 0; k < inner_count; ++k)
+				{
+					d[k] += s[k] * weight;
+				}
+			}
+		}
+	}
+	
+	return destination;
+}
+
+} // namespace
+
+namespace gl {
+
+std::array<std::uint32_t, 3> image_container::get_mip_dimensions(std::uint32_t level) const noexcept
+{
+	return
+	{
+		std::max<std::uint32_t>(1, dimensions[0] >> level),
+		std::max<std::uint32_t>(1, dimensions[1] >> level),
+		std::max<std::uint32_t>(1, dimensions[2] >> level)
+	};
+}
+
+std::size_t image_container::get_mip_size(std::uint32_t level) const noexcept
+{
+	const auto* layout = find_texel_layout(format);
+	if (!layout)
+	{
+		return 0;
+	}
+	
+	const auto [width, height, depth] = get_mip_dimensions(level);
+	const std::size_t factors[] = {width, height, depth, array_layers};
+	
+	std::size_t size = get_texel_size(*layout);
+	for (const auto factor: factors)
+	{
+		if (!checked_multiply(size, factor, size))
+		{
+			return 0;
+		}
+	}
+	
+	return size;
+}
+
+std::size_t image_container::get_mip_offset(std::uint32_t level) const noexcept
+{
+	std::size_t offset = 0;
+	for (std::uint32_t i = 0; i < level; ++i)
+	{
+		offset += get_mip_size(i);
+	}
+	
+	return offset;
+}
+
+std::span<const std::byte> image_container::get_mip_data(std::uint32_t level) const
+{
+	const auto offset = get_mip_offset(level);
+	const auto size = get_mip_size(level);
+	if (level >= mip_levels || offset + size > data.size())
+	{
+		throw std::out_of_range("Image container mip level out of range.");
+	}
+	
+	return std::span{data}.subspan(offset, size);
+}
+
+image_container bake_image_container(const image_data& data, std::uint8_t dimensionality, bool cube, bool srgb, std::uint32_t mip_levels)
+{
+	const auto* layout = find_texel_layout(data.format);
+	if (!layout)
+	{
+		throw std::invalid_argument("Unsupported image container format.");
+	}
+	
+	const auto texel_size = get_texel_size(*layout);
+	const auto [width, height] = data.dimensions;
+	if (data.pixels.size() != texel_size * width * height)
+	{
+		throw std::invalid_argument("Invalid image data size.");
+	}
+	
+	image_container container;
+	container.format = data.format;
+	container.dimensionality = dimensionality;
+	container.cube = cube;
+	
+	// Determine base level dimensions
+	if (cube)
+	{
+		if (dimensionality != 2)
+		{
+			throw std::invalid_argument("Invalid image dimensionality.");
+		}
+		
+		const auto map_layout = infer_cube_map_layout(width, height);
+		if (map_layout != cube_map_layout::column &&
+			map_layout != cube_map_layout::row &&
+			map_layout != cube_map_layout::vertical_cross &&
+			map_layout != cube_map_layout::horizontal_cross)
+		{
+			throw std::invalid_argument("Unsupported cube map layout.");
+		}
+		
+		const auto face_width = infer_cube_map_face_width(width, height, map_layout);
+		container.dimensions = {face_width, face_width, 1};
+		container.array_layers = 6;
+	}
+	else
+	{
+		switch (dimensionality)
+		{
+			case 1:
+				if (width > 1 && height > 1)
+				{
+					throw std::invalid_argument("Invalid image data size.");
+				}
+				container.dimensions = {std::max(width, height), 1, 1};
+				break;
+			
+			case 2:
+				[[fallthrough]];
+			case 3:
+				container.dimensions = {width, height, 1};
+				break;
+			
+			default:
+				throw std::invalid_argument("Invalid image dimensionality.");
+		}
+	}
+	
+	// Determine number of mip levels
+	const auto max_mip_levels = static_cast<std::uint32_t>(std::bit_width(std::max({container.dimensions[0], container.dimensions[1], container.dimensions[2]})));
+	container.mip_levels = mip_levels ? std::min(mip_levels, max_mip_levels) : max_mip_levels;
+	
+	// Allocate mip levels
+	container.data.resize(container.get_mip_offset(container.mip_levels));
+	
+	// Write base level
+	if (cube)
+	{
+		// Copy cube map faces into consecutive layers
+		const auto map_layout = infer_cube_map_layout(width, height);
+		const auto face_width = container.dimensions[0];
+		const auto row_size = texel_size * face_width;
+		for (std::uint32_t face = 0; face < 6; ++face)
+		{
+			const auto [face_x, face_y] = get_cube_map_face_position(map_layout, face);
+			for (std::uint32_t y = 0; y < face_width; ++y)
+			{
+				std::memcpy
+				(
+					container.data.data() + (static_cast<std::size_t>(face) * face_width + y) * row_size,
+					data.pixels.data() + ((static_cast<std::size_t>(face_y) * face_width + y) * width + static_cast<std::size_t>(face_x) * face_width) * texel_size,
+					row_size
+				);
+			}
+		}
+	}
+	else
+	{
+		std::memcpy(container.data.data(), data.pixels.data(), data.pixels.size());
+	}
+	
+	// Generate mip levels from the previous level, filtering in floating-point
+	const bool linear = layout->srgb || (srgb && (layout->type == component_type::unorm8 || layout->type == component_type::unorm16));
+	std::vector<float> components = decode_pixels(*layout, linear, container.get_mip_data(0));
+	auto dimensions = container.dimensions;
+	for (std::uint32_t level = 1; level < container.mip_levels; ++level)
+	{
+		const auto mip_dimensions = container.get_mip_dimensions(level);
+		const std::size_t component_count = layout->component_count;
+		
+		if (mip_dimensions[0] != dimensions[0])
+		{
+			components = resample_axis(components, component_count, dimensions[0], static_cast<std::size_t>(dimensions[1]) * dimensions[2] * container.array_layers, mip_dimensions[0]);
+		}
+		if (mip_dimensions[1] != dimensions[1])
+		{
+			components = resample_axis(components, component_count * mip_dimensions[0], dimensions[1], static_cast<std::size_t>(dimensions[2]) * container.array_layers, mip_dimensions[1]);
+		}
+		if (mip_dimensions[2] != dimensions[2])
+		{
+			components = resample_axis(components, component_count * mip_dimensions[0] * mip_dimensions[1], dimensions[2], container.array_layers, mip_dimensions[2]);
+		}
+		
+		encode_pixels(*layout, linear, components, std::span{container.data}.subspan(container.get_mip_offset(level), container.get_mip_size(level)));
+		dimensions = mip_dimensions;
+	}
+	
+	return container;
+}
+
+std::unique_ptr<image> upload_image_container(const image_container& container)
+{
+	const auto [width, height, depth] = container.dimensions;
+	
+	// Allocate image
+	std::unique_ptr<image> image;
+	switch (container.dimensionality)
+	{
+		case 1:
+			image = std::make_unique<image_1d>(container.format, width, container.mip_levels, container.array_layers);
+			break;
+		
+		case 2:
+			if (container.cube)
+			{
+				image = std::make_unique<image_cube>(container.format, width, container.mip_levels, container.array_layers);
+			}
+			else
+			{
+				image = std::make_unique<image_2d>(container.format, width, height, container.mip_levels, container.array_layers);
+			}
+			break;
+		
+		case 3:
+			image = std::make_unique<image_3d>(container.format, width, height, depth, container.mip_levels);
+			break;
+		
+		default:
+			throw std::invalid_argument("Invalid image dimensionality.");
+	}
+	
+	// Upload mip levels
+	for (std::uint32_t level = 0; level < container.mip_levels; ++level)
+	{
+		const auto [mip_width, mip_height, mip_depth] = container.get_mip_dimensions(level);
+		const auto mip_data = container.get_mip_data(level);
+		
+		switch (container.dimensionality)
+		{
+			case 1:
+				image->write(level, 0, 0, 0, mip_width, container.array_layers, 1, container.format, mip_data);
+				break;
+			
+			case 2:
+				image->write(level, 0, 0, 0, mip_width, mip_height, container.array_layers, container.format, mip_data);
+				break;
+			
+			default:
+				image->write(level, 0, 0, 0, mip_width, mip_height, mip_depth, container.format, mip_data);
+				break;
+		}
+	}
+	
+	return image;
+}
+
+} // namespace gl
+
+/**
+ * Serializes an image container.
+ *
+ * @param[in] container Image container to serialize.
+ * @param[in,out] ctx Serialize context.
+ *
+ * @throw serialize_error Write error.
+ * @throw serialize_error Unsupported image container format.
+ * @throw serialize_error Invalid image container data size.
+ */
+template <>
+void serializer<gl::image_container>::serialize(const gl::image_container& container, serialize_context& ctx)
+{
+	if (!find_texel_layout(container.format))
+	{
+		throw serialize_error("Unsupported image container format.");
+	}
+	if (container.data.size() != container.get_mip_offset(container.mip_levels))
+	{
+		throw serialize_error("Invalid image container data size.");
+	}
+	
+	// Header
+	const std::uint32_t header[image_container_header_word_count] =
+	{
+		image_container_magic,
+		image_container_version,
+		static_cast<std::uint32_t>(container.format),
+		container.dimensionality,
+		container.dimensions[0],
+		container.dimensions[1],
+		container.dimensions[2],
+		container.mip_levels,
+		container.array_layers,
+		container.cube ? image_container_cube_flag : 0
+	};
+	ctx.write32<std::endian::little>(reinterpret_cast<const std::byte*>(header), image_container_header_word_count);
+	
+	// Mip levels
+	ctx.write8(container.data.data(), container.data.size());
+}
+
+/**
+ * Deserializes an image container.
+ *
+ * Mip levels are read with a single read operation, directly into their final storage.
+ *
+ * @param[out] container Image container to deserialize.
+ * @param[in,out] ctx Deserialize context.
+ *
+ * @throw deserialize_error Read error.
+ * @throw deserialize_error Invalid image container file.
+ * @throw deserialize_error Unsupported image container version.
+ * @throw deserialize_error Unsupported image container format.
+ */
+template <>
+void deserializer<gl::image_container>::deserialize(gl::image_container& container, deserialize_context& ctx)
+{
+	// Read header
+	std::array<std::uint32_t, image_container_header_word_count> header;
+	if (ctx.size() < header.size() * sizeof(std::uint32_t))
+	{
+		throw deserialize_error("Invalid image container file.");
+	}
+	ctx.read32<std::endian::little>(reinterpret_cast<std::byte*>(header.data()), header.size());
+	
+	if (header[0] != image_container_magic)
+	{
+		throw deserialize_error("Invalid image container file.");
+	}
+	if (header[1] != image_container_version)
+	{
+		throw deserialize_error(std::format("Unsupported image container version ({}).", header[1]));
+	}
+	
+	container.format = static_cast<gl::format>(header[2]);
+	container.dimensionality = static_cast<std::uint8_t>(header[3]);
+	container.dimensions = {header[4], header[5], header[6]};
+	container.mip_levels = header[7];
+	container.array_layers = header[8];
+	container.cube = header[9] & image_container_cube_flag;
+	
+	if (!find_texel_layout(container.format))
+	{
+		throw deserialize_error(std::format("Unsupported image container format ({}).", header[2]));
+	}
+	
+	// Validate dimensions
+	const auto [width, height, depth] = container.dimensions;
+	if (header[3] < 1 || header[3] > 3 ||
+		!width || !height || !depth || !container.array_layers ||
+		(container.dimensionality == 1 && (height != 1 || depth != 1)) ||
+		(container.dimensionality == 2 && depth != 1) ||
+		(container.dimensionality == 3 && container.array_layers != 1) ||
+		(container.cube && (container.dimensionality != 2 || width != height || container.array_layers % 6)) ||
+		!container.mip_levels || container.mip_levels > static_cast<std::uint32_t>(std::bit_width(std::max({width, height, depth}))))
+	{
+		throw deserialize_error("Invalid image container file.");
+	}
+	
+	// Sum mip level sizes, rejecting dimensions whose size overflows
+	std::size_t data_size = 0;
+	for (std::uint32_t level = 0; level < container.mip_levels; ++level)
+	{
+		const auto mip_size = container.get_mip_size(level);
+		if (!mip_size || mip_size > std::numeric_limits<std::size_t>::max() - data_size)
+		{
+			throw deserialize_error("Invalid image container file.");
+		}
+		
+		data_size += mip_size;
+	}
+	
+	// Validate file size before allocating
+	if (ctx.size() - image_container_header_word_count * sizeof(std::uint32_t) != data_size)
+	{
+		throw deserialize_error("Invalid image container file.");
+	}
+	
+	// Read mip levels
+	container.data.resize(data_size);
+	ctx.read8(container.data.data(), container.data.size());
+}
+
+template <>
+std::unique_ptr<gl::image_container> resource_loader<gl::image_container>::load([[maybe_unused]] ::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+{
+	auto resource = std::make_unique<gl::image_container>();
+	deserializer<gl::image_container>().deserialize(*resource, *ctx);
+	return resource;
+}
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_IMAGE_CONTAINER_HPP
+#define ANTKEEPER_GL_IMAGE_CONTAINER_HPP
+
+#include <engine/gl/format.hpp>
+#include <engine/gl/image.hpp>
+#include <engine/gl/image-data.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace gl {
+
+/**
+ * Pixels of an image and all of its mip levels, stored in the format in which they are uploaded.
+ *
+ * Image containers are baked offline with bake_image_container() and saved as binary resources with the `.img` extension. Image resources loaded from image containers are uploaded level by level, without decoding or generating mipmaps.
+ *
+ * Only uncompressed formats with 8-bit normalized, 16-bit normalized, 16-bit floating-point, or 32-bit floating-point components are supported.
+ */
+struct image_container
+{
+	/// Format of the pixels.
+	gl::format format{gl::format::undefined};
+	
+	/// Image dimensionality, on `[1, 3]`.
+	std::uint8_t dimensionality{2};
+	
+	/// Width, height, and depth of the base mip level, in pixels.
+	std::array<std::uint32_t, 3> dimensions{1, 1, 1};
+	
+	/// Number of mip levels.
+	std::uint32_t mip_levels{1};
+	
+	/// Number of array layers. Each face of a cube image is an array layer.
+	std::uint32_t array_layers{1};
+	
+	/// `true` if the image is a cube image, with six array layers per cube in the order -x, +x, -y, +y, -z, +z, `false` otherwise.
+	bool cube{false};
+	
+	/// Tightly-packed mip levels, base level first. Each mip level contains all array layers, and each layer is ordered bottom row first.
+	std::vector<std::byte> data;
+	
+	/**
+	 * Returns the dimensions of a mip level.
+	 *
+	 * @param level Mip level.
+	 *
+	 * @return Width, height, and depth of the mip level, in pixels.
+	 */
+	[[nodiscard]] std::array<std::uint32_t, 3> get_mip_dimensions(std::uint32_t level) const noexcept;
+	
+	/**
+	 * Returns the size of a mip level, including all array layers.
+	 *
+	 * @param level Mip level.
+	 *
+	 * @return Size of the mip level, in bytes, or `0` if the format is not supported or the size overflows `std::size_t`.
+	 */
+	[[nodiscard]] std::size_t get_mip_size(std::uint32_t level) const noexcept;
+	
+	/**
+	 * Returns the offset of a mip level within the container data.
+	 *
+	 * @param level Mip level.
+	 *
+	 * @return Offset of the mip level, in bytes.
+	 */
+	[[nodiscard]] std::size_t get_mip_offset(std::uint32_t level) const noexcept;
+	
+	/**
+	 * Returns the pixels of a mip level.
+	 *
+	 * @param level Mip level.
+	 *
+	 * @return Pixels of the mip level.
+	 *
+	 * @exception std::out_of_range Mip level out of range.
+	 */
+	[[nodiscard]] std::span<const std::byte> get_mip_data(std::uint32_t level) const;
+};
+
+/**
+ * Bakes decoded image data into an image container, generating its mip levels on the CPU.
+ *
+ * Each mip level is downsampled from the previous level with a box filter which weights source pixels by their coverage of each destination pixel, such that images with non-power-of-two dimensions are filtered correctly. Levels are filtered in floating-point, and the color components of sRGB images are filtered in linear space.
+ *
+ * @param data Decoded image data.
+ * @param dimensionality Image dimensionality, on `[1, 3]`.
+ * @param cube `true` if the image data is a cube map in a column, row, vertical cross, or horizontal cross layout which should be baked into a cube image, `false` otherwise.
+ * @param srgb `true` if the color components of a normalized image are sRGB-encoded, `false` otherwise. Images with sRGB formats are always filtered as sRGB.
+ * @param mip_levels Number of mip levels, or `0` for a complete mipmap chain.
+ *
+ * @return Baked image container.
+ *
+ * @exception std::invalid_argument Unsupported image container format.
+ * @exception std::invalid_argument Invalid image dimensionality.
+ * @exception std::invalid_argument Invalid image data size.
+ * @exception std::invalid_argument Unsupported cube map layout.
+ */
+[[nodiscard]] image_container bake_image_container(const image_data& data, std::uint8_t dimensionality, bool cube = false, bool srgb = false, std::uint32_t mip_levels = 0);
+
+/**
+ * Constructs an image from an image container, uploading each of its mip levels.
+ *
+ * @param container Image container.
+ *
+ * @return Image containing the mip levels of the container. Cube containers are uploaded to cube images.
+ *
+ * @exception std::invalid_argument Invalid image dimensionality.
+ */
+[[nodiscard]] std::unique_ptr<image> upload_image_container(const image_container& container);
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_IMAGE_CONTAINER_HPP
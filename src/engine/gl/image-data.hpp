@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_IMAGE_DATA_HPP
+#define ANTKEEPER_GL_IMAGE_DATA_HPP
+
+#include <engine/gl/format.hpp>
+#include <engine/gl/image.hpp>
+#include <engine/resources/deserialize-context.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gl {
+
+/**
+ * Decoded pixels of an image file, which have not yet been uploaded to an image.
+ */
+struct image_data
+{
+	/// Format of the pixels.
+	gl::format format{gl::format::undefined};
+	
+	/// Width and height of the image, in pixels.
+	std::array<std::uint32_t, 2> dimensions{};
+	
+	/// Tightly-packed pixels, ordered bottom row first.
+	std::vector<std::byte> pixels;
+};
+
+/**
+ * Decodes an image file.
+ *
+ * OpenEXR images are decoded with TinyEXR, and all other formats are decoded with stb_image. Decoding does not require a graphics context, and may be performed on any thread.
+ *
+ * @param ctx Deserialize context of the image file.
+ *
+ * @return Decoded image data.
+ *
+ * @exception deserialize_error Failed to decode image file.
+ */
+[[nodiscard]] image_data decode_image(deserialize_context& ctx);
+
+/**
+ * Constructs an image from decoded image data and generates its mipmaps.
+ *
+ * @param data Decoded image data.
+ * @param dimensionality Image dimensionality, on `[1, 3]`.
+ * @param mip_levels Number of mip levels, or `0` for a complete mipmap chain.
+ *
+ * @return Image containing the decoded pixels.
+ *
+ * @exception std::invalid_argument Invalid image dimensionality.
+ */
+[[nodiscard]] std::unique_ptr<image> upload_image(const image_data& data, std::uint8_t dimensionality, std::uint32_t mip_levels = 0);
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_IMAGE_DATA_HPP
@@ -0,0 +1,266 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/gl/image-streamer.hpp>
+#include <engine/resources/resource-manager.hpp>
+#include <engine/resources/deserialize-error.hpp>
+#include <engine/resources/resource-loader.hpp>
+#include <engine/debug/log.hpp>
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace gl {
+
+namespace {
+
+/// Invokes a request callback, logging rather than propagating its exceptions.
+void invoke(const image_streamer::callback_type& callback, const std::shared_ptr<image_2d>& image, const std::string& path_string)
+{
+	try
+	{
+		callback(image);
+	}
+	catch (const std::exception& e)
+	{
+		debug::log_error("Failed to complete request for image \"{}\": {}", path_string, e.what());
+	}
+}
+
+} // namespace
+
+image_streamer::image_streamer(::resource_manager& resource_manager, std::size_t thread_count):
+	m_resource_manager(&resource_manager)
+{
+	// Construct placeholder image
+	constexpr std::array<std::byte, 4> placeholder_pixel = {std::byte{255}, std::byte{255}, std::byte{255}, std::byte{255}};
+	m_placeholder = std::make_shared<image_2d>(format::r8g8b8a8_unorm, 1, 1);
+	m_placeholder->write(0, 0, 0, 0, 1, 1, 1, format::r8g8b8a8_unorm, placeholder_pixel);
+	
+	// Start worker threads
+	if (!thread_count)
+	{
+		thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+	}
+	m_workers.reserve(thread_count);
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		m_workers.emplace_back(std::bind_front(&image_streamer::work, this));
+	}
+}
+
+image_streamer::~image_streamer()
+{
+	m_workers.clear();
+}
+
+void image_streamer::request(const std::filesystem::path& path, callback_type callback)
+{
+	// Complete requests for images which have already been loaded on the next update
+	if (auto image = m_resource_manager->find<image_2d>(path))
+	{
+		m_ready_requests.emplace_back(path, std::move(image), std::move(callback));
+		return;
+	}
+	
+	// Share requests for images which are being loaded
+	if (auto i = m_requests.find(path); i != m_requests.end())
+	{
+		i->second->callbacks.emplace_back(std::move(callback));
+		return;
+	}
+	
+	auto request = std::make_shared<request_state>();
+	request->path = path;
+	request->callbacks.emplace_back(std::move(callback));
+	m_requests.emplace(path, request);
+	
+	// Queue request for decoding
+	{
+		std::lock_guard lock(m_mutex);
+		m_decode_queue.emplace_back(std::move(request));
+	}
+	m_decode_condition.notify_one();
+}
+
+std::size_t image_streamer::update()
+{
+	complete_ready_requests();
+	
+	std::size_t upload_count = 0;
+	std::size_t upload_size = 0;
+	while (!upload_count || upload_size < m_upload_budget)
+	{
+		std::shared_ptr<request_state> request;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_upload_queue.empty())
+			{
+				break;
+			}
+			
+			request = std::move(m_upload_queue.front());
+			m_upload_queue.pop_front();
+		}
+		
+		upload_size += upload(*request);
+		++upload_count;
+	}
+	
+	return upload_count;
+}
+
+void image_streamer::flush()
+{
+	complete_ready_requests();
+	
+	while (!m_requests.empty())
+	{
+		std::shared_ptr<request_state> request;
+		{
+			std::unique_lock lock(m_mutex);
+			m_upload_condition.wait
+			(
+				lock,
+				[this]()
+				{
+					return !m_upload_queue.empty();
+				}
+			);
+			
+			request = std::move(m_upload_queue.front());
+			m_upload_queue.pop_front();
+		}
+		
+		upload(*request);
+		complete_ready_requests();
+	}
+}
+
+void image_streamer::work(std::stop_token stop_token)
+{
+	for (;;)
+	{
+		// Wait for a request
+		std::shared_ptr<request_state> request;
+		{
+			std::unique_lock lock(m_mutex);
+			if (!m_decode_condition.wait
+			(
+				lock,
+				stop_token,
+				[this]()
+				{
+					return !m_decode_queue.empty();
+				}
+			))
+			{
+				return;
+			}
+			
+			request = std::move(m_decode_queue.front());
+			m_decode_queue.pop_front();
+		}
+		
+		// Read and decode image file
+		try
+		{
+			auto ctx = m_resource_manager->open_read(request->path);
+			if (!ctx)
+			{
+				throw deserialize_error("Failed to open image file.");
+			}
+			
+			// Read pre-mipmapped image containers without decoding
+			if (request->path.extension() == ".img")
+			{
+				request->container = std::move(*resource_loader<image_container>::load(*m_resource_manager, std::move(ctx)));
+			}
+			else
+			{
+				request->data = decode_image(*ctx);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			request->error = e.what();
+		}
+		
+		// Queue request for uploading
+		{
+			std::lock_guard lock(m_mutex);
+			m_upload_queue.emplace_back(std::move(request));
+		}
+		m_upload_condition.notify_one();
+	}
+}
+
+std::size_t image_streamer::upload(request_state& request)
+{
+	const auto path_string = request.path.string();
+	
+	std::shared_ptr<image_2d> image;
+	std::size_t upload_size = 0;
+	if (request.data || request.container)
+	{
+		try
+		{
+			if (request.container)
+			{
+				if (request.container->dimensionality != 2)
+				{
+					throw std::invalid_argument("Invalid image dimensionality.");
+				}
+				
+				image = std::shared_ptr<image_2d>(static_cast<image_2d*>(upload_image_container(*request.container).release()));
+				upload_size = request.container->data.size();
+			}
+			else
+			{
+				image = std::shared_ptr<image_2d>(static_cast<image_2d*>(upload_image(*request.data, 2).release()));
+				upload_size = request.data->pixels.size();
+			}
+			
+			// Cache image, such that it's shared by subsequent requests and loads
+			m_resource_manager->insert(request.path, image);
+			
+			debug::log_debug("Streamed image \"{}\"", path_string);
+		}
+		catch (const std::exception& e)
+		{
+			debug::log_error("Failed to upload image \"{}\": {}", path_string, e.what());
+		}
+	}
+	else
+	{
+		debug::log_error("Failed to load image \"{}\": {}", path_string, request.error);
+	}
+	
+	// Release decoded pixels, and remove the request before its callbacks can make new requests
+	request.data.reset();
+	request.container.reset();
+	m_requests.erase(request.path);
+	
+	for (const auto& callback: request.callbacks)
+	{
+		invoke(callback, image, path_string);
+	}
+	
+	return upload_size;
+}
+
+void image_streamer::complete_ready_requests()
+{
+	auto ready_requests = std::move(m_ready_requests);
+	m_ready_requests.clear();
+	
+	for (const auto& [path, image, callback]: ready_requests)
+	{
+		invoke(callback, image, path.string());
+	}
+}
+
+} // namespace gl
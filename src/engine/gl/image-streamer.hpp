@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_IMAGE_STREAMER_HPP
+#define ANTKEEPER_GL_IMAGE_STREAMER_HPP
+
+#include <engine/gl/image.hpp>
+#include <engine/gl/image-data.hpp>
+#include <engine/gl/image-container.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class resource_manager;
+
+namespace gl {
+
+/**
+ * Loads 2D images asynchronously.
+ *
+ * Image files are read and decoded on a pool of worker threads. Image containers are read without decoding. Decoded images are uploaded by update(), which must be called from the thread which owns the graphics context, and which uploads at most a budgeted number of bytes per call. Uploaded images are cached by the resource manager, such that they're shared with synchronous loads. Until an image has been uploaded, the placeholder image can be used in its place.
+ *
+ * @see resource_manager::set_image_streamer()
+ */
+class image_streamer
+{
+public:
+	/// Function called once a requested image has been uploaded, with a pointer to the image, or `nullptr` if the image could not be loaded.
+	using callback_type = std::function<void(const std::shared_ptr<image_2d>&)>;
+	
+	/**
+	 * Constructs an image streamer.
+	 *
+	 * @param resource_manager Resource manager from which image files are read.
+	 * @param thread_count Number of worker threads, or `0` to use one fewer than the number of hardware threads.
+	 */
+	explicit image_streamer(::resource_manager& resource_manager, std::size_t thread_count = 0);
+	
+	/** Destructs an image streamer, discarding requests which have not yet been decoded and waiting for the worker threads to finish. */
+	~image_streamer();
+	
+	image_streamer(const image_streamer&) = delete;
+	image_streamer(image_streamer&&) = delete;
+	image_streamer& operator=(const image_streamer&) = delete;
+	image_streamer& operator=(image_streamer&&) = delete;
+	
+	/**
+	 * Requests a 2D image.
+	 *
+	 * Requests for an image which is already being loaded share its decode and upload. Requests for an image which has already been uploaded complete on the next update.
+	 *
+	 * @param path Path to the image file.
+	 * @param callback Function called by update() once the image has been uploaded.
+	 */
+	void request(const std::filesystem::path& path, callback_type callback);
+	
+	/**
+	 * Uploads decoded images and completes their requests, until the upload budget has been exhausted.
+	 *
+	 * At least one decoded image is uploaded per call, such that images larger than the upload budget are not stalled.
+	 *
+	 * @return Number of images uploaded.
+	 */
+	std::size_t update();
+	
+	/**
+	 * Waits for all requests to be decoded, then uploads them regardless of the upload budget.
+	 */
+	void flush();
+	
+	/**
+	 * Sets the maximum number of bytes of pixel data uploaded by each call to update().
+	 *
+	 * @param budget Upload budget, in bytes.
+	 */
+	inline void set_upload_budget(std::size_t budget) noexcept
+	{
+		m_upload_budget = budget;
+	}
+	
+	/// Returns the maximum number of bytes of pixel data uploaded by each call to update().
+	[[nodiscard]] inline std::size_t get_upload_budget() const noexcept
+	{
+		return m_upload_budget;
+	}
+	
+	/// Returns the number of images which have been requested but not yet uploaded.
+	[[nodiscard]] inline std::size_t get_pending_count() const noexcept
+	{
+		return m_requests.size();
+	}
+	
+	/// Returns the placeholder image, a single opaque white pixel.
+	[[nodiscard]] inline const std::shared_ptr<image_2d>& get_placeholder() const noexcept
+	{
+		return m_placeholder;
+	}
+
+private:
+	/// Request for an image.
+	struct request_state
+	{
+		/// Path to the image file.
+		std::filesystem::path path;
+		
+		/// Functions to call once the image has been uploaded.
+		std::vector<callback_type> callbacks;
+		
+		/// Decoded image data, or `std::nullopt` if the image is an image container or could not be decoded.
+		std::optional<image_data> data;
+		
+		/// Image container, or `std::nullopt` if the image is not an image container or could not be read.
+		std::optional<image_container> container;
+		
+		/// Description of the error which occurred while decoding the image.
+		std::string error;
+	};
+	
+	/// Reads and decodes requested images, until stop is requested.
+	void work(std::stop_token stop_token);
+	
+	/**
+	 * Uploads a decoded image and completes its request.
+	 *
+	 * @param request Decoded request.
+	 *
+	 * @return Number of bytes of pixel data uploaded.
+	 */
+	std::size_t upload(request_state& request);
+	
+	/// Completes requests for images which had already been uploaded.
+	void complete_ready_requests();
+	
+	::resource_manager* m_resource_manager;
+	std::shared_ptr<image_2d> m_placeholder;
+	std::size_t m_upload_budget{std::size_t{1} << 24};
+	
+	/// Requests which have not yet been uploaded, keyed by image path. Only accessed by the owning thread.
+	std::unordered_map<std::filesystem::path, std::shared_ptr<request_state>> m_requests;
+	
+	/// Requests for images which had already been uploaded.
+	std::vector<std::tuple<std::filesystem::path, std::shared_ptr<image_2d>, callback_type>> m_ready_requests;
+	
+	/// Requests waiting to be decoded, and decoded requests waiting to be uploaded, guarded by `m_mutex`.
+	std::deque<std::shared_ptr<request_state>> m_decode_queue;
+	std::deque<std::shared_ptr<request_state>> m_upload_queue;
+	std::mutex m_mutex;
+	std::condition_variable_any m_decode_condition;
+	std::condition_variable m_upload_condition;
+	
+	/// Worker threads, destructed first such that they stop before the queues are destructed.
+	std::vector<std::jthread> m_workers;
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_IMAGE_STREAMER_HPP
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <engine/gl/image.hpp>
+#include <engine/gl/image-data.hpp>
+#include <engine/gl/image-container.hpp>
 #include <engine/gl/cube-map.hpp>
 #include <engine/gl/opengl/gl-format-lut.hpp>
 #include <engine/resources/resource-loader.hpp>
@@ -9,6 +11,7 @@
 #include <engine/resources/deserializer.hpp>
 #include <engine/debug/log.hpp>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <glad/gl.h>
 #include <stb/stb_image.h>
@@ -570,7 +573,7 @@ namespace {
 		}
 	};
 	
-	[[nodiscard]] std::unique_ptr<gl::image> load_image_stb_image(deserialize_context& ctx, std::uint8_t dimensionality, std::uint32_t mip_levels)
+	[[nodiscard]] gl::image_data decode_image_stb_image(deserialize_context& ctx)
 	{
 		// Setup IO callbacks
 		const stbi_io_callbacks io_callbacks
@@ -584,9 +587,6 @@ namespace {
 		std::size_t component_size = stbi_is_16_bit_from_callbacks(&io_callbacks, &ctx) ? sizeof(std::uint16_t) : sizeof(std::uint8_t);
 		ctx.seek(0);
 		
-		// Set vertical flip on load in order to correctly upload pixel data to OpenGL
-		stbi_set_flip_vertically_on_load(true);
-		
 		// Load image data
 		std::unique_ptr<void, stb_image_deleter> data;
 		int width;
@@ -646,78 +646,23 @@ namespace {
 			throw deserialize_error(stbi_failure_reason());
 		}
 		
-		// Determine number mip levels
-		if (!mip_levels)
-		{
-			mip_levels = static_cast<std::uint32_t>(std::bit_width(static_cast<std::uint32_t>(std::max(width, height))));
-		}
+		gl::image_data image_data;
+		image_data.format = format;
+		image_data.dimensions = {static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)};
 		
-		// Allocate image
-		std::unique_ptr<gl::image> image;
-		switch (dimensionality)
+		// Copy rows in reverse order in order to correctly upload pixel data to OpenGL. Rows are flipped here rather than with stbi_set_flip_vertically_on_load(), which sets state shared by all threads.
+		const std::size_t row_size = static_cast<std::size_t>(width) * static_cast<std::size_t>(components) * component_size;
+		image_data.pixels.resize(row_size * static_cast<std::size_t>(height));
+		const std::byte* rows = static_cast<const std::byte*>(data.get());
+		for (std::size_t y = 0; y < static_cast<std::size_t>(height); ++y)
 		{
-			case 1:
-				image = std::make_unique<gl::image_1d>
-				(
-					format,
-					static_cast<std::uint32_t>(std::max(width, height)),
-					mip_levels
-				);
-				break; 
-			
-			case 2:
-				image = std::make_unique<gl::image_2d>
-				(
-					format,
-					static_cast<std::uint32_t>(width),
-					static_cast<std::uint32_t>(height),
-					mip_levels
-				);
-				break;
-			
-			case 3:
-				image = std::make_unique<gl::image_3d>
-				(
-					format,
-					static_cast<std::uint32_t>(width),
-					static_cast<std::uint32_t>(height),
-					1,
-					mip_levels
-				);
-				break;
-			
-			default:
-				break;
+			std::memcpy(image_data.pixels.data() + y * row_size, rows + (static_cast<std::size_t>(height) - 1 - y) * row_size, row_size);
 		}
 		
-		// Upload image data to image
-		image->write
-		(
-			0,
-			0,
-			0,
-			0,
-			image->get_dimensions()[0],
-			image->get_dimensions()[1],
-			image->get_dimensions()[2],
-			format,
-			{
-				reinterpret_cast<const std::byte*>(data.get()),
-				image->get_dimensions()[0] *
-					image->get_dimensions()[1] *
-					image->get_dimensions()[2] *
-					static_cast<std::size_t>(components) *
-					component_size
-			}
-		);
-		
-		// Generate mipmaps
-		image->generate_mipmaps();
-		
-		return image;
+		return image_data;
 	}
 	
-	[[nodiscard]] std::unique_ptr<gl::image> load_image_tinyexr(deserialize_context& ctx, std::uint8_t dimensionality, std::uint32_t mip_levels)
+	[[nodiscard]] gl::image_data decode_image_tinyexr(deserialize_context& ctx)
 	{
 		const char* error = nullptr;
 		auto tinyexr_error = [&error]()
@@ -835,11 +780,15 @@ namespace {
 				break;
 		}
 		
+		gl::image_data image_data;
+		image_data.format = format;
+		image_data.dimensions = {static_cast<std::uint32_t>(exr_image.width), static_cast<std::uint32_t>(exr_image.height)};
+		
 		// Allocate interleaved image data
-		std::vector<std::byte> data(static_cast<std::size_t>(exr_image.width * exr_image.height * exr_header.num_channels * component_size));
+		image_data.pixels.resize(static_cast<std::size_t>(exr_image.width * exr_image.height * exr_header.num_channels * component_size));
 		
 		// Interleave image data from layers
-		std::byte* component = data.data();
+		std::byte* component = image_data.pixels.data();
 		for (auto y = exr_image.height - 1; y >= 0; --y)
 		{
 			const auto row_offset = y * exr_image.width;
@@ -856,117 +805,164 @@ namespace {
 			}
 		}
 		
-		// Store image dimensions
-		const auto width = static_cast<std::uint32_t>(exr_image.width);
-		const auto height = static_cast<std::uint32_t>(exr_image.height);
-		
 		// Free loaded image data and image header
 		FreeEXRImage(&exr_image);
 		FreeEXRHeader(&exr_header);
 		
-		// Determine number mip levels
-		if (!mip_levels)
+		return image_data;
+	}
+	
+	/**
+	 * Loads an image container and uploads its mip levels, without decoding or generating mipmaps.
+	 *
+	 * @param resource_manager Resource manager.
+	 * @param ctx Deserialize context of the image container file.
+	 * @param dimensionality Expected image dimensionality.
+	 * @param cube `true` if a cube image is expected, `false` otherwise.
+	 *
+	 * @return Uploaded image.
+	 *
+	 * @exception deserialize_error Image container dimensionality mismatch.
+	 */
+	[[nodiscard]] std::unique_ptr<gl::image> load_image_container(::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx, std::uint8_t dimensionality, bool cube)
+	{
+		const auto container = resource_loader<gl::image_container>::load(resource_manager, std::move(ctx));
+		if (container->dimensionality != dimensionality || (cube && !container->cube))
 		{
-			mip_levels = static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+			throw deserialize_error("Image container dimensionality mismatch.");
 		}
 		
-		// Allocate image
-		std::unique_ptr<gl::image> image;
-		switch (dimensionality)
+		return gl::upload_image_container(*container);
+	}
+	
+	[[nodiscard]] std::unique_ptr<gl::image> load_image(::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx, std::uint8_t dimensionality, std::uint32_t mip_levels)
+	{
+		// Upload pre-mipmapped image containers directly
+		if (ctx->path().extension() == ".img")
 		{
-			case 1:
-				image = std::make_unique<gl::image_1d>
-				(
-					format,
-					std::max(width, height),
-					mip_levels
-				);
-				break; 
-			
-			case 2:
-				image = std::make_unique<gl::image_2d>
-				(
-					format,
-					width,
-					height,
-					mip_levels
-				);
-				break;
-			
-			case 3:
-				image = std::make_unique<gl::image_3d>
-				(
-					format,
-					width,
-					height,
-					1,
-					mip_levels
-				);
-				break;
-			
-			default:
-				break;
+			return load_image_container(resource_manager, std::move(ctx), dimensionality, false);
 		}
 		
-		// Upload interleaved image data to image
-		image->write
-		(
-			0,
-			0,
-			0,
-			0,
-			image->get_dimensions()[0],
-			image->get_dimensions()[1],
-			image->get_dimensions()[2],
-			format,
-			data
-		);
-		
-		// Generate mipmaps
-		image->generate_mipmaps();
-		
-		return image;
+		return gl::upload_image(gl::decode_image(*ctx), dimensionality, mip_levels);
+	}
+}
+
+namespace gl {
+
+image_data decode_image(deserialize_context& ctx)
+{
+	// Select decoder according to file extension
+	if (ctx.path().extension() == ".exr")
+	{
+		// Decode EXR images with TinyEXR
+		return decode_image_tinyexr(ctx);
 	}
+	else
+	{
+		// Decode other image formats with stb_image
+		return decode_image_stb_image(ctx);
+	}
+}
+
+std::unique_ptr<image> upload_image(const image_data& data, std::uint8_t dimensionality, std::uint32_t mip_levels)
+{
+	const auto [width, height] = data.dimensions;
 	
-	[[nodiscard]] std::unique_ptr<gl::image> load_image(deserialize_context& ctx, std::uint8_t dimensionality, std::uint32_t mip_levels)
+	// Determine number mip levels
+	if (!mip_levels)
 	{
-		// Select loader according to file extension
-		if (ctx.path().extension() == ".exr")
-		{
-			// Load EXR images with TinyEXR
-			return load_image_tinyexr(ctx, dimensionality, mip_levels);
-		}
-		else
-		{
-			// Load other image formats with stb_image
-			return load_image_stb_image(ctx, dimensionality, mip_levels);
-		}
+		mip_levels = static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+	}
+	
+	// Allocate image
+	std::unique_ptr<image> image;
+	switch (dimensionality)
+	{
+		case 1:
+			image = std::make_unique<image_1d>
+			(
+				data.format,
+				std::max(width, height),
+				mip_levels
+			);
+			break; 
+		
+		case 2:
+			image = std::make_unique<image_2d>
+			(
+				data.format,
+				width,
+				height,
+				mip_levels
+			);
+			break;
+		
+		case 3:
+			image = std::make_unique<image_3d>
+			(
+				data.format,
+				width,
+				height,
+				1,
+				mip_levels
+			);
+			break;
+		
+		default:
+			throw std::invalid_argument("Invalid image dimensionality.");
 	}
+	
+	// Upload image data to image
+	image->write
+	(
+		0,
+		0,
+		0,
+		0,
+		image->get_dimensions()[0],
+		image->get_dimensions()[1],
+		image->get_dimensions()[2],
+		data.format,
+		data.pixels
+	);
+	
+	// Generate mipmaps
+	image->generate_mipmaps();
+	
+	return image;
 }
 
+} // namespace gl
+
 template <>
-std::unique_ptr<gl::image_1d> resource_loader<gl::image_1d>::load([[maybe_unused]] resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+std::unique_ptr<gl::image_1d> resource_loader<gl::image_1d>::load(resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
 {
-	return std::unique_ptr<gl::image_1d>(static_cast<gl::image_1d*>(load_image(*ctx, 1, 0).release()));
+	return std::unique_ptr<gl::image_1d>(static_cast<gl::image_1d*>(load_image(resource_manager, std::move(ctx), 1, 0).release()));
 }
 
 template <>
-std::unique_ptr<gl::image_2d> resource_loader<gl::image_2d>::load([[maybe_unused]] ::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+std::unique_ptr<gl::image_2d> resource_loader<gl::image_2d>::load(::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
 {
-	return std::unique_ptr<gl::image_2d>(static_cast<gl::image_2d*>(load_image(*ctx, 2, 0).release()));
+	return std::unique_ptr<gl::image_2d>(static_cast<gl::image_2d*>(load_image(resource_manager, std::move(ctx), 2, 0).release()));
 }
 
 template <>
-std::unique_ptr<gl::image_3d> resource_loader<gl::image_3d>::load([[maybe_unused]] ::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+std::unique_ptr<gl::image_3d> resource_loader<gl::image_3d>::load(::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
 {
-	return std::unique_ptr<gl::image_3d>(static_cast<gl::image_3d*>(load_image(*ctx, 3, 0).release()));
+	return std::unique_ptr<gl::image_3d>(static_cast<gl::image_3d*>(load_image(resource_manager, std::move(ctx), 3, 0).release()));
 }
 
 template <>
-std::unique_ptr<gl::image_cube> resource_loader<gl::image_cube>::load([[maybe_unused]] ::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+std::unique_ptr<gl::image_cube> resource_loader<gl::image_cube>::load(::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
 {
+	// Upload pre-mipmapped cube image containers directly
+	if (ctx->path().extension() == ".img")
+	{
+		return std::unique_ptr<gl::image_cube>(static_cast<gl::image_cube*>(load_image_container(resource_manager, std::move(ctx), 2, true).release()));
+	}
+	
 	// Load cube map
-	auto cube_map = std::unique_ptr<gl::image_2d>(static_cast<gl::image_2d*>(load_image(*ctx, 2, 1).release()));
+	auto cube_map = std::unique_ptr<gl::image_2d>(static_cast<gl::image_2d*>(gl::upload_image(gl::decode_image(*ctx), 2, 1).release()));
 	
 	// Determine cube map layout
 	const auto layout = gl::infer_cube_map_layout(cube_map->get_dimensions()[0], cube_map->get_dimensions()[1]);
@@ -990,61 +986,11 @@ std::unique_ptr<gl::image_cube> resource_loader<gl::image_cube>::load([[maybe_un
 		static_cast<std::uint32_t>(std::bit_width(face_width))
 	);
 	
-	// Vertical cross layout face offsets
-	constexpr std::uint32_t vcross_offsets[6][2] =
-	{
-		{2, 2}, {0, 2}, // -x, +x
-		{1, 3}, {1, 1}, // -y, +y
-		{1, 0}, {1, 2}  // -z, +z
-	};
-	
-	// Horizontal cross layout face offsets
-	constexpr std::uint32_t hcross_offsets[6][2] =
-	{
-		{2, 1}, {0, 1}, // -x, +x
-		{1, 2}, {1, 0}, // -y, +y
-		{3, 1}, {1, 1}  // -z, +z
-	};
-	
 	// Copy cube map faces to cube image
-	switch (layout)
+	for (std::uint32_t i = 0; i < 6; ++i)
 	{
-		case gl::cube_map_layout::column:
-			for (std::uint32_t i = 0; i < 6; ++i)
-			{
-				cube_map->copy(0, 0, face_width * i, 0, *image, 0, 0, 0, i, face_width, face_width, 1);
-			}
-			break;
-		
-		case gl::cube_map_layout::row:
-			for (std::uint32_t i = 0; i < 6; ++i)
-			{
-				cube_map->copy(0, face_width * i, 0, 0, *image, 0, 0, 0, i, face_width, face_width, 1);
-			}
-			break;
-		
-		case gl::cube_map_layout::vertical_cross:
-			for (std::uint32_t i = 0; i < 6; ++i)
-			{
-				cube_map->copy(0, face_width * vcross_offsets[i][0], face_width * vcross_offsets[i][1], 0, *image, 0, 0, 0, i, face_width, face_width, 1);
-			}
-			break;
-		
-		case gl::cube_map_layout::horizontal_cross:
-			for (std::uint32_t i = 0; i < 6; ++i)
-			{
-				cube_map->copy(0, face_width * hcross_offsets[i][0], face_width * hcross_offsets[i][1], 0, *image, 0, 0, 0, i, face_width, face_width, 1);
-			}
-			break;
-		
-		case gl::cube_map_layout::equirectangular:
-			[[fallthrough]];
-		case gl::cube_map_layout::spherical:
-			[[fallthrough]];
-		case gl::cube_map_layout::unknown:
-			[[fallthrough]];
-		default:
-			break;
+		const auto [x, y] = gl::get_cube_map_face_position(layout, i);
+		cube_map->copy(0, face_width * x, face_width * y, 0, *image, 0, 0, 0, i, face_width, face_width, 1);
 	}
 	
 	// Generate mipmaps
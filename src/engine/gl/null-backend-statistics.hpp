@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_NULL_BACKEND_STATISTICS_HPP
+#define ANTKEEPER_GL_NULL_BACKEND_STATISTICS_HPP
+
+#include <cstdint>
+
+namespace gl {
+
+/**
+ * Commands recorded by the null backend.
+ *
+ * @see load_null_backend()
+ */
+struct null_backend_statistics
+{
+	/// Number of draw calls.
+	std::uint64_t draw_count{};
+	
+	/// Total number of vertices or indices drawn, multiplied by the number of instances of each draw call.
+	std::uint64_t vertex_count{};
+	
+	/// Total number of instances drawn.
+	std::uint64_t instance_count{};
+	
+	/// Number of framebuffer clears.
+	std::uint64_t clear_count{};
+	
+	/// Number of state changes, including framebuffer, shader program, vertex array, vertex buffer, texture, and sampler bindings.
+	std::uint64_t state_change_count{};
+	
+	/// Number of framebuffer bindings.
+	std::uint64_t framebuffer_bind_count{};
+	
+	/// Number of shader program bindings.
+	std::uint64_t shader_program_bind_count{};
+	
+	/// Number of vertex array bindings.
+	std::uint64_t vertex_array_bind_count{};
+	
+	/// Number of texture bindings.
+	std::uint64_t texture_bind_count{};
+	
+	/// Number of shader uniform updates.
+	std::uint64_t uniform_update_count{};
+	
+	/// Number of buffer uploads.
+	std::uint64_t buffer_upload_count{};
+	
+	/// Total number of bytes uploaded to buffers.
+	std::uint64_t buffer_upload_size{};
+	
+	/// Number of texture uploads.
+	std::uint64_t texture_upload_count{};
+	
+	/// Number of shader programs linked.
+	std::uint64_t shader_program_link_count{};
+	
+	/// Number of fence sync objects created.
+	std::uint64_t fence_count{};
+	
+	/// Number of client waits for fences which had not been signaled.
+	std::uint64_t fence_wait_count{};
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_NULL_BACKEND_STATISTICS_HPP
@@ -0,0 +1,869 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/gl/null-backend.hpp>
+#include <glad/gl.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+namespace {
+
+/// Uniform reflected from shader source.
+struct null_uniform
+{
+	std::string name;
+	GLint size;
+	GLenum type;
+};
+
+/// State of the null backend.
+struct null_context
+{
+	null_backend_statistics statistics;
+	GLint default_framebuffer_width{0};
+	GLint default_framebuffer_height{0};
+	GLuint next_name{1};
+	std::unordered_map<GLuint, std::string> shader_sources;
+	std::unordered_map<GLuint, std::vector<GLuint>> program_shaders;
+	std::unordered_map<GLuint, std::vector<null_uniform>> program_uniforms;
+	std::unordered_map<GLuint, std::vector<std::byte>> buffer_storage;
+	std::uintptr_t next_sync{1};
+	std::uintptr_t signaled_sync{0};
+	bool auto_signal_fences{true};
+};
+
+null_context context;
+
+/// Maps GLSL uniform types to OpenGL uniform types. Uniforms of other types are not reflected.
+const std::unordered_map<std::string_view, GLenum> uniform_type_map =
+{
+	{"bool", GL_BOOL},
+	{"bvec2", GL_BOOL_VEC2},
+	{"bvec3", GL_BOOL_VEC3},
+	{"bvec4", GL_BOOL_VEC4},
+	{"int", GL_INT},
+	{"ivec2", GL_INT_VEC2},
+	{"ivec3", GL_INT_VEC3},
+	{"ivec4", GL_INT_VEC4},
+	{"uint", GL_UNSIGNED_INT},
+	{"uvec2", GL_UNSIGNED_INT_VEC2},
+	{"uvec3", GL_UNSIGNED_INT_VEC3},
+	{"uvec4", GL_UNSIGNED_INT_VEC4},
+	{"float", GL_FLOAT},
+	{"vec2", GL_FLOAT_VEC2},
+	{"vec3", GL_FLOAT_VEC3},
+	{"vec4", GL_FLOAT_VEC4},
+	{"mat2", GL_FLOAT_MAT2},
+	{"mat3", GL_FLOAT_MAT3},
+	{"mat4", GL_FLOAT_MAT4},
+	{"sampler1D", GL_SAMPLER_1D},
+	{"sampler1DShadow", GL_SAMPLER_1D_SHADOW},
+	{"isampler1D", GL_INT_SAMPLER_1D},
+	{"usampler1D", GL_UNSIGNED_INT_SAMPLER_1D},
+	{"sampler2D", GL_SAMPLER_2D},
+	{"sampler2DShadow", GL_SAMPLER_2D_SHADOW},
+	{"isampler2D", GL_INT_SAMPLER_2D},
+	{"usampler2D", GL_UNSIGNED_INT_SAMPLER_2D},
+	{"sampler3D", GL_SAMPLER_3D},
+	{"isampler3D", GL_INT_SAMPLER_3D},
+	{"usampler3D", GL_UNSIGNED_INT_SAMPLER_3D},
+	{"samplerCube", GL_SAMPLER_CUBE},
+	{"isamplerCube", GL_INT_SAMPLER_CUBE},
+	{"usamplerCube", GL_UNSIGNED_INT_SAMPLER_CUBE}
+};
+
+[[nodiscard]] constexpr bool is_identifier_char(char c) noexcept
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/// Removes line and block comments from shader source.
+[[nodiscard]] std::string strip_comments(std::string_view source)
+{
+	std::string result;
+	result.reserve(source.size());
+	
+	for (std::size_t i = 0; i < source.size(); ++i)
+	{
+		if (source[i] == '/' && i + 1 < source.size())
+		{
+			if (source[i + 1] == '/')
+			{
+				i = std::min(source.find('\n', i), source.size());
+				result += '\n';
+				continue;
+			}
+			
+			if (source[i + 1] == '*')
+			{
+				i = std::min(source.find("*/", i + 2), source.size() - 1) + 1;
+				result += ' ';
+				continue;
+			}
+		}
+		
+		result += source[i];
+	}
+	
+	return result;
+}
+
+/**
+ * Reflects the uniforms declared in shader source.
+ *
+ * Uniforms are reflected from `uniform <type> <name>[<size>], ...;` declarations, regardless of whether they are active. Array sizes may be integer literals or integer-valued `#define` directives.
+ */
+void reflect_uniforms(std::string_view shader_source, std::vector<null_uniform>& uniforms)
+{
+	const std::string source = strip_comments(shader_source);
+	
+	std::size_t position = 0;
+	const auto skip_whitespace = [&]()
+	{
+		while (position < source.size() && std::isspace(static_cast<unsigned char>(source[position])))
+		{
+			++position;
+		}
+	};
+	const auto read_identifier = [&]() -> std::string_view
+	{
+		skip_whitespace();
+		const std::size_t begin = position;
+		while (position < source.size() && is_identifier_char(source[position]))
+		{
+			++position;
+		}
+		return std::string_view(source).substr(begin, position - begin);
+	};
+	
+	// Collect integer-valued macros, which may be used as array sizes
+	std::unordered_map<std::string_view, GLint> macros;
+	for (std::size_t i = source.find("#define"); i != std::string::npos; i = source.find("#define", i + 1))
+	{
+		position = i + 7;
+		const auto macro_name = read_identifier();
+		const auto macro_value = read_identifier();
+		
+		GLint value = 0;
+		if (std::from_chars(macro_value.data(), macro_value.data() + macro_value.size(), value).ec == std::errc{})
+		{
+			macros[macro_name] = value;
+		}
+	}
+	
+	for (std::size_t i = source.find("uniform"); i != std::string::npos; i = source.find("uniform", i + 1))
+	{
+		// Match whole word
+		if ((i && is_identifier_char(source[i - 1])) || (i + 7 < source.size() && is_identifier_char(source[i + 7])))
+		{
+			continue;
+		}
+		
+		position = i + 7;
+		
+		// Read type, skipping precision qualifiers
+		auto type_name = read_identifier();
+		while (type_name == "lowp" || type_name == "mediump" || type_name == "highp")
+		{
+			type_name = read_identifier();
+		}
+		
+		// Skip uniform blocks and unsupported types
+		const auto type = uniform_type_map.find(type_name);
+		if (type == uniform_type_map.end())
+		{
+			continue;
+		}
+		
+		// Read declarators
+		while (position < source.size())
+		{
+			const auto name = read_identifier();
+			if (name.empty())
+			{
+				break;
+			}
+			
+			GLint size = 1;
+			skip_whitespace();
+			if (position < source.size() && source[position] == '[')
+			{
+				++position;
+				const auto size_token = read_identifier();
+				if (std::from_chars(size_token.data(), size_token.data() + size_token.size(), size).ec != std::errc{})
+				{
+					const auto macro = macros.find(size_token);
+					size = (macro != macros.end()) ? macro->second : 1;
+				}
+				size = std::max(size, 1);
+				
+				position = std::min(source.find(']', position), source.size());
+				++position;
+				skip_whitespace();
+			}
+			
+			if (std::find_if(uniforms.begin(), uniforms.end(), [name](const auto& uniform){return uniform.name == name;}) == uniforms.end())
+			{
+				uniforms.push_back({std::string(name), size, type->second});
+			}
+			
+			if (position >= source.size() || source[position] != ',')
+			{
+				break;
+			}
+			++position;
+		}
+	}
+}
+
+/// Generates object names.
+void generate_names(GLsizei n, GLuint* names)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		names[i] = context.next_name++;
+	}
+}
+
+/// Records a state change.
+void record_state_change()
+{
+	++context.statistics.state_change_count;
+}
+
+/// Records a shader uniform update.
+void record_uniform_update()
+{
+	++context.statistics.uniform_update_count;
+}
+
+/// Records a texture upload.
+void record_texture_upload()
+{
+	++context.statistics.texture_upload_count;
+}
+
+/// Writes a string to an output buffer of fixed size.
+void write_string(std::string_view string, GLsizei buffer_size, GLsizei* length, GLchar* buffer)
+{
+	GLsizei count = 0;
+	if (buffer && buffer_size > 0)
+	{
+		count = static_cast<GLsizei>(std::min(string.size(), static_cast<std::size_t>(buffer_size - 1)));
+		std::memcpy(buffer, string.data(), static_cast<std::size_t>(count));
+		buffer[count] = '\0';
+	}
+	
+	if (length)
+	{
+		*length = count;
+	}
+}
+
+/// Returns the initial value of an integer state variable, writing multiple values where necessary.
+void get_integer(GLenum pname, GLint* data)
+{
+	switch (pname)
+	{
+		case GL_VIEWPORT:
+		case GL_SCISSOR_BOX:
+			data[0] = 0;
+			data[1] = 0;
+			data[2] = context.default_framebuffer_width;
+			data[3] = context.default_framebuffer_height;
+			break;
+		
+		case GL_POLYGON_MODE:
+			*data = GL_FILL;
+			break;
+		case GL_CULL_FACE_MODE:
+			*data = GL_BACK;
+			break;
+		case GL_FRONT_FACE:
+			*data = GL_CCW;
+			break;
+		case GL_PROVOKING_VERTEX:
+			*data = GL_LAST_VERTEX_CONVENTION;
+			break;
+		case GL_DEPTH_FUNC:
+			*data = GL_LESS;
+			break;
+		
+		case GL_STENCIL_FAIL:
+		case GL_STENCIL_PASS_DEPTH_PASS:
+		case GL_STENCIL_PASS_DEPTH_FAIL:
+		case GL_STENCIL_BACK_FAIL:
+		case GL_STENCIL_BACK_PASS_DEPTH_PASS:
+		case GL_STENCIL_BACK_PASS_DEPTH_FAIL:
+			*data = GL_KEEP;
+			break;
+		case GL_STENCIL_FUNC:
+		case GL_STENCIL_BACK_FUNC:
+			*data = GL_ALWAYS;
+			break;
+		case GL_STENCIL_VALUE_MASK:
+		case GL_STENCIL_WRITEMASK:
+		case GL_STENCIL_BACK_VALUE_MASK:
+		case GL_STENCIL_BACK_WRITEMASK:
+			*data = -1;
+			break;
+		
+		case GL_LOGIC_OP_MODE:
+			*data = GL_COPY;
+			break;
+		case GL_BLEND_SRC_RGB:
+		case GL_BLEND_SRC_ALPHA:
+			*data = GL_ONE;
+			break;
+		case GL_BLEND_DST_RGB:
+		case GL_BLEND_DST_ALPHA:
+			*data = GL_ZERO;
+			break;
+		case GL_BLEND_EQUATION_RGB:
+		case GL_BLEND_EQUATION_ALPHA:
+			*data = GL_FUNC_ADD;
+			break;
+		
+		case GL_NUM_EXTENSIONS:
+			*data = 1;
+			break;
+		case GL_MAJOR_VERSION:
+			*data = 4;
+			break;
+		case GL_MINOR_VERSION:
+			*data = 6;
+			break;
+		case GL_MAX_VIEWPORTS:
+			*data = 16;
+			break;
+		case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+			*data = 256;
+			break;
+		
+		default:
+			*data = 0;
+			break;
+	}
+}
+
+/// Returns the initial value of a floating-point state variable, writing multiple values where necessary.
+void get_float(GLenum pname, GLfloat* data)
+{
+	switch (pname)
+	{
+		case GL_DEPTH_RANGE:
+			data[0] = 0.0f;
+			data[1] = 1.0f;
+			break;
+		
+		case GL_BLEND_COLOR:
+		case GL_COLOR_CLEAR_VALUE:
+			std::fill_n(data, 4, 0.0f);
+			break;
+		
+		case GL_POINT_SIZE:
+		case GL_LINE_WIDTH:
+		case GL_DEPTH_CLEAR_VALUE:
+			*data = 1.0f;
+			break;
+		
+		case GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT:
+			*data = 16.0f;
+			break;
+		
+		default:
+		{
+			GLint value = 0;
+			get_integer(pname, &value);
+			*data = static_cast<GLfloat>(value);
+			break;
+		}
+	}
+}
+
+/// Returns the initial value of a boolean state variable, writing multiple values where necessary.
+void get_boolean(GLenum pname, GLboolean* data)
+{
+	switch (pname)
+	{
+		case GL_COLOR_WRITEMASK:
+			std::fill_n(data, 4, static_cast<GLboolean>(GL_TRUE));
+			break;
+		
+		case GL_DEPTH_WRITEMASK:
+			*data = GL_TRUE;
+			break;
+		
+		default:
+		{
+			GLint value = 0;
+			get_integer(pname, &value);
+			*data = value ? GL_TRUE : GL_FALSE;
+			break;
+		}
+	}
+}
+
+/// Returns the value of a shader program parameter.
+void get_program(GLuint program, GLenum pname, GLint* params)
+{
+	const auto uniforms = context.program_uniforms.find(program);
+	
+	switch (pname)
+	{
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS:
+			*params = GL_TRUE;
+			break;
+		
+		case GL_ACTIVE_UNIFORMS:
+			*params = (uniforms != context.program_uniforms.end()) ? static_cast<GLint>(uniforms->second.size()) : 0;
+			break;
+		
+		case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+			*params = 0;
+			if (uniforms != context.program_uniforms.end())
+			{
+				for (const auto& uniform: uniforms->second)
+				{
+					// Account for array suffix and null terminator
+					*params = std::max(*params, static_cast<GLint>(uniform.name.size() + (uniform.size > 1 ? 3 : 0) + 1));
+				}
+			}
+			break;
+		
+		default:
+			*params = 0;
+			break;
+	}
+}
+
+/// Links a shader program, reflecting the uniforms of its attached shaders.
+void link_program(GLuint program)
+{
+	auto& uniforms = context.program_uniforms[program];
+	uniforms.clear();
+	
+	if (auto shaders = context.program_shaders.find(program); shaders != context.program_shaders.end())
+	{
+		for (const auto shader: shaders->second)
+		{
+			if (auto source = context.shader_sources.find(shader); source != context.shader_sources.end())
+			{
+				reflect_uniforms(source->second, uniforms);
+			}
+		}
+	}
+	
+	++context.statistics.shader_program_link_count;
+}
+
+/// Returns the name of an active uniform.
+void get_active_uniform(GLuint program, GLuint index, GLsizei buffer_size, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+	const auto uniforms = context.program_uniforms.find(program);
+	if (uniforms == context.program_uniforms.end() || index >= uniforms->second.size())
+	{
+		write_string({}, buffer_size, length, name);
+		return;
+	}
+	
+	const auto& uniform = uniforms->second[index];
+	*size = uniform.size;
+	*type = uniform.type;
+	write_string(uniform.size > 1 ? uniform.name + "[0]" : uniform.name, buffer_size, length, name);
+}
+
+/// Returns the location of a uniform, which is its index.
+[[nodiscard]] GLint get_uniform_location(GLuint program, const GLchar* name)
+{
+	const auto uniforms = context.program_uniforms.find(program);
+	if (uniforms == context.program_uniforms.end())
+	{
+		return -1;
+	}
+	
+	// Strip array notation
+	std::string_view base_name = name;
+	base_name = base_name.substr(0, base_name.find('['));
+	
+	const auto uniform = std::find_if
+	(
+		uniforms->second.begin(),
+		uniforms->second.end(),
+		[base_name](const auto& uniform)
+		{
+			return uniform.name == base_name;
+		}
+	);
+	
+	return (uniform != uniforms->second.end()) ? static_cast<GLint>(uniform - uniforms->second.begin()) : -1;
+}
+
+/// Returns a null backend implementation of an OpenGL function, checking its signature against its function pointer type.
+template <class T>
+[[nodiscard]] inline std::pair<std::string_view, GLADapiproc> make_entry(std::string_view name, T function) noexcept
+{
+	return {name, reinterpret_cast<GLADapiproc>(function)};
+}
+
+/// Returns the OpenGL functions of the null backend.
+[[nodiscard]] const std::unordered_map<std::string_view, GLADapiproc>& get_functions()
+{
+	static const std::unordered_map<std::string_view, GLADapiproc> functions =
+	{
+		// Queries
+		make_entry<PFNGLGETSTRINGPROC>("glGetString", [](GLenum name) -> const GLubyte*
+		{
+			switch (name)
+			{
+				case GL_VENDOR:
+					return reinterpret_cast<const GLubyte*>("Antkeeper");
+				case GL_RENDERER:
+					return reinterpret_cast<const GLubyte*>("Null");
+				case GL_VERSION:
+					return reinterpret_cast<const GLubyte*>("4.6.0 Null");
+				case GL_SHADING_LANGUAGE_VERSION:
+					return reinterpret_cast<const GLubyte*>("4.60 Null");
+				default:
+					return nullptr;
+			}
+		}),
+		make_entry<PFNGLGETSTRINGIPROC>("glGetStringi", [](GLenum name, GLuint index) -> const GLubyte*
+		{
+			return (name == GL_EXTENSIONS && index == 0) ? reinterpret_cast<const GLubyte*>("GL_EXT_texture_filter_anisotropic") : nullptr;
+		}),
+		make_entry<PFNGLGETINTEGERVPROC>("glGetIntegerv", [](GLenum pname, GLint* data){get_integer(pname, data);}),
+		make_entry<PFNGLGETFLOATVPROC>("glGetFloatv", [](GLenum pname, GLfloat* data){get_float(pname, data);}),
+		make_entry<PFNGLGETBOOLEANVPROC>("glGetBooleanv", [](GLenum pname, GLboolean* data){get_boolean(pname, data);}),
+		make_entry<PFNGLISENABLEDPROC>("glIsEnabled", [](GLenum) -> GLboolean {return GL_FALSE;}),
+		make_entry<PFNGLDEBUGMESSAGECALLBACKPROC>("glDebugMessageCallback", [](GLDEBUGPROC, const void*){}),
+		make_entry<PFNGLPIXELSTOREIPROC>("glPixelStorei", [](GLenum, GLint){}),
+		make_entry<PFNGLCLIPCONTROLPROC>("glClipControl", [](GLenum, GLenum){record_state_change();}),
+		
+		// Rasterization, depth-stencil, and color blend state
+		make_entry<PFNGLENABLEPROC>("glEnable", [](GLenum){record_state_change();}),
+		make_entry<PFNGLDISABLEPROC>("glDisable", [](GLenum){record_state_change();}),
+		make_entry<PFNGLVIEWPORTPROC>("glViewport", [](GLint, GLint, GLsizei, GLsizei){record_state_change();}),
+		make_entry<PFNGLDEPTHRANGEPROC>("glDepthRange", [](GLdouble, GLdouble){record_state_change();}),
+		make_entry<PFNGLSCISSORPROC>("glScissor", [](GLint, GLint, GLsizei, GLsizei){record_state_change();}),
+		make_entry<PFNGLPOLYGONMODEPROC>("glPolygonMode", [](GLenum, GLenum){record_state_change();}),
+		make_entry<PFNGLCULLFACEPROC>("glCullFace", [](GLenum){record_state_change();}),
+		make_entry<PFNGLFRONTFACEPROC>("glFrontFace", [](GLenum){record_state_change();}),
+		make_entry<PFNGLPOLYGONOFFSETPROC>("glPolygonOffset", [](GLfloat, GLfloat){record_state_change();}),
+		make_entry<PFNGLPROVOKINGVERTEXPROC>("glProvokingVertex", [](GLenum){record_state_change();}),
+		make_entry<PFNGLPOINTSIZEPROC>("glPointSize", [](GLfloat){record_state_change();}),
+		make_entry<PFNGLLINEWIDTHPROC>("glLineWidth", [](GLfloat){record_state_change();}),
+		make_entry<PFNGLDEPTHFUNCPROC>("glDepthFunc", [](GLenum){record_state_change();}),
+		make_entry<PFNGLDEPTHMASKPROC>("glDepthMask", [](GLboolean){record_state_change();}),
+		make_entry<PFNGLSTENCILOPSEPARATEPROC>("glStencilOpSeparate", [](GLenum, GLenum, GLenum, GLenum){record_state_change();}),
+		make_entry<PFNGLSTENCILFUNCSEPARATEPROC>("glStencilFuncSeparate", [](GLenum, GLenum, GLint, GLuint){record_state_change();}),
+		make_entry<PFNGLSTENCILMASKSEPARATEPROC>("glStencilMaskSeparate", [](GLenum, GLuint){record_state_change();}),
+		make_entry<PFNGLLOGICOPPROC>("glLogicOp", [](GLenum){record_state_change();}),
+		make_entry<PFNGLBLENDFUNCSEPARATEPROC>("glBlendFuncSeparate", [](GLenum, GLenum, GLenum, GLenum){record_state_change();}),
+		make_entry<PFNGLBLENDEQUATIONSEPARATEPROC>("glBlendEquationSeparate", [](GLenum, GLenum){record_state_change();}),
+		make_entry<PFNGLCOLORMASKPROC>("glColorMask", [](GLboolean, GLboolean, GLboolean, GLboolean){record_state_change();}),
+		make_entry<PFNGLBLENDCOLORPROC>("glBlendColor", [](GLfloat, GLfloat, GLfloat, GLfloat){record_state_change();}),
+		
+		// Bindings
+		make_entry<PFNGLBINDFRAMEBUFFERPROC>("glBindFramebuffer", [](GLenum, GLuint)
+		{
+			record_state_change();
+			++context.statistics.framebuffer_bind_count;
+		}),
+		make_entry<PFNGLUSEPROGRAMPROC>("glUseProgram", [](GLuint)
+		{
+			record_state_change();
+			++context.statistics.shader_program_bind_count;
+		}),
+		make_entry<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray", [](GLuint)
+		{
+			record_state_change();
+			++context.statistics.vertex_array_bind_count;
+		}),
+		make_entry<PFNGLBINDTEXTUREUNITPROC>("glBindTextureUnit", [](GLuint, GLuint)
+		{
+			record_state_change();
+			++context.statistics.texture_bind_count;
+		}),
+		make_entry<PFNGLBINDSAMPLERPROC>("glBindSampler", [](GLuint, GLuint){record_state_change();}),
+		make_entry<PFNGLVERTEXARRAYVERTEXBUFFERPROC>("glVertexArrayVertexBuffer", [](GLuint, GLuint, GLuint, GLintptr, GLsizei){record_state_change();}),
+		make_entry<PFNGLBINDBUFFERRANGEPROC>("glBindBufferRange", [](GLenum, GLuint, GLuint, GLintptr, GLsizeiptr){record_state_change();}),
+		
+		// Drawing
+		make_entry<PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC>("glDrawArraysInstancedBaseInstance", [](GLenum, GLint, GLsizei count, GLsizei instance_count, GLuint)
+		{
+			++context.statistics.draw_count;
+			context.statistics.vertex_count += static_cast<std::uint64_t>(count) * static_cast<std::uint64_t>(instance_count);
+			context.statistics.instance_count += static_cast<std::uint64_t>(instance_count);
+		}),
+		make_entry<PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC>("glDrawElementsInstancedBaseInstance", [](GLenum, GLsizei count, GLenum, const void*, GLsizei instance_count, GLuint)
+		{
+			++context.statistics.draw_count;
+			context.statistics.vertex_count += static_cast<std::uint64_t>(count) * static_cast<std::uint64_t>(instance_count);
+			context.statistics.instance_count += static_cast<std::uint64_t>(instance_count);
+		}),
+		
+		// Clear
+		make_entry<PFNGLCLEARPROC>("glClear", [](GLbitfield){++context.statistics.clear_count;}),
+		make_entry<PFNGLCLEARCOLORPROC>("glClearColor", [](GLfloat, GLfloat, GLfloat, GLfloat){record_state_change();}),
+		make_entry<PFNGLCLEARDEPTHPROC>("glClearDepth", [](GLdouble){record_state_change();}),
+		make_entry<PFNGLCLEARSTENCILPROC>("glClearStencil", [](GLint){record_state_change();}),
+		
+		// Buffers
+		make_entry<PFNGLCREATEBUFFERSPROC>("glCreateBuffers", [](GLsizei n, GLuint* buffers){generate_names(n, buffers);}),
+		make_entry<PFNGLDELETEBUFFERSPROC>("glDeleteBuffers", [](GLsizei n, const GLuint* buffers)
+		{
+			for (GLsizei i = 0; i < n; ++i)
+			{
+				context.buffer_storage.erase(buffers[i]);
+			}
+		}),
+		make_entry<PFNGLNAMEDBUFFERDATAPROC>("glNamedBufferData", [](GLuint, GLsizeiptr size, const void*, GLenum)
+		{
+			++context.statistics.buffer_upload_count;
+			context.statistics.buffer_upload_size += static_cast<std::uint64_t>(size);
+		}),
+		make_entry<PFNGLNAMEDBUFFERSUBDATAPROC>("glNamedBufferSubData", [](GLuint, GLintptr, GLsizeiptr size, const void*)
+		{
+			++context.statistics.buffer_upload_count;
+			context.statistics.buffer_upload_size += static_cast<std::uint64_t>(size);
+		}),
+		make_entry<PFNGLNAMEDBUFFERSTORAGEPROC>("glNamedBufferStorage", [](GLuint buffer, GLsizeiptr size, const void* data, GLbitfield)
+		{
+			// Persistently-mapped buffers need real storage
+			auto& storage = context.buffer_storage[buffer];
+			storage.assign(static_cast<std::size_t>(size), std::byte{0});
+			if (data)
+			{
+				std::memcpy(storage.data(), data, storage.size());
+				++context.statistics.buffer_upload_count;
+				context.statistics.buffer_upload_size += static_cast<std::uint64_t>(size);
+			}
+		}),
+		make_entry<PFNGLMAPNAMEDBUFFERRANGEPROC>("glMapNamedBufferRange", [](GLuint buffer, GLintptr offset, GLsizeiptr, GLbitfield) -> void*
+		{
+			if (auto it = context.buffer_storage.find(buffer); it != context.buffer_storage.end())
+			{
+				return it->second.data() + offset;
+			}
+			return nullptr;
+		}),
+		make_entry<PFNGLUNMAPNAMEDBUFFERPROC>("glUnmapNamedBuffer", [](GLuint) -> GLboolean {return GL_TRUE;}),
+		make_entry<PFNGLCOPYNAMEDBUFFERSUBDATAPROC>("glCopyNamedBufferSubData", [](GLuint, GLuint, GLintptr, GLintptr, GLsizeiptr){}),
+		make_entry<PFNGLGETNAMEDBUFFERSUBDATAPROC>("glGetNamedBufferSubData", [](GLuint, GLintptr, GLsizeiptr size, void* data)
+		{
+			std::memset(data, 0, static_cast<std::size_t>(size));
+		}),
+		
+		// Sync objects
+		make_entry<PFNGLFENCESYNCPROC>("glFenceSync", [](GLenum, GLbitfield) -> GLsync
+		{
+			++context.statistics.fence_count;
+			return reinterpret_cast<GLsync>(context.next_sync++);
+		}),
+		make_entry<PFNGLCLIENTWAITSYNCPROC>("glClientWaitSync", [](GLsync sync, GLbitfield, GLuint64 timeout) -> GLenum
+		{
+			// Fences are signaled in the order they were created
+			const auto name = reinterpret_cast<std::uintptr_t>(sync);
+			if (context.auto_signal_fences || name <= context.signaled_sync)
+			{
+				return GL_ALREADY_SIGNALED;
+			}
+			if (!timeout)
+			{
+				return GL_TIMEOUT_EXPIRED;
+			}
+			
+			// Waiting for an unsignaled fence signals it
+			++context.statistics.fence_wait_count;
+			context.signaled_sync = name;
+			return GL_CONDITION_SATISFIED;
+		}),
+		make_entry<PFNGLDELETESYNCPROC>("glDeleteSync", [](GLsync){}),
+		
+		// Vertex arrays
+		make_entry<PFNGLCREATEVERTEXARRAYSPROC>("glCreateVertexArrays", [](GLsizei n, GLuint* arrays){generate_names(n, arrays);}),
+		make_entry<PFNGLDELETEVERTEXARRAYSPROC>("glDeleteVertexArrays", [](GLsizei, const GLuint*){}),
+		make_entry<PFNGLENABLEVERTEXARRAYATTRIBPROC>("glEnableVertexArrayAttrib", [](GLuint, GLuint){}),
+		make_entry<PFNGLVERTEXARRAYATTRIBBINDINGPROC>("glVertexArrayAttribBinding", [](GLuint, GLuint, GLuint){}),
+		make_entry<PFNGLVERTEXARRAYATTRIBFORMATPROC>("glVertexArrayAttribFormat", [](GLuint, GLuint, GLint, GLenum, GLboolean, GLuint){}),
+		make_entry<PFNGLVERTEXARRAYATTRIBIFORMATPROC>("glVertexArrayAttribIFormat", [](GLuint, GLuint, GLint, GLenum, GLuint){}),
+		make_entry<PFNGLVERTEXARRAYATTRIBLFORMATPROC>("glVertexArrayAttribLFormat", [](GLuint, GLuint, GLint, GLenum, GLuint){}),
+		make_entry<PFNGLVERTEXARRAYBINDINGDIVISORPROC>("glVertexArrayBindingDivisor", [](GLuint, GLuint, GLuint){}),
+		
+		// Framebuffers
+		make_entry<PFNGLCREATEFRAMEBUFFERSPROC>("glCreateFramebuffers", [](GLsizei n, GLuint* framebuffers){generate_names(n, framebuffers);}),
+		make_entry<PFNGLDELETEFRAMEBUFFERSPROC>("glDeleteFramebuffers", [](GLsizei, const GLuint*){}),
+		make_entry<PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC>("glCheckNamedFramebufferStatus", [](GLuint, GLenum) -> GLenum {return GL_FRAMEBUFFER_COMPLETE;}),
+		make_entry<PFNGLNAMEDFRAMEBUFFERDRAWBUFFERPROC>("glNamedFramebufferDrawBuffer", [](GLuint, GLenum){}),
+		make_entry<PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC>("glNamedFramebufferDrawBuffers", [](GLuint, GLsizei, const GLenum*){}),
+		make_entry<PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC>("glNamedFramebufferReadBuffer", [](GLuint, GLenum){}),
+		make_entry<PFNGLNAMEDFRAMEBUFFERTEXTUREPROC>("glNamedFramebufferTexture", [](GLuint, GLenum, GLuint, GLint){}),
+		make_entry<PFNGLREADBUFFERPROC>("glReadBuffer", [](GLenum){}),
+		make_entry<PFNGLREADPIXELSPROC>("glReadPixels", [](GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*){}),
+		
+		// Textures and samplers
+		make_entry<PFNGLCREATETEXTURESPROC>("glCreateTextures", [](GLenum, GLsizei n, GLuint* textures){generate_names(n, textures);}),
+		make_entry<PFNGLGENTEXTURESPROC>("glGenTextures", [](GLsizei n, GLuint* textures){generate_names(n, textures);}),
+		make_entry<PFNGLDELETETEXTURESPROC>("glDeleteTextures", [](GLsizei, const GLuint*){}),
+		make_entry<PFNGLTEXTUREVIEWPROC>("glTextureView", [](GLuint, GLenum, GLuint, GLenum, GLuint, GLuint, GLuint, GLuint){}),
+		make_entry<PFNGLTEXTURESTORAGE1DPROC>("glTextureStorage1D", [](GLuint, GLsizei, GLenum, GLsizei){}),
+		make_entry<PFNGLTEXTURESTORAGE2DPROC>("glTextureStorage2D", [](GLuint, GLsizei, GLenum, GLsizei, GLsizei){}),
+		make_entry<PFNGLTEXTURESTORAGE3DPROC>("glTextureStorage3D", [](GLuint, GLsizei, GLenum, GLsizei, GLsizei, GLsizei){}),
+		make_entry<PFNGLTEXTURESUBIMAGE1DPROC>("glTextureSubImage1D", [](GLuint, GLint, GLint, GLsizei, GLenum, GLenum, const void*){record_texture_upload();}),
+		make_entry<PFNGLTEXTURESUBIMAGE2DPROC>("glTextureSubImage2D", [](GLuint, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*){record_texture_upload();}),
+		make_entry<PFNGLTEXTURESUBIMAGE3DPROC>("glTextureSubImage3D", [](GLuint, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const void*){record_texture_upload();}),
+		make_entry<PFNGLGETTEXTURESUBIMAGEPROC>("glGetTextureSubImage", [](GLuint, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, GLsizei buffer_size, void* pixels)
+		{
+			std::memset(pixels, 0, static_cast<std::size_t>(buffer_size));
+		}),
+		make_entry<PFNGLGENERATETEXTUREMIPMAPPROC>("glGenerateTextureMipmap", [](GLuint){}),
+		make_entry<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData", [](GLuint, GLenum, GLint, GLint, GLint, GLint, GLuint, GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei){}),
+		make_entry<PFNGLCREATESAMPLERSPROC>("glCreateSamplers", [](GLsizei n, GLuint* samplers){generate_names(n, samplers);}),
+		make_entry<PFNGLDELETESAMPLERSPROC>("glDeleteSamplers", [](GLsizei, const GLuint*){}),
+		make_entry<PFNGLSAMPLERPARAMETERIPROC>("glSamplerParameteri", [](GLuint, GLenum, GLint){}),
+		make_entry<PFNGLSAMPLERPARAMETERFPROC>("glSamplerParameterf", [](GLuint, GLenum, GLfloat){}),
+		make_entry<PFNGLSAMPLERPARAMETERFVPROC>("glSamplerParameterfv", [](GLuint, GLenum, const GLfloat*){}),
+		
+		// Shaders
+		make_entry<PFNGLCREATESHADERPROC>("glCreateShader", [](GLenum) -> GLuint {return context.next_name++;}),
+		make_entry<PFNGLDELETESHADERPROC>("glDeleteShader", [](GLuint shader){context.shader_sources.erase(shader);}),
+		make_entry<PFNGLISSHADERPROC>("glIsShader", [](GLuint) -> GLboolean {return GL_TRUE;}),
+		make_entry<PFNGLSHADERSOURCEPROC>("glShaderSource", [](GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+		{
+			auto& source = context.shader_sources[shader];
+			source.clear();
+			for (GLsizei i = 0; i < count; ++i)
+			{
+				if (lengths && lengths[i] >= 0)
+				{
+					source.append(strings[i], static_cast<std::size_t>(lengths[i]));
+				}
+				else
+				{
+					source.append(strings[i]);
+				}
+			}
+		}),
+		make_entry<PFNGLCOMPILESHADERPROC>("glCompileShader", [](GLuint){}),
+		make_entry<PFNGLGETSHADERIVPROC>("glGetShaderiv", [](GLuint, GLenum pname, GLint* params)
+		{
+			*params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+		}),
+		make_entry<PFNGLGETSHADERINFOLOGPROC>("glGetShaderInfoLog", [](GLuint, GLsizei buffer_size, GLsizei* length, GLchar* info_log){write_string({}, buffer_size, length, info_log);}),
+		
+		// Shader programs
+		make_entry<PFNGLCREATEPROGRAMPROC>("glCreateProgram", []() -> GLuint {return context.next_name++;}),
+		make_entry<PFNGLDELETEPROGRAMPROC>("glDeleteProgram", [](GLuint program)
+		{
+			context.program_shaders.erase(program);
+			context.program_uniforms.erase(program);
+		}),
+		make_entry<PFNGLISPROGRAMPROC>("glIsProgram", [](GLuint) -> GLboolean {return GL_TRUE;}),
+		make_entry<PFNGLATTACHSHADERPROC>("glAttachShader", [](GLuint program, GLuint shader){context.program_shaders[program].emplace_back(shader);}),
+		make_entry<PFNGLDETACHSHADERPROC>("glDetachShader", [](GLuint program, GLuint shader)
+		{
+			if (auto shaders = context.program_shaders.find(program); shaders != context.program_shaders.end())
+			{
+				std::erase(shaders->second, shader);
+			}
+		}),
+		make_entry<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri", [](GLuint, GLenum, GLint){}),
+		make_entry<PFNGLLINKPROGRAMPROC>("glLinkProgram", [](GLuint program){link_program(program);}),
+		make_entry<PFNGLGETPROGRAMIVPROC>("glGetProgramiv", [](GLuint program, GLenum pname, GLint* params){get_program(program, pname, params);}),
+		make_entry<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog", [](GLuint, GLsizei buffer_size, GLsizei* length, GLchar* info_log){write_string({}, buffer_size, length, info_log);}),
+		make_entry<PFNGLPROGRAMBINARYPROC>("glProgramBinary", [](GLuint program, GLenum, const void*, GLsizei){link_program(program);}),
+		make_entry<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary", [](GLuint, GLsizei, GLsizei* length, GLenum* binary_format, void*)
+		{
+			if (length)
+			{
+				*length = 0;
+			}
+			*binary_format = 0;
+		}),
+		make_entry<PFNGLGETACTIVEUNIFORMPROC>("glGetActiveUniform", [](GLuint program, GLuint index, GLsizei buffer_size, GLsizei* length, GLint* size, GLenum* type, GLchar* name){get_active_uniform(program, index, buffer_size, length, size, type, name);}),
+		make_entry<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation", [](GLuint program, const GLchar* name) -> GLint {return get_uniform_location(program, name);}),
+		
+		// Uniforms
+		make_entry<PFNGLUNIFORM1FPROC>("glUniform1f", [](GLint, GLfloat){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM1IPROC>("glUniform1i", [](GLint, GLint){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM2IPROC>("glUniform2i", [](GLint, GLint, GLint){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM3IPROC>("glUniform3i", [](GLint, GLint, GLint, GLint){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM4IPROC>("glUniform4i", [](GLint, GLint, GLint, GLint, GLint){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM1UIPROC>("glUniform1ui", [](GLint, GLuint){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM1FVPROC>("glUniform1fv", [](GLint, GLsizei, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM2FVPROC>("glUniform2fv", [](GLint, GLsizei, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM3FVPROC>("glUniform3fv", [](GLint, GLsizei, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM4FVPROC>("glUniform4fv", [](GLint, GLsizei, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM1IVPROC>("glUniform1iv", [](GLint, GLsizei, const GLint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM2IVPROC>("glUniform2iv", [](GLint, GLsizei, const GLint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM3IVPROC>("glUniform3iv", [](GLint, GLsizei, const GLint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM4IVPROC>("glUniform4iv", [](GLint, GLsizei, const GLint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM1UIVPROC>("glUniform1uiv", [](GLint, GLsizei, const GLuint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM2UIVPROC>("glUniform2uiv", [](GLint, GLsizei, const GLuint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM3UIVPROC>("glUniform3uiv", [](GLint, GLsizei, const GLuint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORM4UIVPROC>("glUniform4uiv", [](GLint, GLsizei, const GLuint*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORMMATRIX2FVPROC>("glUniformMatrix2fv", [](GLint, GLsizei, GLboolean, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORMMATRIX3FVPROC>("glUniformMatrix3fv", [](GLint, GLsizei, GLboolean, const GLfloat*){record_uniform_update();}),
+		make_entry<PFNGLUNIFORMMATRIX4FVPROC>("glUniformMatrix4fv", [](GLint, GLsizei, GLboolean, const GLfloat*){record_uniform_update();})
+	};
+	
+	return functions;
+}
+
+/// Loads a null backend OpenGL function.
+GLADapiproc load_function(const char* name)
+{
+	const auto& functions = get_functions();
+	if (auto i = functions.find(name); i != functions.end())
+	{
+		return i->second;
+	}
+	
+	return nullptr;
+}
+
+} // namespace
+
+bool load_null_backend(std::uint32_t width, std::uint32_t height)
+{
+	context = {};
+	context.default_framebuffer_width = static_cast<GLint>(width);
+	context.default_framebuffer_height = static_cast<GLint>(height);
+	
+	return gladLoadGL(load_function) != 0;
+}
+
+const null_backend_statistics& get_null_backend_statistics() noexcept
+{
+	return context.statistics;
+}
+
+void reset_null_backend_statistics() noexcept
+{
+	context.statistics = {};
+}
+
+void set_null_backend_auto_signal_fences(bool signal) noexcept
+{
+	context.auto_signal_fences = signal;
+}
+
+void signal_null_backend_fences() noexcept
+{
+	context.signaled_sync = context.next_sync - 1;
+}
+
+} // namespace gl
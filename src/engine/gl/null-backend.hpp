@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_NULL_BACKEND_HPP
+#define ANTKEEPER_GL_NULL_BACKEND_HPP
+
+#include <engine/gl/null-backend-statistics.hpp>
+#include <cstdint>
+
+namespace gl {
+
+/**
+ * Loads a null OpenGL backend in place of a graphics context.
+ *
+ * The null backend loads OpenGL functions which record state changes, uploads, and draw calls, but never reach a graphics driver, such that gl::pipeline, GL objects, and the renderer can run headless. Object names are generated, shaders always compile and link, and the uniforms of linked shader programs are reflected from the declarations in their shader source. Queried pipeline state is the initial OpenGL state.
+ *
+ * The null backend is intended for measuring the CPU cost of rendering, for example:
+ *
+ * @code{.cpp}
+ * gl::load_null_backend(1920, 1080);
+ * gl::pipeline pipeline;
+ * render::renderer renderer(pipeline, resource_manager);
+ * // ...
+ * gl::reset_null_backend_statistics();
+ * renderer.render(t, dt, alpha, collection);
+ * const auto& statistics = gl::get_null_backend_statistics();
+ * @endcode
+ *
+ * @param width Width of the default framebuffer.
+ * @param height Height of the default framebuffer.
+ *
+ * @return `true` if the null backend was loaded, `false` otherwise.
+ *
+ * @warning Loading the null backend replaces any OpenGL functions which were previously loaded.
+ */
+[[nodiscard]] bool load_null_backend(std::uint32_t width, std::uint32_t height);
+
+/// Returns the commands recorded by the null backend since it was loaded or its statistics were last reset.
+[[nodiscard]] const null_backend_statistics& get_null_backend_statistics() noexcept;
+
+/// Resets the commands recorded by the null backend.
+void reset_null_backend_statistics() noexcept;
+
+/**
+ * Sets whether the null backend signals fences as soon as they're created, which is the default.
+ *
+ * If disabled, fences are signaled in the order they were created, either by signal_null_backend_fences() or when waited upon with a nonzero timeout, which simulates a GPU that lags behind the CPU. Polling an unsignaled fence reports a timeout.
+ *
+ * @param signal `true` if fences should be signaled when created, `false` otherwise.
+ */
+void set_null_backend_auto_signal_fences(bool signal) noexcept;
+
+/// Signals all fences which have been created by the null backend.
+void signal_null_backend_fences() noexcept;
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_NULL_BACKEND_HPP
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_PIPELINE_STATISTICS_HPP
+#define ANTKEEPER_GL_PIPELINE_STATISTICS_HPP
+
+#include <cstdint>
+
+namespace gl {
+
+/**
+ * Cumulative counts of the commands issued through a graphics pipeline.
+ *
+ * Redundant commands are commands which were filtered by the pipeline, as they would not have changed its state.
+ */
+struct pipeline_statistics
+{
+	/// Number of draw calls.
+	std::uint64_t draw_count{};
+	
+	/// Total number of vertices or indices drawn, multiplied by the number of instances of each draw call.
+	std::uint64_t vertex_count{};
+	
+	/// Total number of instances drawn.
+	std::uint64_t instance_count{};
+	
+	/// Number of attachment clears.
+	std::uint64_t clear_count{};
+	
+	/// Number of framebuffer bindings.
+	std::uint64_t framebuffer_bind_count{};
+	
+	/// Number of redundant framebuffer bindings.
+	std::uint64_t redundant_framebuffer_bind_count{};
+	
+	/// Number of shader program bindings.
+	std::uint64_t shader_program_bind_count{};
+	
+	/// Number of redundant shader program bindings.
+	std::uint64_t redundant_shader_program_bind_count{};
+	
+	/// Number of vertex array bindings.
+	std::uint64_t vertex_array_bind_count{};
+	
+	/// Number of vertex buffer bindings.
+	std::uint64_t vertex_buffer_bind_count{};
+	
+	/// Number of uniform buffer bindings.
+	std::uint64_t uniform_buffer_bind_count{};
+	
+	/// Number of fixed-function state changes.
+	std::uint64_t state_change_count{};
+	
+	/// Number of redundant fixed-function state changes.
+	std::uint64_t redundant_state_change_count{};
+};
+
+/**
+ * Subtracts two sets of pipeline statistics, giving the commands issued between them.
+ *
+ * @param a Later pipeline statistics.
+ * @param b Earlier pipeline statistics.
+ *
+ * @return Commands issued after @p b, up to and including @p a.
+ */
+[[nodiscard]] constexpr pipeline_statistics operator-(const pipeline_statistics& a, const pipeline_statistics& b) noexcept
+{
+	return
+	{
+		a.draw_count - b.draw_count,
+		a.vertex_count - b.vertex_count,
+		a.instance_count - b.instance_count,
+		a.clear_count - b.clear_count,
+		a.framebuffer_bind_count - b.framebuffer_bind_count,
+		a.redundant_framebuffer_bind_count - b.redundant_framebuffer_bind_count,
+		a.shader_program_bind_count - b.shader_program_bind_count,
+		a.redundant_shader_program_bind_count - b.redundant_shader_program_bind_count,
+		a.vertex_array_bind_count - b.vertex_array_bind_count,
+		a.vertex_buffer_bind_count - b.vertex_buffer_bind_count,
+		a.uniform_buffer_bind_count - b.uniform_buffer_bind_count,
+		a.state_change_count - b.state_change_count,
+		a.redundant_state_change_count - b.redundant_state_change_count
+	};
+}
+
+/**
+ * Adds two sets of pipeline statistics.
+ *
+ * @param a First pipeline statistics.
+ * @param b Second pipeline statistics.
+ *
+ * @return Sum of @p a and @p b.
+ */
+[[nodiscard]] constexpr pipeline_statistics operator+(const pipeline_statistics& a, const pipeline_statistics& b) noexcept
+{
+	return
+	{
+		a.draw_count + b.draw_count,
+		a.vertex_count + b.vertex_count,
+		a.instance_count + b.instance_count,
+		a.clear_count + b.clear_count,
+		a.framebuffer_bind_count + b.framebuffer_bind_count,
+		a.redundant_framebuffer_bind_count + b.redundant_framebuffer_bind_count,
+		a.shader_program_bind_count + b.shader_program_bind_count,
+		a.redundant_shader_program_bind_count + b.redundant_shader_program_bind_count,
+		a.vertex_array_bind_count + b.vertex_array_bind_count,
+		a.vertex_buffer_bind_count + b.vertex_buffer_bind_count,
+		a.uniform_buffer_bind_count + b.uniform_buffer_bind_count,
+		a.state_change_count + b.state_change_count,
+		a.redundant_state_change_count + b.redundant_state_change_count
+	};
+}
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_PIPELINE_STATISTICS_HPP
@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <stdexcept>
 #include <bit>
+#include <format>
+#include <string>
 #include <stacktrace>
 
 namespace {
@@ -220,6 +222,20 @@ pipeline::pipeline()
 	
 	// Fetch limitations
 	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &m_max_sampler_anisotropy);
+	GLint gl_uniform_buffer_offset_alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &gl_uniform_buffer_offset_alignment);
+	if (gl_uniform_buffer_offset_alignment > 0)
+	{
+		m_uniform_buffer_offset_alignment = static_cast<std::size_t>(gl_uniform_buffer_offset_alignment);
+	}
+	
+	// Construct shader cache, keyed by the driver vendor, renderer, and version
+	const auto gl_string = [](GLenum name) -> std::string
+	{
+		const auto value = reinterpret_cast<const char*>(glGetString(name));
+		return value ? value : "";
+	};
+	m_shader_cache = std::make_unique<shader_cache>(std::format("{}\n{}\n{}", gl_string(GL_VENDOR), gl_string(GL_RENDERER), gl_string(GL_VERSION)));
 	
 	// Fetch dimensions of default framebuffer
 	GLint gl_scissor_box[4] = {0, 0, 0, 0};
@@ -264,12 +280,22 @@ void pipeline::bind_framebuffer(const gl::framebuffer* framebuffer)
 		{
 			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->m_gl_named_framebuffer);
 			m_bound_gl_named_framebuffer = framebuffer->m_gl_named_framebuffer;
+			++m_statistics.framebuffer_bind_count;
+		}
+		else
+		{
+			++m_statistics.redundant_framebuffer_bind_count;
 		}
 	}
 	else if (m_bound_gl_named_framebuffer)
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		m_bound_gl_named_framebuffer = 0;
+		++m_statistics.framebuffer_bind_count;
+	}
+	else
+	{
+		++m_statistics.redundant_framebuffer_bind_count;
 	}
 }
 
@@ -281,12 +307,22 @@ void pipeline::bind_shader_program(const gl::shader_program* shader_program)
 		{
 			glUseProgram(shader_program->m_gl_program_id);
 			m_bound_gl_program_id = shader_program->m_gl_program_id;
+			++m_statistics.shader_program_bind_count;
+		}
+		else
+		{
+			++m_statistics.redundant_shader_program_bind_count;
 		}
 	}
 	else if (m_bound_gl_program_id)
 	{
 		glUseProgram(0);
 		m_bound_gl_program_id = 0;
+		++m_statistics.shader_program_bind_count;
+	}
+	else
+	{
+		++m_statistics.redundant_shader_program_bind_count;
 	}
 }
 
@@ -294,6 +330,7 @@ void pipeline::bind_vertex_array(const vertex_array* array)
 {
 	m_bound_gl_named_array = array ? array->m_gl_named_array : 0;
 	glBindVertexArray(m_bound_gl_named_array);
+	++m_statistics.vertex_array_bind_count;
 	
 	/// @bug
 	/// 
@@ -346,6 +383,35 @@ void pipeline::bind_vertex_buffers(std::uint32_t first_binding, std::span<const
 			static_cast<GLsizei>(strides[i])
 		);
 	}
+	
+	m_statistics.vertex_buffer_bind_count += buffers.size();
+}
+
+void pipeline::bind_uniform_buffers(std::uint32_t first_binding, std::span<const vertex_buffer* const> buffers, std::span<const std::size_t> offsets, std::span<const std::size_t> sizes)
+{
+	if (offsets.size() < buffers.size())
+	{
+		throw std::out_of_range("Uniform buffer binding offset out of range.");
+	}
+	
+	if (sizes.size() < buffers.size())
+	{
+		throw std::out_of_range("Uniform buffer binding size out of range.");
+	}
+	
+	for (std::size_t i = 0; i < buffers.size(); ++i)
+	{
+		glBindBufferRange
+		(
+			GL_UNIFORM_BUFFER,
+			static_cast<GLuint>(first_binding + i),
+			buffers[i]->m_gl_named_buffer,
+			static_cast<GLintptr>(offsets[i]),
+			static_cast<GLsizeiptr>(sizes[i])
+		);
+	}
+	
+	m_statistics.uniform_buffer_bind_count += buffers.size();
 }
 
 void pipeline::set_primitive_topology(primitive_topology topology)
@@ -360,6 +426,8 @@ void pipeline::set_primitive_restart_enabled(bool enabled)
 {
 	if (m_input_assembly_state.primitive_restart_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		if (enabled)
 		{
 			glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
@@ -371,6 +439,10 @@ void pipeline::set_primitive_restart_enabled(bool enabled)
 		
 		m_input_assembly_state.primitive_restart_enabled = enabled;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_viewport(std::uint32_t first_viewport, std::span<const gl::viewport> viewports)
@@ -389,6 +461,7 @@ void pipeline::set_viewport(std::uint32_t first_viewport, std::span<const gl::vi
 	
 	const auto& active_viewport = m_viewport_state.viewports.front();
 	const auto& viewport = viewports.front();
+	bool viewport_updated = false;
 	
 	// Update viewport position and dimensions
 	if (active_viewport.width != viewport.width ||
@@ -396,6 +469,8 @@ void pipeline::set_viewport(std::uint32_t first_viewport, std::span<const gl::vi
 		active_viewport.x != viewport.x ||
 		active_viewport.y != viewport.y)
 	{
+		viewport_updated = true;
+		
 		glViewport
 		(
 			static_cast<GLint>(viewport.x),
@@ -409,9 +484,20 @@ void pipeline::set_viewport(std::uint32_t first_viewport, std::span<const gl::vi
 	if (active_viewport.min_depth != viewport.min_depth ||
 		active_viewport.max_depth != viewport.max_depth)
 	{
+		viewport_updated = true;
+		
 		glDepthRange(viewport.min_depth, viewport.max_depth);
 	}
 	
+	if (viewport_updated)
+	{
+		++m_statistics.state_change_count;
+	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
+	
 	// Update viewport state
 	std::copy(viewports.begin(), viewports.end(), m_viewport_state.viewports.begin() + first_viewport);
 }
@@ -439,6 +525,8 @@ void pipeline::set_scissor(std::uint32_t first_scissor, std::span<const gl::scis
 		active_scissor.x != scissor.x ||
 		active_scissor.y != scissor.y)
 	{
+		++m_statistics.state_change_count;
+		
 		glScissor
 		(
 			static_cast<GLint>(scissor.x),
@@ -447,6 +535,10 @@ void pipeline::set_scissor(std::uint32_t first_scissor, std::span<const gl::scis
 			std::max(0, static_cast<GLsizei>(scissor.height))
 		);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 	
 	// Update viewport state
 	std::copy(scissors.begin(), scissors.end(), m_viewport_state.scissors.begin() + first_scissor);
@@ -456,6 +548,8 @@ void pipeline::set_rasterizer_discard_enabled(bool enabled)
 {
 	if (m_rasterization_state.rasterizer_discard_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		if (enabled)
 		{
 			glEnable(GL_RASTERIZER_DISCARD);
@@ -467,12 +561,18 @@ void pipeline::set_rasterizer_discard_enabled(bool enabled)
 		
 		m_rasterization_state.rasterizer_discard_enabled = enabled;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_fill_mode(fill_mode mode)
 {
 	if (m_rasterization_state.fill_mode != mode)
 	{
+		++m_statistics.state_change_count;
+		
 		switch (mode)
 		{
 			case fill_mode::fill:
@@ -493,12 +593,18 @@ void pipeline::set_fill_mode(fill_mode mode)
 		
 		m_rasterization_state.fill_mode = mode;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_cull_mode(cull_mode mode)
 {
 	if (m_rasterization_state.cull_mode != mode)
 	{
+		++m_statistics.state_change_count;
+		
 		if (mode == cull_mode::none)
 		{
 			glDisable(GL_CULL_FACE);
@@ -533,22 +639,34 @@ void pipeline::set_cull_mode(cull_mode mode)
 		
 		m_rasterization_state.cull_mode = mode;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_front_face(front_face face)
 {
 	if (m_rasterization_state.front_face != face)
 	{
+		++m_statistics.state_change_count;
+		
 		glFrontFace(face == front_face::counter_clockwise ? GL_CCW : GL_CW);
 		
 		m_rasterization_state.front_face = face;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_bias_enabled(bool enabled)
 {
 	if (m_rasterization_state.depth_bias_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		if (enabled)
 		{
 			glEnable(GL_POLYGON_OFFSET_FILL);
@@ -564,6 +682,10 @@ void pipeline::set_depth_bias_enabled(bool enabled)
 		
 		m_rasterization_state.depth_bias_enabled = enabled;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_bias_factors(float constant_factor, float slope_factor)
@@ -572,17 +694,25 @@ void pipeline::set_depth_bias_factors(float constant_factor, float slope_factor)
 	if (m_rasterization_state.depth_bias_constant_factor != constant_factor ||
 		m_rasterization_state.depth_bias_slope_factor != slope_factor)
 	{
+		++m_statistics.state_change_count;
+		
 		glPolygonOffset(slope_factor, constant_factor);
 		
 		m_rasterization_state.depth_bias_constant_factor = constant_factor;
 		m_rasterization_state.depth_bias_slope_factor = slope_factor;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_clamp_enabled(bool enabled)
 {
 	if (m_rasterization_state.depth_clamp_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		if (enabled)
 		{
 			glEnable(GL_DEPTH_CLAMP);
@@ -594,12 +724,18 @@ void pipeline::set_depth_clamp_enabled(bool enabled)
 		
 		m_rasterization_state.depth_clamp_enabled = enabled;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_scissor_test_enabled(bool enabled)
 {
 	if (m_rasterization_state.scissor_test_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		if (enabled)
 		{
 			glEnable(GL_SCISSOR_TEST);
@@ -611,42 +747,66 @@ void pipeline::set_scissor_test_enabled(bool enabled)
 		
 		m_rasterization_state.scissor_test_enabled = enabled;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_provoking_vertex_mode(provoking_vertex_mode mode)
 {
 	if (m_rasterization_state.provoking_vertex_mode != mode)
 	{
+		++m_statistics.state_change_count;
+		
 		const auto gl_provoking_vertex_mode = provoking_vertex_mode_lut[std::to_underlying(mode)];
 		glProvokingVertex(gl_provoking_vertex_mode);
 		m_rasterization_state.provoking_vertex_mode = mode;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_point_size(float size)
 {
 	if (m_rasterization_state.point_size != size)
 	{
+		++m_statistics.state_change_count;
+		
 		glPointSize(size);
 		
 		m_rasterization_state.point_size = size;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_line_width(float width)
 {
 	if (m_rasterization_state.line_width != width)
 	{
+		++m_statistics.state_change_count;
+		
 		glLineWidth(width);
 		
 		m_rasterization_state.line_width = width;
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_test_enabled(bool enabled)
 {
 	if (m_depth_stencil_state.depth_test_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		m_depth_stencil_state.depth_test_enabled = enabled;
 		
 		if (enabled)
@@ -658,31 +818,49 @@ void pipeline::set_depth_test_enabled(bool enabled)
 			glDisable(GL_DEPTH_TEST);
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_write_enabled(bool enabled)
 {
 	if (m_depth_stencil_state.depth_write_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		m_depth_stencil_state.depth_write_enabled = enabled;
 		glDepthMask(enabled);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_depth_compare_op(gl::compare_op compare_op)
 {
 	if (m_depth_stencil_state.depth_compare_op != compare_op)
 	{
+		++m_statistics.state_change_count;
+		
 		m_depth_stencil_state.depth_compare_op = compare_op;
 		const auto gl_compare_op = compare_op_lut[std::to_underlying(compare_op)];
 		glDepthFunc(gl_compare_op);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_stencil_test_enabled(bool enabled)
 {
 	if (m_depth_stencil_state.stencil_test_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		m_depth_stencil_state.stencil_test_enabled = enabled;
 		
 		if (enabled)
@@ -694,6 +872,10 @@ void pipeline::set_stencil_test_enabled(bool enabled)
 			glDisable(GL_STENCIL_TEST);
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_stencil_op(std::uint8_t face_mask, stencil_op fail_op, stencil_op pass_op, stencil_op depth_fail_op, gl::compare_op compare_op)
@@ -741,6 +923,8 @@ void pipeline::set_stencil_op(std::uint8_t face_mask, stencil_op fail_op, stenci
 	
 	if (stencil_op_updated || compare_op_updated)
 	{
+		++m_statistics.state_change_count;
+		
 		const auto gl_face = stencil_face_lut[face_mask];
 		
 		if (stencil_op_updated)
@@ -778,6 +962,10 @@ void pipeline::set_stencil_op(std::uint8_t face_mask, stencil_op fail_op, stenci
 			}
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_stencil_compare_mask(std::uint8_t face_mask, std::uint32_t compare_mask)
@@ -804,6 +992,8 @@ void pipeline::set_stencil_compare_mask(std::uint8_t face_mask, std::uint32_t co
 	
 	if (compare_mask_updated)
 	{
+		++m_statistics.state_change_count;
+		
 		const auto gl_face = stencil_face_lut[face_mask];
 		
 		if (face_mask == stencil_face_front_and_back)
@@ -833,6 +1023,10 @@ void pipeline::set_stencil_compare_mask(std::uint8_t face_mask, std::uint32_t co
 			glStencilFuncSeparate(gl_face, gl_compare_op, std::bit_cast<GLint>(m_depth_stencil_state.stencil_back.reference), std::bit_cast<GLuint>(compare_mask));
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_stencil_reference(std::uint8_t face_mask, std::uint32_t reference)
@@ -859,6 +1053,8 @@ void pipeline::set_stencil_reference(std::uint8_t face_mask, std::uint32_t refer
 	
 	if (reference_updated)
 	{
+		++m_statistics.state_change_count;
+		
 		const auto gl_face = stencil_face_lut[face_mask];
 		
 		if (face_mask == stencil_face_front_and_back)
@@ -888,6 +1084,10 @@ void pipeline::set_stencil_reference(std::uint8_t face_mask, std::uint32_t refer
 			glStencilFuncSeparate(gl_face, gl_compare_op, std::bit_cast<GLint>(reference), std::bit_cast<GLuint>(m_depth_stencil_state.stencil_back.compare_mask));
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_stencil_write_mask(std::uint8_t face_mask, std::uint32_t write_mask)
@@ -914,15 +1114,23 @@ void pipeline::set_stencil_write_mask(std::uint8_t face_mask, std::uint32_t writ
 	
 	if (write_mask_updated)
 	{
+		++m_statistics.state_change_count;
+		
 		const auto gl_face = stencil_face_lut[face_mask];
 		glStencilMaskSeparate(gl_face, std::bit_cast<GLuint>(write_mask));
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_logic_op_enabled(bool enabled)
 {
 	if (m_color_blend_state.logic_op_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		m_color_blend_state.logic_op_enabled = enabled;
 		
 		if (enabled)
@@ -934,23 +1142,35 @@ void pipeline::set_logic_op_enabled(bool enabled)
 			glDisable(GL_COLOR_LOGIC_OP);
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_logic_op(gl::logic_op logic_op)
 {
 	if (m_color_blend_state.logic_op != logic_op)
 	{
+		++m_statistics.state_change_count;
+		
 		m_color_blend_state.logic_op = logic_op;
 		
 		const auto gl_logic_op = logic_op_lut[std::to_underlying(logic_op)];
 		glLogicOp(gl_logic_op);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_color_blend_enabled(bool enabled)
 {
 	if (m_color_blend_state.blend_enabled != enabled)
 	{
+		++m_statistics.state_change_count;
+		
 		m_color_blend_state.blend_enabled = enabled;
 		
 		if (enabled)
@@ -962,10 +1182,16 @@ void pipeline::set_color_blend_enabled(bool enabled)
 			glDisable(GL_BLEND);
 		}
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_color_blend_equation(const color_blend_equation& equation)
 {
+	bool equation_updated = false;
+	
 	if (m_color_blend_state.color_blend_equation.src_color_blend_factor != equation.src_color_blend_factor ||
 		m_color_blend_state.color_blend_equation.dst_color_blend_factor != equation.dst_color_blend_factor ||
 		m_color_blend_state.color_blend_equation.src_alpha_blend_factor != equation.src_alpha_blend_factor ||
@@ -982,6 +1208,7 @@ void pipeline::set_color_blend_equation(const color_blend_equation& equation)
 		const auto gl_dst_alpha = blend_factor_lut[std::to_underlying(equation.dst_alpha_blend_factor)];
 		
 		glBlendFuncSeparate(gl_src_rgb, gl_dst_rgb, gl_src_alpha, gl_dst_alpha);
+		equation_updated = true;
 	}
 	
 	if (m_color_blend_state.color_blend_equation.color_blend_op != equation.color_blend_op ||
@@ -994,6 +1221,16 @@ void pipeline::set_color_blend_equation(const color_blend_equation& equation)
 		const auto gl_mode_alpha = blend_op_lut[std::to_underlying(equation.alpha_blend_op)];
 		
 		glBlendEquationSeparate(gl_mode_rgb, gl_mode_alpha);
+		equation_updated = true;
+	}
+	
+	if (equation_updated)
+	{
+		++m_statistics.state_change_count;
+	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
 	}
 }
 
@@ -1001,6 +1238,8 @@ void pipeline::set_color_write_mask(std::uint8_t mask)
 {
 	if (m_color_blend_state.color_write_mask != mask)
 	{
+		++m_statistics.state_change_count;
+		
 		m_color_blend_state.color_write_mask = mask;
 		
 		glColorMask
@@ -1011,19 +1250,33 @@ void pipeline::set_color_write_mask(std::uint8_t mask)
 			mask & color_component_a_bit
 		);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::set_blend_constants(const std::array<float, 4>& blend_constants)
 {
 	if (m_color_blend_state.blend_constants != blend_constants)
 	{
+		++m_statistics.state_change_count;
+		
 		m_color_blend_state.blend_constants = blend_constants;
 		glBlendColor(blend_constants[0], blend_constants[1], blend_constants[2], blend_constants[3]);
 	}
+	else
+	{
+		++m_statistics.redundant_state_change_count;
+	}
 }
 
 void pipeline::draw(std::uint32_t vertex_count, std::uint32_t instance_count, std::uint32_t first_vertex, std::uint32_t first_instance)
 {
+	++m_statistics.draw_count;
+	m_statistics.vertex_count += static_cast<std::uint64_t>(vertex_count) * instance_count;
+	m_statistics.instance_count += instance_count;
+	
 	glDrawArraysInstancedBaseInstance
 	(
 		primitive_topology_lut[std::to_underlying(m_input_assembly_state.topology)],
@@ -1036,6 +1289,10 @@ void pipeline::draw(std::uint32_t vertex_count, std::uint32_t instance_count, st
 
 void pipeline::draw_indexed(std::uint32_t index_count, std::uint32_t instance_count, std::uint32_t first_index, [[maybe_unused]] std::int32_t vertex_offset, std::uint32_t first_instance)
 {
+	++m_statistics.draw_count;
+	m_statistics.vertex_count += static_cast<std::uint64_t>(index_count) * instance_count;
+	m_statistics.instance_count += instance_count;
+	
 	glDrawElementsInstancedBaseInstance
 	(
 		primitive_topology_lut[std::to_underlying(m_input_assembly_state.topology)],
@@ -1092,6 +1349,7 @@ void pipeline::clear_attachments(std::uint8_t mask, const clear_value& value)
 	
 	// Clear attachments
 	glClear(gl_clear_mask);
+	++m_statistics.clear_count;
 }
 
 void pipeline::defaut_framebuffer_resized(std::uint32_t width, std::uint32_t height) noexcept
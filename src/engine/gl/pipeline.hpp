@@ -10,15 +10,18 @@
 #include <engine/gl/pipeline-input-assembly-state.hpp>
 #include <engine/gl/pipeline-vertex-input-state.hpp>
 #include <engine/gl/pipeline-color-blend-state.hpp>
+#include <engine/gl/pipeline-statistics.hpp>
 #include <engine/gl/vertex-array.hpp>
 #include <engine/gl/vertex-buffer.hpp>
 #include <engine/gl/clear-value.hpp>
 #include <engine/gl/framebuffer.hpp>
 #include <engine/gl/shader-program.hpp>
+#include <engine/gl/shader-cache.hpp>
 #include <engine/gl/clear-bits.hpp>
 #include <engine/gl/stencil-face-bits.hpp>
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <span>
 
 namespace app { class sdl_window_manager; }
@@ -69,6 +72,26 @@ public:
 	
 	/// @}
 	
+	/// @name Uniform buffer state
+	/// @{
+	
+	/**
+	 * Binds ranges of buffers to uniform block binding points.
+	 *
+	 * @param first_binding Index of the first uniform block binding point.
+	 * @param buffers Sequence of buffers to bind.
+	 * @param offsets Sequence of byte offsets into each buffer. Offsets must be multiples of the uniform buffer offset alignment.
+	 * @param sizes Sequence of byte sizes of each buffer range.
+	 *
+	 * @exception std::out_of_range Uniform buffer binding offset out of range.
+	 * @exception std::out_of_range Uniform buffer binding size out of range.
+	 *
+	 * @see get_uniform_buffer_offset_alignment()
+	 */
+	void bind_uniform_buffers(std::uint32_t first_binding, std::span<const vertex_buffer* const> buffers, std::span<const std::size_t> offsets, std::span<const std::size_t> sizes);
+	
+	/// @}
+	
 	/// @name Input assembly state
 	/// @{
 	
@@ -381,8 +404,50 @@ public:
 		return m_max_sampler_anisotropy;
 	}
 	
+	/// Returns the required alignment of uniform buffer binding offsets, in bytes.
+	[[nodiscard]] inline constexpr std::size_t get_uniform_buffer_offset_alignment() const noexcept
+	{
+		return m_uniform_buffer_offset_alignment;
+	}
+	
 	/// @}
 	
+	/// @name Shader programs
+	/// @{
+	
+	/**
+	 * Returns the shader program binary cache of the pipeline, keyed by the identity of the graphics driver.
+	 *
+	 * @note Shader programs should be built through the shader cache rather than directly from shader templates.
+	 */
+	[[nodiscard]] inline shader_cache& get_shader_cache() noexcept
+	{
+		return *m_shader_cache;
+	}
+	
+	/// @}
+	
+	/// @name Statistics
+	/// @{
+	
+	/**
+	 * Returns the cumulative counts of the commands issued through the pipeline.
+	 *
+	 * @note Statistics accumulate until reset. The commands issued within a span of time, such as a frame or render pass, are the difference between the statistics at its start and end.
+	 */
+	[[nodiscard]] inline const pipeline_statistics& get_statistics() const noexcept
+	{
+		return m_statistics;
+	}
+	
+	/// Resets the pipeline statistics.
+	inline void reset_statistics() noexcept
+	{
+		m_statistics = {};
+	}
+	
+	/// @}
+
 private:
 	friend class app::sdl_window_manager;
 	
@@ -399,7 +464,9 @@ private:
 	
 	std::uint32_t m_max_viewports{1};
 	float m_max_sampler_anisotropy{0.0f};
+	std::size_t m_uniform_buffer_offset_alignment{256};
 	std::array<std::uint32_t, 2> m_default_framebuffer_dimensions{0, 0};
+	std::unique_ptr<shader_cache> m_shader_cache;
 	
 	pipeline_vertex_input_state m_vertex_input_state;
 	pipeline_input_assembly_state m_input_assembly_state;
@@ -408,6 +475,7 @@ private:
 	pipeline_depth_stencil_state m_depth_stencil_state;
 	pipeline_color_blend_state m_color_blend_state;
 	clear_value m_clear_value;
+	pipeline_statistics m_statistics;
 	
 	unsigned int m_bound_gl_named_framebuffer{};
 	unsigned int m_bound_gl_program_id{};
@@ -0,0 +1,323 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/gl/shader-cache.hpp>
+#include <engine/hash/fnv1a.hpp>
+#include <engine/debug/log.hpp>
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+namespace {
+
+/// Cache file signature.
+constexpr std::uint32_t cache_file_magic = 0x48535441; // "ATSH"
+
+/// Cache file format version.
+constexpr std::uint32_t cache_file_version = 1;
+
+/// Cache file extension.
+constexpr std::string_view cache_file_extension = ".bin";
+
+/// Header which precedes the binary data of a cache file.
+struct cache_file_header
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint64_t driver_hash;
+	std::uint64_t key;
+	std::uint32_t format;
+	std::uint32_t size;
+};
+
+} // namespace
+
+shader_cache::shader_cache(const std::string& driver_identity):
+	m_driver_identity(driver_identity),
+	m_driver_hash(hash::fnv1a64<char>(driver_identity))
+{}
+
+shader_cache::~shader_cache()
+{
+	wait();
+}
+
+void shader_cache::set_directory(const std::filesystem::path& directory)
+{
+	wait();
+	
+	{
+		std::lock_guard lock(m_binaries_mutex);
+		m_binaries.clear();
+	}
+	
+	m_directory = directory;
+	if (m_directory.empty())
+	{
+		return;
+	}
+	
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	if (error)
+	{
+		debug::log_error("Failed to create shader cache directory \"{}\": {}", m_directory.string(), error.message());
+		m_directory.clear();
+	}
+}
+
+void shader_cache::prewarm()
+{
+	if (m_directory.empty())
+	{
+		return;
+	}
+	
+	wait();
+	
+	m_prewarm_task = std::async
+	(
+		std::launch::async,
+		[this]()
+		{
+			std::size_t count = 0;
+			
+			std::error_code error;
+			for (const auto& entry: std::filesystem::directory_iterator(m_directory, error))
+			{
+				const auto& path = entry.path();
+				if (!entry.is_regular_file() || path.extension() != cache_file_extension)
+				{
+					continue;
+				}
+				
+				// Parse cache key from file name
+				const std::string stem = path.stem().string();
+				std::uint64_t key = 0;
+				if (const auto [ptr, ec] = std::from_chars(stem.data(), stem.data() + stem.size(), key, 16); ec != std::errc{} || ptr != stem.data() + stem.size())
+				{
+					continue;
+				}
+				
+				if (auto binary = read(path, key))
+				{
+					std::lock_guard lock(m_binaries_mutex);
+					m_binaries.try_emplace(key, std::move(*binary));
+					++count;
+				}
+			}
+			
+			debug::log_debug("Pre-warmed {} shader program binaries", count);
+		}
+	);
+}
+
+std::unique_ptr<shader_program> shader_cache::build(const shader_template& shader_template, const shader_template::dictionary_type& definitions)
+{
+	const std::uint64_t key = make_key(shader_template.hash(), definitions);
+	
+	// Load cached program binary
+	if (auto binary = load(key))
+	{
+		auto program = std::make_unique<shader_program>();
+		if (program->load_binary(*binary))
+		{
+			++m_hit_count;
+			return program;
+		}
+		
+		// Binary was rejected by the driver
+		debug::log_warning("Discarding rejected shader program binary {:016x}", key);
+		discard(key);
+	}
+	
+	++m_miss_count;
+	
+	// Compile and link shader template, then cache the program binary
+	auto program = shader_template.build(definitions);
+	if (program->linked() && !m_directory.empty())
+	{
+		store(key, program->get_binary());
+	}
+	
+	return program;
+}
+
+std::uint64_t shader_cache::make_key(std::size_t template_hash, const shader_template::dictionary_type& definitions) const
+{
+	// Sort definitions by key, such that the cache key is independent of their iteration order
+	std::vector<const shader_template::dictionary_type::value_type*> sorted_definitions;
+	sorted_definitions.reserve(definitions.size());
+	for (const auto& definition: definitions)
+	{
+		sorted_definitions.emplace_back(&definition);
+	}
+	std::sort
+	(
+		sorted_definitions.begin(),
+		sorted_definitions.end(),
+		[](const auto* a, const auto* b)
+		{
+			return a->first < b->first;
+		}
+	);
+	
+	// Hash template hash, driver hash, and definitions
+	std::string key_string = std::format("{:016x}{:016x}", static_cast<std::uint64_t>(template_hash), m_driver_hash);
+	for (const auto* definition: sorted_definitions)
+	{
+		key_string += '\n';
+		key_string += definition->first;
+		key_string += '=';
+		key_string += definition->second;
+	}
+	
+	return hash::fnv1a64<char>(key_string);
+}
+
+std::optional<shader_program_binary> shader_cache::load(std::uint64_t key)
+{
+	{
+		std::lock_guard lock(m_binaries_mutex);
+		if (auto node = m_binaries.extract(key))
+		{
+			return std::move(node.mapped());
+		}
+	}
+	
+	if (m_directory.empty())
+	{
+		return std::nullopt;
+	}
+	
+	const auto path = get_path(key);
+	if (!std::filesystem::exists(path))
+	{
+		return std::nullopt;
+	}
+	
+	auto binary = read(path, key);
+	if (!binary)
+	{
+		// Remove invalid or outdated cache file
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+	
+	return binary;
+}
+
+bool shader_cache::store(std::uint64_t key, const shader_program_binary& binary)
+{
+	if (m_directory.empty() || binary.data.empty())
+	{
+		return false;
+	}
+	
+	const cache_file_header header
+	{
+		cache_file_magic,
+		cache_file_version,
+		m_driver_hash,
+		key,
+		binary.format,
+		static_cast<std::uint32_t>(binary.data.size())
+	};
+	
+	// Write to a temporary file, then rename it, such that partially-written cache files are never read
+	const auto path = get_path(key);
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+	{
+		std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()));
+		if (!stream)
+		{
+			debug::log_error("Failed to write shader cache file \"{}\"", temporary_path.string());
+			return false;
+		}
+	}
+	
+	std::error_code error;
+	std::filesystem::rename(temporary_path, path, error);
+	if (error)
+	{
+		debug::log_error("Failed to write shader cache file \"{}\": {}", path.string(), error.message());
+		std::filesystem::remove(temporary_path, error);
+		return false;
+	}
+	
+	return true;
+}
+
+void shader_cache::discard(std::uint64_t key)
+{
+	{
+		std::lock_guard lock(m_binaries_mutex);
+		m_binaries.erase(key);
+	}
+	
+	if (!m_directory.empty())
+	{
+		std::error_code error;
+		std::filesystem::remove(get_path(key), error);
+	}
+}
+
+std::filesystem::path shader_cache::get_path(std::uint64_t key) const
+{
+	return m_directory / std::format("{:016x}{}", key, cache_file_extension);
+}
+
+std::optional<shader_program_binary> shader_cache::read(const std::filesystem::path& path, std::uint64_t key) const
+{
+	std::ifstream stream(path, std::ios::binary);
+	
+	// Read and validate header
+	cache_file_header header{};
+	if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != cache_file_magic ||
+		header.version != cache_file_version ||
+		header.driver_hash != m_driver_hash ||
+		header.key != key)
+	{
+		return std::nullopt;
+	}
+	
+	// Treat files whose size does not match the header as cache misses, rather than allocating a corrupt size
+	std::error_code error_code;
+	const auto file_size = std::filesystem::file_size(path, error_code);
+	if (error_code || file_size != sizeof(header) + std::uintmax_t{header.size})
+	{
+		return std::nullopt;
+	}
+	
+	// Read binary data
+	shader_program_binary binary;
+	binary.format = header.format;
+	binary.data.resize(header.size);
+	if (!stream.read(reinterpret_cast<char*>(binary.data.data()), static_cast<std::streamsize>(binary.data.size())) || stream.peek() != std::ifstream::traits_type::eof())
+	{
+		return std::nullopt;
+	}
+	
+	return binary;
+}
+
+void shader_cache::wait()
+{
+	if (m_prewarm_task.valid())
+	{
+		m_prewarm_task.wait();
+	}
+}
+
+} // namespace gl
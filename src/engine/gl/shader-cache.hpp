@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_SHADER_CACHE_HPP
+#define ANTKEEPER_GL_SHADER_CACHE_HPP
+
+#include <engine/gl/shader-program.hpp>
+#include <engine/gl/shader-program-binary.hpp>
+#include <engine/gl/shader-template.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace gl {
+
+/**
+ * Disk cache of linked shader program binaries.
+ *
+ * Shader programs are keyed by the hash of their shader template, their template definitions, and the identity of the graphics driver. When a shader program is built through the cache, a cached binary is loaded if one exists. Otherwise the shader template is compiled and linked, and the binary of the linked program is written to the cache directory. Cache files written by a different driver, and binaries rejected by the driver, are discarded.
+ *
+ * Only build() requires a graphics context. Keys, cache files, and pre-warming are independent of the graphics driver.
+ */
+class shader_cache
+{
+public:
+	/**
+	 * Constructs a shader cache.
+	 *
+	 * @param driver_identity String which identifies the graphics driver, such as its vendor, renderer, and version strings.
+	 */
+	explicit shader_cache(const std::string& driver_identity);
+	
+	/** Destructs a shader cache, waiting for pre-warming to finish. */
+	~shader_cache();
+	
+	shader_cache(const shader_cache&) = delete;
+	shader_cache(shader_cache&&) = delete;
+	shader_cache& operator=(const shader_cache&) = delete;
+	shader_cache& operator=(shader_cache&&) = delete;
+	
+	/**
+	 * Sets the directory in which cache files are stored, creating it if necessary.
+	 *
+	 * @param directory Path to the cache directory, or an empty path to disable the disk cache.
+	 */
+	void set_directory(const std::filesystem::path& directory);
+	
+	/**
+	 * Asynchronously reads all valid cache files in the cache directory into memory, such that programs which were built in previous sessions can be loaded without waiting for disk reads.
+	 *
+	 * @note Shader programs are still created on the calling thread of build(), as graphics contexts are bound to a single thread.
+	 */
+	void prewarm();
+	
+	/** Waits for pre-warming to finish, such that all pre-warmed binaries can be loaded from memory. */
+	void wait();
+	
+	/**
+	 * Builds a shader program from a shader template, loading a cached program binary if possible.
+	 *
+	 * @param shader_template Shader template from which to build the shader program.
+	 * @param definitions Container of definitions used to replace `#pragma define <key> <value>` directives.
+	 *
+	 * @return Linked shader program.
+	 *
+	 * @exception std::runtime_error Any exceptions thrown by gl::shader_template::build().
+	 */
+	[[nodiscard]] std::unique_ptr<shader_program> build(const shader_template& shader_template, const shader_template::dictionary_type& definitions = {});
+	
+	/**
+	 * Generates the cache key of a shader program.
+	 *
+	 * @param template_hash Hash of the shader template source code.
+	 * @param definitions Shader template definitions.
+	 *
+	 * @return 64-bit cache key, independent of the iteration order of @p definitions.
+	 */
+	[[nodiscard]] std::uint64_t make_key(std::size_t template_hash, const shader_template::dictionary_type& definitions) const;
+	
+	/**
+	 * Loads a cached shader program binary, from memory if it was pre-warmed, or from the cache directory otherwise.
+	 *
+	 * @param key Cache key.
+	 *
+	 * @return Cached shader program binary, or `std::nullopt` if the binary is not cached or its cache file is invalid.
+	 */
+	[[nodiscard]] std::optional<shader_program_binary> load(std::uint64_t key);
+	
+	/**
+	 * Writes a shader program binary to the cache directory.
+	 *
+	 * @param key Cache key.
+	 * @param binary Shader program binary.
+	 *
+	 * @return `true` if the binary was written, `false` otherwise.
+	 */
+	bool store(std::uint64_t key, const shader_program_binary& binary);
+	
+	/**
+	 * Removes a shader program binary from the cache.
+	 *
+	 * @param key Cache key.
+	 */
+	void discard(std::uint64_t key);
+	
+	/// Returns the cache directory.
+	[[nodiscard]] inline const std::filesystem::path& get_directory() const noexcept
+	{
+		return m_directory;
+	}
+	
+	/// Returns the string which identifies the graphics driver.
+	[[nodiscard]] inline const std::string& get_driver_identity() const noexcept
+	{
+		return m_driver_identity;
+	}
+	
+	/// Returns the number of shader programs which were loaded from cached binaries.
+	[[nodiscard]] inline std::size_t get_hit_count() const noexcept
+	{
+		return m_hit_count;
+	}
+	
+	/// Returns the number of shader programs which were compiled and linked from shader templates.
+	[[nodiscard]] inline std::size_t get_miss_count() const noexcept
+	{
+		return m_miss_count;
+	}
+
+private:
+	/// Returns the path to the cache file of a cache key.
+	[[nodiscard]] std::filesystem::path get_path(std::uint64_t key) const;
+	
+	/// Reads and validates a cache file.
+	[[nodiscard]] std::optional<shader_program_binary> read(const std::filesystem::path& path, std::uint64_t key) const;
+	
+	std::string m_driver_identity;
+	std::uint64_t m_driver_hash{0};
+	std::filesystem::path m_directory;
+	std::size_t m_hit_count{0};
+	std::size_t m_miss_count{0};
+	
+	/// Pre-warmed shader program binaries.
+	std::unordered_map<std::uint64_t, shader_program_binary> m_binaries;
+	std::mutex m_binaries_mutex;
+	std::future<void> m_prewarm_task;
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_SHADER_CACHE_HPP
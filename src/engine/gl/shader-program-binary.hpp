@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_SHADER_PROGRAM_BINARY_HPP
+#define ANTKEEPER_GL_SHADER_PROGRAM_BINARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+/**
+ * Driver-specific binary representation of a linked shader program.
+ */
+struct shader_program_binary
+{
+	/// Driver-specific binary format.
+	std::uint32_t format{0};
+	
+	/// Binary data.
+	std::vector<std::byte> data;
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_SHADER_PROGRAM_BINARY_HPP
@@ -106,6 +106,9 @@ bool shader_program::link()
 
 	debug::log_trace("Linking shader program {}...", m_gl_program_id);
 	
+	// Allow the linked program binary to be retrieved
+	glProgramParameteri(m_gl_program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	
 	// Link OpenGL shader program
 	glLinkProgram(m_gl_program_id);
 	
@@ -149,6 +152,61 @@ bool shader_program::link()
 	return m_linked;
 }
 
+bool shader_program::load_binary(const shader_program_binary& binary)
+{
+	m_linked = false;
+	m_info_log.clear();
+	m_variable_map.clear();
+	
+	// Check that the OpenGL shader program is valid
+	if (glIsProgram(m_gl_program_id) != GL_TRUE)
+	{
+		throw std::runtime_error("Invalid OpenGL shader program");
+	}
+	
+	// Load OpenGL shader program binary
+	glProgramBinary(m_gl_program_id, static_cast<GLenum>(binary.format), binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+	
+	// Get OpenGL shader program linking status, which is false if the binary was rejected
+	GLint gl_link_status;
+	glGetProgramiv(m_gl_program_id, GL_LINK_STATUS, &gl_link_status);
+	m_linked = (gl_link_status == GL_TRUE);
+	
+	if (m_linked)
+	{
+		// Load shader variables
+		load_variables();
+	}
+	
+	return m_linked;
+}
+
+shader_program_binary shader_program::get_binary() const
+{
+	shader_program_binary binary;
+	if (!m_linked)
+	{
+		return binary;
+	}
+	
+	// Get OpenGL shader program binary length
+	GLint gl_binary_length = 0;
+	glGetProgramiv(m_gl_program_id, GL_PROGRAM_BINARY_LENGTH, &gl_binary_length);
+	if (gl_binary_length <= 0)
+	{
+		return binary;
+	}
+	
+	// Read OpenGL shader program binary
+	GLenum gl_binary_format = 0;
+	binary.data.resize(static_cast<std::size_t>(gl_binary_length));
+	glGetProgramBinary(m_gl_program_id, gl_binary_length, &gl_binary_length, &gl_binary_format, binary.data.data());
+	binary.data.resize(static_cast<std::size_t>(gl_binary_length));
+	binary.format = static_cast<std::uint32_t>(gl_binary_format);
+	
+	return binary;
+}
+
 void shader_program::load_variables()
 {
 	m_variable_map.clear();
@@ -176,11 +234,11 @@ void shader_program::load_variables()
 		GLenum uniform_type;
 		glGetActiveUniform(m_gl_program_id, static_cast<GLuint>(uniform_index), static_cast<GLsizei>(max_uniform_name_length), &uniform_name_length, &uniform_size, &uniform_type, uniform_name.data());
 		
-		// Get uniform location
+		// Get uniform location, skipping members of uniform blocks, which have no location
 		const GLint uniform_location = glGetUniformLocation(m_gl_program_id, uniform_name.c_str());
 		if (uniform_location == -1)
 		{
-			throw std::runtime_error("Failed to get shader uniform location");
+			continue;
 		}
 		
 		// Get length of variable name by stripping array notation from uniform name
@@ -264,22 +322,30 @@ void shader_program::load_variables()
 			
 			case GL_SAMPLER_1D:
 			case GL_SAMPLER_1D_SHADOW:
+			case GL_INT_SAMPLER_1D:
+			case GL_UNSIGNED_INT_SAMPLER_1D:
 				variable = std::make_unique<const gl_shader_texture_1d>(variable_size, uniform_location, texture_index);
 				texture_index += uniform_size;
 				break;
 			
 			case GL_SAMPLER_2D:
 			case GL_SAMPLER_2D_SHADOW:
+			case GL_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_2D:
 				variable = std::make_unique<const gl_shader_texture_2d>(variable_size, uniform_location, texture_index);
 				texture_index += uniform_size;
 				break;
 			
 			case GL_SAMPLER_3D:
+			case GL_INT_SAMPLER_3D:
+			case GL_UNSIGNED_INT_SAMPLER_3D:
 				variable = std::make_unique<const gl_shader_texture_3d>(variable_size, uniform_location, texture_index);
 				texture_index += uniform_size;
 				break;
 			
 			case GL_SAMPLER_CUBE:
+			case GL_INT_SAMPLER_CUBE:
+			case GL_UNSIGNED_INT_SAMPLER_CUBE:
 				variable = std::make_unique<const gl_shader_texture_cube>(variable_size, uniform_location, texture_index);
 				texture_index += uniform_size;
 				break;
@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <memory>
 #include <engine/hash/fnv1a.hpp>
+#include <engine/gl/shader-program-binary.hpp>
 
 namespace gl {
 
@@ -90,6 +91,26 @@ public:
 	 */
 	bool link();
 	
+	/**
+	 * Replaces the shader program with a previously linked shader program binary.
+	 *
+	 * @param binary Shader program binary.
+	 *
+	 * @return `true` if the binary was accepted by the driver, `false` otherwise.
+	 *
+	 * @warning All existing of the shader program's variables will be invalidated.
+	 *
+	 * @see get_binary() const
+	 */
+	bool load_binary(const shader_program_binary& binary);
+	
+	/**
+	 * Returns the binary representation of the linked shader program.
+	 *
+	 * @return Shader program binary, or an empty binary if the shader program is not linked.
+	 */
+	[[nodiscard]] shader_program_binary get_binary() const;
+	
 	/// Returns `true` if the shader program has been successfully linked, `false` otherwise.
 	[[nodiscard]] inline bool linked() const noexcept
 	{
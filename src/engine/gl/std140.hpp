@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_STD140_HPP
+#define ANTKEEPER_GL_STD140_HPP
+
+#include <engine/math/vector.hpp>
+#include <engine/math/matrix.hpp>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace gl {
+
+/**
+ * std140 layout rules of the GLSL type which corresponds to a C++ type.
+ *
+ * @tparam T C++ type of a scalar, vector, or matrix uniform block member.
+ *
+ * @see OpenGL 4.6 Core Profile Specification, section 7.6.2.2, "Standard Uniform Block Layout".
+ */
+template <class T>
+struct std140_traits;
+
+/// @private
+template <>
+struct std140_traits<float>
+{
+	static constexpr std::size_t base_alignment = 4;
+	static constexpr std::size_t size = 4;
+};
+
+/// @private
+template <>
+struct std140_traits<int>
+{
+	static constexpr std::size_t base_alignment = 4;
+	static constexpr std::size_t size = 4;
+};
+
+/// @private
+template <>
+struct std140_traits<unsigned int>
+{
+	static constexpr std::size_t base_alignment = 4;
+	static constexpr std::size_t size = 4;
+};
+
+/// @private
+template <class T, std::size_t N>
+struct std140_traits<math::vector<T, N>>
+{
+	static_assert(N >= 2 && N <= 4);
+	
+	// Three-component vectors are aligned as four-component vectors
+	static constexpr std::size_t base_alignment = (N == 2 ? 2 : 4) * std140_traits<T>::size;
+	static constexpr std::size_t size = N * std140_traits<T>::size;
+};
+
+/// @private
+template <class T, std::size_t N, std::size_t M>
+struct std140_traits<math::matrix<T, N, M>>
+{
+	// Matrices are stored as arrays of column vectors, each padded to 16 bytes
+	static constexpr std::size_t base_alignment = 16;
+	static constexpr std::size_t size = N * 16;
+};
+
+/**
+ * Rounds an offset up to a multiple of an alignment.
+ *
+ * @param offset Offset, in bytes.
+ * @param alignment Alignment, in bytes.
+ *
+ * @return Aligned offset, in bytes.
+ */
+[[nodiscard]] inline constexpr std::size_t std140_align(std::size_t offset, std::size_t alignment) noexcept
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Returns the byte stride between consecutive elements of a std140 array.
+ *
+ * @tparam T Element type.
+ */
+template <class T>
+[[nodiscard]] inline constexpr std::size_t std140_array_stride() noexcept
+{
+	return std140_align(std140_traits<T>::size, 16);
+}
+
+/**
+ * Computes the byte offsets of consecutive members of a std140 uniform block.
+ *
+ * Members are appended in declaration order. Each call returns the offset of the appended member.
+ */
+class std140_layout
+{
+public:
+	/**
+	 * Appends a member to the block.
+	 *
+	 * @tparam T Member type.
+	 *
+	 * @return Offset of the member, in bytes.
+	 */
+	template <class T>
+	constexpr std::size_t append() noexcept
+	{
+		const std::size_t offset = std140_align(m_size, std140_traits<T>::base_alignment);
+		m_size = offset + std140_traits<T>::size;
+		return offset;
+	}
+	
+	/**
+	 * Appends an array member to the block.
+	 *
+	 * @tparam T Element type.
+	 *
+	 * @param count Number of array elements.
+	 *
+	 * @return Offset of the first array element, in bytes.
+	 */
+	template <class T>
+	constexpr std::size_t append_array(std::size_t count) noexcept
+	{
+		// Arrays are aligned to 16 bytes and padded to a multiple of 16 bytes
+		const std::size_t offset = std140_align(m_size, 16);
+		m_size = offset + std140_array_stride<T>() * count;
+		return offset;
+	}
+	
+	/// Returns the size of the block, in bytes, padded to a multiple of 16 bytes.
+	[[nodiscard]] inline constexpr std::size_t size() const noexcept
+	{
+		return std140_align(m_size, 16);
+	}
+
+private:
+	std::size_t m_size{0};
+};
+
+/**
+ * Writes a value into a std140 buffer.
+ *
+ * @tparam T Value type.
+ *
+ * @param buffer Buffer into which the value will be written.
+ * @param offset Offset into the buffer, in bytes, of the std140 member.
+ * @param value Value to write.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+template <class T>
+void std140_write(std::span<std::byte> buffer, std::size_t offset, const T& value)
+{
+	if (offset + std140_traits<T>::size > buffer.size())
+	{
+		throw std::out_of_range("std140 write operation exceeded buffer bounds.");
+	}
+	
+	if constexpr (requires {T::column_count;})
+	{
+		// Write matrix columns at 16-byte strides
+		for (std::size_t i = 0; i < T::column_count; ++i)
+		{
+			std::memcpy(buffer.data() + offset + i * 16, &value[i], sizeof(value[i]));
+		}
+	}
+	else
+	{
+		std::memcpy(buffer.data() + offset, &value, sizeof(value));
+	}
+}
+
+/**
+ * Writes a sequence of values into a std140 array.
+ *
+ * @tparam T Element type.
+ *
+ * @param buffer Buffer into which the values will be written.
+ * @param offset Offset into the buffer, in bytes, of the first element of the std140 array.
+ * @param values Values to write.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+template <class T>
+void std140_write_array(std::span<std::byte> buffer, std::size_t offset, std::span<const T> values)
+{
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		std140_write(buffer, offset + i * std140_array_stride<T>(), values[i]);
+	}
+}
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_STD140_HPP
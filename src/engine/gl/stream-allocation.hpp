@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_STREAM_ALLOCATION_HPP
+#define ANTKEEPER_GL_STREAM_ALLOCATION_HPP
+
+#include <cstddef>
+#include <span>
+
+namespace gl {
+
+class vertex_buffer;
+
+/**
+ * Range of a stream buffer allocated for the current frame.
+ *
+ * @see stream_buffer::allocate()
+ */
+struct stream_allocation
+{
+	/// Buffer in which the range was allocated. Valid until the end of the frame.
+	const vertex_buffer* buffer{nullptr};
+	
+	/// Offset into the buffer, in bytes, of the first byte of the range.
+	std::size_t offset{0};
+	
+	/// Mapped memory of the range, into which data should be written before it's used by the GL.
+	std::span<std::byte> data;
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_STREAM_ALLOCATION_HPP
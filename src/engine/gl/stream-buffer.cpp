@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/gl/stream-buffer.hpp>
+#include <engine/debug/log.hpp>
+#include <glad/gl.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace gl {
+
+namespace {
+
+/// Storage and mapping flags of stream buffers.
+constexpr GLbitfield stream_buffer_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+/// Duration of each wait for a frame fence, in nanoseconds.
+constexpr GLuint64 fence_timeout = 1000000000;
+
+/// Rounds a stream position up to a multiple of an alignment.
+[[nodiscard]] inline constexpr std::uint64_t align_position(std::uint64_t position, std::uint64_t alignment) noexcept
+{
+	return (position + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+stream_buffer::stream_buffer(std::size_t capacity):
+	m_capacity{std::bit_ceil(std::max<std::size_t>(capacity, 1))}
+{
+	create_buffer();
+}
+
+stream_buffer::~stream_buffer()
+{
+	for (const auto& fence: m_fences)
+	{
+		glDeleteSync(static_cast<GLsync>(fence.sync));
+	}
+}
+
+stream_allocation stream_buffer::allocate(std::size_t size, std::size_t alignment)
+{
+	alignment = std::max<std::size_t>(alignment, 1);
+	
+	// Grow the buffer if the allocation could never fit
+	if (size > m_capacity)
+	{
+		grow(size);
+	}
+	
+	// Align the allocation, wrapping around to the beginning of the buffer if it would cross the end
+	std::uint64_t position = align_position(m_head, alignment);
+	if ((position & (m_capacity - 1)) + size > m_capacity)
+	{
+		position = align_position(m_head, m_capacity);
+	}
+	
+	// Wait for the GL to finish reading previous frames which overlap the allocation
+	while (position + size > m_tail + m_capacity)
+	{
+		if (m_fences.empty())
+		{
+			if (m_head == m_frame_begin)
+			{
+				// No allocations are in use, so the frame can begin at the allocation
+				m_frame_begin = position;
+				m_tail = position;
+				break;
+			}
+			
+			// Allocations of the current frame exceed the capacity of the buffer
+			grow(m_capacity * 2);
+			return allocate(size, alignment);
+		}
+		
+		wait();
+	}
+	
+	m_head = position + size;
+	
+	const std::size_t offset = static_cast<std::size_t>(position & (m_capacity - 1));
+	return {m_buffer.get(), offset, {m_mapped_data + offset, size}};
+}
+
+stream_allocation stream_buffer::write(std::span<const std::byte> data, std::size_t alignment)
+{
+	const auto allocation = allocate(data.size(), alignment);
+	if (!data.empty())
+	{
+		std::memcpy(allocation.data.data(), data.data(), data.size());
+	}
+	
+	return allocation;
+}
+
+void stream_buffer::fence()
+{
+	// Fence the allocations of the current frame
+	if (m_head != m_frame_begin)
+	{
+		m_fences.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_head});
+		m_frame_begin = m_head;
+	}
+	
+	// Retire frames whose fences have been signaled, without waiting
+	while (!m_fences.empty())
+	{
+		const auto sync = static_cast<GLsync>(m_fences.front().sync);
+		const GLenum status = glClientWaitSync(sync, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			break;
+		}
+		
+		glDeleteSync(sync);
+		m_tail = m_fences.front().end;
+		m_fences.pop_front();
+	}
+	
+	// Replaced buffers are no longer referenced by render operations. The GL defers their deletion until it's done reading them.
+	m_replaced_buffers.clear();
+}
+
+void stream_buffer::create_buffer()
+{
+	// Replace the data store of an empty buffer with persistently-mappable immutable storage
+	m_buffer = std::make_unique<vertex_buffer>(buffer_usage::stream_draw, 0);
+	glNamedBufferStorage(m_buffer->m_gl_named_buffer, static_cast<GLsizeiptr>(m_capacity), nullptr, stream_buffer_flags);
+	m_buffer->m_size = m_capacity;
+	
+	m_mapped_data = static_cast<std::byte*>(glMapNamedBufferRange(m_buffer->m_gl_named_buffer, 0, static_cast<GLsizeiptr>(m_capacity), stream_buffer_flags));
+	if (!m_mapped_data)
+	{
+		throw std::runtime_error("Failed to map stream buffer.");
+	}
+}
+
+void stream_buffer::grow(std::size_t min_capacity)
+{
+	debug::log_debug("Growing stream buffer from {} to {} bytes", m_capacity, std::bit_ceil(std::max(m_capacity * 2, min_capacity)));
+	
+	// Keep the current buffer until the end of the frame, as render operations may reference it
+	m_replaced_buffers.emplace_back(std::move(m_buffer));
+	
+	// Fences of the replaced buffer are no longer needed
+	for (const auto& fence: m_fences)
+	{
+		glDeleteSync(static_cast<GLsync>(fence.sync));
+	}
+	m_fences.clear();
+	
+	m_capacity = std::bit_ceil(std::max(m_capacity * 2, min_capacity));
+	create_buffer();
+	
+	m_head = 0;
+	m_frame_begin = 0;
+	m_tail = 0;
+	++m_grow_count;
+}
+
+void stream_buffer::wait()
+{
+	const auto& fence = m_fences.front();
+	const auto sync = static_cast<GLsync>(fence.sync);
+	
+	GLenum status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, fence_timeout);
+	if (status != GL_ALREADY_SIGNALED)
+	{
+		++m_wait_count;
+	}
+	while (status == GL_TIMEOUT_EXPIRED)
+	{
+		status = glClientWaitSync(sync, 0, fence_timeout);
+	}
+	if (status == GL_WAIT_FAILED)
+	{
+		debug::log_error("Failed to wait for stream buffer fence");
+	}
+	
+	glDeleteSync(sync);
+	m_tail = fence.end;
+	m_fences.pop_front();
+}
+
+} // namespace gl
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_GL_STREAM_BUFFER_HPP
+#define ANTKEEPER_GL_STREAM_BUFFER_HPP
+
+#include <engine/gl/stream-allocation.hpp>
+#include <engine/gl/vertex-buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace gl {
+
+/**
+ * Persistently-mapped ring buffer from which transient vertex, instance, and uniform data is sub-allocated each frame.
+ *
+ * Allocations are placed one after another, wrapping around to the beginning of the buffer when the end is reached. A fence is inserted at the end of each frame, and memory written during a frame is only reused once the fence of that frame has been signaled, so data is never overwritten while the GL may still be reading it. If the allocations of a single frame exceed the capacity of the buffer, the buffer is replaced with one of twice the capacity.
+ *
+ * Data must be written into the mapped memory of an allocation before any commands which read the allocation are issued. Mapped memory is coherent, so no explicit flushes are necessary.
+ */
+class stream_buffer
+{
+public:
+	/**
+	 * Constructs a stream buffer.
+	 *
+	 * @param capacity Buffer size, in bytes. Rounded up to a power of two.
+	 *
+	 * @exception std::runtime_error Failed to map stream buffer.
+	 */
+	explicit stream_buffer(std::size_t capacity);
+	
+	/// Destructs a stream buffer, deleting any pending fences.
+	~stream_buffer();
+	
+	stream_buffer(const stream_buffer&) = delete;
+	stream_buffer(stream_buffer&&) = delete;
+	stream_buffer& operator=(const stream_buffer&) = delete;
+	stream_buffer& operator=(stream_buffer&&) = delete;
+	
+	/**
+	 * Allocates a range of the buffer for the current frame, waiting for the GL to finish reading the range if it was written in a previous frame.
+	 *
+	 * @param size Size of the range, in bytes.
+	 * @param alignment Alignment of the range offset, in bytes. Must be a power of two.
+	 *
+	 * @return Allocated range.
+	 *
+	 * @exception std::runtime_error Failed to map stream buffer.
+	 */
+	[[nodiscard]] stream_allocation allocate(std::size_t size, std::size_t alignment = 16);
+	
+	/**
+	 * Allocates a range of the buffer for the current frame and writes data into it.
+	 *
+	 * @param data Data to write.
+	 * @param alignment Alignment of the range offset, in bytes. Must be a power of two.
+	 *
+	 * @return Allocated range.
+	 *
+	 * @exception std::runtime_error Failed to map stream buffer.
+	 */
+	stream_allocation write(std::span<const std::byte> data, std::size_t alignment = 16);
+	
+	/**
+	 * Ends the current frame by inserting a fence after the commands which read its allocations, and retires the allocations of previous frames whose fences have been signaled.
+	 *
+	 * Buffers replaced during the frame are destroyed.
+	 */
+	void fence();
+	
+	/// Returns the size of the buffer, in bytes.
+	[[nodiscard]] inline constexpr std::size_t get_capacity() const noexcept
+	{
+		return m_capacity;
+	}
+	
+	/// Returns the number of bytes allocated during the current frame, including alignment padding.
+	[[nodiscard]] inline constexpr std::size_t get_frame_size() const noexcept
+	{
+		return static_cast<std::size_t>(m_head - m_frame_begin);
+	}
+	
+	/// Returns the number of frames whose allocations have not yet been retired.
+	[[nodiscard]] inline std::size_t get_pending_frame_count() const noexcept
+	{
+		return m_fences.size();
+	}
+	
+	/// Returns the number of times an allocation waited for the GL to finish reading a previous frame.
+	[[nodiscard]] inline constexpr std::uint64_t get_wait_count() const noexcept
+	{
+		return m_wait_count;
+	}
+	
+	/// Returns the number of times the buffer has been replaced with a larger buffer.
+	[[nodiscard]] inline constexpr std::uint64_t get_grow_count() const noexcept
+	{
+		return m_grow_count;
+	}
+
+private:
+	/// Fence inserted at the end of a frame.
+	struct frame_fence
+	{
+		/// GL sync object.
+		void* sync;
+		
+		/// Stream position at the end of the frame.
+		std::uint64_t end;
+	};
+	
+	/// Creates and maps a buffer of the current capacity.
+	void create_buffer();
+	
+	/// Replaces the buffer with a buffer of at least a minimum capacity.
+	void grow(std::size_t min_capacity);
+	
+	/// Waits for the oldest pending frame fence to be signaled, then retires its allocations.
+	void wait();
+	
+	std::unique_ptr<vertex_buffer> m_buffer;
+	std::byte* m_mapped_data{nullptr};
+	std::size_t m_capacity{0};
+	
+	/// Buffers replaced during the current frame, which may still be referenced by render operations.
+	std::vector<std::unique_ptr<vertex_buffer>> m_replaced_buffers;
+	
+	/// Fences of frames whose allocations have not yet been retired, from oldest to newest.
+	std::deque<frame_fence> m_fences;
+	
+	/// Monotonic stream position of the next allocation. The buffer offset of a stream position is the position modulo the capacity.
+	std::uint64_t m_head{0};
+	
+	/// Stream position of the first allocation of the current frame.
+	std::uint64_t m_frame_begin{0};
+	
+	/// Stream position before which all allocations have been retired.
+	std::uint64_t m_tail{0};
+	
+	std::uint64_t m_wait_count{0};
+	std::uint64_t m_grow_count{0};
+};
+
+} // namespace gl
+
+#endif // ANTKEEPER_GL_STREAM_BUFFER_HPP
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <engine/gl/texture.hpp>
+#include <engine/gl/image-streamer.hpp>
 #include <engine/resources/deserialize-context.hpp>
 #include <engine/resources/deserialize-error.hpp>
 #include <engine/resources/resource-loader.hpp>
@@ -61,6 +62,13 @@ namespace {
 			std::string image_path(image_path_length, '\0');
 			ctx.read8(reinterpret_cast<std::byte*>(image_path.data()), image_path_length);
 			
+			// Stream 2D images which have not yet been loaded, using a placeholder image until they have been uploaded
+			gl::image_streamer* image_streamer = nullptr;
+			if (texture_type == texture_type_2d && resource_manager.get_image_streamer() && !resource_manager.find<gl::image_2d>(image_path))
+			{
+				image_streamer = resource_manager.get_image_streamer();
+			}
+			
 			// Load image
 			std::shared_ptr<gl::image> image;
 			switch (texture_type)
@@ -72,7 +80,7 @@ namespace {
 				
 				case texture_type_2d:
 				case texture_type_2d_array:
-					image = resource_manager.load<gl::image_2d>(image_path);
+					image = image_streamer ? image_streamer->get_placeholder() : resource_manager.load<gl::image_2d>(image_path);
 					break;
 					
 				case texture_type_3d:
@@ -101,6 +109,7 @@ namespace {
 			ctx.read32_le(reinterpret_cast<std::byte*>(&array_layer_count), 1);
 			
 			// Handle automatic mip level count (`0`)
+			const auto requested_mip_level_count = mip_level_count;
 			if (!mip_level_count)
 			{
 				mip_level_count = image->get_mip_levels();
@@ -175,6 +184,29 @@ namespace {
 					
 				case texture_type_2d:
 				{
+					if (image_streamer)
+					{
+						// View placeholder image, then view streamed image once it has been uploaded
+						auto texture = std::make_unique<gl::texture_2d>(std::make_shared<gl::image_view_2d>(image), std::move(sampler));
+						image_streamer->request
+						(
+							image_path,
+							[&resource_manager, texture_path = ctx.path(), format, first_mip_level, requested_mip_level_count, first_array_layer](const std::shared_ptr<gl::image_2d>& image)
+							{
+								auto texture = resource_manager.find<gl::texture_2d>(texture_path);
+								if (!image || !texture)
+								{
+									return;
+								}
+								
+								const auto mip_level_count = requested_mip_level_count ? requested_mip_level_count : image->get_mip_levels();
+								texture->set_image_view(std::make_shared<gl::image_view_2d>(image, format, first_mip_level, mip_level_count, first_array_layer));
+							}
+						);
+						
+						return texture;
+					}
+					
 					auto image_view = std::make_shared<gl::image_view_2d>(image, format, first_mip_level, mip_level_count, first_array_layer);
 					return std::make_unique<gl::texture_2d>(std::move(image_view), std::move(sampler));
 				}
@@ -201,6 +201,23 @@ namespace {
 
 namespace gl {
 
+vertex_array::vertex_array(std::span<const vertex_input_attribute> attributes, std::span<const vertex_input_binding> bindings):
+	vertex_array(attributes)
+{
+	m_bindings.assign(bindings.begin(), bindings.end());
+	
+	for (const auto& binding: m_bindings)
+	{
+		// Set binding input rate
+		glVertexArrayBindingDivisor
+		(
+			m_gl_named_array,
+			static_cast<GLuint>(binding.binding),
+			(binding.input_rate == vertex_input_rate::instance) ? 1 : 0
+		);
+	}
+}
+
 vertex_array::vertex_array(std::span<const vertex_input_attribute> attributes)
 {
 	m_attributes.assign(attributes.begin(), attributes.end());
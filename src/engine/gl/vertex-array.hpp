@@ -5,6 +5,7 @@
 #define ANTKEEPER_GL_VERTEX_ARRAY_HPP
 
 #include <engine/gl/vertex-input-attribute.hpp>
+#include <engine/gl/vertex-input-binding.hpp>
 #include <span>
 #include <vector>
 
@@ -20,10 +21,12 @@ public:
 	 * Constructs a vertex array.
 	 *
 	 * @param attributes Vertex input attributes.
+	 * @param bindings Vertex input bindings. Bindings which are not described default to per-vertex input rate.
 	 *
 	 * @exception std::invalid_argument Vertex input attribute has unsupported format.
 	 */
 	/// @{
+	vertex_array(std::span<const vertex_input_attribute> attributes, std::span<const vertex_input_binding> bindings);
 	explicit vertex_array(std::span<const vertex_input_attribute> attributes);
 	vertex_array();
 	/// @}
@@ -37,6 +40,12 @@ public:
 		return m_attributes;
 	}
 	
+	/// Returns the vertex array's vertex input bindings.
+	[[nodiscard]] inline constexpr const std::vector<vertex_input_binding>& bindings() const noexcept
+	{
+		return m_bindings;
+	}
+
 	vertex_array(const vertex_array&) = delete;
 	vertex_array(vertex_array&&) = delete;
 	vertex_array& operator=(const vertex_array&) = delete;
@@ -46,6 +55,7 @@ private:
 	friend class pipeline;
 	
 	std::vector<vertex_input_attribute> m_attributes;
+	std::vector<vertex_input_binding> m_bindings;
 	unsigned int m_gl_named_array{0};
 };
 
@@ -176,6 +176,7 @@ public:
 
 private:
 	friend class pipeline;
+	friend class stream_buffer;
 	
 	unsigned int m_gl_named_buffer{0};
 	buffer_usage m_usage{buffer_usage::static_draw};
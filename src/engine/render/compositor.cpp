@@ -3,6 +3,7 @@
 
 #include <engine/render/compositor.hpp>
 #include <engine/render/pass.hpp>
+#include <chrono>
 
 namespace render {
 
@@ -25,9 +26,17 @@ void compositor::composite(render::context& ctx)
 {
 	for (pass* pass: passes)
 	{
+		pass->m_statistics = {};
+
 		if (pass->is_enabled())
 		{
+			const auto pipeline_statistics = pass->m_pipeline->get_statistics();
+			const auto t0 = std::chrono::steady_clock::now();
+
 			pass->render(ctx);
+
+			pass->m_statistics.cpu_time = std::chrono::steady_clock::now() - t0;
+			pass->m_statistics.pipeline = pass->m_pipeline->get_statistics() - pipeline_statistics;
 		}
 	}
 }
@@ -21,6 +21,13 @@ public:
 	void remove_pass(pass* pass);
 	void remove_passes();
 
+	/**
+	 * Executes each enabled pass in order, recording the statistics of each pass.
+	 *
+	 * @param ctx Render context.
+	 *
+	 * @see pass::get_statistics()
+	 */
 	void composite(render::context& ctx);
 
 	const std::list<pass*>* get_passes() const;
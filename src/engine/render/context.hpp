@@ -8,6 +8,11 @@
 #include <engine/render/operation.hpp>
 #include <vector>
 
+namespace gl
+{
+	class stream_buffer;
+}
+
 namespace scene
 {
 	class camera;
@@ -37,6 +42,15 @@ struct context
 	/// Subframe interpolation factor.
 	float alpha;
 	
+	/// Index of the frame being rendered.
+	unsigned int frame;
+	
+	/// Stream buffer from which per-frame vertex, instance, and uniform block data is allocated. The camera uniform block of the active camera is bound before its compositor is executed.
+	gl::stream_buffer* stream_buffer;
+	
+	/// Alignment of uniform block offsets within the stream buffer, in bytes.
+	std::size_t uniform_buffer_offset_alignment;
+
 	/// Objects visible to the active camera.
 	std::vector<scene::object_base*> objects;
 	
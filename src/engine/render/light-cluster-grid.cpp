@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/light-cluster-grid.hpp>
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <format>
+#include <numeric>
+#include <stdexcept>
+
+namespace render {
+
+light_cluster_grid::light_cluster_grid(const math::uvec3& dimensions)
+{
+	set_dimensions(dimensions);
+}
+
+void light_cluster_grid::set_dimensions(const math::uvec3& dimensions)
+{
+	if (!dimensions.x() || !dimensions.y() || !dimensions.z())
+	{
+		throw std::invalid_argument(std::format("Light cluster grid dimensions ({}, {}, {}) must be non-zero.", dimensions.x(), dimensions.y(), dimensions.z()));
+	}
+	
+	m_dimensions = dimensions;
+	m_clusters.assign(get_cluster_count(), math::uvec2{0, 0});
+	m_light_indices.clear();
+	
+	m_slices.resize(m_dimensions.z());
+	std::iota(m_slices.begin(), m_slices.end(), std::uint32_t{0});
+	m_slice_lights.resize(m_dimensions.z());
+	m_slice_light_indices.resize(m_dimensions.z());
+	m_slice_offsets.resize(m_dimensions.z());
+}
+
+void light_cluster_grid::build(bool orthographic, const math::fvec4& clip_extents, float clip_near, float clip_far, std::span<const math::fvec4> lights)
+{
+	m_orthographic = orthographic;
+	m_clip_extents = clip_extents;
+	m_clip_near = clip_near;
+	m_clip_far = std::max(std::min(clip_far, m_max_depth), clip_near * 2.0f);
+	
+	// Find transform from view-space depth to depth slice
+	const float slice_count = static_cast<float>(m_dimensions.z());
+	if (m_orthographic)
+	{
+		const float scale = slice_count / (m_clip_far - m_clip_near);
+		m_depth_slice_transform = {scale, -m_clip_near * scale, 0.0f};
+	}
+	else
+	{
+		const float scale = slice_count / std::log(m_clip_far / m_clip_near);
+		m_depth_slice_transform = {scale, -std::log(m_clip_near) * scale, 1.0f};
+	}
+	
+	const std::uint32_t tile_count_x = m_dimensions.x();
+	const std::uint32_t tile_count_y = m_dimensions.y();
+	const std::size_t slice_cluster_count = static_cast<std::size_t>(tile_count_x) * tile_count_y;
+	const float tile_width = (m_clip_extents[1] - m_clip_extents[0]) / static_cast<float>(tile_count_x);
+	const float tile_height = (m_clip_extents[3] - m_clip_extents[2]) / static_cast<float>(tile_count_y);
+	
+	// Assign lights to the clusters of each depth slice
+	std::for_each
+	(
+		std::execution::par,
+		m_slices.begin(),
+		m_slices.end(),
+		[&](std::uint32_t slice)
+		{
+			// The farthest depth slice extends to the far clipping plane
+			const float slice_near = get_slice_depth(slice);
+			const float slice_far = (slice + 1 < m_dimensions.z()) ? get_slice_depth(slice + 1) : std::max(clip_far, m_clip_far);
+			
+			// Find lights which overlap the depth slice
+			auto& slice_lights = m_slice_lights[slice];
+			slice_lights.clear();
+			for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(lights.size()); ++i)
+			{
+				const float depth = -lights[i].z();
+				const float radius = lights[i][3];
+				if (depth + radius >= slice_near && depth - radius <= slice_far)
+				{
+					slice_lights.emplace_back(i);
+				}
+			}
+			
+			auto& slice_light_indices = m_slice_light_indices[slice];
+			slice_light_indices.clear();
+			
+			auto cluster = m_clusters.begin() + static_cast<std::ptrdiff_t>(slice * slice_cluster_count);
+			for (std::uint32_t y = 0; y < tile_count_y; ++y)
+			{
+				const float tile_bottom = m_clip_extents[2] + tile_height * static_cast<float>(y);
+				const float tile_top = tile_bottom + tile_height;
+				
+				for (std::uint32_t x = 0; x < tile_count_x; ++x, ++cluster)
+				{
+					const float tile_left = m_clip_extents[0] + tile_width * static_cast<float>(x);
+					const float tile_right = tile_left + tile_width;
+					
+					// Find view-space bounds of the cluster
+					math::fvec3 min{tile_left, tile_bottom, -slice_far};
+					math::fvec3 max{tile_right, tile_top, -slice_near};
+					if (!m_orthographic)
+					{
+						// Scale tile extents by the depth slice boundaries, taking care with infinite far clipping planes
+						const auto scale_min = [&](float extent){return (extent < 0.0f) ? extent * slice_far : extent * slice_near;};
+						const auto scale_max = [&](float extent){return (extent > 0.0f) ? extent * slice_far : extent * slice_near;};
+						min = {scale_min(tile_left), scale_min(tile_bottom), -slice_far};
+						max = {scale_max(tile_right), scale_max(tile_top), -slice_near};
+					}
+					
+					const std::size_t first = slice_light_indices.size();
+					for (std::uint32_t i: slice_lights)
+					{
+						// Find squared distance from the light center to the cluster bounds
+						const auto& light = lights[i];
+						float sqr_distance = 0.0f;
+						for (std::size_t j = 0; j < 3; ++j)
+						{
+							const float d = std::max(std::max(min[j] - light[j], light[j] - max[j]), 0.0f);
+							sqr_distance += d * d;
+						}
+						
+						if (sqr_distance <= light[3] * light[3])
+						{
+							slice_light_indices.emplace_back(i);
+						}
+					}
+					
+					*cluster = {static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(slice_light_indices.size() - first)};
+				}
+			}
+		}
+	);
+	
+	// Find offset of each depth slice's first light index
+	std::transform(m_slice_light_indices.begin(), m_slice_light_indices.end(), m_slice_offsets.begin(), [](const auto& indices){return indices.size();});
+	const std::size_t light_index_count = std::accumulate(m_slice_offsets.begin(), m_slice_offsets.end(), std::size_t{0});
+	std::exclusive_scan(m_slice_offsets.begin(), m_slice_offsets.end(), m_slice_offsets.begin(), std::size_t{0});
+	m_light_indices.resize(light_index_count);
+	
+	// Concatenate light indices of each depth slice
+	std::for_each
+	(
+		std::execution::par,
+		m_slices.begin(),
+		m_slices.end(),
+		[&](std::uint32_t slice)
+		{
+			const std::size_t offset = m_slice_offsets[slice];
+			const auto& slice_light_indices = m_slice_light_indices[slice];
+			std::copy(slice_light_indices.begin(), slice_light_indices.end(), m_light_indices.begin() + static_cast<std::ptrdiff_t>(offset));
+			
+			const auto first = m_clusters.begin() + static_cast<std::ptrdiff_t>(slice * slice_cluster_count);
+			std::for_each
+			(
+				first,
+				first + static_cast<std::ptrdiff_t>(slice_cluster_count),
+				[offset](math::uvec2& cluster)
+				{
+					cluster[0] += static_cast<std::uint32_t>(offset);
+				}
+			);
+		}
+	);
+}
+
+std::uint32_t light_cluster_grid::get_depth_slice(float depth) const noexcept
+{
+	const float d = (m_depth_slice_transform.z() != 0.0f) ? std::log(depth) : depth;
+	const float slice = std::floor(d * m_depth_slice_transform.x() + m_depth_slice_transform.y());
+	return static_cast<std::uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(m_dimensions.z() - 1)));
+}
+
+float light_cluster_grid::get_slice_depth(std::uint32_t slice) const noexcept
+{
+	const float t = static_cast<float>(slice) / static_cast<float>(m_dimensions.z());
+	if (m_orthographic)
+	{
+		return m_clip_near + (m_clip_far - m_clip_near) * t;
+	}
+	
+	return m_clip_near * std::pow(m_clip_far / m_clip_near, t);
+}
+
+} // namespace render
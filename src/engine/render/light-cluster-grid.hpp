@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_LIGHT_CLUSTER_GRID_HPP
+#define ANTKEEPER_RENDER_LIGHT_CLUSTER_GRID_HPP
+
+#include <engine/math/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace render {
+
+/**
+ * Grid of clusters (froxels) over a view frustum, in which each cluster lists the lights which may influence it.
+ *
+ * Clusters are tiled uniformly in screen space, and sliced in view-space depth: logarithmically for perspective projections, linearly for orthographic projections. Lights are bounded by view-space spheres. The lights of each depth slice are assigned in parallel, then concatenated, such that the light indices of each cluster are stored contiguously and in ascending order.
+ *
+ * The slice of a view-space depth `d` is `floor(mix(d, log(d), p.z) * p.x + p.y)`, where `p` is the depth slice transform.
+ */
+class light_cluster_grid
+{
+public:
+	/// Default number of clusters in the X-, Y-, and Z-dimensions.
+	static constexpr math::uvec3 default_dimensions{16, 9, 24};
+	
+	/**
+	 * Constructs a light cluster grid.
+	 *
+	 * @param dimensions Number of clusters in the X-, Y-, and Z-dimensions.
+	 *
+	 * @exception std::invalid_argument Light cluster grid dimensions must be non-zero.
+	 */
+	explicit light_cluster_grid(const math::uvec3& dimensions = default_dimensions);
+	
+	/**
+	 * Sets the dimensions of the grid.
+	 *
+	 * @param dimensions Number of clusters in the X-, Y-, and Z-dimensions.
+	 *
+	 * @exception std::invalid_argument Light cluster grid dimensions must be non-zero.
+	 */
+	void set_dimensions(const math::uvec3& dimensions);
+	
+	/**
+	 * Sets the maximum view-space depth of the grid. Fragments beyond this depth use the lights of the farthest depth slice.
+	 *
+	 * @param depth Maximum depth of the grid.
+	 */
+	inline void set_max_depth(float depth) noexcept
+	{
+		m_max_depth = depth;
+	}
+	
+	/**
+	 * Assigns lights to clusters.
+	 *
+	 * @param orthographic `true` if the view frustum has an orthographic projection, `false` if it has a perspective projection.
+	 * @param clip_extents Left, right, bottom, and top clipping planes of the view frustum. For perspective projections, the extents at a depth of `1`.
+	 * @param clip_near View-space depth of the near clipping plane.
+	 * @param clip_far View-space depth of the far clipping plane.
+	 * @param lights View-space bounding spheres of the lights, with the sphere center in the XYZ-components and the radius in the W-component.
+	 */
+	void build(bool orthographic, const math::fvec4& clip_extents, float clip_near, float clip_far, std::span<const math::fvec4> lights);
+	
+	/// Returns the number of clusters in the X-, Y-, and Z-dimensions.
+	[[nodiscard]] inline constexpr const math::uvec3& get_dimensions() const noexcept
+	{
+		return m_dimensions;
+	}
+	
+	/// Returns the total number of clusters.
+	[[nodiscard]] inline constexpr std::size_t get_cluster_count() const noexcept
+	{
+		return static_cast<std::size_t>(m_dimensions.x()) * m_dimensions.y() * m_dimensions.z();
+	}
+	
+	/// Returns the maximum view-space depth of the grid.
+	[[nodiscard]] inline constexpr float get_max_depth() const noexcept
+	{
+		return m_max_depth;
+	}
+	
+	/// Returns the scale, bias, and logarithmic flag which transform a view-space depth into a depth slice.
+	[[nodiscard]] inline constexpr const math::fvec3& get_depth_slice_transform() const noexcept
+	{
+		return m_depth_slice_transform;
+	}
+	
+	/// Returns the offset of the first light index of each cluster, and its number of light indices. Clusters are ordered by X, then Y, then Z.
+	[[nodiscard]] inline std::span<const math::uvec2> get_clusters() const noexcept
+	{
+		return m_clusters;
+	}
+	
+	/// Returns the light indices of all clusters.
+	[[nodiscard]] inline std::span<const std::uint32_t> get_light_indices() const noexcept
+	{
+		return m_light_indices;
+	}
+	
+	/**
+	 * Returns the depth slice of a view-space depth.
+	 *
+	 * @param depth View-space depth.
+	 *
+	 * @return Index of the depth slice, clamped to the grid.
+	 */
+	[[nodiscard]] std::uint32_t get_depth_slice(float depth) const noexcept;
+
+private:
+	/// Returns the view-space depth of the near boundary of a depth slice.
+	[[nodiscard]] float get_slice_depth(std::uint32_t slice) const noexcept;
+	
+	math::uvec3 m_dimensions;
+	float m_max_depth{1000.0f};
+	bool m_orthographic{false};
+	math::fvec4 m_clip_extents{};
+	float m_clip_near{};
+	float m_clip_far{};
+	math::fvec3 m_depth_slice_transform{};
+	
+	std::vector<math::uvec2> m_clusters;
+	std::vector<std::uint32_t> m_light_indices;
+	
+	/// Depth slice indices.
+	std::vector<std::uint32_t> m_slices;
+	
+	/// Lights which overlap each depth slice.
+	std::vector<std::vector<std::uint32_t>> m_slice_lights;
+	
+	/// Light indices of each depth slice.
+	std::vector<std::vector<std::uint32_t>> m_slice_light_indices;
+	
+	/// Offset of the first light index of each depth slice.
+	std::vector<std::size_t> m_slice_offsets;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_LIGHT_CLUSTER_GRID_HPP
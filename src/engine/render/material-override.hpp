@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_MATERIAL_OVERRIDE_HPP
+#define ANTKEEPER_RENDER_MATERIAL_OVERRIDE_HPP
+
+#include <engine/render/material-variable.hpp>
+#include <engine/hash/fnv1a.hpp>
+#include <memory>
+
+namespace render {
+
+/**
+ * Replaces the value of a material variable for a render operation, without modifying the shared material.
+ */
+struct material_override
+{
+	/// Key of the overridden material variable.
+	hash::fnv1a32_t key;
+	
+	/// Variable whose value replaces the value of the material variable.
+	std::shared_ptr<material_variable_base> variable;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_MATERIAL_OVERRIDE_HPP
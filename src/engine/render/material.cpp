@@ -8,12 +8,20 @@
 #include <engine/render/material-flags.hpp>
 #include <engine/utility/json.hpp>
 #include <engine/hash/combine-hash.hpp>
+#include <atomic>
 #include <utility>
 #include <type_traits>
 #include <string>
 
 namespace render {
 
+namespace {
+
+/// Source of material generations.
+std::atomic<std::uint64_t> material_generation_counter{0};
+
+} // namespace
+
 material::material(const material& other)
 {
 	*this = other;
@@ -37,6 +45,7 @@ material& material::operator=(const material& other)
 	}
 	
 	m_hash = other.m_hash;
+	m_generation = next_generation();
 	
 	return *this;
 }
@@ -79,6 +88,7 @@ void material::set_shader_template(std::shared_ptr<gl::shader_template> shader_t
 void material::set_variable(hash::fnv1a32_t key, std::shared_ptr<material_variable_base> value)
 {
 	m_variable_map[key] = std::move(value);
+	m_generation = next_generation();
 }
 
 std::shared_ptr<material_variable_base> material::get_variable(hash::fnv1a32_t key) const
@@ -91,6 +101,11 @@ std::shared_ptr<material_variable_base> material::get_variable(hash::fnv1a32_t k
 	return nullptr;
 }
 
+std::uint64_t material::next_generation() noexcept
+{
+	return ++material_generation_counter;
+}
+
 void material::rehash() noexcept
 {
 	m_hash = 0;
@@ -165,7 +165,22 @@ public:
 		return m_hash;
 	}
 	
+	/**
+	 * Returns the generation of the material.
+	 *
+	 * Generations are unique across all materials. A material is assigned a new generation when it is constructed, assigned, or has a variable set, such that caches keyed by material address can detect stale entries.
+	 */
+	[[nodiscard]] inline std::uint64_t generation() const noexcept
+	{
+		return m_generation;
+	}
+	
 private:
+	/**
+	 * Returns a new, globally-unique material generation.
+	 */
+	[[nodiscard]] static std::uint64_t next_generation() noexcept;
+	
 	/**
 	 * Recalculates the material state hash.
 	 */
@@ -178,6 +193,7 @@ private:
 	std::shared_ptr<gl::shader_template> m_shader_template;
 	std::unordered_map<hash::fnv1a32_t, std::shared_ptr<material_variable_base>> m_variable_map;
 	std::size_t m_hash{0};
+	std::uint64_t m_generation{next_generation()};
 };
 
 } // namespace render
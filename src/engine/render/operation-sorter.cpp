@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/operation-sorter.hpp>
+#include <algorithm>
+#include <execution>
+#include <numeric>
+
+namespace render {
+
+void operation_sorter::sort(std::vector<const operation*>& operations, key_function_type key)
+{
+	const std::size_t count = operations.size();
+	if (count < 2)
+	{
+		return;
+	}
+	
+	// Split entries into chunks
+	const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+	m_chunks.resize(chunk_count);
+	std::iota(m_chunks.begin(), m_chunks.end(), std::size_t{0});
+	m_chunk_offsets.resize(chunk_count);
+	
+	// Generate sort keys
+	m_entries.resize(count);
+	m_buffer.resize(count);
+	std::for_each
+	(
+		std::execution::par_unseq,
+		m_chunks.begin(),
+		m_chunks.end(),
+		[&](std::size_t chunk)
+		{
+			const std::size_t end = std::min(count, (chunk + 1) * chunk_size);
+			for (std::size_t i = chunk * chunk_size; i < end; ++i)
+			{
+				m_entries[i] = {key(*operations[i]), operations[i]};
+			}
+		}
+	);
+	
+	// Find which bits differ between keys, to skip digits shared by all keys
+	std::uint64_t differing_bits = 0;
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		differing_bits |= m_entries[i].key ^ m_entries[0].key;
+	}
+	
+	for (unsigned int shift = 0; shift < 64; shift += digit_bits)
+	{
+		if (!((differing_bits >> shift) & (digit_count - 1)))
+		{
+			continue;
+		}
+		
+		// Count digits in each chunk
+		std::for_each
+		(
+			std::execution::par_unseq,
+			m_chunks.begin(),
+			m_chunks.end(),
+			[&](std::size_t chunk)
+			{
+				auto& histogram = m_chunk_offsets[chunk];
+				histogram.fill(0);
+				
+				const std::size_t end = std::min(count, (chunk + 1) * chunk_size);
+				for (std::size_t i = chunk * chunk_size; i < end; ++i)
+				{
+					++histogram[(m_entries[i].key >> shift) & (digit_count - 1)];
+				}
+			}
+		);
+		
+		// Convert counts into scatter offsets, ordered by digit then by chunk
+		std::size_t offset = 0;
+		for (std::size_t digit = 0; digit < digit_count; ++digit)
+		{
+			for (auto& offsets: m_chunk_offsets)
+			{
+				const std::size_t digit_total = offsets[digit];
+				offsets[digit] = offset;
+				offset += digit_total;
+			}
+		}
+		
+		// Scatter entries by digit
+		std::for_each
+		(
+			std::execution::par_unseq,
+			m_chunks.begin(),
+			m_chunks.end(),
+			[&](std::size_t chunk)
+			{
+				auto& offsets = m_chunk_offsets[chunk];
+				
+				const std::size_t end = std::min(count, (chunk + 1) * chunk_size);
+				for (std::size_t i = chunk * chunk_size; i < end; ++i)
+				{
+					m_buffer[offsets[(m_entries[i].key >> shift) & (digit_count - 1)]++] = m_entries[i];
+				}
+			}
+		);
+		
+		m_entries.swap(m_buffer);
+	}
+	
+	// Write sorted operations
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		operations[i] = m_entries[i].operation;
+	}
+}
+
+} // namespace render
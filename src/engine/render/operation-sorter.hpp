@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_OPERATION_SORTER_HPP
+#define ANTKEEPER_RENDER_OPERATION_SORTER_HPP
+
+#include <engine/render/operation.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+/**
+ * Sorts render operations by 64-bit sort keys.
+ *
+ * Keys are sorted with a parallel least significant digit radix sort. Digits shared by all keys are skipped, so keys with few distinct high bits sort in few passes. Scratch buffers are retained between sorts.
+ */
+class operation_sorter
+{
+public:
+	/// Function which returns the sort key of a render operation.
+	using key_function_type = std::uint64_t(*)(const operation&);
+	
+	/**
+	 * Sorts render operations in ascending order of sort key.
+	 *
+	 * @param operations Render operations to sort.
+	 * @param key Function which returns the sort key of a render operation.
+	 *
+	 * @note The sort is stable.
+	 */
+	void sort(std::vector<const operation*>& operations, key_function_type key);
+	
+private:
+	/// Sort key and its render operation.
+	struct entry
+	{
+		std::uint64_t key;
+		const render::operation* operation;
+	};
+	
+	/// Number of bits per radix digit.
+	static constexpr unsigned int digit_bits = 8;
+	
+	/// Number of distinct radix digit values.
+	static constexpr std::size_t digit_count = std::size_t{1} << digit_bits;
+	
+	/// Number of entries processed by each parallel task.
+	static constexpr std::size_t chunk_size = 4096;
+	
+	std::vector<entry> m_entries;
+	std::vector<entry> m_buffer;
+	std::vector<std::size_t> m_chunks;
+	std::vector<std::array<std::size_t, digit_count>> m_chunk_offsets;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_OPERATION_SORTER_HPP
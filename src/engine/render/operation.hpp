@@ -9,6 +9,8 @@
 #include <engine/gl/vertex-buffer.hpp>
 #include <engine/gl/primitive-topology.hpp>
 #include <engine/render/material.hpp>
+#include <engine/render/material-override.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <span>
@@ -32,12 +34,36 @@ struct operation
 	
 	std::shared_ptr<render::material> material;
 	
+	/// Material variable overrides, applied after the material has been bound.
+	std::span<const material_override> material_overrides{};
+
 	math::fmat4 transform{math::identity<math::fmat4>};
 	float depth{};
 	
 	std::span<const math::fmat4> skinning_matrices{};
 	
+	/// Uniform buffer containing the packed skinning palette of the operation, bound to the skinning uniform block, or `nullptr` if the operation has no packed skinning palette.
+	/// @see skinning_block
+	const gl::vertex_buffer* skinning_buffer{nullptr};
+
+	/// Offset into the skinning buffer, in bytes, of the skinning uniform block.
+	std::size_t skinning_offset{0};
+
 	std::uint32_t layer_mask{};
+
+	/// Vertex buffer of per-instance transforms, bound to vertex binding `1`, or `nullptr` if the operation is not instanced. Transforms of the operation begin at index `first_instance`.
+	const gl::vertex_buffer* instance_buffer{nullptr};
+
+	/// Local-space vertex data of the operation as a triangle list, in the layout of its vertex array, from which the operation may be merged into a batch. Empty if the operation cannot be batched.
+	/// @see batching_stage
+	std::span<const std::byte> batch_vertex_data{};
+
+	/// Revision of the batch vertex data, which must change whenever the contents of the batch vertex data change.
+	std::uint32_t batch_revision{0};
+
+	/// Material pass sort key, generated when the operation is queued.
+	/// @see make_material_sort_key()
+	std::uint64_t sort_key{};
 };
 
 } // namespace render
@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_PASS_STATISTICS_HPP
+#define ANTKEEPER_RENDER_PASS_STATISTICS_HPP
+
+#include <engine/gl/pipeline-statistics.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace render {
+
+/**
+ * Statistics of the most recent execution of a render pass.
+ */
+struct pass_statistics
+{
+	/// CPU time spent executing the pass.
+	std::chrono::steady_clock::duration cpu_time{};
+	
+	/// Commands issued through the graphics pipeline by the pass.
+	gl::pipeline_statistics pipeline;
+	
+	/// Number of render operations processed by the pass.
+	std::uint64_t operation_count{};
+	
+	/// Number of shader variable updates.
+	std::uint64_t uniform_upload_count{};
+	
+	/// Number of texture shader variable updates.
+	std::uint64_t texture_bind_count{};
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_PASS_STATISTICS_HPP
@@ -8,6 +8,7 @@
 #include <engine/gl/framebuffer.hpp>
 #include <engine/gl/clear-value.hpp>
 #include <engine/render/context.hpp>
+#include <engine/render/pass-statistics.hpp>
 
 namespace render {
 
@@ -43,13 +44,28 @@ public:
 	
 	void clear();
 
+	/**
+	 * Returns the statistics of the most recent execution of the pass by a compositor.
+	 *
+	 * @see compositor::composite()
+	 */
+	[[nodiscard]] inline const pass_statistics& get_statistics() const noexcept
+	{
+		return m_statistics;
+	}
+
 protected:
 	gl::pipeline* m_pipeline;
 	const gl::framebuffer* m_framebuffer;
 	std::uint8_t m_clear_mask{};
 	gl::clear_value m_clear_value;
 	
+	/// Statistics of the most recent execution of the pass. Passes may count the operations they process and the shader variables they update, while compositors measure CPU time and pipeline commands.
+	pass_statistics m_statistics;
+
 private:
+	friend class compositor;
+
 	bool m_enabled;
 };
 
@@ -24,21 +24,22 @@ bloom_pass::bloom_pass(gl::pipeline* pipeline, resource_manager* resource_manage
 	auto downsample_shader_template = resource_manager->load<gl::shader_template>("bloom-downsample.glsl");
 	
 	// Build downsample shader program with Karis averaging
-	m_downsample_karis_shader = downsample_shader_template->build
+	m_downsample_karis_shader = m_pipeline->get_shader_cache().build
 	(
+		*downsample_shader_template,
 		{
 			{"KARIS_AVERAGE", std::string()}
 		}
 	);
 	
 	// Build downsample shader program without Karis averaging
-	m_downsample_shader = downsample_shader_template->build();
+	m_downsample_shader = m_pipeline->get_shader_cache().build(*downsample_shader_template);
 	
 	// Load upsample shader template
 	auto upsample_shader_template = resource_manager->load<gl::shader_template>("bloom-upsample.glsl");
 	
 	// Build upsample shader program
-	m_upsample_shader = upsample_shader_template->build();
+	m_upsample_shader = m_pipeline->get_shader_cache().build(*upsample_shader_template);
 	
 	// Construct framebuffer texture sampler
 	m_sampler = std::make_shared<gl::sampler>
@@ -27,7 +27,7 @@ composite_pass::composite_pass(gl::pipeline* pipeline, const gl::framebuffer* fr
 	
 	// Load shader template and build shader program
 	auto shader_template = resource_manager->load<gl::shader_template>("composite.glsl");
-	m_shader_program = shader_template->build();
+	m_shader_program = m_pipeline->get_shader_cache().build(*shader_template);
 	if (!m_shader_program->linked())
 	{
 		debug::log_error("Failed to composite pass shader program: {}", m_shader_program->info());
@@ -10,9 +10,14 @@
 #include <engine/gl/vertex-buffer.hpp>
 #include <engine/gl/vertex-array.hpp>
 #include <engine/gl/texture.hpp>
+#include <engine/gl/image.hpp>
+#include <engine/gl/image-view.hpp>
+#include <engine/gl/sampler.hpp>
 #include <engine/gl/shader-variable-type.hpp>
+#include <engine/gl/stream-buffer.hpp>
 #include <engine/render/vertex-attribute-location.hpp>
 #include <engine/render/material-flags.hpp>
+#include <engine/render/material-override.hpp>
 #include <engine/render/model.hpp>
 #include <engine/render/context.hpp>
 #include <engine/scene/camera.hpp>
@@ -26,77 +31,181 @@
 #include <engine/math/quaternion.hpp>
 #include <engine/math/projection.hpp>
 #include <engine/hash/combine-hash.hpp>
+#include <algorithm>
+#include <bit>
 #include <cmath>
-#include <execution>
+#include <numbers>
+#include <stdexcept>
+#include <string>
 
 namespace render {
 
 namespace {
 
-/**
- * Sorts render operations for the material pass.
- */
-bool operation_compare(const render::operation* a, const render::operation* b)
+/// Offset of the first instance transform in an instance buffer.
+constexpr std::size_t instance_buffer_offset = 0;
+
+/// Stride between instance transforms in an instance buffer.
+constexpr std::size_t instance_buffer_stride = sizeof(math::fmat4);
+
+/// Name of the shader template define directive which indicates support for clustered lighting.
+const std::string clustered_lighting_directive = "CLUSTERED_LIGHTING";
+
+/// Name of the shader template define directive which indicates lights are read from the light uniform block.
+const std::string light_block_directive = "LIGHT_BLOCK_BINDING";
+
+/// Width of light index textures, in texels.
+constexpr std::uint32_t light_index_texture_width = 1024;
+
+/// Byte sizes of the light and shadow uniform blocks, in binding order.
+constexpr std::size_t light_block_sizes[2] = {light_block_offsets.size, shadow_block_offsets.size};
+
+/// Returns the radius at which the illuminance of a light with a given exposure-normalized luminous flux falls below a cutoff illuminance.
+[[nodiscard]] inline float light_cutoff_radius(const math::fvec3& luminous_flux, float cutoff_illuminance) noexcept
+{
+	const float luminous_intensity = math::max_element(luminous_flux) / (4.0f * std::numbers::pi_v<float>);
+	return std::sqrt(std::max(luminous_intensity, 0.0f) / cutoff_illuminance);
+}
+
+/// Constructs a 2D texture of unsigned integer texels which are sampled without filtering.
+[[nodiscard]] std::shared_ptr<gl::texture_2d> make_uint_texture(gl::format format, std::uint32_t width, std::uint32_t height)
+{
+	return std::make_shared<gl::texture_2d>
+	(
+		std::make_shared<gl::image_view_2d>
+		(
+			std::make_shared<gl::image_2d>(format, width, height)
+		),
+		std::make_shared<gl::sampler>
+		(
+			gl::sampler_filter::nearest,
+			gl::sampler_filter::nearest,
+			gl::sampler_mipmap_mode::nearest,
+			gl::sampler_address_mode::clamp_to_edge,
+			gl::sampler_address_mode::clamp_to_edge
+		)
+	);
+}
+
+/// Returns the shader variable type which corresponds to a material variable type.
+[[nodiscard]] constexpr gl::shader_variable_type to_shader_variable_type(material_variable_type type) noexcept
 {
-	// Render operations with materials first
-	if (!a->material)
+	switch (type)
 	{
-		return false;
+		case material_variable_type::bvec1:        return gl::shader_variable_type::bvec1;
+		case material_variable_type::bvec2:        return gl::shader_variable_type::bvec2;
+		case material_variable_type::bvec3:        return gl::shader_variable_type::bvec3;
+		case material_variable_type::bvec4:        return gl::shader_variable_type::bvec4;
+		case material_variable_type::ivec1:        return gl::shader_variable_type::ivec1;
+		case material_variable_type::ivec2:        return gl::shader_variable_type::ivec2;
+		case material_variable_type::ivec3:        return gl::shader_variable_type::ivec3;
+		case material_variable_type::ivec4:        return gl::shader_variable_type::ivec4;
+		case material_variable_type::uvec1:        return gl::shader_variable_type::uvec1;
+		case material_variable_type::uvec2:        return gl::shader_variable_type::uvec2;
+		case material_variable_type::uvec3:        return gl::shader_variable_type::uvec3;
+		case material_variable_type::uvec4:        return gl::shader_variable_type::uvec4;
+		case material_variable_type::fvec1:        return gl::shader_variable_type::fvec1;
+		case material_variable_type::fvec2:        return gl::shader_variable_type::fvec2;
+		case material_variable_type::fvec3:        return gl::shader_variable_type::fvec3;
+		case material_variable_type::fvec4:        return gl::shader_variable_type::fvec4;
+		case material_variable_type::fmat2:        return gl::shader_variable_type::fmat2;
+		case material_variable_type::fmat3:        return gl::shader_variable_type::fmat3;
+		case material_variable_type::fmat4:        return gl::shader_variable_type::fmat4;
+		case material_variable_type::texture_1d:   return gl::shader_variable_type::texture_1d;
+		case material_variable_type::texture_2d:   return gl::shader_variable_type::texture_2d;
+		case material_variable_type::texture_3d:   return gl::shader_variable_type::texture_3d;
+		case material_variable_type::texture_cube: return gl::shader_variable_type::texture_cube;
+		default:                                   return gl::shader_variable_type::bvec1;
 	}
-	else if (!b->material)
+}
+
+/// Returns a pointer to the first element of a material variable.
+[[nodiscard]] const void* material_variable_data(const material_variable_base& variable) noexcept
+{
+	switch (variable.type())
 	{
-		return true;
+		case material_variable_type::bvec2:        return static_cast<const matvar_bvec2&>(variable).data();
+		case material_variable_type::bvec3:        return static_cast<const matvar_bvec3&>(variable).data();
+		case material_variable_type::bvec4:        return static_cast<const matvar_bvec4&>(variable).data();
+		case material_variable_type::ivec1:        return static_cast<const matvar_int&>(variable).data();
+		case material_variable_type::ivec2:        return static_cast<const matvar_ivec2&>(variable).data();
+		case material_variable_type::ivec3:        return static_cast<const matvar_ivec3&>(variable).data();
+		case material_variable_type::ivec4:        return static_cast<const matvar_ivec4&>(variable).data();
+		case material_variable_type::uvec1:        return static_cast<const matvar_uint&>(variable).data();
+		case material_variable_type::uvec2:        return static_cast<const matvar_uvec2&>(variable).data();
+		case material_variable_type::uvec3:        return static_cast<const matvar_uvec3&>(variable).data();
+		case material_variable_type::uvec4:        return static_cast<const matvar_uvec4&>(variable).data();
+		case material_variable_type::fvec1:        return static_cast<const matvar_float&>(variable).data();
+		case material_variable_type::fvec2:        return static_cast<const matvar_fvec2&>(variable).data();
+		case material_variable_type::fvec3:        return static_cast<const matvar_fvec3&>(variable).data();
+		case material_variable_type::fvec4:        return static_cast<const matvar_fvec4&>(variable).data();
+		case material_variable_type::fmat2:        return static_cast<const matvar_fmat2&>(variable).data();
+		case material_variable_type::fmat3:        return static_cast<const matvar_fmat3&>(variable).data();
+		case material_variable_type::fmat4:        return static_cast<const matvar_fmat4&>(variable).data();
+		case material_variable_type::texture_1d:   return static_cast<const matvar_texture_1d&>(variable).data();
+		case material_variable_type::texture_2d:   return static_cast<const matvar_texture_2d&>(variable).data();
+		case material_variable_type::texture_3d:   return static_cast<const matvar_texture_3d&>(variable).data();
+		case material_variable_type::texture_cube: return static_cast<const matvar_texture_cube&>(variable).data();
+		case material_variable_type::bvec1:
+		default:                                   return nullptr;
 	}
-	
-	const bool translucent_a = a->material->get_blend_mode() == material_blend_mode::translucent;
-	const bool translucent_b = b->material->get_blend_mode() == material_blend_mode::translucent;
-	
-	if (translucent_a)
+}
+
+/// Uploads material variable elements of type `T` to a shader variable.
+template <class T>
+inline void update_span(const gl::shader_variable& variable, const void* data, std::uint32_t count)
+{
+	variable.update(std::span<const T>{static_cast<const T*>(data), count});
+}
+
+/// Uploads material variable elements to a shader variable.
+void update_material_variable(const gl::shader_variable& variable, gl::shader_variable_type type, const void* data, std::uint32_t count)
+{
+	switch (type)
 	{
-		if (translucent_b)
-		{
-			// A and B are both translucent, render back to front
-			return (a->depth < b->depth);
-		}
-		else
-		{
-			// A is translucent, B is opaque. Render B first
-			return false;
-		}
+		case gl::shader_variable_type::bvec2:        update_span<math::bvec2>(variable, data, count); break;
+		case gl::shader_variable_type::bvec3:        update_span<math::bvec3>(variable, data, count); break;
+		case gl::shader_variable_type::bvec4:        update_span<math::bvec4>(variable, data, count); break;
+		case gl::shader_variable_type::ivec1:        update_span<int>(variable, data, count); break;
+		case gl::shader_variable_type::ivec2:        update_span<math::ivec2>(variable, data, count); break;
+		case gl::shader_variable_type::ivec3:        update_span<math::ivec3>(variable, data, count); break;
+		case gl::shader_variable_type::ivec4:        update_span<math::ivec4>(variable, data, count); break;
+		case gl::shader_variable_type::uvec1:        update_span<unsigned int>(variable, data, count); break;
+		case gl::shader_variable_type::uvec2:        update_span<math::uvec2>(variable, data, count); break;
+		case gl::shader_variable_type::uvec3:        update_span<math::uvec3>(variable, data, count); break;
+		case gl::shader_variable_type::uvec4:        update_span<math::uvec4>(variable, data, count); break;
+		case gl::shader_variable_type::fvec1:        update_span<float>(variable, data, count); break;
+		case gl::shader_variable_type::fvec2:        update_span<math::fvec2>(variable, data, count); break;
+		case gl::shader_variable_type::fvec3:        update_span<math::fvec3>(variable, data, count); break;
+		case gl::shader_variable_type::fvec4:        update_span<math::fvec4>(variable, data, count); break;
+		case gl::shader_variable_type::fmat2:        update_span<math::fmat2>(variable, data, count); break;
+		case gl::shader_variable_type::fmat3:        update_span<math::fmat3>(variable, data, count); break;
+		case gl::shader_variable_type::fmat4:        update_span<math::fmat4>(variable, data, count); break;
+		case gl::shader_variable_type::texture_1d:   update_span<std::shared_ptr<gl::texture_1d>>(variable, data, count); break;
+		case gl::shader_variable_type::texture_2d:   update_span<std::shared_ptr<gl::texture_2d>>(variable, data, count); break;
+		case gl::shader_variable_type::texture_3d:   update_span<std::shared_ptr<gl::texture_3d>>(variable, data, count); break;
+		case gl::shader_variable_type::texture_cube: update_span<std::shared_ptr<gl::texture_cube>>(variable, data, count); break;
+		case gl::shader_variable_type::bvec1:
+		default:                                     break;
 	}
-	else
+}
+
+/**
+ * Uploads a material variable to the shader variable with the same key and type, if the shader program has one.
+ *
+ * @return `true` if the material variable was uploaded, `false` otherwise.
+ */
+bool override_material_variable(const gl::shader_program& shader_program, hash::fnv1a32_t key, const material_variable_base& variable)
+{
+	const auto shader_variable = shader_program.variable(key);
+	const auto type = to_shader_variable_type(variable.type());
+	if (!shader_variable || shader_variable->type() != type)
 	{
-		if (translucent_b)
-		{
-			// A is opaque, B is translucent. Render A first
-			return true;
-		}
-		else
-		{
-			// A and B are both opaque, sort by material hash
-			const std::size_t hash_a = a->material->hash();
-			const std::size_t hash_b = b->material->hash();
-			
-			if (hash_a != hash_b)
-			{
-				// A and B have different material hashes, sort by hash
-				return (hash_a < hash_b);
-			}
-			else
-			{
-				// A and B have the same material hash, sort by layer mask
-				if (a->layer_mask != b->layer_mask)
-				{
-					return (a->layer_mask < b->layer_mask);
-				}
-				else
-				{
-					// A and B have the same layer mask, sort by VAO
-					return (a->vertex_array < b->vertex_array);
-				}
-			}
-		}
+		return false;
 	}
+	
+	update_material_variable(*shader_variable, type, material_variable_data(variable), static_cast<std::uint32_t>(std::min<std::size_t>(variable.size(), shader_variable->size())));
+	return true;
 }
 
 } // namespace
@@ -114,6 +223,17 @@ material_pass::material_pass(gl::pipeline* pipeline, const gl::framebuffer* fram
 
 void material_pass::render(render::context& ctx)
 {
+	// Evict lighting states not evaluated last frame, such as those of destroyed cameras, keeping the cluster textures of those still in use
+	m_lighting = nullptr;
+	std::erase_if
+	(
+		m_lighting_states,
+		[&](const auto& entry)
+		{
+			return frame - entry.second.frame > 1;
+		}
+	);
+	
 	m_pipeline->bind_framebuffer(m_framebuffer);
 	clear();
 	
@@ -142,13 +262,17 @@ void material_pass::render(render::context& ctx)
 	shader_cache_entry* active_cache_entry = nullptr;
 	std::uint32_t active_layer_mask = 0;
 	std::size_t active_lighting_state_hash = 0;
+	bool active_instanced = false;
+	std::span<const material_override> active_material_overrides;
+	const gl::vertex_buffer* active_skinning_buffer = nullptr;
+	std::size_t active_skinning_offset = 0;
 	
 	// Gather information
 	evaluate_camera(ctx);
 	evaluate_misc(ctx);
 	
 	// Sort render operations
-	std::sort(std::execution::par_unseq, ctx.operations.begin(), ctx.operations.end(), operation_compare);
+	m_operation_sorter.sort(ctx.operations, [](const render::operation& operation){return operation.sort_key;});
 	
 	for (const render::operation* operation: ctx.operations)
 	{
@@ -171,10 +295,16 @@ void material_pass::render(render::context& ctx)
 		{
 			evaluate_lighting(ctx, operation->layer_mask & ctx.camera->get_layer_mask());
 			active_layer_mask = operation->layer_mask;
+			
+			// Force lighting-dependent shader variables to be updated
+			active_material = nullptr;
+			active_cache_key = 0;
 		}
 		
 		// Switch materials if necessary
-		if (active_material != material || active_lighting_state_hash != lighting_state_hash)
+		const bool instanced = operation->instance_buffer != nullptr;
+		const bool material_switched = active_material != material || active_lighting_state_hash != m_lighting->lighting_state_hash || active_instanced != instanced;
+		if (material_switched)
 		{
 			// if (!material->get_shader_template())
 			// {
@@ -225,8 +355,15 @@ void material_pass::render(render::context& ctx)
 				active_material_hash = material->hash();
 			}
 			
-			// Calculate shader cache key
-			std::size_t cache_key = hash::combine_hash(lighting_state_hash, material->get_shader_template()->hash());
+			// Calculate shader cache key, ignoring the number of lights which are read from the light uniform block or light clusters
+			const bool clustered = material->get_shader_template()->has_define_directive(clustered_lighting_directive);
+			const bool light_block = material->get_shader_template()->has_define_directive(light_block_directive);
+			const std::size_t shader_lighting_state_hash = light_block ? m_lighting->block_lighting_state_hash : (clustered ? m_lighting->clustered_lighting_state_hash : m_lighting->lighting_state_hash);
+			std::size_t cache_key = hash::combine_hash(shader_lighting_state_hash, material->get_shader_template()->hash());
+			if (instanced)
+			{
+				cache_key = hash::combine_hash(cache_key, std::size_t{1});
+			}
 			if (active_cache_key != cache_key)
 			{
 				// Lookup shader cache entry
@@ -238,46 +375,65 @@ void material_pass::render(render::context& ctx)
 				{
 					// Construct cache entry
 					active_cache_entry = &shader_cache[cache_key];
-					active_cache_entry->shader_program = generate_shader_program(*material->get_shader_template(), material->get_blend_mode());
-					build_shader_command_buffer(active_cache_entry->shader_command_buffer, *active_cache_entry->shader_program);
-					build_geometry_command_buffer(active_cache_entry->geometry_command_buffer, *active_cache_entry->shader_program);
+					active_cache_entry->shader_program = generate_shader_program(*material->get_shader_template(), material->get_blend_mode(), instanced, clustered);
+					build_shader_commands(active_cache_entry->shader_commands, *active_cache_entry->shader_program);
+					build_geometry_commands(active_cache_entry->geometry_commands, *active_cache_entry->shader_program);
 					
 					debug::log_trace("Generated material cache entry {:x}", cache_key);
 				}
 				
 				// Bind shader and update shader-specific variables
-				for (const auto& command: active_cache_entry->shader_command_buffer)
-				{
-					command();
-				}
+				execute(active_cache_entry->shader_commands);
 				
 				active_cache_key = cache_key;
 			}
 			
-			// Find or build material command buffer
-			std::vector<std::function<void()>>* material_command_buffer;
-			if (auto i = active_cache_entry->material_command_buffers.find(material); i != active_cache_entry->material_command_buffers.end())
-			{
-				material_command_buffer = &i->second;
-			}
-			else
+			// Find material command stream, re-recording it if the material has changed since it was recorded
+			auto& material_command_stream = active_cache_entry->material_commands[material];
+			if (material_command_stream.generation != material->generation())
 			{
-				material_command_buffer = &active_cache_entry->material_command_buffers[material];
-				build_material_command_buffer(*material_command_buffer, *active_cache_entry->shader_program, *material);
+				material_command_stream.commands.clear();
+				build_material_commands(material_command_stream.commands, *active_cache_entry->shader_program, *material);
+				material_command_stream.generation = material->generation();
 				
-				debug::log_trace("Generated material command buffer");
+				debug::log_trace("Generated material command stream");
 			}
 			
 			// Update material-dependent shader variables
-			for (const auto& command: *material_command_buffer)
-			{
-				command();
-			}
+			execute(material_command_stream.commands);
 			
 			active_material = material;
-			active_lighting_state_hash = lighting_state_hash;
+			active_lighting_state_hash = m_lighting->lighting_state_hash;
+			active_instanced = instanced;
 		}
 		
+		// Restore material variables overridden by the previous operation, if the material variables were not just updated
+		if (!material_switched)
+		{
+			for (const auto& material_override: active_material_overrides)
+			{
+				if (const auto variable = material->get_variable(material_override.key))
+				{
+					if (override_material_variable(*active_cache_entry->shader_program, material_override.key, *variable))
+					{
+						++m_statistics.uniform_upload_count;
+					}
+				}
+			}
+		}
+		
+		// Apply material variable overrides
+		for (const auto& material_override: operation->material_overrides)
+		{
+			if (material_override.variable)
+			{
+				if (override_material_variable(*active_cache_entry->shader_program, material_override.key, *material_override.variable))
+				{
+					++m_statistics.uniform_upload_count;
+				}
+			}
+		}
+		active_material_overrides = operation->material_overrides;
 		
 		model = &operation->transform;
 		
@@ -290,15 +446,26 @@ void material_pass::render(render::context& ctx)
 		skinning_matrices = operation->skinning_matrices;
 		
 		// Update geometry-dependent shader variables
-		for (const auto& command: active_cache_entry->geometry_command_buffer)
+		execute(active_cache_entry->geometry_commands);
+		
+		// Bind packed skinning palette, which is shared by all operations of a skeletal mesh
+		if (operation->skinning_buffer && (operation->skinning_buffer != active_skinning_buffer || operation->skinning_offset != active_skinning_offset))
 		{
-			command();
+			constexpr std::size_t skinning_block_size = skinning_block_offsets.size;
+			m_pipeline->bind_uniform_buffers(skinning_block_binding, {&operation->skinning_buffer, 1}, {&operation->skinning_offset, 1}, {&skinning_block_size, 1});
+			active_skinning_buffer = operation->skinning_buffer;
+			active_skinning_offset = operation->skinning_offset;
 		}
 		
 		m_pipeline->set_primitive_topology(operation->primitive_topology);
 		m_pipeline->bind_vertex_array(operation->vertex_array);
 		m_pipeline->bind_vertex_buffers(0, {&operation->vertex_buffer, 1}, {&operation->vertex_offset, 1}, {&operation->vertex_stride, 1});
+		if (instanced)
+		{
+			m_pipeline->bind_vertex_buffers(1, {&operation->instance_buffer, 1}, {&instance_buffer_offset, 1}, {&instance_buffer_stride, 1});
+		}
 		m_pipeline->draw(operation->vertex_count, operation->instance_count, operation->first_vertex, operation->first_instance);
+		++m_statistics.operation_count;
 	}
 	
 	++frame;
@@ -321,15 +488,32 @@ void material_pass::evaluate_camera(const render::context& ctx)
 	camera_exposure = ctx.camera->get_exposure_normalization();
 }
 
+std::size_t material_pass::lighting_key_hash::operator()(const lighting_key& key) const noexcept
+{
+	return hash::combine_hash(std::hash<const scene::camera*>{}(key.first), std::hash<std::uint32_t>{}(key.second));
+}
+
 void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t layer_mask)
 {
+	// Find lighting state of the camera and layer mask, reusing it if it was already evaluated this frame
+	auto [iterator, inserted] = m_lighting_states.try_emplace(lighting_key{ctx.camera, layer_mask});
+	lighting_state& lighting = iterator->second;
+	m_lighting = &lighting;
+	if (!inserted && lighting.frame == frame)
+	{
+		// Rebind light blocks, which are still allocated in the stream buffer
+		m_pipeline->bind_uniform_buffers(light_block_binding, lighting.block_buffers, lighting.block_offsets, light_block_sizes);
+		return;
+	}
+	lighting.frame = frame;
+	
 	// Reset light and shadow counts
-	light_probe_count = 0;
-	directional_light_count = 0;
-	directional_shadow_count = 0;
-	spot_light_count = 0;
-	point_light_count = 0;
-	rectangle_light_count = 0;
+	lighting.light_probe_count = 0;
+	lighting.directional_light_count = 0;
+	lighting.directional_shadow_count = 0;
+	lighting.spot_light_count = 0;
+	lighting.point_light_count = 0;
+	lighting.rectangle_light_count = 0;
 	
 	const auto& light_probes = ctx.collection->get_objects(scene::light_probe::object_type_id);
 	for (const scene::object_base* object: light_probes)
@@ -339,12 +523,12 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 			continue;
 		}
 		
-		if (!light_probe_count)
+		if (!lighting.light_probe_count)
 		{
 			const scene::light_probe& light_probe = static_cast<const scene::light_probe&>(*object);
-			++light_probe_count;
-			light_probe_luminance_texture = light_probe.get_luminance_texture().get();
-			light_probe_illuminance_texture = light_probe.get_illuminance_texture().get();
+			++lighting.light_probe_count;
+			lighting.light_probe_luminance_texture = light_probe.get_luminance_texture().get();
+			lighting.light_probe_illuminance_texture = light_probe.get_illuminance_texture().get();
 		}
 	}
 	
@@ -365,36 +549,36 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 			{
 				const scene::directional_light& directional_light = static_cast<const scene::directional_light&>(light);
 				
-				const std::size_t light_index = directional_light_count;
+				const std::size_t light_index = lighting.directional_light_count;
 				
-				++directional_light_count;
-				if (directional_light_count > directional_light_colors.size())
+				++lighting.directional_light_count;
+				if (lighting.directional_light_count > lighting.directional_light_colors.size())
 				{
-					directional_light_colors.resize(directional_light_count);
-					directional_light_directions.resize(directional_light_count);
+					lighting.directional_light_colors.resize(lighting.directional_light_count);
+					lighting.directional_light_directions.resize(lighting.directional_light_count);
 				}
 				
-				directional_light_colors[light_index] = directional_light.get_colored_illuminance() * ctx.camera->get_exposure_normalization();
-				directional_light_directions[light_index] = directional_light.get_direction() * ctx.camera->get_rotation();
+				lighting.directional_light_colors[light_index] = directional_light.get_colored_illuminance() * ctx.camera->get_exposure_normalization();
+				lighting.directional_light_directions[light_index] = directional_light.get_direction() * ctx.camera->get_rotation();
 				
 				// Add directional shadow
 				if (directional_light.is_shadow_caster() && directional_light.get_shadow_framebuffer())
 				{
-					const std::size_t shadow_index = directional_shadow_count;
+					const std::size_t shadow_index = lighting.directional_shadow_count;
 					
-					++directional_shadow_count;
-					if (directional_shadow_count > directional_shadow_maps.size())
+					++lighting.directional_shadow_count;
+					if (lighting.directional_shadow_count > lighting.directional_shadow_maps.size())
 					{
-						directional_shadow_maps.resize(directional_shadow_count);
-						directional_shadow_splits.resize(directional_shadow_count);
-						directional_shadow_fade_ranges.resize(directional_shadow_count);
-						directional_shadow_matrices.resize(directional_shadow_count);
+						lighting.directional_shadow_maps.resize(lighting.directional_shadow_count);
+						lighting.directional_shadow_splits.resize(lighting.directional_shadow_count);
+						lighting.directional_shadow_fade_ranges.resize(lighting.directional_shadow_count);
+						lighting.directional_shadow_matrices.resize(lighting.directional_shadow_count);
 					}
 					
-					directional_shadow_maps[shadow_index] = directional_light.get_shadow_texture().get();
-					directional_shadow_splits[shadow_index] = directional_light.get_shadow_cascade_distances();
-					directional_shadow_fade_ranges[shadow_index] = directional_light.get_shadow_fade_range();
-					directional_shadow_matrices[shadow_index] = directional_light.get_shadow_cascade_matrices();
+					lighting.directional_shadow_maps[shadow_index] = directional_light.get_shadow_texture().get();
+					lighting.directional_shadow_splits[shadow_index] = directional_light.get_shadow_cascade_distances();
+					lighting.directional_shadow_fade_ranges[shadow_index] = directional_light.get_shadow_fade_range();
+					lighting.directional_shadow_matrices[shadow_index] = directional_light.get_shadow_cascade_matrices();
 				}
 				break;
 			}
@@ -404,21 +588,21 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 			{
 				const scene::spot_light& spot_light = static_cast<const scene::spot_light&>(light);
 				
-				const std::size_t index = spot_light_count;
+				const std::size_t index = lighting.spot_light_count;
 				
-				++spot_light_count;
-				if (spot_light_count > spot_light_colors.size())
+				++lighting.spot_light_count;
+				if (lighting.spot_light_count > lighting.spot_light_colors.size())
 				{
-					spot_light_colors.resize(spot_light_count);
-					spot_light_positions.resize(spot_light_count);
-					spot_light_directions.resize(spot_light_count);
-					spot_light_cutoffs.resize(spot_light_count);
+					lighting.spot_light_colors.resize(lighting.spot_light_count);
+					lighting.spot_light_positions.resize(lighting.spot_light_count);
+					lighting.spot_light_directions.resize(lighting.spot_light_count);
+					lighting.spot_light_cutoffs.resize(lighting.spot_light_count);
 				}
 				
-				spot_light_colors[index] = spot_light.get_luminous_flux() * ctx.camera->get_exposure_normalization();
-				spot_light_positions[index] = spot_light.get_translation() - ctx.camera->get_translation();
-				spot_light_directions[index] = spot_light.get_direction() * ctx.camera->get_rotation();
-				spot_light_cutoffs[index] = spot_light.get_cosine_cutoff();
+				lighting.spot_light_colors[index] = spot_light.get_luminous_flux() * ctx.camera->get_exposure_normalization();
+				lighting.spot_light_positions[index] = spot_light.get_translation() - ctx.camera->get_translation();
+				lighting.spot_light_directions[index] = spot_light.get_direction() * ctx.camera->get_rotation();
+				lighting.spot_light_cutoffs[index] = spot_light.get_cosine_cutoff();
 				break;
 			}
 			
@@ -427,17 +611,17 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 			{
 				const scene::point_light& point_light = static_cast<const scene::point_light&>(light);
 				
-				const std::size_t index = point_light_count;
+				const std::size_t index = lighting.point_light_count;
 				
-				++point_light_count;
-				if (point_light_count > point_light_colors.size())
+				++lighting.point_light_count;
+				if (lighting.point_light_count > lighting.point_light_colors.size())
 				{
-					point_light_colors.resize(point_light_count);
-					point_light_positions.resize(point_light_count);
+					lighting.point_light_colors.resize(lighting.point_light_count);
+					lighting.point_light_positions.resize(lighting.point_light_count);
 				}
 				
-				point_light_colors[index] = point_light.get_colored_luminous_flux() * ctx.camera->get_exposure_normalization();
-				point_light_positions[index] = point_light.get_translation() - ctx.camera->get_translation();
+				lighting.point_light_colors[index] = point_light.get_colored_luminous_flux() * ctx.camera->get_exposure_normalization();
+				lighting.point_light_positions[index] = point_light.get_translation() - ctx.camera->get_translation();
 				
 				break;
 			}
@@ -447,21 +631,21 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 			{
 				const scene::rectangle_light& rectangle_light = static_cast<const scene::rectangle_light&>(light);
 				
-				const std::size_t index = rectangle_light_count;
+				const std::size_t index = lighting.rectangle_light_count;
 				
-				++rectangle_light_count;
-				if (rectangle_light_count > rectangle_light_colors.size())
+				++lighting.rectangle_light_count;
+				if (lighting.rectangle_light_count > lighting.rectangle_light_colors.size())
 				{
-					rectangle_light_colors.resize(rectangle_light_count);
-					rectangle_light_corners.resize(rectangle_light_count * 4);
+					lighting.rectangle_light_colors.resize(lighting.rectangle_light_count);
+					lighting.rectangle_light_corners.resize(lighting.rectangle_light_count * 4);
 				}
 				
-				rectangle_light_colors[index] = rectangle_light.get_colored_luminance() * ctx.camera->get_exposure_normalization();
+				lighting.rectangle_light_colors[index] = rectangle_light.get_colored_luminance() * ctx.camera->get_exposure_normalization();
 				
 				const auto corners = rectangle_light.get_corners();
 				for (std::size_t i = 0; i < 4; ++i)
 				{
-					rectangle_light_corners[index * 4 + i] = (corners[i] - ctx.camera->get_translation()) * ctx.camera->get_rotation();
+					lighting.rectangle_light_corners[index * 4 + i] = (corners[i] - ctx.camera->get_translation()) * ctx.camera->get_rotation();
 				}
 				
 				break;
@@ -473,12 +657,169 @@ void material_pass::evaluate_lighting(const render::context& ctx, std::uint32_t
 	}
 	
 	// Generate lighting state hash
-	lighting_state_hash = std::hash<std::size_t>{}(light_probe_count);
-	lighting_state_hash = hash::combine_hash(lighting_state_hash, std::hash<std::size_t>{}(directional_light_count));
-	lighting_state_hash = hash::combine_hash(lighting_state_hash, std::hash<std::size_t>{}(directional_shadow_count));
-	lighting_state_hash = hash::combine_hash(lighting_state_hash, std::hash<std::size_t>{}(point_light_count));
-	lighting_state_hash = hash::combine_hash(lighting_state_hash, std::hash<std::size_t>{}(spot_light_count));
-	lighting_state_hash = hash::combine_hash(lighting_state_hash, std::hash<std::size_t>{}(rectangle_light_count));
+	lighting.lighting_state_hash = std::hash<std::size_t>{}(lighting.light_probe_count);
+	lighting.lighting_state_hash = hash::combine_hash(lighting.lighting_state_hash, std::hash<std::size_t>{}(lighting.directional_light_count));
+	lighting.lighting_state_hash = hash::combine_hash(lighting.lighting_state_hash, std::hash<std::size_t>{}(lighting.directional_shadow_count));
+	lighting.lighting_state_hash = hash::combine_hash(lighting.lighting_state_hash, std::hash<std::size_t>{}(lighting.point_light_count));
+	lighting.lighting_state_hash = hash::combine_hash(lighting.lighting_state_hash, std::hash<std::size_t>{}(lighting.spot_light_count));
+	lighting.lighting_state_hash = hash::combine_hash(lighting.lighting_state_hash, std::hash<std::size_t>{}(lighting.rectangle_light_count));
+	
+	// Generate clustered lighting state hash
+	lighting.clustered_lighting_state_hash = std::hash<std::size_t>{}(lighting.light_probe_count);
+	lighting.clustered_lighting_state_hash = hash::combine_hash(lighting.clustered_lighting_state_hash, std::hash<std::size_t>{}(lighting.directional_light_count));
+	lighting.clustered_lighting_state_hash = hash::combine_hash(lighting.clustered_lighting_state_hash, std::hash<std::size_t>{}(lighting.directional_shadow_count));
+	lighting.clustered_lighting_state_hash = hash::combine_hash(lighting.clustered_lighting_state_hash, std::hash<std::size_t>{}(lighting.rectangle_light_count));
+	
+	// Generate light block lighting state hash
+	lighting.block_lighting_state_hash = std::hash<std::size_t>{}(lighting.light_probe_count);
+	lighting.block_lighting_state_hash = hash::combine_hash(lighting.block_lighting_state_hash, std::hash<std::size_t>{}(lighting.directional_shadow_count));
+	
+	// Cap the number of lights read from the light uniform block and light clusters
+	lighting.block_point_light_count = std::min(lighting.point_light_count, max_point_light_count);
+	lighting.block_spot_light_count = std::min(lighting.spot_light_count, max_spot_light_count);
+	const std::size_t dropped_light_count = (lighting.point_light_count - lighting.block_point_light_count) + (lighting.spot_light_count - lighting.block_spot_light_count);
+	if (dropped_light_count != lighting.dropped_light_count)
+	{
+		if (dropped_light_count)
+		{
+			debug::log_warning("{} point and spot lights exceed the light block capacity and will be ignored by clustered and light block shaders", dropped_light_count);
+		}
+		lighting.dropped_light_count = dropped_light_count;
+	}
+	
+	write_light_blocks(ctx, lighting);
+	evaluate_light_clusters(ctx, lighting);
+}
+
+void material_pass::write_light_blocks(const render::context& ctx, lighting_state& lighting)
+{
+	const light_block light_data
+	{
+		{lighting.directional_light_colors.data(), lighting.directional_light_count},
+		{lighting.directional_light_directions.data(), lighting.directional_light_count},
+		{lighting.point_light_colors.data(), lighting.block_point_light_count},
+		{lighting.point_light_positions.data(), lighting.block_point_light_count},
+		{lighting.spot_light_colors.data(), lighting.block_spot_light_count},
+		{lighting.spot_light_positions.data(), lighting.block_spot_light_count},
+		{lighting.spot_light_directions.data(), lighting.block_spot_light_count},
+		{lighting.spot_light_cutoffs.data(), lighting.block_spot_light_count},
+		{lighting.rectangle_light_colors.data(), lighting.rectangle_light_count},
+		{lighting.rectangle_light_corners.data(), lighting.rectangle_light_count * 4}
+	};
+	const auto light_block_allocation = ctx.stream_buffer->allocate(light_block_offsets.size, m_pipeline->get_uniform_buffer_offset_alignment());
+	pack_light_block(light_data, light_block_allocation.data);
+	
+	const shadow_block shadow_data
+	{
+		{lighting.directional_shadow_splits.data(), lighting.directional_shadow_count},
+		{lighting.directional_shadow_fade_ranges.data(), lighting.directional_shadow_count},
+		{lighting.directional_shadow_matrices.data(), lighting.directional_shadow_count}
+	};
+	const auto shadow_block_allocation = ctx.stream_buffer->allocate(shadow_block_offsets.size, m_pipeline->get_uniform_buffer_offset_alignment());
+	pack_shadow_block(shadow_data, shadow_block_allocation.data);
+	
+	// Bind blocks, which were packed directly into the stream buffer, and keep their allocations for reuse within the frame
+	lighting.block_buffers[0] = light_block_allocation.buffer;
+	lighting.block_buffers[1] = shadow_block_allocation.buffer;
+	lighting.block_offsets[0] = light_block_allocation.offset;
+	lighting.block_offsets[1] = shadow_block_allocation.offset;
+	static_assert(shadow_block_binding == light_block_binding + 1);
+	m_pipeline->bind_uniform_buffers(light_block_binding, lighting.block_buffers, lighting.block_offsets, light_block_sizes);
+}
+
+void material_pass::evaluate_light_clusters(const render::context& ctx, lighting_state& lighting)
+{
+	// Bound point lights, then spot lights, with view-space spheres
+	const float cutoff_illuminance = std::max(m_light_cutoff_illuminance, 1e-6f);
+	m_light_bounds.resize(lighting.block_point_light_count + lighting.block_spot_light_count);
+	for (std::size_t i = 0; i < lighting.block_point_light_count; ++i)
+	{
+		const auto center = lighting.point_light_positions[i] * ctx.camera->get_rotation();
+		m_light_bounds[i] = {center.x(), center.y(), center.z(), light_cutoff_radius(lighting.point_light_colors[i], cutoff_illuminance)};
+	}
+	for (std::size_t i = 0; i < lighting.block_spot_light_count; ++i)
+	{
+		const auto center = lighting.spot_light_positions[i] * ctx.camera->get_rotation();
+		m_light_bounds[lighting.block_point_light_count + i] = {center.x(), center.y(), center.z(), light_cutoff_radius(lighting.spot_light_colors[i], cutoff_illuminance)};
+	}
+	
+	// Assign lights to clusters
+	const auto& camera = *ctx.camera;
+	math::fvec4 clip_extents;
+	if (camera.is_orthographic())
+	{
+		clip_extents = {camera.get_clip_left(), camera.get_clip_right(), camera.get_clip_bottom(), camera.get_clip_top()};
+	}
+	else
+	{
+		const float extent_y = std::tan(camera.get_vertical_fov() * 0.5f);
+		const float extent_x = extent_y * camera.get_aspect_ratio();
+		clip_extents = {-extent_x, extent_x, -extent_y, extent_y};
+	}
+	m_light_cluster_grid.build(camera.is_orthographic(), clip_extents, camera.get_clip_near(), camera.get_clip_far(), m_light_bounds);
+	
+	// Upload clusters
+	const auto& dimensions = m_light_cluster_grid.get_dimensions();
+	const std::uint32_t cluster_texture_width = dimensions.x() * dimensions.y();
+	const std::uint32_t cluster_texture_height = dimensions.z();
+	if (!lighting.cluster_texture ||
+		lighting.cluster_texture->get_image_view()->get_image()->get_dimensions()[0] != cluster_texture_width ||
+		lighting.cluster_texture->get_image_view()->get_image()->get_dimensions()[1] != cluster_texture_height)
+	{
+		lighting.cluster_texture = make_uint_texture(gl::format::r32g32_uint, cluster_texture_width, cluster_texture_height);
+	}
+	lighting.cluster_texture->get_image_view()->get_image()->write
+	(
+		0,
+		0,
+		0,
+		0,
+		cluster_texture_width,
+		cluster_texture_height,
+		1,
+		gl::format::r32g32_uint,
+		std::as_bytes(m_light_cluster_grid.get_clusters())
+	);
+	
+	// Upload light indices, growing the light index texture if necessary
+	const auto light_indices = m_light_cluster_grid.get_light_indices();
+	const std::uint32_t row_count = static_cast<std::uint32_t>(light_indices.size() / light_index_texture_width);
+	const std::uint32_t remainder = static_cast<std::uint32_t>(light_indices.size() % light_index_texture_width);
+	const std::uint32_t min_height = std::max<std::uint32_t>(row_count + (remainder ? 1 : 0), 1);
+	if (!lighting.index_texture || lighting.index_texture->get_image_view()->get_image()->get_dimensions()[1] < min_height)
+	{
+		lighting.index_texture = make_uint_texture(gl::format::r32_uint, light_index_texture_width, std::bit_ceil(min_height));
+	}
+	if (row_count)
+	{
+		lighting.index_texture->get_image_view()->get_image()->write
+		(
+			0,
+			0,
+			0,
+			0,
+			light_index_texture_width,
+			row_count,
+			1,
+			gl::format::r32_uint,
+			std::as_bytes(light_indices.first(static_cast<std::size_t>(row_count) * light_index_texture_width))
+		);
+	}
+	if (remainder)
+	{
+		lighting.index_texture->get_image_view()->get_image()->write
+		(
+			0,
+			0,
+			row_count,
+			0,
+			remainder,
+			1,
+			1,
+			gl::format::r32_uint,
+			std::as_bytes(light_indices.last(remainder))
+		);
+	}
 }
 
 void material_pass::evaluate_misc(const render::context& ctx)
@@ -497,7 +838,7 @@ void material_pass::evaluate_misc(const render::context& ctx)
 	///mouse_position = ...
 }
 
-std::unique_ptr<gl::shader_program> material_pass::generate_shader_program(const gl::shader_template& shader_template, material_blend_mode blend_mode) const
+std::unique_ptr<gl::shader_program> material_pass::generate_shader_program(const gl::shader_template& shader_template, material_blend_mode blend_mode, bool instanced, bool clustered) const
 {
 	std::unordered_map<std::string, std::string> definitions;
 	
@@ -511,21 +852,46 @@ std::unique_ptr<gl::shader_program> material_pass::generate_shader_program(const
 	definitions["VERTEX_BARYCENTRIC"] = std::to_string(vertex_attribute_location::barycentric);
 	definitions["VERTEX_TARGET"]      = std::to_string(vertex_attribute_location::target);
 	
+	if (instanced)
+	{
+		definitions["VERTEX_INSTANCE_TRANSFORM"] = std::to_string(vertex_attribute_location::instance_transform);
+	}
+	
 	definitions["FRAGMENT_OUTPUT_COLOR"] = "0";
 	
-	definitions["LIGHT_PROBE_COUNT"] = std::to_string(light_probe_count);
-	definitions["DIRECTIONAL_LIGHT_COUNT"] = std::to_string(directional_light_count);
-	definitions["DIRECTIONAL_SHADOW_COUNT"] = std::to_string(directional_shadow_count);
-	definitions["POINT_LIGHT_COUNT"] = std::to_string(point_light_count);
-	definitions["SPOT_LIGHT_COUNT"] = std::to_string(spot_light_count);
-	definitions["RECTANGLE_LIGHT_COUNT"] = std::to_string(rectangle_light_count);
+	definitions["CAMERA_BLOCK_BINDING"] = std::to_string(camera_block_binding);
+	definitions["LIGHT_BLOCK_BINDING"] = std::to_string(light_block_binding);
+	definitions["SHADOW_BLOCK_BINDING"] = std::to_string(shadow_block_binding);
+	definitions["SKINNING_BLOCK_BINDING"] = std::to_string(skinning_block_binding);
+	definitions["MAX_DIRECTIONAL_LIGHT_COUNT"] = std::to_string(light_block_max_directional_light_count);
+	definitions["MAX_POINT_LIGHT_COUNT"] = std::to_string(max_point_light_count);
+	definitions["MAX_SPOT_LIGHT_COUNT"] = std::to_string(max_spot_light_count);
+	definitions["MAX_RECTANGLE_LIGHT_COUNT"] = std::to_string(light_block_max_rectangle_light_count);
+	definitions["MAX_DIRECTIONAL_SHADOW_COUNT"] = std::to_string(shadow_block_max_directional_shadow_count);
+	definitions["MAX_SHADOW_CASCADE_COUNT"] = std::to_string(shadow_block_max_cascade_count);
+	definitions["MAX_SKINNING_BONE_COUNT"] = std::to_string(skinning_block_max_bone_count);
+	
+	definitions["LIGHT_PROBE_COUNT"] = std::to_string(m_lighting->light_probe_count);
+	definitions["DIRECTIONAL_LIGHT_COUNT"] = std::to_string(m_lighting->directional_light_count);
+	definitions["DIRECTIONAL_SHADOW_COUNT"] = std::to_string(m_lighting->directional_shadow_count);
+	definitions["RECTANGLE_LIGHT_COUNT"] = std::to_string(m_lighting->rectangle_light_count);
+	
+	if (clustered)
+	{
+		definitions["CLUSTERED_LIGHTING"] = "1";
+	}
+	else
+	{
+		definitions["POINT_LIGHT_COUNT"] = std::to_string(m_lighting->point_light_count);
+		definitions["SPOT_LIGHT_COUNT"] = std::to_string(m_lighting->spot_light_count);
+	}
 	
 	if (blend_mode == material_blend_mode::masked)
 	{
 		definitions["MASKED_OPACITY"] = "1";
 	}
 	
-	auto shader_program = shader_template.build(definitions);
+	auto shader_program = m_pipeline->get_shader_cache().build(shader_template, definitions);
 	
 	if (!shader_program->linked())
 	{
@@ -536,83 +902,64 @@ std::unique_ptr<gl::shader_program> material_pass::generate_shader_program(const
 	return shader_program;
 }
 
-void material_pass::build_shader_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program) const
+void material_pass::build_shader_commands(std::vector<command>& commands, const gl::shader_program& shader_program) const
 {
+	const auto emit = [&](command_opcode opcode, const gl::shader_variable* variable)
+	{
+		commands.emplace_back(command{opcode, variable->type(), 0, variable, nullptr});
+	};
+	
 	// Bind shader program
-	command_buffer.emplace_back([&](){m_pipeline->bind_shader_program(&shader_program);});
+	commands.emplace_back(command{command_opcode::bind_shader_program, {}, 0, &shader_program, nullptr});
 	
 	// Update camera variables
 	if (auto view_var = shader_program.variable("view"))
 	{
-		command_buffer.emplace_back([&, view_var](){view_var->update(*view);});
+		emit(command_opcode::view, view_var);
 	}
 	if (auto inv_view_var = shader_program.variable("inv_view"))
 	{
-		command_buffer.emplace_back([&, inv_view_var](){inv_view_var->update(*inv_view);});
+		emit(command_opcode::inv_view, inv_view_var);
 	}
 	if (auto projection_var = shader_program.variable("projection"))
 	{
-		command_buffer.emplace_back([&, projection_var](){projection_var->update(*projection);});
+		emit(command_opcode::projection, projection_var);
 	}
 	if (auto view_projection_var = shader_program.variable("view_projection"))
 	{
-		command_buffer.emplace_back([&, view_projection_var](){view_projection_var->update(*view_projection);});
+		emit(command_opcode::view_projection, view_projection_var);
 	}
 	if (auto camera_position_var = shader_program.variable("camera_position"))
 	{
-		command_buffer.emplace_back([&, camera_position_var](){camera_position_var->update(*camera_position);});
+		emit(command_opcode::camera_position, camera_position_var);
 	}
 	if (auto camera_exposure_var = shader_program.variable("camera_exposure"))
 	{
-		command_buffer.emplace_back([&, camera_exposure_var](){camera_exposure_var->update(camera_exposure);});
+		emit(command_opcode::camera_exposure, camera_exposure_var);
 	}
 	
 	// Update IBL variables
 	if (auto brdf_lut_var = shader_program.variable("brdf_lut"))
 	{
-		command_buffer.emplace_back
-		(
-			[&, brdf_lut_var]()
-			{
-				brdf_lut_var->update(*brdf_lut);
-			}
-		);
+		emit(command_opcode::brdf_lut, brdf_lut_var);
 	}
 	
 	// Update light probe variables
-	if (light_probe_count)
+	if (m_lighting->light_probe_count)
 	{
 		if (auto light_probe_luminance_texture_var = shader_program.variable("light_probe_luminance_texture"))
 		{
-			command_buffer.emplace_back
-			(
-				[&, light_probe_luminance_texture_var]()
-				{
-					light_probe_luminance_texture_var->update(*light_probe_luminance_texture);
-				}
-			);
+			emit(command_opcode::light_probe_luminance_texture, light_probe_luminance_texture_var);
 		}
 		
 		if (auto light_probe_luminance_mip_scale_var = shader_program.variable("light_probe_luminance_mip_scale"))
 		{
-			command_buffer.emplace_back
-			(
-				[&, light_probe_luminance_mip_scale_var]()
-				{
-					light_probe_luminance_mip_scale_var->update(std::max<float>(static_cast<float>(light_probe_luminance_texture->get_image_view()->get_mip_level_count()) - 4.0f, 0.0f));
-				}
-			);
+			emit(command_opcode::light_probe_luminance_mip_scale, light_probe_luminance_mip_scale_var);
 		}
 		
 		if (auto light_probe_illuminance_texture_var = shader_program.variable("light_probe_illuminance_texture"))
 		{
-			command_buffer.emplace_back
-			(
-				[&, light_probe_illuminance_texture_var]()
-				{
-					light_probe_illuminance_texture_var->update(*light_probe_illuminance_texture);
-				}
-			);
+			emit(command_opcode::light_probe_illuminance_texture, light_probe_illuminance_texture_var);
 		}
 	}
 	
@@ -621,235 +968,181 @@ void material_pass::build_shader_command_buffer(std::vector<std::function<void()
 	{
 		if (auto ltc_lut_2_var = shader_program.variable("ltc_lut_2"))
 		{
-			command_buffer.emplace_back
-			(
-				[&, ltc_lut_1_var, ltc_lut_2_var]()
-				{
-					ltc_lut_1_var->update(*ltc_lut_1);
-					ltc_lut_2_var->update(*ltc_lut_2);
-				}
-			);
+			emit(command_opcode::ltc_lut_1, ltc_lut_1_var);
+			emit(command_opcode::ltc_lut_2, ltc_lut_2_var);
 		}
 	}
-	if (rectangle_light_count)
+	if (m_lighting->rectangle_light_count)
 	{
 		if (auto rectangle_light_colors_var = shader_program.variable("rectangle_light_colors"))
 		{
-			auto rectangle_light_corners_var = shader_program.variable("rectangle_light_corners");
-			
-			if (rectangle_light_corners_var)
+			if (auto rectangle_light_corners_var = shader_program.variable("rectangle_light_corners"))
 			{
-				command_buffer.emplace_back
-				(
-					[&, rectangle_light_colors_var, rectangle_light_corners_var]()
-					{
-						rectangle_light_colors_var->update(std::span<const math::fvec3>{rectangle_light_colors.data(), rectangle_light_count});
-						rectangle_light_corners_var->update(std::span<const math::fvec3>{rectangle_light_corners.data(), rectangle_light_count * 4});
-					}
-				);
+				emit(command_opcode::rectangle_light_colors, rectangle_light_colors_var);
+				emit(command_opcode::rectangle_light_corners, rectangle_light_corners_var);
 			}
 		}
 	}
 	
 	// Update directional light variables
-	if (directional_light_count)
+	if (m_lighting->directional_light_count)
 	{
 		if (auto directional_light_colors_var = shader_program.variable("directional_light_colors"))
 		{
 			if (auto directional_light_directions_var = shader_program.variable("directional_light_directions"))
 			{
-				command_buffer.emplace_back
-				(
-					[&, directional_light_colors_var, directional_light_directions_var]()
-					{
-						directional_light_colors_var->update(std::span<const math::fvec3>{directional_light_colors.data(), directional_light_count});
-						directional_light_directions_var->update(std::span<const math::fvec3>{directional_light_directions.data(), directional_light_count});
-					}
-				);
+				emit(command_opcode::directional_light_colors, directional_light_colors_var);
+				emit(command_opcode::directional_light_directions, directional_light_directions_var);
 			}
 		}
 	}
 	
 	// Update directional shadow variables
-	if (directional_shadow_count)
+	if (m_lighting->directional_shadow_count)
 	{
-		if (auto directional_shadow_maps_var = shader_program.variable("directional_shadow_maps"))
+		auto directional_shadow_maps_var = shader_program.variable("directional_shadow_maps");
+		auto directional_shadow_splits_var = shader_program.variable("directional_shadow_splits");
+		auto directional_shadow_fade_ranges_var = shader_program.variable("directional_shadow_fade_ranges");
+		auto directional_shadow_matrices_var = shader_program.variable("directional_shadow_matrices");
+		
+		if (directional_shadow_maps_var && directional_shadow_splits_var && directional_shadow_fade_ranges_var && directional_shadow_matrices_var)
 		{
-			auto directional_shadow_splits_var = shader_program.variable("directional_shadow_splits");
-			auto directional_shadow_fade_ranges_var = shader_program.variable("directional_shadow_fade_ranges");
-			auto directional_shadow_matrices_var = shader_program.variable("directional_shadow_matrices");
-			
-			if (directional_shadow_maps_var && directional_shadow_splits_var && directional_shadow_fade_ranges_var && directional_shadow_matrices_var)
-			{
-				command_buffer.emplace_back
-				(
-					[&, directional_shadow_maps_var, directional_shadow_splits_var, directional_shadow_fade_ranges_var, directional_shadow_matrices_var]()
-					{
-						directional_shadow_maps_var->update(std::span<const gl::texture_2d* const>{directional_shadow_maps.data(), directional_shadow_count});
-						
-						std::size_t offset = 0;
-						for (std::size_t i = 0; i < directional_shadow_count; ++i)
-						{
-							directional_shadow_splits_var->update(directional_shadow_splits[i], i);
-							directional_shadow_fade_ranges_var->update(directional_shadow_fade_ranges[i], i);
-							directional_shadow_matrices_var->update(directional_shadow_matrices[i], offset);
-							offset += directional_shadow_matrices[i].size();
-						}
-					}
-				);
-			}
+			emit(command_opcode::directional_shadow_maps, directional_shadow_maps_var);
+			emit(command_opcode::directional_shadow_splits, directional_shadow_splits_var);
+			emit(command_opcode::directional_shadow_fade_ranges, directional_shadow_fade_ranges_var);
+			emit(command_opcode::directional_shadow_matrices, directional_shadow_matrices_var);
 		}
 	}
 	
-	// Update point light variables
-	if (point_light_count)
+	// Update point light variables (point light arrays of clustered lighting shaders are present regardless of point light count)
+	if (auto point_light_colors_var = shader_program.variable("point_light_colors"))
 	{
-		if (auto point_light_colors_var = shader_program.variable("point_light_colors"))
+		if (auto point_light_positions_var = shader_program.variable("point_light_positions"))
 		{
-			auto point_light_positions_var = shader_program.variable("point_light_positions");
-			
-			if (point_light_positions_var)
-			{
-				command_buffer.emplace_back
-				(
-					[&, point_light_colors_var, point_light_positions_var]()
-					{
-						point_light_colors_var->update(std::span<const math::fvec3>{point_light_colors.data(), point_light_count});
-						point_light_positions_var->update(std::span<const math::fvec3>{point_light_positions.data(), point_light_count});
-					}
-				);
-			}
+			emit(command_opcode::point_light_colors, point_light_colors_var);
+			emit(command_opcode::point_light_positions, point_light_positions_var);
 		}
 	}
+	if (auto point_light_count_var = shader_program.variable("point_light_count"))
+	{
+		emit(command_opcode::point_light_count, point_light_count_var);
+	}
 	
 	// Update spot light variables
-	if (spot_light_count)
+	if (auto spot_light_colors_var = shader_program.variable("spot_light_colors"))
 	{
-		if (auto spot_light_colors_var = shader_program.variable("spot_light_colors"))
+		auto spot_light_positions_var = shader_program.variable("spot_light_positions");
+		auto spot_light_directions_var = shader_program.variable("spot_light_directions");
+		auto spot_light_cutoffs_var = shader_program.variable("spot_light_cutoffs");
+		
+		if (spot_light_positions_var && spot_light_directions_var && spot_light_cutoffs_var)
 		{
-			auto spot_light_positions_var = shader_program.variable("spot_light_positions");
-			auto spot_light_directions_var = shader_program.variable("spot_light_directions");
-			auto spot_light_cutoffs_var = shader_program.variable("spot_light_cutoffs");
-			
-			if (spot_light_positions_var && spot_light_directions_var && spot_light_cutoffs_var)
-			{
-				command_buffer.emplace_back
-				(
-					[&, spot_light_colors_var, spot_light_positions_var, spot_light_directions_var, spot_light_cutoffs_var]()
-					{
-						spot_light_colors_var->update(std::span<const math::fvec3>{spot_light_colors.data(), spot_light_count});
-						spot_light_positions_var->update(std::span<const math::fvec3>{spot_light_positions.data(), spot_light_count});
-						spot_light_directions_var->update(std::span<const math::fvec3>{spot_light_directions.data(), spot_light_count});
-						spot_light_cutoffs_var->update(std::span<const math::fvec2>{spot_light_cutoffs.data(), spot_light_count});
-					}
-				);
-			}
+			emit(command_opcode::spot_light_colors, spot_light_colors_var);
+			emit(command_opcode::spot_light_positions, spot_light_positions_var);
+			emit(command_opcode::spot_light_directions, spot_light_directions_var);
+			emit(command_opcode::spot_light_cutoffs, spot_light_cutoffs_var);
 		}
 	}
+	if (auto spot_light_count_var = shader_program.variable("spot_light_count"))
+	{
+		emit(command_opcode::spot_light_count, spot_light_count_var);
+	}
+	
+	// Update light cluster variables
+	auto light_cluster_texture_var = shader_program.variable("light_cluster_texture");
+	auto light_index_texture_var = shader_program.variable("light_index_texture");
+	auto light_cluster_dimensions_var = shader_program.variable("light_cluster_dimensions");
+	auto light_cluster_depth_transform_var = shader_program.variable("light_cluster_depth_transform");
+	if (light_cluster_texture_var && light_index_texture_var && light_cluster_dimensions_var && light_cluster_depth_transform_var)
+	{
+		emit(command_opcode::light_cluster_texture, light_cluster_texture_var);
+		emit(command_opcode::light_index_texture, light_index_texture_var);
+		emit(command_opcode::light_cluster_dimensions, light_cluster_dimensions_var);
+		emit(command_opcode::light_cluster_depth_transform, light_cluster_depth_transform_var);
+	}
 	
 	// Update time variable
 	if (auto time_var = shader_program.variable("time"))
 	{
-		command_buffer.emplace_back([&, time_var](){time_var->update(time);});
+		emit(command_opcode::time, time_var);
 	}
 	
 	// Update timestep variable
 	if (auto timestep_var = shader_program.variable("timestep"))
 	{
-		command_buffer.emplace_back([&, timestep_var](){timestep_var->update(timestep);});
+		emit(command_opcode::timestep, timestep_var);
 	}
 	
 	// Update frame variable
 	if (auto frame_var = shader_program.variable("frame"))
 	{
-		command_buffer.emplace_back([&, frame_var](){frame_var->update(frame);});
+		emit(command_opcode::frame, frame_var);
 	}
 	
 	// Update subframe variable
 	if (auto subframe_var = shader_program.variable("subframe"))
 	{
-		command_buffer.emplace_back([&, subframe_var](){subframe_var->update(subframe);});
+		emit(command_opcode::subframe, subframe_var);
 	}
 	
 	// Update resolution variable
 	if (auto resolution_var = shader_program.variable("resolution"))
 	{
-		command_buffer.emplace_back([&, resolution_var](){resolution_var->update(resolution);});
+		emit(command_opcode::resolution, resolution_var);
 	}
 	
 	// Update mouse position variable
 	if (auto mouse_position_var = shader_program.variable("mouse_position"))
 	{
-		command_buffer.emplace_back([&, mouse_position_var](){mouse_position_var->update(mouse_position);});
+		emit(command_opcode::mouse_position, mouse_position_var);
 	}
 }
 
-void material_pass::build_geometry_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program) const
+void material_pass::build_geometry_commands(std::vector<command>& commands, const gl::shader_program& shader_program) const
 {
+	const auto emit = [&](command_opcode opcode, const gl::shader_variable* variable)
+	{
+		commands.emplace_back(command{opcode, variable->type(), 0, variable, nullptr});
+	};
+	
 	// Update model matrix variable
 	if (auto model_var = shader_program.variable("model"))
 	{
-		command_buffer.emplace_back([&, model_var](){model_var->update(*model);});
+		emit(command_opcode::model, model_var);
 	}
 	
 	// Update normal-model matrix variable
 	if (auto normal_model_var = shader_program.variable("normal_model"))
 	{
-		command_buffer.emplace_back
-		(
-			[&, normal_model_var]()
-			{
-				normal_model_var->update(math::transpose(math::inverse(math::fmat3(*model))));
-			}
-		);
+		emit(command_opcode::normal_model, normal_model_var);
 	}
 	
-	// Update model-view matrix and normal-model-view matrix variables
-	auto model_view_var = shader_program.variable("model_view");
-	auto normal_model_view_var = shader_program.variable("normal_model_view");
-	if (model_view_var && normal_model_view_var)
+	// Update model-view matrix variable
+	if (auto model_view_var = shader_program.variable("model_view"))
 	{
-		command_buffer.emplace_back
-		(
-			[&, model_view_var, normal_model_view_var]()
-			{
-				model_view_var->update(model_view);
-				normal_model_view_var->update(math::transpose(math::inverse(math::fmat3(model_view))));
-			}
-		);
+		emit(command_opcode::model_view, model_view_var);
 	}
-	else
+	
+	// Update normal-model-view matrix variable
+	if (auto normal_model_view_var = shader_program.variable("normal_model_view"))
 	{
-		if (model_view_var)
-		{
-			command_buffer.emplace_back([&, model_view_var](){model_view_var->update(model_view);});
-		}
-		else if (normal_model_view_var)
-		{
-			command_buffer.emplace_back
-			(
-				[&, normal_model_view_var]()
-				{
-					normal_model_view_var->update(math::transpose(math::inverse(math::fmat3(model_view))));
-				}
-			);
-		}
+		emit(command_opcode::normal_model_view, normal_model_view_var);
 	}
 	
 	// Update model-view-projection matrix variable
 	if (auto model_view_projection_var = shader_program.variable("model_view_projection"))
 	{
-		command_buffer.emplace_back([&, model_view_projection_var](){model_view_projection_var->update((*projection) * model_view);});
+		emit(command_opcode::model_view_projection, model_view_projection_var);
 	}
 	
 	// Update skinning matrices variable
 	if (auto skinning_matrices_var = shader_program.variable("skinning_matrices"))
 	{
-		command_buffer.emplace_back([&, skinning_matrices_var](){skinning_matrices_var->update(skinning_matrices);});
+		emit(command_opcode::skinning_matrices, skinning_matrices_var);
 	}
 }
 
-void material_pass::build_material_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program, const material& material) const
+void material_pass::build_material_commands(std::vector<command>& commands, const gl::shader_program& shader_program, const material& material)
 {
 	for (const auto& [key, material_var]: material.get_variables())
 	{
@@ -859,284 +1152,212 @@ void material_pass::build_material_command_buffer(std::vector<std::function<void
 		}
 		
 		const auto shader_var = shader_program.variable(key);
-		if (!shader_var)
+		if (!shader_var || shader_var->type() != to_shader_variable_type(material_var->type()))
 		{
 			continue;
 		}
 		
-		const std::size_t size = std::min<std::size_t>(material_var->size(), shader_var->size());
+		/// @todo render::matvar_bool is broken due to the std::vector<bool> specialization.
+		if (shader_var->type() == gl::shader_variable_type::bvec1)
+		{
+			throw std::runtime_error("bvec1 unimplemented");
+		}
 		
-		switch (shader_var->type())
+		commands.emplace_back
+		(
+			command
+			{
+				command_opcode::material_variable,
+				shader_var->type(),
+				static_cast<std::uint32_t>(std::min<std::size_t>(material_var->size(), shader_var->size())),
+				shader_var,
+				material_variable_data(*material_var)
+			}
+		);
+	}
+}
+
+void material_pass::execute(std::span<const command> commands)
+{
+	for (const auto& command: commands)
+	{
+		// Shader program commands target a shader program
+		if (command.opcode == command_opcode::bind_shader_program)
 		{
-			/// @todo render::matvar_bool is broken due to the std::vector<bool> specialization.
-			case gl::shader_variable_type::bvec1:
-				throw std::runtime_error("bvec1 unimplemented");
+			m_pipeline->bind_shader_program(static_cast<const gl::shader_program*>(command.target));
+			continue;
+		}
+		
+		// All other commands target a shader variable
+		const auto& variable = *static_cast<const gl::shader_variable*>(command.target);
+		
+		// Count shader variable updates, noting texture variables follow all other types
+		++m_statistics.uniform_upload_count;
+		if (command.type >= gl::shader_variable_type::texture_1d)
+		{
+			++m_statistics.texture_bind_count;
+		}
+		
+		switch (command.opcode)
+		{
+			case command_opcode::bind_shader_program:
 				break;
 			
-			case gl::shader_variable_type::bvec2:
-				if (material_var->type() == material_variable_type::bvec2)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_bvec2>(material_var)]()
-						{
-							shader_var->update(std::span<const math::bvec2>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::view:
+				variable.update(*view);
 				break;
-			case gl::shader_variable_type::bvec3:
-				if (material_var->type() == material_variable_type::bvec3)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_bvec3>(material_var)]()
-						{
-							shader_var->update(std::span<const math::bvec3>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::inv_view:
+				variable.update(*inv_view);
 				break;
-			case gl::shader_variable_type::bvec4:
-				if (material_var->type() == material_variable_type::bvec4)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_bvec4>(material_var)]()
-						{
-							shader_var->update(std::span<const math::bvec4>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::projection:
+				variable.update(*projection);
 				break;
-			case gl::shader_variable_type::ivec1:
-				if (material_var->type() == material_variable_type::ivec1)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_int>(material_var)]()
-						{
-							shader_var->update(std::span<const int>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::view_projection:
+				variable.update(*view_projection);
 				break;
-			case gl::shader_variable_type::ivec2:
-				if (material_var->type() == material_variable_type::ivec2)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_ivec2>(material_var)]()
-						{
-							shader_var->update(std::span<const math::ivec2>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::camera_position:
+				variable.update(*camera_position);
 				break;
-			case gl::shader_variable_type::ivec3:
-				if (material_var->type() == material_variable_type::ivec3)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_ivec3>(material_var)]()
-						{
-							shader_var->update(std::span<const math::ivec3>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::camera_exposure:
+				variable.update(camera_exposure);
 				break;
-			case gl::shader_variable_type::ivec4:
-				if (material_var->type() == material_variable_type::ivec4)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_ivec4>(material_var)]()
-						{
-							shader_var->update(std::span<const math::ivec4>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::brdf_lut:
+				variable.update(*brdf_lut);
 				break;
-			case gl::shader_variable_type::uvec1:
-				if (material_var->type() == material_variable_type::uvec1)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_uint>(material_var)]()
-						{
-							shader_var->update(std::span<const unsigned int>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::light_probe_luminance_texture:
+				variable.update(*m_lighting->light_probe_luminance_texture);
 				break;
-			case gl::shader_variable_type::uvec2:
-				if (material_var->type() == material_variable_type::uvec2)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_uvec2>(material_var)]()
-						{
-							shader_var->update(std::span<const math::uvec2>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::light_probe_luminance_mip_scale:
+				variable.update(std::max<float>(static_cast<float>(m_lighting->light_probe_luminance_texture->get_image_view()->get_mip_level_count()) - 4.0f, 0.0f));
 				break;
-			case gl::shader_variable_type::uvec3:
-				if (material_var->type() == material_variable_type::uvec3)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_uvec3>(material_var)]()
-						{
-							shader_var->update(std::span<const math::uvec3>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::light_probe_illuminance_texture:
+				variable.update(*m_lighting->light_probe_illuminance_texture);
 				break;
-			case gl::shader_variable_type::uvec4:
-				if (material_var->type() == material_variable_type::uvec4)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_uvec4>(material_var)]()
-						{
-							shader_var->update(std::span<const math::uvec4>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::ltc_lut_1:
+				variable.update(*ltc_lut_1);
 				break;
-			case gl::shader_variable_type::fvec1:
-				if (material_var->type() == material_variable_type::fvec1)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_float>(material_var)]()
-						{
-							shader_var->update(std::span<const float>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::ltc_lut_2:
+				variable.update(*ltc_lut_2);
 				break;
-			case gl::shader_variable_type::fvec2:
-				if (material_var->type() == material_variable_type::fvec2)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fvec2>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fvec2>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::rectangle_light_colors:
+				variable.update(std::span<const math::fvec3>{m_lighting->rectangle_light_colors.data(), m_lighting->rectangle_light_count});
 				break;
-			case gl::shader_variable_type::fvec3:
-				if (material_var->type() == material_variable_type::fvec3)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fvec3>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fvec3>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::rectangle_light_corners:
+				variable.update(std::span<const math::fvec3>{m_lighting->rectangle_light_corners.data(), m_lighting->rectangle_light_count * 4});
 				break;
-			case gl::shader_variable_type::fvec4:
-				if (material_var->type() == material_variable_type::fvec4)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fvec4>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fvec4>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::directional_light_colors:
+				variable.update(std::span<const math::fvec3>{m_lighting->directional_light_colors.data(), m_lighting->directional_light_count});
 				break;
-			case gl::shader_variable_type::fmat2:
-				if (material_var->type() == material_variable_type::fmat2)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fmat2>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fmat2>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::directional_light_directions:
+				variable.update(std::span<const math::fvec3>{m_lighting->directional_light_directions.data(), m_lighting->directional_light_count});
 				break;
-			case gl::shader_variable_type::fmat3:
-				if (material_var->type() == material_variable_type::fmat3)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fmat3>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fmat3>{material_var->data(), size});
-						}
-					);
-				}
+			
+			case command_opcode::directional_shadow_maps:
+				variable.update(std::span<const gl::texture_2d* const>{m_lighting->directional_shadow_maps.data(), m_lighting->directional_shadow_count});
 				break;
-			case gl::shader_variable_type::fmat4:
-				if (material_var->type() == material_variable_type::fmat4)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_fmat4>(material_var)]()
-						{
-							shader_var->update(std::span<const math::fmat4>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::directional_shadow_splits:
+				variable.update(std::span<const math::fvec4>{m_lighting->directional_shadow_splits.data(), m_lighting->directional_shadow_count});
 				break;
-			case gl::shader_variable_type::texture_1d:
-				if (material_var->type() == material_variable_type::texture_1d)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_texture_1d>(material_var)]()
-						{
-							shader_var->update(std::span<const std::shared_ptr<gl::texture_1d>>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::directional_shadow_fade_ranges:
+				variable.update(std::span<const float>{m_lighting->directional_shadow_fade_ranges.data(), m_lighting->directional_shadow_count});
 				break;
-			case gl::shader_variable_type::texture_2d:
-				if (material_var->type() == material_variable_type::texture_2d)
+			case command_opcode::directional_shadow_matrices:
+			{
+				std::size_t offset = 0;
+				for (std::size_t i = 0; i < m_lighting->directional_shadow_count; ++i)
 				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_texture_2d>(material_var)]()
-						{
-							shader_var->update(std::span<const std::shared_ptr<gl::texture_2d>>{material_var->data(), size});
-						}
-					);
+					variable.update(m_lighting->directional_shadow_matrices[i], offset);
+					offset += m_lighting->directional_shadow_matrices[i].size();
 				}
 				break;
-			case gl::shader_variable_type::texture_3d:
-				if (material_var->type() == material_variable_type::texture_3d)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_texture_3d>(material_var)]()
-						{
-							shader_var->update(std::span<const std::shared_ptr<gl::texture_3d>>{material_var->data(), size});
-						}
-					);
-				}
+			}
+			
+			case command_opcode::point_light_colors:
+				variable.update(std::span<const math::fvec3>{m_lighting->point_light_colors.data(), m_lighting->point_light_count});
 				break;
-			case gl::shader_variable_type::texture_cube:
-				if (material_var->type() == material_variable_type::texture_cube)
-				{
-					command_buffer.emplace_back
-					(
-						[size, shader_var, material_var = std::static_pointer_cast<matvar_texture_cube>(material_var)]()
-						{
-							shader_var->update(std::span<const std::shared_ptr<gl::texture_cube>>{material_var->data(), size});
-						}
-					);
-				}
+			case command_opcode::point_light_positions:
+				variable.update(std::span<const math::fvec3>{m_lighting->point_light_positions.data(), m_lighting->point_light_count});
+				break;
+			
+			case command_opcode::spot_light_colors:
+				variable.update(std::span<const math::fvec3>{m_lighting->spot_light_colors.data(), m_lighting->spot_light_count});
+				break;
+			case command_opcode::spot_light_positions:
+				variable.update(std::span<const math::fvec3>{m_lighting->spot_light_positions.data(), m_lighting->spot_light_count});
+				break;
+			case command_opcode::spot_light_directions:
+				variable.update(std::span<const math::fvec3>{m_lighting->spot_light_directions.data(), m_lighting->spot_light_count});
+				break;
+			case command_opcode::spot_light_cutoffs:
+				variable.update(std::span<const math::fvec2>{m_lighting->spot_light_cutoffs.data(), m_lighting->spot_light_count});
+				break;
+			case command_opcode::point_light_count:
+				variable.update(static_cast<unsigned int>(m_lighting->block_point_light_count));
+				break;
+			case command_opcode::spot_light_count:
+				variable.update(static_cast<unsigned int>(m_lighting->block_spot_light_count));
+				break;
+			
+			case command_opcode::light_cluster_texture:
+				variable.update(*m_lighting->cluster_texture);
+				break;
+			case command_opcode::light_index_texture:
+				variable.update(*m_lighting->index_texture);
 				break;
+			case command_opcode::light_cluster_dimensions:
+				variable.update(m_light_cluster_grid.get_dimensions());
+				break;
+			case command_opcode::light_cluster_depth_transform:
+				variable.update(m_light_cluster_grid.get_depth_slice_transform());
+				break;
+			
+			case command_opcode::time:
+				variable.update(time);
+				break;
+			case command_opcode::timestep:
+				variable.update(timestep);
+				break;
+			case command_opcode::frame:
+				variable.update(frame);
+				break;
+			case command_opcode::subframe:
+				variable.update(subframe);
+				break;
+			case command_opcode::resolution:
+				variable.update(resolution);
+				break;
+			case command_opcode::mouse_position:
+				variable.update(mouse_position);
+				break;
+			
+			case command_opcode::model:
+				variable.update(*model);
+				break;
+			case command_opcode::normal_model:
+				variable.update(math::transpose(math::inverse(math::fmat3(*model))));
+				break;
+			case command_opcode::model_view:
+				variable.update(model_view);
+				break;
+			case command_opcode::normal_model_view:
+				variable.update(math::transpose(math::inverse(math::fmat3(model_view))));
+				break;
+			case command_opcode::model_view_projection:
+				variable.update((*projection) * model_view);
+				break;
+			case command_opcode::skinning_matrices:
+				variable.update(skinning_matrices);
+				break;
+			
+			case command_opcode::material_variable:
+				update_material_variable(variable, command.type, command.data, command.count);
+				break;
+			
 			default:
 				break;
 		}
@@ -7,13 +7,22 @@
 #include <engine/render/pass.hpp>
 #include <engine/render/material.hpp>
 #include <engine/render/material-blend-mode.hpp>
+#include <engine/render/operation-sorter.hpp>
+#include <engine/render/light-cluster-grid.hpp>
+#include <engine/render/uniform-blocks.hpp>
 #include <engine/math/vector.hpp>
 #include <engine/gl/shader-program.hpp>
 #include <engine/gl/shader-variable.hpp>
+#include <engine/gl/shader-variable-type.hpp>
 #include <engine/gl/texture.hpp>
-#include <functional>
+#include <engine/gl/vertex-buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <span>
+#include <utility>
+#include <vector>
 
 class resource_manager;
 
@@ -21,6 +30,13 @@ namespace render {
 
 /**
  * Renders scene objects using their material-specified shaders and properties.
+ *
+ * Shader templates with a `#pragma define CLUSTERED_LIGHTING` directive use clustered forward lighting: point and spot lights are assigned to the clusters of a light cluster grid on the CPU, and shaders loop over the lights of the cluster containing each fragment. Such shaders declare point and spot light arrays of fixed capacities, `MAX_POINT_LIGHT_COUNT` and `MAX_SPOT_LIGHT_COUNT`, so changes in the number of point and spot lights don't generate new shader programs.
+ *
+ * Shader templates with a `#pragma define LIGHT_BLOCK_BINDING` directive read lights from the light uniform block rather than from individual shader variables. Such shaders declare light arrays of the fixed block capacities, so changes in the number of lights, other than light probes and directional shadows, don't generate new shader programs. The light and shadow uniform blocks are written whenever lights are evaluated for a new layer mask, and the camera uniform block is written by the renderer.
+ *
+ * @see light_cluster_grid
+ * @see uniform-blocks.hpp
  */
 class material_pass: public pass
 {
@@ -40,19 +56,206 @@ public:
 		mouse_position = position;
 	}
 	
+	/**
+	 * Sets the illuminance below which clustered point and spot lights are considered to have no influence. Determines the radii of the light bounds assigned to light clusters.
+	 *
+	 * @param illuminance Exposure-normalized cutoff illuminance.
+	 */
+	inline void set_light_cutoff_illuminance(float illuminance) noexcept
+	{
+		m_light_cutoff_illuminance = illuminance;
+	}
+	
+	/// Returns the light cluster grid.
+	[[nodiscard]] inline light_cluster_grid& get_light_cluster_grid() noexcept
+	{
+		return m_light_cluster_grid;
+	}
+	
+	/// Returns the illuminance below which clustered point and spot lights are considered to have no influence.
+	[[nodiscard]] inline float get_light_cutoff_illuminance() const noexcept
+	{
+		return m_light_cutoff_illuminance;
+	}
+	
+	/// Maximum number of point lights in clustered and light block shaders. Point lights in excess of this are ignored by these shaders.
+	static constexpr std::size_t max_point_light_count = light_block_max_point_light_count;
+	
+	/// Maximum number of spot lights in clustered and light block shaders. Spot lights in excess of this are ignored by these shaders.
+	static constexpr std::size_t max_spot_light_count = light_block_max_spot_light_count;
+	
 private:
+	/// Shader variable update command opcodes.
+	enum class command_opcode: std::uint8_t
+	{
+		bind_shader_program,
+		view,
+		inv_view,
+		projection,
+		view_projection,
+		camera_position,
+		camera_exposure,
+		brdf_lut,
+		light_probe_luminance_texture,
+		light_probe_luminance_mip_scale,
+		light_probe_illuminance_texture,
+		ltc_lut_1,
+		ltc_lut_2,
+		rectangle_light_colors,
+		rectangle_light_corners,
+		directional_light_colors,
+		directional_light_directions,
+		directional_shadow_maps,
+		directional_shadow_splits,
+		directional_shadow_fade_ranges,
+		directional_shadow_matrices,
+		point_light_colors,
+		point_light_positions,
+		spot_light_colors,
+		spot_light_positions,
+		spot_light_directions,
+		spot_light_cutoffs,
+		point_light_count,
+		spot_light_count,
+		light_cluster_texture,
+		light_index_texture,
+		light_cluster_dimensions,
+		light_cluster_depth_transform,
+		time,
+		timestep,
+		frame,
+		subframe,
+		resolution,
+		mouse_position,
+		model,
+		normal_model,
+		model_view,
+		normal_model_view,
+		model_view_projection,
+		skinning_matrices,
+		material_variable
+	};
+	
+	/**
+	 * Shader variable update command.
+	 *
+	 * Render state commands read their values from the pass when executed. Material variable commands point directly into the element storage of a material variable.
+	 */
+	struct command
+	{
+		/// Command opcode.
+		command_opcode opcode;
+		
+		/// Type of the shader variable to update.
+		gl::shader_variable_type type;
+		
+		/// Number of material variable elements to upload.
+		std::uint32_t count;
+		
+		/// Shader variable to update, or shader program to bind.
+		const void* target;
+		
+		/// Pointer to the first material variable element.
+		const void* data;
+	};
+	
+	/// Material command stream, tagged with the material generation from which it was recorded.
+	struct material_command_stream
+	{
+		std::uint64_t generation{0};
+		std::vector<command> commands;
+	};
+	
 	struct shader_cache_entry
 	{
 		std::unique_ptr<gl::shader_program> shader_program;
 		
-		/// Command buffer which enables the shader and updates render state-related shader variables.
-		std::vector<std::function<void()>> shader_command_buffer;
+		/// Commands which bind the shader and update render state-related shader variables.
+		std::vector<command> shader_commands;
+		
+		/// Commands which update geometry-related shader variables.
+		std::vector<command> geometry_commands;
+		
+		/// Map of materials to commands which update corresponding material shader variables.
+		std::unordered_map<const material*, material_command_stream> material_commands;
+	};
+	
+	/// Camera and layer mask for which lighting is evaluated.
+	using lighting_key = std::pair<const scene::camera*, std::uint32_t>;
+	
+	/// Hashes the camera and layer mask of a lighting state.
+	struct lighting_key_hash
+	{
+		[[nodiscard]] std::size_t operator()(const lighting_key& key) const noexcept;
+	};
+	
+	/// Lighting evaluated for a camera and layer mask.
+	struct lighting_state
+	{
+		/// Frame in which the lighting was last evaluated.
+		unsigned int frame{0};
+		
+		// Light probes
+		const gl::texture_cube* light_probe_luminance_texture{};
+		const gl::texture_1d* light_probe_illuminance_texture{};
+		std::size_t light_probe_count{0};
+		
+		// Point lights
+		std::vector<math::fvec3> point_light_colors;
+		std::vector<math::fvec3> point_light_positions;
+		std::size_t point_light_count{0};
+		
+		// Directional lights
+		std::vector<math::fvec3> directional_light_colors;
+		std::vector<math::fvec3> directional_light_directions;
+		std::size_t directional_light_count{0};
+		
+		// Directional shadows
+		std::vector<const gl::texture_2d*> directional_shadow_maps;
+		std::vector<math::fvec4> directional_shadow_splits;
+		std::vector<float> directional_shadow_fade_ranges;
+		std::vector<std::span<const math::fmat4>> directional_shadow_matrices;
+		std::size_t directional_shadow_count{0};
+		
+		// Spot lights
+		std::vector<math::fvec3> spot_light_colors;
+		std::vector<math::fvec3> spot_light_positions;
+		std::vector<math::fvec3> spot_light_directions;
+		std::vector<math::fvec2> spot_light_cutoffs;
+		std::size_t spot_light_count{0};
+		
+		// Rectangle lights
+		std::vector<math::fvec3> rectangle_light_colors;
+		std::vector<math::fvec3> rectangle_light_corners;
+		std::size_t rectangle_light_count{0};
+		
+		/// Number of point lights in the light uniform block and light clusters.
+		std::size_t block_point_light_count{0};
+		
+		/// Number of spot lights in the light uniform block and light clusters.
+		std::size_t block_spot_light_count{0};
+		
+		/// Number of point and spot lights in excess of the light uniform block capacity, as last logged.
+		std::size_t dropped_light_count{0};
+		
+		/// Stream buffer allocations of the light and shadow uniform blocks.
+		const gl::vertex_buffer* block_buffers[2]{};
+		std::size_t block_offsets[2]{};
 		
-		/// Command buffer which updates geometry-related shader variables.
-		std::vector<std::function<void()>> geometry_command_buffer;
+		/// Texture containing the offset and count of the light indices of each cluster.
+		std::shared_ptr<gl::texture_2d> cluster_texture;
 		
-		/// Map of materials to command buffers which update corresponding material shader variables.
-		std::unordered_map<const material*, std::vector<std::function<void()>>> material_command_buffers;
+		/// Texture containing the light indices of all clusters.
+		std::shared_ptr<gl::texture_2d> index_texture;
+		
+		/// Hash of the lighting state.
+		std::size_t lighting_state_hash{0};
+		
+		/// Hash of the lighting state, excluding the number of clustered lights.
+		std::size_t clustered_lighting_state_hash{0};
+		
+		/// Hash of the lighting state, excluding the number of lights in the light uniform block.
+		std::size_t block_lighting_state_hash{0};
 	};
 	
 	/// Map of state hashes to shader cache entries.
@@ -64,17 +267,34 @@ private:
 	void evaluate_camera(const render::context& ctx);
 	
 	/**
-	 * Evaluates scene lights and stores lighting information in local variables to be passed to shaders.
+	 * Evaluates the scene lights visible to the active camera in a layer mask, unless they were already evaluated this frame, and makes them the active lighting state.
 	 */
 	void evaluate_lighting(const render::context& ctx, std::uint32_t layer_mask);
 	
 	void evaluate_misc(const render::context& ctx);
 	
-	[[nodiscard]] std::unique_ptr<gl::shader_program> generate_shader_program(const gl::shader_template& shader_template, material_blend_mode blend_mode) const;
+	/**
+	 * Writes the light and shadow uniform blocks of a lighting state.
+	 */
+	void write_light_blocks(const render::context& ctx, lighting_state& lighting);
+	
+	/**
+	 * Assigns the point and spot lights of a lighting state to light clusters and uploads the clusters into its light cluster textures.
+	 */
+	void evaluate_light_clusters(const render::context& ctx, lighting_state& lighting);
 	
-	void build_shader_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program) const;
-	void build_geometry_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program) const;
-	void build_material_command_buffer(std::vector<std::function<void()>>& command_buffer, const gl::shader_program& shader_program, const material& material) const;
+	[[nodiscard]] std::unique_ptr<gl::shader_program> generate_shader_program(const gl::shader_template& shader_template, material_blend_mode blend_mode, bool instanced, bool clustered) const;
+	
+	void build_shader_commands(std::vector<command>& commands, const gl::shader_program& shader_program) const;
+	void build_geometry_commands(std::vector<command>& commands, const gl::shader_program& shader_program) const;
+	static void build_material_commands(std::vector<command>& commands, const gl::shader_program& shader_program, const material& material);
+	
+	/**
+	 * Executes a command stream.
+	 *
+	 * @param commands Commands to execute, in order.
+	 */
+	void execute(std::span<const command> commands);
 	
 	// Camera
 	const math::fmat4* view;
@@ -87,39 +307,14 @@ private:
 	const math::fvec3* camera_position;
 	float camera_exposure;
 	
-	// Light probes
-	const gl::texture_cube* light_probe_luminance_texture{};
-	const gl::texture_1d* light_probe_illuminance_texture{};
-	std::size_t light_probe_count;
-	
-	// Point lights
-	std::vector<math::fvec3> point_light_colors;
-	std::vector<math::fvec3> point_light_positions;
-	std::size_t point_light_count;
-	
-	// Directional lights
-	std::vector<math::fvec3> directional_light_colors;
-	std::vector<math::fvec3> directional_light_directions;
-	std::size_t directional_light_count;
-	
-	// Directional shadows
-	std::vector<const gl::texture_2d*> directional_shadow_maps;
-	std::vector<math::fvec4> directional_shadow_splits;
-	std::vector<float> directional_shadow_fade_ranges;
-	std::vector<std::span<const math::fmat4>> directional_shadow_matrices;
-	std::size_t directional_shadow_count;
-	
-	// Spot lights
-	std::vector<math::fvec3> spot_light_colors;
-	std::vector<math::fvec3> spot_light_positions;
-	std::vector<math::fvec3> spot_light_directions;
-	std::vector<math::fvec2> spot_light_cutoffs;
-	std::size_t spot_light_count;
-	
-	// Rectangle lights
-	std::vector<math::fvec3> rectangle_light_colors;
-	std::vector<math::fvec3> rectangle_light_corners;
-	std::size_t rectangle_light_count;
+	// Lighting
+	std::unordered_map<lighting_key, lighting_state, lighting_key_hash> m_lighting_states;
+	const lighting_state* m_lighting{};
+	
+	// Light clusters
+	light_cluster_grid m_light_cluster_grid;
+	std::vector<math::fvec4> m_light_bounds;
+	float m_light_cutoff_illuminance{1.0f / 256.0f};
 	
 	// LTC
 	std::shared_ptr<gl::texture_2d> ltc_lut_1;
@@ -140,10 +335,10 @@ private:
 	const math::fmat4* model;
 	std::span<const math::fmat4> skinning_matrices;
 	
-	/// Hash of the lighting state.
-	std::size_t lighting_state_hash;
-	
 	std::shared_ptr<render::material> fallback_material;
+	
+	/// Sorts render operations by their sort keys.
+	operation_sorter m_operation_sorter;
 };
 
 } // namespace render
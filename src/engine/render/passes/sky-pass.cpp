@@ -13,6 +13,7 @@
 #include <engine/render/context.hpp>
 #include <engine/render/model.hpp>
 #include <engine/render/material.hpp>
+#include <engine/render/uniform-blocks.hpp>
 #include <engine/scene/camera.hpp>
 #include <engine/math/functions.hpp>
 #include <engine/math/vector.hpp>
@@ -26,6 +27,16 @@
 
 namespace render {
 
+namespace {
+
+/// Shader template definitions of the camera uniform block, which sky, moon, and star shaders may read instead of individual camera variables.
+const gl::shader_template::dictionary_type camera_block_definitions =
+{
+	{"CAMERA_BLOCK_BINDING", std::to_string(camera_block_binding)}
+};
+
+} // namespace
+
 sky_pass::sky_pass(gl::pipeline* pipeline, const gl::framebuffer* framebuffer, resource_manager* resource_manager):
 	pass(pipeline, framebuffer),
 	mouse_position{0.0f, 0.0f},
@@ -114,7 +125,7 @@ sky_pass::sky_pass(gl::pipeline* pipeline, const gl::framebuffer* framebuffer, r
 	m_sky_probe_shader_template = resource_manager->load<gl::shader_template>("sky-probe.glsl");
 	
 	// Build sky probe shader program
-	m_sky_probe_shader_program = m_sky_probe_shader_template->build({});
+	m_sky_probe_shader_program = m_pipeline->get_shader_cache().build(*m_sky_probe_shader_template);
 	if (!m_sky_probe_shader_program->linked())
 	{
 		debug::log_error("Failed to build sky probe shader program: {}", m_sky_probe_shader_program->info());
@@ -522,7 +533,7 @@ void sky_pass::set_sky_model(std::shared_ptr<render::model> model)
 		
 		if (m_sky_material)
 		{
-			sky_shader_program = m_sky_material->get_shader_template()->build();
+			sky_shader_program = m_pipeline->get_shader_cache().build(*m_sky_material->get_shader_template(), camera_block_definitions);
 			
 			if (sky_shader_program->linked())
 			{
@@ -578,7 +589,7 @@ void sky_pass::set_moon_model(std::shared_ptr<render::model> model)
 		
 		if (m_moon_material)
 		{
-			moon_shader_program = m_moon_material->get_shader_template()->build();	
+			moon_shader_program = m_pipeline->get_shader_cache().build(*m_moon_material->get_shader_template(), camera_block_definitions);	
 			
 			if (moon_shader_program->linked())
 			{
@@ -631,7 +642,7 @@ void sky_pass::set_stars_model(std::shared_ptr<render::model> model)
 		
 		if (m_stars_material)
 		{
-			star_shader_program = m_stars_material->get_shader_template()->build();
+			star_shader_program = m_pipeline->get_shader_cache().build(*m_stars_material->get_shader_template(), camera_block_definitions);
 			
 			if (star_shader_program->linked())
 			{
@@ -873,8 +884,9 @@ void sky_pass::rebuild_transmittance_lut_framebuffer()
 
 void sky_pass::rebuild_transmittance_lut_shader_program()
 {
-	m_transmittance_lut_shader_program = m_transmittance_lut_shader_template->build
+	m_transmittance_lut_shader_program = m_pipeline->get_shader_cache().build
 	(
+		*m_transmittance_lut_shader_template,
 		{
 			{"SAMPLE_COUNT", std::to_string(m_transmittance_lut_sample_count)}
 		}
@@ -981,8 +993,9 @@ void sky_pass::rebuild_multiscattering_lut_framebuffer()
 
 void sky_pass::rebuild_multiscattering_lut_shader_program()
 {
-	m_multiscattering_lut_shader_program = m_multiscattering_lut_shader_template->build
+	m_multiscattering_lut_shader_program = m_pipeline->get_shader_cache().build
 	(
+		*m_multiscattering_lut_shader_template,
 		{
 			{"DIRECTION_SAMPLE_COUNT", std::to_string(m_multiscattering_lut_direction_sample_count)},
 			{"SCATTER_SAMPLE_COUNT", std::to_string(m_multiscattering_lut_scatter_sample_count)}
@@ -1098,8 +1111,9 @@ void sky_pass::rebuild_luminance_lut_framebuffer()
 
 void sky_pass::rebuild_luminance_lut_shader_program()
 {
-	m_luminance_lut_shader_program = m_luminance_lut_shader_template->build
+	m_luminance_lut_shader_program = m_pipeline->get_shader_cache().build
 	(
+		*m_luminance_lut_shader_template,
 		{
 			{"SAMPLE_COUNT", std::to_string(m_luminance_lut_sample_count)}
 		}
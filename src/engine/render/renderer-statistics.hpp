@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_RENDERER_STATISTICS_HPP
+#define ANTKEEPER_RENDER_RENDERER_STATISTICS_HPP
+
+#include <engine/gl/pipeline-statistics.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace render {
+
+/**
+ * Statistics of the most recent frame rendered by a renderer.
+ *
+ * Stage CPU times are summed over all cameras. The statistics of individual passes are recorded by the passes themselves.
+ *
+ * @see pass::get_statistics()
+ */
+struct renderer_statistics
+{
+	/// Total CPU time spent rendering the frame.
+	std::chrono::steady_clock::duration cpu_time{};
+	
+	/// CPU time spent in the light probe stage.
+	std::chrono::steady_clock::duration light_probe_stage_cpu_time{};
+	
+	/// CPU time spent in the culling stage.
+	std::chrono::steady_clock::duration culling_stage_cpu_time{};
+	
+	/// CPU time spent in the skinning stage.
+	std::chrono::steady_clock::duration skinning_stage_cpu_time{};
+	
+	/// CPU time spent in the cascaded shadow map stage.
+	std::chrono::steady_clock::duration cascaded_shadow_map_stage_cpu_time{};
+	
+	/// CPU time spent in the queue stage.
+	std::chrono::steady_clock::duration queue_stage_cpu_time{};
+	
+	/// CPU time spent in the batching stage.
+	std::chrono::steady_clock::duration batching_stage_cpu_time{};
+	
+	/// CPU time spent in the instancing stage.
+	std::chrono::steady_clock::duration instancing_stage_cpu_time{};
+	
+	/// CPU time spent in compositors, executing render passes.
+	std::chrono::steady_clock::duration compositor_cpu_time{};
+	
+	/// Commands issued through the graphics pipeline during the frame.
+	gl::pipeline_statistics pipeline;
+	
+	/// Number of cameras rendered.
+	std::uint64_t camera_count{};
+	
+	/// Number of visible objects, summed over all cameras.
+	std::uint64_t object_count{};
+	
+	/// Number of render operations passed to compositors, summed over all cameras.
+	std::uint64_t operation_count{};
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_RENDERER_STATISTICS_HPP
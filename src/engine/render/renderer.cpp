@@ -4,6 +4,7 @@
 #include <engine/render/renderer.hpp>
 #include <engine/render/context.hpp>
 #include <engine/render/compositor.hpp>
+#include <engine/render/uniform-blocks.hpp>
 #include <engine/scene/collection.hpp>
 #include <engine/scene/camera.hpp>
 #include <engine/scene/static-mesh.hpp>
@@ -16,17 +17,31 @@
 #include <engine/config.hpp>
 #include <engine/math/quaternion.hpp>
 #include <engine/math/constants.hpp>
+#include <chrono>
 #include <functional>
 #include <set>
 
 namespace render {
 
-renderer::renderer(gl::pipeline& pipeline, ::resource_manager& resource_manager)
+namespace {
+
+/// Initial size of the stream buffer, in bytes.
+constexpr std::size_t stream_buffer_capacity = 1 << 22;
+
+} // namespace
+
+renderer::renderer(gl::pipeline& pipeline, ::resource_manager& resource_manager):
+	m_pipeline(&pipeline)
 {
 	m_light_probe_stage = std::make_unique<render::light_probe_stage>(pipeline, resource_manager);
 	m_cascaded_shadow_map_stage = std::make_unique<render::cascaded_shadow_map_stage>(pipeline, resource_manager);
 	m_culling_stage = std::make_unique<render::culling_stage>();
+	m_skinning_stage = std::make_unique<render::skinning_stage>();
 	m_queue_stage = std::make_unique<render::queue_stage>();
+	m_batching_stage = std::make_unique<render::batching_stage>();
+	m_instancing_stage = std::make_unique<render::instancing_stage>();
+	
+	m_stream_buffer = std::make_unique<gl::stream_buffer>(stream_buffer_capacity);
 }
 
 void renderer::render(float t, float dt, float alpha, scene::collection& collection)
@@ -36,9 +51,25 @@ void renderer::render(float t, float dt, float alpha, scene::collection& collect
 	m_ctx.t = t;
 	m_ctx.dt = dt;
 	m_ctx.alpha = alpha;
+	m_ctx.frame = m_frame;
+	m_ctx.stream_buffer = m_stream_buffer.get();
+	m_ctx.uniform_buffer_offset_alignment = m_pipeline->get_uniform_buffer_offset_alignment();
+	
+	// Reset statistics
+	m_statistics = {};
+	const auto pipeline_statistics = m_pipeline->get_statistics();
+	const auto frame_t0 = std::chrono::steady_clock::now();
+	
+	// Executes a render stage and measures its CPU time
+	const auto execute_stage = [&](render::stage& stage, std::chrono::steady_clock::duration& cpu_time)
+	{
+		const auto t0 = std::chrono::steady_clock::now();
+		stage.execute(m_ctx);
+		cpu_time += std::chrono::steady_clock::now() - t0;
+	};
 	
 	// Execute light probe stage
-	m_light_probe_stage->execute(m_ctx);
+	execute_stage(*m_light_probe_stage, m_statistics.light_probe_stage_cpu_time);
 	
 	// Get list of cameras to be sorted
 	const auto& cameras = collection.get_objects(scene::camera::object_type_id);
@@ -62,18 +93,67 @@ void renderer::render(float t, float dt, float alpha, scene::collection& collect
 		m_ctx.objects.clear();
 		m_ctx.operations.clear();
 		
-		// Execute cascaded shadow map stage
-		m_cascaded_shadow_map_stage->execute(m_ctx);
-		
 		// Execute culling stage
-		m_culling_stage->execute(m_ctx);
+		execute_stage(*m_culling_stage, m_statistics.culling_stage_cpu_time);
+		m_statistics.object_count += m_ctx.objects.size();
+		
+		// Execute skinning stage
+		execute_stage(*m_skinning_stage, m_statistics.skinning_stage_cpu_time);
+		
+		// Execute cascaded shadow map stage
+		execute_stage(*m_cascaded_shadow_map_stage, m_statistics.cascaded_shadow_map_stage_cpu_time);
 		
 		// Execute queue stage
-		m_queue_stage->execute(m_ctx);
+		execute_stage(*m_queue_stage, m_statistics.queue_stage_cpu_time);
+		
+		// Execute batching stage
+		execute_stage(*m_batching_stage, m_statistics.batching_stage_cpu_time);
+		
+		// Execute instancing stage
+		execute_stage(*m_instancing_stage, m_statistics.instancing_stage_cpu_time);
+		m_statistics.operation_count += m_ctx.operations.size();
+		
+		// Write and bind camera uniform block, shared by all passes of the compositor
+		const camera_block camera_data
+		{
+			camera.get_view(),
+			camera.get_inv_view(),
+			camera.get_projection(),
+			camera.get_inv_projection(),
+			camera.get_view_projection(),
+			camera.get_translation(),
+			camera.get_exposure_normalization(),
+			t,
+			dt,
+			alpha,
+			m_frame
+		};
+		const auto camera_block_allocation = m_stream_buffer->allocate(camera_block_offsets.size, m_ctx.uniform_buffer_offset_alignment);
+		pack_camera_block(camera_data, camera_block_allocation.data);
+		const std::size_t camera_block_size = camera_block_offsets.size;
+		m_pipeline->bind_uniform_buffers(camera_block_binding, {&camera_block_allocation.buffer, 1}, {&camera_block_allocation.offset, 1}, {&camera_block_size, 1});
 		
 		// Pass render context to the camera's compositor
+		const auto compositor_t0 = std::chrono::steady_clock::now();
 		compositor->composite(m_ctx);
+		m_statistics.compositor_cpu_time += std::chrono::steady_clock::now() - compositor_t0;
+		
+		++m_statistics.camera_count;
 	}
+	
+	// Fence the stream buffer allocations of the frame
+	m_stream_buffer->fence();
+	
+	m_statistics.cpu_time = std::chrono::steady_clock::now() - frame_t0;
+	m_statistics.pipeline = m_pipeline->get_statistics() - pipeline_statistics;
+	
+	++m_frame;
+}
+
+void renderer::set_persistent_queues(bool persistent)
+{
+	m_culling_stage->set_persistent(persistent);
+	m_queue_stage->set_persistent(persistent);
 }
 
 } // namespace render
@@ -5,12 +5,17 @@
 #define ANTKEEPER_RENDER_RENDERER_HPP
 
 #include <engine/render/context.hpp>
+#include <engine/render/renderer-statistics.hpp>
 #include <engine/render/stages/culling-stage.hpp>
 #include <engine/render/stages/queue-stage.hpp>
+#include <engine/render/stages/batching-stage.hpp>
+#include <engine/render/stages/instancing-stage.hpp>
+#include <engine/render/stages/skinning-stage.hpp>
 #include <engine/render/stages/cascaded-shadow-map-stage.hpp>
 #include <engine/render/stages/light-probe-stage.hpp>
 #include <engine/scene/collection.hpp>
 #include <engine/gl/pipeline.hpp>
+#include <engine/gl/stream-buffer.hpp>
 #include <engine/resources/resource-manager.hpp>
 #include <memory>
 
@@ -40,12 +45,43 @@ public:
 	 */
 	void render(float t, float dt, float alpha, scene::collection& collection);
 	
+	/**
+	 * Enables or disables persistent render queues.
+	 *
+	 * If enabled, the visible objects and static render operations of each camera are cached across frames, and only objects which have changed are culled and rendered again.
+	 *
+	 * @param persistent `true` if render queues should persist across frames, `false` otherwise.
+	 *
+	 * @see culling_stage::set_persistent()
+	 * @see queue_stage::set_persistent()
+	 */
+	void set_persistent_queues(bool persistent);
+
+	/// Returns `true` if render queues persist across frames, `false` otherwise.
+	[[nodiscard]] inline bool has_persistent_queues() const noexcept
+	{
+		return m_queue_stage->is_persistent();
+	}
+
+	/// Returns the statistics of the most recently rendered frame.
+	[[nodiscard]] inline const renderer_statistics& get_statistics() const noexcept
+	{
+		return m_statistics;
+	}
+
 private:
+	gl::pipeline* m_pipeline;
 	render::context m_ctx;
+	unsigned int m_frame{0};
+	std::unique_ptr<gl::stream_buffer> m_stream_buffer;
 	std::unique_ptr<render::light_probe_stage> m_light_probe_stage;
 	std::unique_ptr<render::cascaded_shadow_map_stage> m_cascaded_shadow_map_stage;
 	std::unique_ptr<render::culling_stage> m_culling_stage;
+	std::unique_ptr<render::skinning_stage> m_skinning_stage;
 	std::unique_ptr<render::queue_stage> m_queue_stage;
+	std::unique_ptr<render::batching_stage> m_batching_stage;
+	std::unique_ptr<render::instancing_stage> m_instancing_stage;
+	renderer_statistics m_statistics;
 };
 
 } // namespace render
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/sort-key.hpp>
+#include <engine/render/operation.hpp>
+#include <bit>
+
+namespace render {
+
+namespace {
+
+/**
+ * Returns the low bits of an object address, ignoring alignment bits.
+ *
+ * @tparam Bits Number of bits to return.
+ */
+template <unsigned int Bits>
+[[nodiscard]] inline std::uint64_t address_bits(const void* pointer) noexcept
+{
+	return (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer)) >> 4) & ((std::uint64_t{1} << Bits) - 1);
+}
+
+/**
+ * Maps a float to an unsigned integer of the same order.
+ */
+[[nodiscard]] inline std::uint64_t quantize_depth(float depth) noexcept
+{
+	const auto bits = std::bit_cast<std::uint32_t>(depth);
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+} // namespace
+
+std::uint64_t make_material_sort_key(const operation& operation) noexcept
+{
+	const material* material = operation.material.get();
+	if (!material)
+	{
+		return std::uint64_t{1} << 63;
+	}
+	
+	std::uint64_t key = (address_bits<8>(material) << 22) | ((std::uint64_t{operation.layer_mask} & 0xff) << 14) | address_bits<14>(operation.vertex_array);
+	
+	if (material->get_blend_mode() == material_blend_mode::translucent)
+	{
+		key |= (std::uint64_t{1} << 62) | (quantize_depth(operation.depth) << 30);
+	}
+	else
+	{
+		const auto& shader_template = material->get_shader_template();
+		const std::uint64_t shader_template_hash = shader_template ? static_cast<std::uint64_t>(shader_template->hash()) : 0;
+		const std::uint64_t material_hash = static_cast<std::uint64_t>(material->hash());
+		key |= ((shader_template_hash >> 48) << 46) | (((material_hash >> 48) & 0xffff) << 30);
+	}
+	
+	return key;
+}
+
+std::uint64_t make_shadow_sort_key(const operation& operation) noexcept
+{
+	const std::uint64_t skinned = !operation.skinning_matrices.empty();
+	const std::uint64_t two_sided = operation.material && operation.material->is_two_sided();
+	
+	return (skinned << 63) | (two_sided << 62) | address_bits<62>(operation.vertex_array);
+}
+
+} // namespace render
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_SORT_KEY_HPP
+#define ANTKEEPER_RENDER_SORT_KEY_HPP
+
+#include <cstdint>
+
+namespace render {
+
+struct operation;
+
+/**
+ * Generates the material pass sort key of a render operation.
+ *
+ * Operations with materials precede operations without materials, and opaque operations precede translucent operations. Opaque operations are grouped by shader template hash, material hash, material, layer mask, and vertex array. Translucent operations are ordered by depth, then grouped by material, layer mask, and vertex array.
+ *
+ * Key layout, from most to least significant bit:
+ *
+ * | Bits  | Opaque              | Translucent    |
+ * | ----- | ------------------- | -------------- |
+ * | 63    | No material         | No material    |
+ * | 62    | Translucent (`0`)   | Translucent (`1`) |
+ * | 61-46 | Shader template hash | Quantized depth |
+ * | 45-30 | Material hash       | Quantized depth |
+ * | 29-22 | Material ID         | Material ID    |
+ * | 21-14 | Layer mask          | Layer mask     |
+ * | 13-0  | Vertex array ID     | Vertex array ID |
+ *
+ * @param operation Render operation.
+ *
+ * @return 64-bit sort key.
+ *
+ * @note Should be generated after the operation's material, depth, and layer mask are set.
+ */
+[[nodiscard]] std::uint64_t make_material_sort_key(const operation& operation) noexcept;
+
+/**
+ * Generates the shadow map sort key of a render operation.
+ *
+ * Unskinned operations precede skinned operations, and one-sided operations precede two-sided operations. Operations are then grouped by vertex array.
+ *
+ * @param operation Render operation.
+ *
+ * @return 64-bit sort key.
+ */
+[[nodiscard]] std::uint64_t make_shadow_sort_key(const operation& operation) noexcept;
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_SORT_KEY_HPP
@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/stages/batching-stage.hpp>
+#include <engine/render/vertex-attribute-location.hpp>
+#include <engine/render/sort-key.hpp>
+#include <engine/render/material.hpp>
+#include <engine/render/context.hpp>
+#include <engine/scene/camera.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
+
+namespace render {
+
+namespace {
+
+/// Returns the offset of the two-dimensional floating-point position attribute of a vertex array, or `std::nullopt` if the vertex array has no such attribute.
+[[nodiscard]] std::optional<std::size_t> get_position_offset(const gl::vertex_array& vertex_array) noexcept
+{
+	for (const auto& attribute: vertex_array.attributes())
+	{
+		if (attribute.location == vertex_attribute_location::position)
+		{
+			if (attribute.binding == 0 && attribute.format == gl::format::r32g32_sfloat)
+			{
+				return attribute.offset;
+			}
+			
+			break;
+		}
+	}
+	
+	return std::nullopt;
+}
+
+/// Returns `true` if an operation can be merged into a batch.
+[[nodiscard]] bool is_batchable(const operation& operation) noexcept
+{
+	return !operation.batch_vertex_data.empty() &&
+		operation.vertex_array &&
+		operation.material &&
+		operation.vertex_stride &&
+		operation.batch_vertex_data.size() % operation.vertex_stride == 0 &&
+		operation.skinning_matrices.empty() &&
+		operation.material_overrides.empty() &&
+		operation.instance_count == 1 &&
+		!operation.instance_buffer &&
+		get_position_offset(*operation.vertex_array);
+}
+
+/// Returns a tuple of the operation properties which must match for operations to be batched.
+[[nodiscard]] inline auto batching_key(const operation& operation) noexcept
+{
+	return std::make_tuple
+	(
+		static_cast<const material*>(operation.material.get()),
+		operation.vertex_array,
+		operation.vertex_stride,
+		operation.layer_mask,
+		operation.transform[3][2]
+	);
+}
+
+/**
+ * Copies the vertices of an operation into a batch, transforming their positions into the space of the batch.
+ *
+ * @param source Operation to copy.
+ * @param destination Vertex data of the operation within the batch.
+ * @param position_offset Offset of the position attribute within a vertex, in bytes.
+ */
+void write_batch_vertices(const operation& source, std::span<std::byte> destination, std::size_t position_offset)
+{
+	std::memcpy(destination.data(), source.batch_vertex_data.data(), destination.size());
+	
+	const auto& m = source.transform;
+	for (std::size_t i = position_offset; i < destination.size(); i += source.vertex_stride)
+	{
+		float position[2];
+		std::memcpy(position, destination.data() + i, sizeof(position));
+		
+		const float transformed_position[2] =
+		{
+			m[0][0] * position[0] + m[1][0] * position[1] + m[3][0],
+			m[0][1] * position[0] + m[1][1] * position[1] + m[3][1]
+		};
+		std::memcpy(destination.data() + i, transformed_position, sizeof(transformed_position));
+	}
+}
+
+} // namespace
+
+void batching_stage::execute(render::context& ctx)
+{
+	// Free batches which no camera drew in this or the previous frame, such as those of destroyed or inactive cameras, whether or not their camera executes this stage
+	std::erase_if
+	(
+		m_batches,
+		[&ctx](const auto& pair)
+		{
+			return ctx.frame - pair.second.frame > 1;
+		}
+	);
+	
+	// Only batch screen-space operations
+	if (!ctx.camera->is_orthographic())
+	{
+		return;
+	}
+	
+	m_candidates.clear();
+	
+	// Separate batching candidates from other operations
+	std::erase_if
+	(
+		ctx.operations,
+		[&](const operation* operation)
+		{
+			if (!is_batchable(*operation))
+			{
+				return false;
+			}
+			
+			m_candidates.emplace_back(operation);
+			return true;
+		}
+	);
+	
+	// Group candidates with matching material, vertex layout, and layer mask, preserving their order within each group
+	std::stable_sort
+	(
+		m_candidates.begin(),
+		m_candidates.end(),
+		[](const operation* a, const operation* b)
+		{
+			return batching_key(*a) < batching_key(*b);
+		}
+	);
+	
+	for (auto first = m_candidates.begin(); first != m_candidates.end();)
+	{
+		const auto key = batching_key(**first);
+		const auto last = std::find_if
+		(
+			first + 1,
+			m_candidates.end(),
+			[&key](const operation* operation)
+			{
+				return batching_key(*operation) != key;
+			}
+		);
+		
+		if (static_cast<std::size_t>(std::distance(first, last)) < m_min_batch_size)
+		{
+			// Leave group unbatched
+			ctx.operations.insert(ctx.operations.end(), first, last);
+			first = last;
+			continue;
+		}
+		
+		auto& batch = m_batches[std::tuple_cat(std::make_tuple(ctx.camera), key)];
+		batch.frame = ctx.frame;
+		update_batch(batch, {first, last}, *get_position_offset(*(*first)->vertex_array));
+		ctx.operations.emplace_back(&batch.batch_operation);
+		
+		first = last;
+	}
+	
+	// Free batches which are no longer drawn by the camera
+	std::erase_if
+	(
+		m_batches,
+		[&ctx](const auto& pair)
+		{
+			return std::get<0>(pair.first) == ctx.camera && pair.second.frame != ctx.frame;
+		}
+	);
+}
+
+void batching_stage::update_batch(batch& batch, std::span<const operation* const> operations, std::size_t position_offset)
+{
+	// Rebuild the batch if the sequence of operations or the sizes of their vertex data changed
+	const bool rebuild = !std::equal
+	(
+		batch.items.begin(),
+		batch.items.end(),
+		operations.begin(),
+		operations.end(),
+		[](const batch_item& item, const operation* operation)
+		{
+			return item.source == operation && item.size == operation->batch_vertex_data.size();
+		}
+	);
+	
+	if (rebuild)
+	{
+		// Lay out operations in draw order
+		batch.items.clear();
+		std::size_t size = 0;
+		for (const operation* operation: operations)
+		{
+			batch.items.emplace_back(operation, operation->batch_revision, operation->transform, size, operation->batch_vertex_data.size());
+			size += operation->batch_vertex_data.size();
+		}
+		
+		batch.vertex_data.resize(size);
+		for (const auto& item: batch.items)
+		{
+			write_batch_vertices(*item.source, std::span{batch.vertex_data}.subspan(item.offset, item.size), position_offset);
+		}
+		
+		// Upload the whole batch, enlarging its vertex buffer if necessary
+		if (!batch.vertex_buffer || batch.vertex_buffer->size() < size)
+		{
+			batch.vertex_buffer = std::make_unique<gl::vertex_buffer>(gl::buffer_usage::dynamic_draw, std::bit_ceil(size));
+		}
+		batch.vertex_buffer->write(batch.vertex_data);
+	}
+	else
+	{
+		// Rewrite operations which moved or changed in place
+		std::size_t dirty_begin = batch.vertex_data.size();
+		std::size_t dirty_end = 0;
+		for (auto& item: batch.items)
+		{
+			if (item.revision == item.source->batch_revision && item.transform == item.source->transform)
+			{
+				continue;
+			}
+			
+			item.revision = item.source->batch_revision;
+			item.transform = item.source->transform;
+			write_batch_vertices(*item.source, std::span{batch.vertex_data}.subspan(item.offset, item.size), position_offset);
+			
+			dirty_begin = std::min(dirty_begin, item.offset);
+			dirty_end = std::max(dirty_end, item.offset + item.size);
+		}
+		
+		if (dirty_begin < dirty_end)
+		{
+			batch.vertex_buffer->write(dirty_begin, std::span{batch.vertex_data}.subspan(dirty_begin, dirty_end - dirty_begin));
+		}
+	}
+	
+	// Update batch operation
+	const operation& first_operation = *operations.front();
+	auto& batch_operation = batch.batch_operation;
+	batch_operation.primitive_topology = gl::primitive_topology::triangle_list;
+	batch_operation.vertex_array = first_operation.vertex_array;
+	batch_operation.vertex_buffer = batch.vertex_buffer.get();
+	batch_operation.vertex_offset = 0;
+	batch_operation.vertex_stride = first_operation.vertex_stride;
+	batch_operation.first_vertex = 0;
+	batch_operation.vertex_count = static_cast<std::uint32_t>(batch.vertex_data.size() / first_operation.vertex_stride);
+	batch_operation.material = first_operation.material;
+	batch_operation.transform = math::identity<math::fmat4>;
+	batch_operation.transform[3][2] = first_operation.transform[3][2];
+	batch_operation.layer_mask = first_operation.layer_mask;
+	batch_operation.depth = first_operation.depth;
+	for (const operation* operation: operations)
+	{
+		batch_operation.depth = std::min(batch_operation.depth, operation->depth);
+	}
+	batch_operation.sort_key = make_material_sort_key(batch_operation);
+}
+
+} // namespace render
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_BATCHING_STAGE_HPP
+#define ANTKEEPER_RENDER_BATCHING_STAGE_HPP
+
+#include <engine/render/stage.hpp>
+#include <engine/render/operation.hpp>
+#include <engine/gl/vertex-buffer.hpp>
+#include <engine/math/matrix.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace scene
+{
+	class camera;
+}
+
+namespace render {
+
+/**
+ * Merges screen-space render operations which share a material, vertex array, and layer mask into a single dynamic mesh per group, such as the text and quads of menus and HUDs.
+ *
+ * Only operations of cameras with orthographic projections are merged, and only if they provide batch vertex data and their vertex array reads two-dimensional floating-point positions from binding `0`. Positions are transformed into the space of the batch on the CPU.
+ *
+ * Batches are retained between frames, and freed once their camera stops drawing them, or once they haven't been drawn for a frame, such as the batches of destroyed cameras. A batch is only rebuilt when the sequence of operations it merges, or the size of their vertex data, changes. Operations which were moved or had their batch revision changed, such as scrolled or highlighted menu items, are rewritten in place and uploaded without rebuilding the batch.
+ *
+ * @see operation::batch_vertex_data
+ */
+class batching_stage: public stage
+{
+public:
+	/** Destructs a batching stage. */
+	~batching_stage() override = default;
+	
+	void execute(render::context& ctx) override;
+	
+	/**
+	 * Sets the minimum number of operations which will be merged into a batch.
+	 *
+	 * @param count Minimum batch size.
+	 */
+	inline void set_min_batch_size(std::size_t count) noexcept
+	{
+		m_min_batch_size = std::max<std::size_t>(count, 2);
+	}
+	
+	/// Returns the minimum number of operations which will be merged into a batch.
+	[[nodiscard]] inline std::size_t get_min_batch_size() const noexcept
+	{
+		return m_min_batch_size;
+	}
+
+private:
+	/// Operation merged into a batch.
+	struct batch_item
+	{
+		/// Merged operation.
+		const operation* source;
+		
+		/// Batch revision of the operation when it was last written.
+		std::uint32_t revision;
+		
+		/// Transform of the operation when it was last written.
+		math::fmat4 transform;
+		
+		/// Offset of the operation's vertices within the batch, in bytes.
+		std::size_t offset;
+		
+		/// Size of the operation's vertices, in bytes.
+		std::size_t size;
+	};
+	
+	/// Dynamic mesh of merged operations.
+	struct batch
+	{
+		/// Operations merged into the batch, in draw order.
+		std::vector<batch_item> items;
+		
+		/// Vertex data of the batch.
+		std::vector<std::byte> vertex_data;
+		
+		/// Vertex buffer of the batch.
+		std::unique_ptr<gl::vertex_buffer> vertex_buffer;
+		
+		/// Render operation which draws the batch.
+		operation batch_operation;
+		
+		/// Index of the frame in which the batch was last drawn.
+		unsigned int frame{0};
+	};
+	
+	/// Camera, material, vertex array, vertex stride, layer mask, and depth translation shared by the operations of a batch.
+	using batch_key = std::tuple<const scene::camera*, const material*, const gl::vertex_array*, std::size_t, std::uint32_t, float>;
+	
+	/**
+	 * Updates a batch from the operations it merges, rebuilding it if necessary.
+	 *
+	 * @param batch Batch to update.
+	 * @param operations Operations to merge into the batch.
+	 * @param position_offset Offset of the position attribute within a vertex, in bytes.
+	 */
+	void update_batch(batch& batch, std::span<const operation* const> operations, std::size_t position_offset);
+	
+	std::size_t m_min_batch_size{2};
+	
+	/// Operations which may be batched.
+	std::vector<const operation*> m_candidates;
+	
+	/// Batches retained between frames.
+	std::map<batch_key, batch> m_batches;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_BATCHING_STAGE_HPP
@@ -8,6 +8,8 @@
 #include <engine/gl/shader-program.hpp>
 #include <engine/render/context.hpp>
 #include <engine/render/material.hpp>
+#include <engine/render/sort-key.hpp>
+#include <engine/render/uniform-blocks.hpp>
 #include <engine/render/vertex-attribute-location.hpp>
 #include <engine/scene/camera.hpp>
 #include <engine/scene/collection.hpp>
@@ -26,8 +28,6 @@
 
 namespace render {
 
-static bool operation_compare(const render::operation* a, const render::operation* b);
-
 cascaded_shadow_map_stage::cascaded_shadow_map_stage(gl::pipeline& pipeline, ::resource_manager& resource_manager):
 	m_pipeline(&pipeline)
 {
@@ -41,6 +41,8 @@ cascaded_shadow_map_stage::cascaded_shadow_map_stage(gl::pipeline& pipeline, ::r
 	m_shader_template_definitions["VERTEX_BONE_WEIGHT"] = std::to_string(vertex_attribute_location::bone_weight);
 	m_shader_template_definitions["VERTEX_BONE_WEIGHT"] = std::to_string(vertex_attribute_location::bone_weight);
 	m_shader_template_definitions["MAX_BONE_COUNT"] = std::to_string(m_max_bone_count);
+	m_shader_template_definitions["SKINNING_BLOCK_BINDING"] = std::to_string(skinning_block_binding);
+	m_shader_template_definitions["MAX_SKINNING_BONE_COUNT"] = std::to_string(skinning_block_max_bone_count);
 	
 	// Static mesh shader
 	{
@@ -125,26 +127,16 @@ void cascaded_shadow_map_stage::queue(render::context& ctx, scene::directional_l
 	// Build light view frustum from light view projection matrix
 	const geom::view_frustum<float> light_view_frustum(light_view_projection);
 	
-	// Tests whether a box is completely outside a plane
-	auto box_outside_plane = [](const geom::box<float>& box, const geom::plane<float>& plane) -> bool
-	{
-		const math::fvec3 p =
-		{
-			(plane.normal.x() > 0.0f) ? box.max.x() : box.min.x(),
-			(plane.normal.y() > 0.0f) ? box.max.y() : box.min.y(),
-			(plane.normal.z() > 0.0f) ? box.max.z() : box.min.z()
-		};
-		
-		return plane.distance(p) < 0.0f;
-	};
+	// Find objects within the light view frustum (excluding near plane [reverse-z, so far=near])
+	m_shadow_casters.clear();
+	ctx.collection->query(std::span<const geom::plane<float>>{light_view_frustum.planes, 5}, m_shadow_casters);
 	
-	// For each object in the scene collection
-	const auto& objects = ctx.collection->get_objects();
+	// For each object in the light view frustum
 	std::for_each
 	(
 		std::execution::seq,
-		std::begin(objects),
-		std::end(objects),
+		std::begin(m_shadow_casters),
+		std::end(m_shadow_casters),
 		[&](scene::object_base* object)
 		{
 			// Cull object if it doesn't share a common layer with the camera and light
@@ -159,17 +151,6 @@ void cascaded_shadow_map_stage::queue(render::context& ctx, scene::directional_l
 				return;
 			}
 			
-			// Cull object if it's outside of the light view frustum (excluding near plane [reverse-z, so far=near])
-			const auto& object_bounds = object->get_bounds();
-			if (box_outside_plane(object_bounds, light_view_frustum.left()) ||
-				box_outside_plane(object_bounds, light_view_frustum.right()) ||
-				box_outside_plane(object_bounds, light_view_frustum.bottom()) ||
-				box_outside_plane(object_bounds, light_view_frustum.top()) ||
-				box_outside_plane(object_bounds, light_view_frustum.near()))
-			{
-				return;
-			}
-			
 			// Add object render operations to render context
 			object->render(ctx);
 		}
@@ -224,7 +205,7 @@ void cascaded_shadow_map_stage::render_shadow_atlas(render::context& ctx, scene:
 	const auto cascade_resolution = atlas_resolution >> 1;
 	
 	// Sort render operations
-	std::sort(std::execution::par_unseq, ctx.operations.begin(), ctx.operations.end(), operation_compare);
+	m_operation_sorter.sort(ctx.operations, make_shadow_sort_key);
 	
 	gl::shader_program* active_shader_program = nullptr;
 	
@@ -363,7 +344,18 @@ void cascaded_shadow_map_stage::render_shadow_atlas(render::context& ctx, scene:
 			else if (active_shader_program == m_skeletal_mesh_shader_program.get())
 			{
 				m_skeletal_mesh_model_view_projection_var->update(model_view_projection);
-				m_skeletal_mesh_skinning_matrices_var->update(operation->skinning_matrices);
+				
+				if (operation->skinning_buffer)
+				{
+					// Bind packed skinning palette
+					constexpr std::size_t skinning_block_size = skinning_block_offsets.size;
+					m_pipeline->bind_uniform_buffers(skinning_block_binding, {&operation->skinning_buffer, 1}, {&operation->skinning_offset, 1}, {&skinning_block_size, 1});
+				}
+				
+				if (m_skeletal_mesh_skinning_matrices_var)
+				{
+					m_skeletal_mesh_skinning_matrices_var->update(operation->skinning_matrices);
+				}
 			}
 			
 			// Draw geometry
@@ -380,7 +372,7 @@ void cascaded_shadow_map_stage::render_shadow_atlas(render::context& ctx, scene:
 
 void cascaded_shadow_map_stage::rebuild_static_mesh_shader_program()
 {
-	m_static_mesh_shader_program = m_static_mesh_shader_template->build(m_shader_template_definitions);
+	m_static_mesh_shader_program = m_pipeline->get_shader_cache().build(*m_static_mesh_shader_template, m_shader_template_definitions);
 	if (!m_static_mesh_shader_program->linked())
 	{
 		debug::log_error("Failed to build cascaded shadow map shader program for static meshes: {}", m_static_mesh_shader_program->info());
@@ -396,7 +388,7 @@ void cascaded_shadow_map_stage::rebuild_static_mesh_shader_program()
 
 void cascaded_shadow_map_stage::rebuild_skeletal_mesh_shader_program()
 {
-	m_skeletal_mesh_shader_program = m_skeletal_mesh_shader_template->build(m_shader_template_definitions);
+	m_skeletal_mesh_shader_program = m_pipeline->get_shader_cache().build(*m_skeletal_mesh_shader_template, m_shader_template_definitions);
 	if (!m_skeletal_mesh_shader_program->linked())
 	{
 		debug::log_error("Failed to build cascaded shadow map shader program for skeletal meshes: {}", m_skeletal_mesh_shader_program->info());
@@ -412,89 +404,4 @@ void cascaded_shadow_map_stage::rebuild_skeletal_mesh_shader_program()
 	}
 }
 
-bool operation_compare(const render::operation* a, const render::operation* b)
-{
-	const bool skinned_a = !a->skinning_matrices.empty();
-	const bool skinned_b = !b->skinning_matrices.empty();
-	const bool two_sided_a = (a->material) ? a->material->is_two_sided() : false;
-	const bool two_sided_b = (b->material) ? b->material->is_two_sided() : false;
-	
-	if (skinned_a)
-	{
-		if (skinned_b)
-		{
-			// A and B are both skinned, sort by two-sided
-			if (two_sided_a)
-			{
-				if (two_sided_b)
-				{
-					// A and B are both two-sided, sort by VAO
-					return (a->vertex_array < b->vertex_array);
-				}
-				else
-				{
-					// A is two-sided, B is one-sided. Render B first
-					return false;
-				}
-			}
-			else
-			{
-				if (two_sided_b)
-				{
-					// A is one-sided, B is two-sided. Render A first
-					return true;
-				}
-				else
-				{
-					// A and B are both one-sided, sort by VAO
-					return (a->vertex_array < b->vertex_array);
-				}
-			}
-		}
-		else
-		{
-			// A is skinned, B is unskinned. Render B first
-			return false;
-		}
-	}
-	else
-	{
-		if (skinned_b)
-		{
-			// A is unskinned, B is skinned. Render A first
-			return true;
-		}
-		else
-		{
-			// A and B are both unskinned, sort by two-sided
-			if (two_sided_a)
-			{
-				if (two_sided_b)
-				{
-					// A and B are both two-sided, sort by VAO
-					return (a->vertex_array < b->vertex_array);
-				}
-				else
-				{
-					// A is two-sided, B is one-sided. Render B first
-					return false;
-				}
-			}
-			else
-			{
-				if (two_sided_b)
-				{
-					// A is one-sided, B is two-sided. Render A first
-					return true;
-				}
-				else
-				{
-					// A and B are both one-sided, sort by VAO
-					return (a->vertex_array < b->vertex_array);
-				}
-			}
-		}
-	}
-}
-
 } // namespace render
@@ -5,6 +5,7 @@
 #define ANTKEEPER_RENDER_CASCADED_SHADOW_MAP_STAGE_HPP
 
 #include <engine/render/stage.hpp>
+#include <engine/render/operation-sorter.hpp>
 #include <engine/gl/shader-template.hpp>
 #include <engine/gl/shader-program.hpp>
 #include <engine/gl/shader-variable.hpp>
@@ -14,6 +15,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace render {
 
@@ -85,6 +87,11 @@ private:
 	std::unique_ptr<gl::shader_program> m_skeletal_mesh_shader_program;
 	const gl::shader_variable* m_skeletal_mesh_model_view_projection_var;
 	const gl::shader_variable* m_skeletal_mesh_skinning_matrices_var;
+	
+	operation_sorter m_operation_sorter;
+	
+	/// Objects within the light view frustum of the current cascade.
+	std::vector<scene::object_base*> m_shadow_casters;
 };
 
 } // namespace render
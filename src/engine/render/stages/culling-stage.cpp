@@ -5,52 +5,157 @@
 #include <engine/scene/camera.hpp>
 #include <engine/scene/collection.hpp>
 #include <algorithm>
+#include <cmath>
 #include <execution>
-#include <mutex>
+#include <numeric>
 
 namespace render {
 
 void culling_stage::execute(render::context& ctx)
 {
-	// Get all objects in the collection
-	const auto& objects = ctx.collection->get_objects();
+	if (!m_persistent)
+	{
+		cull(ctx);
+		return;
+	}
 	
+	const std::uint64_t revision = ctx.collection->get_revision();
+	const auto camera_layer_mask = ctx.camera->get_layer_mask();
+	const auto& view_projection = ctx.camera->get_view_projection();
+	auto& cache = m_caches[ctx.camera];
+	
+	// Check if the camera's view-projection matrix is within tolerance of the cached view-projection matrix
+	bool view_projection_cached = true;
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		for (std::size_t j = 0; j < 4; ++j)
+		{
+			view_projection_cached &= std::abs(view_projection[i][j] - cache.view_projection[i][j]) <= m_view_projection_tolerance;
+		}
+	}
+	
+	// Cull all objects if the cached objects are outdated or could have been destroyed, or the camera has changed
+	if (cache.collection != ctx.collection ||
+		cache.revision + 1 < revision ||
+		ctx.collection->get_removal_revision() > cache.revision ||
+		cache.layer_mask != camera_layer_mask ||
+		!view_projection_cached)
+	{
+		const std::size_t first = ctx.objects.size();
+		cull(ctx);
+		
+		cache.collection = ctx.collection;
+		cache.revision = revision;
+		cache.view_projection = view_projection;
+		cache.layer_mask = camera_layer_mask;
+		cache.objects.assign(ctx.objects.begin() + static_cast<std::ptrdiff_t>(first), ctx.objects.end());
+		
+		return;
+	}
+	
+	// Re-evaluate visibility of objects which changed in the latest revision
+	if (cache.revision != revision)
+	{
+		std::erase_if(cache.objects, [&](const scene::object_base* object){return ctx.collection->changed_since(*object, cache.revision);});
+		
+		const auto& view_frustum = ctx.camera->get_view_frustum();
+		for (scene::object_base* object: ctx.collection->get_changed_objects())
+		{
+			if (object->get_object_type_id() != scene::camera::object_type_id &&
+				(object->get_layer_mask() & camera_layer_mask) &&
+				view_frustum.intersects(object->get_bounds()))
+			{
+				cache.objects.emplace_back(object);
+			}
+		}
+		
+		cache.revision = revision;
+	}
+	
+	ctx.objects.insert(ctx.objects.end(), cache.objects.begin(), cache.objects.end());
+}
+
+void culling_stage::set_persistent(bool persistent)
+{
+	m_persistent = persistent;
+	m_caches.clear();
+}
+
+void culling_stage::cull(render::context& ctx)
+{
 	// Get camera layer mask and view frustum
 	const auto camera_layer_mask = ctx.camera->get_layer_mask();
 	const auto& view_frustum = ctx.camera->get_view_frustum();
 	
-	// Construct mutex to guard set of visible objects
-	std::mutex mutex;
+	// Find objects within the view frustum
+	m_candidates.clear();
+	ctx.collection->query(view_frustum, m_candidates);
+	const std::size_t count = m_candidates.size();
+	if (!count)
+	{
+		return;
+	}
+	
+	// Split objects into chunks
+	const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+	m_chunks.resize(chunk_count);
+	std::iota(m_chunks.begin(), m_chunks.end(), std::size_t{0});
+	m_chunk_offsets.resize(chunk_count);
+	m_visibility.resize(count);
 	
-	// For each object in the scene collection
+	// Test objects for visibility and count visible objects in each chunk
 	std::for_each
 	(
 		std::execution::par,
-		std::begin(objects),
-		std::end(objects),
-		[&](scene::object_base* object)
+		m_chunks.begin(),
+		m_chunks.end(),
+		[&](std::size_t chunk)
 		{
-			// Ignore cameras
-			if (object->get_object_type_id() == scene::camera::object_type_id)
+			const std::size_t begin = chunk * chunk_size;
+			const std::size_t end = std::min(count, begin + chunk_size);
+			
+			// Cull cameras and objects which don't share any common layers with the camera
+			for (std::size_t i = begin; i < end; ++i)
 			{
-				return;
+				const scene::object_base& object = *m_candidates[i];
+				m_visibility[i] = (object.get_object_type_id() != scene::camera::object_type_id) && (object.get_layer_mask() & camera_layer_mask);
 			}
 			
-			// Cull object if it doesn't share any common layers with the camera
-			if (!(object->get_layer_mask() & camera_layer_mask))
+			// Count visible objects
+			std::size_t visible_count = 0;
+			for (std::size_t i = begin; i < end; ++i)
 			{
-				return;
+				visible_count += m_visibility[i];
 			}
+			m_chunk_offsets[chunk] = visible_count;
+		}
+	);
+	
+	// Find offset of each chunk's first visible object
+	const std::size_t first = ctx.objects.size();
+	const std::size_t visible_count = std::accumulate(m_chunk_offsets.begin(), m_chunk_offsets.end(), std::size_t{0});
+	std::exclusive_scan(m_chunk_offsets.begin(), m_chunk_offsets.end(), m_chunk_offsets.begin(), first);
+	ctx.objects.resize(first + visible_count);
+	
+	// Scatter visible objects, in query order
+	std::for_each
+	(
+		std::execution::par,
+		m_chunks.begin(),
+		m_chunks.end(),
+		[&](std::size_t chunk)
+		{
+			const std::size_t begin = chunk * chunk_size;
+			const std::size_t end = std::min(count, begin + chunk_size);
 			
-			// Cull object if it's outside of the camera view frustum
-			if (!view_frustum.intersects(object->get_bounds()))
+			std::size_t offset = m_chunk_offsets[chunk];
+			for (std::size_t i = begin; i < end; ++i)
 			{
-				return;
+				if (m_visibility[i])
+				{
+					ctx.objects[offset++] = m_candidates[i];
+				}
 			}
-			
-			// Insert object into set of visible objects
-			std::lock_guard<std::mutex> guard(mutex);
-			ctx.objects.push_back(object);
 		}
 	);
 }
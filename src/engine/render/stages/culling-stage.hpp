@@ -5,11 +5,20 @@
 #define ANTKEEPER_RENDER_CULLING_STAGE_HPP
 
 #include <engine/render/stage.hpp>
+#include <engine/math/matrix.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace render {
 
 /**
  * Builds a set of scene objects visible to the current camera and stores it in the render context.
+ *
+ * Objects within the camera's view frustum are found with the spatial index of the scene collection. They are then culled by layer in parallel chunks, counted per chunk, and scattered to prefix-summed offsets, such that they retain their query order without synchronization.
+ *
+ * In persistent mode, the visible objects of each camera are cached. Only objects which changed since the previous frame are re-evaluated, unless the camera's view-projection matrix or layer mask changes, or objects are removed from the collection.
  */
 class culling_stage: public stage
 {
@@ -18,6 +27,79 @@ public:
 	~culling_stage() override = default;
 	
 	void execute(render::context& ctx) override;
+	
+	/**
+	 * Enables or disables persistent mode.
+	 *
+	 * @param persistent `true` if visible objects should be cached across frames, `false` otherwise.
+	 */
+	void set_persistent(bool persistent);
+
+	/**
+	 * Sets the maximum per-element difference between the current and cached view-projection matrices of a camera for which the cached visible objects of the camera remain valid.
+	 *
+	 * @param tolerance View-projection tolerance.
+	 */
+	inline void set_view_projection_tolerance(float tolerance) noexcept
+	{
+		m_view_projection_tolerance = tolerance;
+	}
+
+	/// Returns `true` if persistent mode is enabled, `false` otherwise.
+	[[nodiscard]] inline bool is_persistent() const noexcept
+	{
+		return m_persistent;
+	}
+
+	/// Returns the view-projection tolerance.
+	[[nodiscard]] inline float get_view_projection_tolerance() const noexcept
+	{
+		return m_view_projection_tolerance;
+	}
+
+private:
+	/// Visible objects of a camera, cached across frames.
+	struct visibility_cache
+	{
+		/// Collection from which the visible objects were found.
+		const scene::collection* collection{nullptr};
+
+		/// Revision of the collection in which the visible objects were found.
+		std::uint64_t revision{0};
+
+		/// Camera view-projection matrix with which the visible objects were found.
+		math::fmat4 view_projection{};
+
+		/// Camera layer mask with which the visible objects were found.
+		std::uint32_t layer_mask{0};
+
+		/// Visible objects.
+		std::vector<scene::object_base*> objects;
+	};
+
+	/// Appends all objects visible to the camera to the render context.
+	void cull(render::context& ctx);
+
+	bool m_persistent{false};
+	float m_view_projection_tolerance{0.0f};
+
+	/// Cached visible objects of each camera.
+	std::unordered_map<const scene::camera*, visibility_cache> m_caches;
+
+	/// Number of objects culled by each parallel task.
+	static constexpr std::size_t chunk_size = 1024;
+	
+	/// Objects within the view frustum.
+	std::vector<scene::object_base*> m_candidates;
+	
+	/// Visibility of each object within the view frustum.
+	std::vector<std::uint8_t> m_visibility;
+	
+	/// Chunk indices.
+	std::vector<std::size_t> m_chunks;
+	
+	/// Number of visible objects in each chunk, then the offset of each chunk's first visible object.
+	std::vector<std::size_t> m_chunk_offsets;
 };
 
 } // namespace render
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/stages/instancing-stage.hpp>
+#include <engine/render/vertex-attribute-location.hpp>
+#include <engine/render/sort-key.hpp>
+#include <engine/render/material.hpp>
+#include <engine/render/context.hpp>
+#include <engine/gl/stream-buffer.hpp>
+#include <engine/gl/shader-template.hpp>
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string>
+#include <tuple>
+
+namespace render {
+
+namespace {
+
+/// Name of the shader template define directive which indicates support for instancing.
+const std::string instance_transform_directive = "VERTEX_INSTANCE_TRANSFORM";
+
+/// Returns a tuple of the operation properties which must match for operations to be combined.
+[[nodiscard]] inline auto instancing_key(const operation& operation) noexcept
+{
+	return std::tie
+	(
+		operation.vertex_array,
+		operation.material,
+		operation.layer_mask,
+		operation.vertex_buffer,
+		operation.vertex_offset,
+		operation.vertex_stride,
+		operation.first_vertex,
+		operation.vertex_count,
+		operation.primitive_topology
+	);
+}
+
+/// Returns `true` if two vertex input attributes are equal.
+[[nodiscard]] inline bool attributes_equal(const gl::vertex_input_attribute& a, const gl::vertex_input_attribute& b) noexcept
+{
+	return a.location == b.location && a.binding == b.binding && a.format == b.format && a.offset == b.offset;
+}
+
+} // namespace
+
+void instancing_stage::execute(render::context& ctx)
+{
+	m_candidates.clear();
+	m_instanced_operations.clear();
+	m_instance_transforms.clear();
+	
+	// Separate instancing candidates from other operations
+	std::erase_if
+	(
+		ctx.operations,
+		[&](const operation* operation)
+		{
+			if (!operation->vertex_array ||
+				!operation->material ||
+				!operation->material->get_shader_template() ||
+				operation->material->get_blend_mode() == material_blend_mode::translucent ||
+				!operation->skinning_matrices.empty() ||
+				!operation->material_overrides.empty() ||
+				operation->instance_count != 1 ||
+				operation->instance_buffer)
+			{
+				return false;
+			}
+			
+			m_candidates.emplace_back(operation);
+			return true;
+		}
+	);
+	
+	// Group candidates with matching geometry, material, and layer mask
+	std::sort
+	(
+		m_candidates.begin(),
+		m_candidates.end(),
+		[](const operation* a, const operation* b)
+		{
+			return instancing_key(*a) < instancing_key(*b);
+		}
+	);
+	
+	// Reserve instanced operations, such that their addresses remain stable while they're generated
+	m_instanced_operations.reserve(m_candidates.size() / m_min_instance_count);
+	
+	for (auto first = m_candidates.begin(); first != m_candidates.end();)
+	{
+		const auto key = instancing_key(**first);
+		const auto last = std::find_if
+		(
+			first + 1,
+			m_candidates.end(),
+			[&key](const operation* operation)
+			{
+				return instancing_key(*operation) != key;
+			}
+		);
+		
+		const auto count = static_cast<std::size_t>(std::distance(first, last));
+		if (count < m_min_instance_count || !(*first)->material->get_shader_template()->has_define_directive(instance_transform_directive))
+		{
+			// Leave group uninstanced
+			ctx.operations.insert(ctx.operations.end(), first, last);
+			first = last;
+			continue;
+		}
+		
+		// Generate instanced operation
+		auto& instanced_operation = m_instanced_operations.emplace_back(**first);
+		instanced_operation.vertex_array = get_instanced_vertex_array(*(*first)->vertex_array);
+		instanced_operation.first_instance = static_cast<std::uint32_t>(m_instance_transforms.size());
+		instanced_operation.instance_count = static_cast<std::uint32_t>(count);
+		
+		// Append instance transforms, taking the depth of the nearest instance
+		for (auto i = first; i != last; ++i)
+		{
+			m_instance_transforms.emplace_back((*i)->transform);
+			instanced_operation.depth = std::min(instanced_operation.depth, (*i)->depth);
+		}
+		
+		instanced_operation.sort_key = make_material_sort_key(instanced_operation);
+		ctx.operations.emplace_back(&instanced_operation);
+		
+		first = last;
+	}
+	
+	if (m_instance_transforms.empty())
+	{
+		return;
+	}
+	
+	// Write instance transforms into the stream buffer, aligned such that the allocation starts at a whole instance
+	const auto data = std::as_bytes(std::span{m_instance_transforms});
+	const auto allocation = ctx.stream_buffer->allocate(data.size(), sizeof(math::fmat4));
+	std::memcpy(allocation.data.data(), data.data(), data.size());
+	
+	// Offset the first instance of each instanced operation to the allocation
+	const auto first_instance = static_cast<std::uint32_t>(allocation.offset / sizeof(math::fmat4));
+	for (auto& instanced_operation: m_instanced_operations)
+	{
+		instanced_operation.instance_buffer = allocation.buffer;
+		instanced_operation.first_instance += first_instance;
+	}
+}
+
+const gl::vertex_array* instancing_stage::get_instanced_vertex_array(const gl::vertex_array& vertex_array)
+{
+	const auto& attributes = vertex_array.attributes();
+	
+	auto& instanced_vertex_array = m_instanced_vertex_arrays[&vertex_array];
+	if (instanced_vertex_array)
+	{
+		// Reuse the instanced vertex array, unless the source vertex array address has been reused by a vertex array with different attributes
+		const auto& instanced_attributes = instanced_vertex_array->attributes();
+		if (instanced_attributes.size() == attributes.size() + 4 && std::equal(attributes.begin(), attributes.end(), instanced_attributes.begin(), attributes_equal))
+		{
+			return instanced_vertex_array.get();
+		}
+	}
+	
+	// Copy source vertex attributes, then add instance transform columns
+	std::vector<gl::vertex_input_attribute> instanced_attributes(attributes.begin(), attributes.end());
+	for (std::uint32_t i = 0; i < 4; ++i)
+	{
+		instanced_attributes.emplace_back
+		(
+			gl::vertex_input_attribute
+			{
+				.location = vertex_attribute_location::instance_transform + i,
+				.binding = 1,
+				.format = gl::format::r32g32b32a32_sfloat,
+				.offset = i * static_cast<std::uint32_t>(sizeof(math::fvec4))
+			}
+		);
+	}
+	
+	const gl::vertex_input_binding instance_binding
+	{
+		.binding = 1,
+		.stride = static_cast<std::uint32_t>(sizeof(math::fmat4)),
+		.input_rate = gl::vertex_input_rate::instance
+	};
+	
+	instanced_vertex_array = std::make_unique<gl::vertex_array>(instanced_attributes, std::span{&instance_binding, 1});
+	
+	return instanced_vertex_array.get();
+}
+
+} // namespace render
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_INSTANCING_STAGE_HPP
+#define ANTKEEPER_RENDER_INSTANCING_STAGE_HPP
+
+#include <engine/render/stage.hpp>
+#include <engine/render/operation.hpp>
+#include <engine/gl/vertex-array.hpp>
+#include <engine/math/matrix.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace render {
+
+/**
+ * Combines render operations which draw the same geometry with the same material and layer mask into instanced render operations.
+ *
+ * Per-instance transforms of all instanced operations are written into one allocation of the renderer's stream buffer, and the instanced operation draws from a copy of the source vertex array which additionally reads an instance transform attribute at `vertex_attribute_location::instance_transform`.
+ *
+ * Only operations whose material shader template has a `#pragma define VERTEX_INSTANCE_TRANSFORM` directive are instanced. Skinned operations, translucent operations, operations with material overrides, and operations which are already instanced are left untouched.
+ */
+class instancing_stage: public stage
+{
+public:
+	/** Destructs an instancing stage. */
+	~instancing_stage() override = default;
+	
+	void execute(render::context& ctx) override;
+	
+	/**
+	 * Sets the minimum number of operations which will be combined into an instanced operation.
+	 *
+	 * @param count Minimum instance count.
+	 */
+	inline void set_min_instance_count(std::size_t count) noexcept
+	{
+		m_min_instance_count = std::max<std::size_t>(count, 2);
+	}
+	
+	/// Returns the minimum number of operations which will be combined into an instanced operation.
+	[[nodiscard]] inline std::size_t get_min_instance_count() const noexcept
+	{
+		return m_min_instance_count;
+	}
+
+private:
+	/// Returns a copy of a vertex array with instance transform attributes, creating it if necessary.
+	[[nodiscard]] const gl::vertex_array* get_instanced_vertex_array(const gl::vertex_array& vertex_array);
+	
+	std::size_t m_min_instance_count{2};
+	
+	/// Operations which may be instanced.
+	std::vector<const operation*> m_candidates;
+	
+	/// Instanced operations generated for the current camera.
+	std::vector<operation> m_instanced_operations;
+	
+	/// Per-instance transforms of the instanced operations.
+	std::vector<math::fmat4> m_instance_transforms;
+	
+	/// Instanced vertex arrays, keyed by source vertex array.
+	std::unordered_map<const gl::vertex_array*, std::unique_ptr<gl::vertex_array>> m_instanced_vertex_arrays;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_INSTANCING_STAGE_HPP
@@ -310,7 +310,7 @@ void light_probe_stage::set_cubemap_filter_mip_bias(float bias)
 
 void light_probe_stage::rebuild_cubemap_to_sh_shader_program()
 {
-	m_cubemap_to_sh_shader_program = m_cubemap_to_sh_shader_template->build({{"SAMPLE_COUNT", std::to_string(m_sh_sample_count)}});
+	m_cubemap_to_sh_shader_program = m_pipeline->get_shader_cache().build(*m_cubemap_to_sh_shader_template, {{"SAMPLE_COUNT", std::to_string(m_sh_sample_count)}});
 	if (!m_cubemap_to_sh_shader_program->linked())
 	{
 		debug::log_error("Failed to build cubemap to spherical harmonics shader program: {}", m_cubemap_to_sh_shader_program->info());
@@ -331,7 +331,7 @@ void light_probe_stage::rebuild_cubemap_to_sh_shader_program()
 
 void light_probe_stage::rebuild_cubemap_downsample_shader_program()
 {
-	m_cubemap_downsample_shader_program = m_cubemap_downsample_shader_template->build({});
+	m_cubemap_downsample_shader_program = m_pipeline->get_shader_cache().build(*m_cubemap_downsample_shader_template);
 	if (!m_cubemap_downsample_shader_program->linked())
 	{
 		debug::log_error("Failed to build cubemap downsample shader program: {}", m_cubemap_downsample_shader_program->info());
@@ -352,7 +352,7 @@ void light_probe_stage::rebuild_cubemap_downsample_shader_program()
 
 void light_probe_stage::rebuild_cubemap_filter_lut_shader_program()
 {
-	m_cubemap_filter_lut_shader_program = m_cubemap_filter_lut_shader_template->build({});
+	m_cubemap_filter_lut_shader_program = m_pipeline->get_shader_cache().build(*m_cubemap_filter_lut_shader_template);
 	if (!m_cubemap_filter_lut_shader_program->linked())
 	{
 		debug::log_error("Failed to build cubemap filter LUT shader program: {}", m_cubemap_filter_lut_shader_program->info());
@@ -403,7 +403,7 @@ void light_probe_stage::rebuild_cubemap_filter_lut_texture()
 
 void light_probe_stage::rebuild_cubemap_filter_shader_program()
 {
-	m_cubemap_filter_shader_program = m_cubemap_filter_shader_template->build({{"SAMPLE_COUNT", std::to_string(m_cubemap_filter_sample_count)}});
+	m_cubemap_filter_shader_program = m_pipeline->get_shader_cache().build(*m_cubemap_filter_shader_template, {{"SAMPLE_COUNT", std::to_string(m_cubemap_filter_sample_count)}});
 	if (!m_cubemap_filter_shader_program->linked())
 	{
 		debug::log_error("Failed to build cubemap filter shader program: {}", m_cubemap_filter_shader_program->info());
@@ -2,25 +2,114 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <engine/render/stages/queue-stage.hpp>
+#include <engine/render/material.hpp>
 #include <engine/scene/object.hpp>
+#include <engine/scene/collection.hpp>
 #include <algorithm>
 #include <execution>
+#include <span>
 
 namespace render {
 
 void queue_stage::execute(render::context& ctx)
 {
-	// For each visible object in the render context
-	std::for_each
-	(
-		std::execution::seq,
-		std::begin(ctx.objects),
-		std::end(ctx.objects),
-		[&ctx](scene::object_base* object)
+	if (!m_persistent)
+	{
+		// For each visible object in the render context
+		std::for_each
+		(
+			std::execution::seq,
+			std::begin(ctx.objects),
+			std::end(ctx.objects),
+			[&ctx](scene::object_base* object)
+			{
+				object->render(ctx);
+			}
+		);
+
+		return;
+	}
+
+	const std::uint64_t revision = ctx.collection->get_revision();
+	auto& cache = m_caches[ctx.camera];
+
+	// Static operations of objects which haven't changed since the cache was built can be reused, unless they could have been destroyed
+	const bool reuse_static_operations =
+		cache.collection == ctx.collection &&
+		cache.revision + 1 >= revision &&
+		ctx.collection->get_removal_revision() <= cache.revision;
+
+	if (!reuse_static_operations || cache.revision != revision || cache.objects != ctx.objects)
+	{
+		rebuild(ctx, cache, reuse_static_operations, revision);
+		return;
+	}
+
+	// Visible objects and their static operations are unchanged, only render dynamic objects
+	ctx.operations.insert(ctx.operations.end(), cache.static_operations.begin(), cache.static_operations.end());
+	for (const scene::object_base* object: cache.dynamic_objects)
+	{
+		object->render(ctx);
+	}
+}
+
+void queue_stage::set_persistent(bool persistent)
+{
+	m_persistent = persistent;
+	m_caches.clear();
+	m_next_cache = {};
+}
+
+void queue_stage::rebuild(render::context& ctx, queue_cache& cache, bool reuse_static_operations, std::uint64_t revision)
+{
+	auto& next = m_next_cache;
+	next.static_operations.clear();
+	next.static_ranges.clear();
+	next.dynamic_objects.clear();
+
+	for (scene::object_base* object: ctx.objects)
+	{
+		if (object->has_static_operations())
+		{
+			// Reuse cached static operations of unchanged objects
+			if (reuse_static_operations && !ctx.collection->changed_since(*object, cache.revision))
+			{
+				if (auto i = cache.static_ranges.find(object); i != cache.static_ranges.end())
+				{
+					const auto first = cache.static_operations.begin() + static_cast<std::ptrdiff_t>(i->second.first);
+					const auto last = first + static_cast<std::ptrdiff_t>(i->second.second);
+
+					next.static_ranges[object] = {next.static_operations.size(), i->second.second};
+					next.static_operations.insert(next.static_operations.end(), first, last);
+					ctx.operations.insert(ctx.operations.end(), first, last);
+					continue;
+				}
+			}
+
+			const std::size_t first = ctx.operations.size();
+			object->render(ctx);
+			const auto operations = std::span{ctx.operations}.subspan(first);
+
+			// Cache operations unless their order depends on the camera
+			if (std::none_of(operations.begin(), operations.end(), [](const operation* operation){return operation->material && operation->material->get_blend_mode() == material_blend_mode::translucent;}))
+			{
+				next.static_ranges[object] = {next.static_operations.size(), operations.size()};
+				next.static_operations.insert(next.static_operations.end(), operations.begin(), operations.end());
+				continue;
+			}
+		}
+		else
 		{
 			object->render(ctx);
 		}
-	);
+
+		next.dynamic_objects.emplace_back(object);
+	}
+
+	next.collection = ctx.collection;
+	next.revision = revision;
+	next.objects.assign(ctx.objects.begin(), ctx.objects.end());
+	std::swap(cache, next);
 }
 
 } // namespace render
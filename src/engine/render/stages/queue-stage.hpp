@@ -5,11 +5,20 @@
 #define ANTKEEPER_RENDER_QUEUE_STAGE_HPP
 
 #include <engine/render/stage.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace render {
 
 /**
  * Builds render queues.
+ *
+ * In persistent mode, the render operations of objects with static operations are cached for each camera, and objects are only asked to render again once they change. Objects with translucent render operations are rendered every frame, as their operations depend on the camera.
+ *
+ * @see scene::object_base::has_static_operations()
  */
 class queue_stage: public stage
 {
@@ -18,6 +27,53 @@ public:
 	~queue_stage() override = default;
 	
 	void execute(render::context& ctx) override;
+
+	/**
+	 * Enables or disables persistent mode.
+	 *
+	 * @param persistent `true` if static render operations should be cached across frames, `false` otherwise.
+	 */
+	void set_persistent(bool persistent);
+
+	/// Returns `true` if persistent mode is enabled, `false` otherwise.
+	[[nodiscard]] inline bool is_persistent() const noexcept
+	{
+		return m_persistent;
+	}
+
+private:
+	/// Render queue of a camera, cached across frames.
+	struct queue_cache
+	{
+		/// Collection from which the queue was built.
+		const scene::collection* collection{nullptr};
+
+		/// Revision of the collection in which the queue was built.
+		std::uint64_t revision{0};
+
+		/// Visible objects from which the queue was built.
+		std::vector<scene::object_base*> objects;
+
+		/// Render operations of visible objects with static operations.
+		std::vector<const operation*> static_operations;
+
+		/// Index of the first static operation of each object, and its number of static operations.
+		std::unordered_map<const scene::object_base*, std::pair<std::size_t, std::size_t>> static_ranges;
+
+		/// Visible objects which must be rendered every frame.
+		std::vector<const scene::object_base*> dynamic_objects;
+	};
+
+	/// Adds the render operations of all visible objects to the render context, and rebuilds the queue cache.
+	void rebuild(render::context& ctx, queue_cache& cache, bool reuse_static_operations, std::uint64_t revision);
+
+	bool m_persistent{false};
+
+	/// Cached render queue of each camera.
+	std::unordered_map<const scene::camera*, queue_cache> m_caches;
+
+	/// Queue cache being built.
+	queue_cache m_next_cache;
 };
 
 } // namespace render
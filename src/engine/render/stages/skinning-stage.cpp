@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/stages/skinning-stage.hpp>
+#include <engine/scene/skeletal-mesh.hpp>
+
+namespace render {
+
+void skinning_stage::execute(render::context& ctx)
+{
+	// Collect poses of visible skeletal meshes
+	m_poses.clear();
+	for (const scene::object_base* object: ctx.objects)
+	{
+		if (object->get_object_type_id() == scene::skeletal_mesh::object_type_id)
+		{
+			m_poses.emplace_back(&static_cast<const scene::skeletal_mesh*>(object)->get_pose());
+		}
+	}
+	
+	// Update skinning matrices of all collected poses
+	m_pose_evaluator.evaluate(m_poses);
+}
+
+} // namespace render
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_SKINNING_STAGE_HPP
+#define ANTKEEPER_RENDER_SKINNING_STAGE_HPP
+
+#include <engine/render/stage.hpp>
+#include <engine/animation/skeleton-pose-evaluator.hpp>
+#include <vector>
+
+class skeleton_pose;
+
+namespace render {
+
+/**
+ * Updates the skinning matrices of all visible skeletal meshes in a single batched pass.
+ */
+class skinning_stage: public stage
+{
+public:
+	/** Destructs a skinning stage. */
+	~skinning_stage() override = default;
+	
+	void execute(render::context& ctx) override;
+	
+private:
+	std::vector<const skeleton_pose*> m_poses;
+	skeleton_pose_evaluator m_pose_evaluator;
+};
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_SKINNING_STAGE_HPP
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/render/uniform-blocks.hpp>
+#include <algorithm>
+
+namespace render {
+
+// Verify block layouts against the byte offsets of the GLSL declarations
+static_assert(camera_block_offsets.view == 0);
+static_assert(camera_block_offsets.inv_view == 64);
+static_assert(camera_block_offsets.projection == 128);
+static_assert(camera_block_offsets.inv_projection == 192);
+static_assert(camera_block_offsets.view_projection == 256);
+static_assert(camera_block_offsets.camera_position == 320);
+static_assert(camera_block_offsets.camera_exposure == 332);
+static_assert(camera_block_offsets.time == 336);
+static_assert(camera_block_offsets.timestep == 340);
+static_assert(camera_block_offsets.subframe == 344);
+static_assert(camera_block_offsets.frame == 348);
+static_assert(camera_block_offsets.size == 352);
+
+static_assert(light_block_offsets.directional_light_count == 0);
+static_assert(light_block_offsets.point_light_count == 4);
+static_assert(light_block_offsets.spot_light_count == 8);
+static_assert(light_block_offsets.rectangle_light_count == 12);
+static_assert(light_block_offsets.directional_light_colors == 16);
+static_assert(light_block_offsets.directional_light_directions == 80);
+static_assert(light_block_offsets.point_light_colors == 144);
+static_assert(light_block_offsets.point_light_positions == 4240);
+static_assert(light_block_offsets.spot_light_colors == 8336);
+static_assert(light_block_offsets.spot_light_positions == 8848);
+static_assert(light_block_offsets.spot_light_directions == 9360);
+static_assert(light_block_offsets.spot_light_cutoffs == 9872);
+static_assert(light_block_offsets.rectangle_light_colors == 10384);
+static_assert(light_block_offsets.rectangle_light_corners == 10512);
+static_assert(light_block_offsets.size == 11024);
+
+static_assert(shadow_block_offsets.directional_shadow_count == 0);
+static_assert(shadow_block_offsets.directional_shadow_splits == 16);
+static_assert(shadow_block_offsets.directional_shadow_fade_ranges == 80);
+static_assert(shadow_block_offsets.directional_shadow_matrices == 144);
+static_assert(shadow_block_offsets.size == 1168);
+
+static_assert(skinning_block_offsets.skinning_palette == 0);
+static_assert(skinning_block_offsets.bone_stride == 48);
+static_assert(skinning_block_offsets.size == 12288);
+
+// Blocks must fit within the minimum guaranteed maximum uniform block size
+static_assert(light_block_offsets.size <= 16384);
+static_assert(skinning_block_offsets.size <= 16384);
+
+namespace {
+
+/// Returns the first elements of a sequence, up to a capacity.
+template <class T>
+[[nodiscard]] inline std::span<const T> clamp_span(std::span<const T> values, std::size_t capacity) noexcept
+{
+	return values.first(std::min(values.size(), capacity));
+}
+
+} // namespace
+
+void pack_camera_block(const camera_block& block, std::span<std::byte> buffer)
+{
+	const auto& offsets = camera_block_offsets;
+	gl::std140_write(buffer, offsets.view, block.view);
+	gl::std140_write(buffer, offsets.inv_view, block.inv_view);
+	gl::std140_write(buffer, offsets.projection, block.projection);
+	gl::std140_write(buffer, offsets.inv_projection, block.inv_projection);
+	gl::std140_write(buffer, offsets.view_projection, block.view_projection);
+	gl::std140_write(buffer, offsets.camera_position, block.camera_position);
+	gl::std140_write(buffer, offsets.camera_exposure, block.camera_exposure);
+	gl::std140_write(buffer, offsets.time, block.time);
+	gl::std140_write(buffer, offsets.timestep, block.timestep);
+	gl::std140_write(buffer, offsets.subframe, block.subframe);
+	gl::std140_write(buffer, offsets.frame, block.frame);
+}
+
+void pack_light_block(const light_block& block, std::span<std::byte> buffer)
+{
+	const auto& offsets = light_block_offsets;
+	
+	const auto directional_light_colors = clamp_span(block.directional_light_colors, light_block_max_directional_light_count);
+	const auto directional_light_directions = clamp_span(block.directional_light_directions, directional_light_colors.size());
+	const auto point_light_colors = clamp_span(block.point_light_colors, light_block_max_point_light_count);
+	const auto point_light_positions = clamp_span(block.point_light_positions, point_light_colors.size());
+	const auto spot_light_colors = clamp_span(block.spot_light_colors, light_block_max_spot_light_count);
+	const auto spot_light_positions = clamp_span(block.spot_light_positions, spot_light_colors.size());
+	const auto spot_light_directions = clamp_span(block.spot_light_directions, spot_light_colors.size());
+	const auto spot_light_cutoffs = clamp_span(block.spot_light_cutoffs, spot_light_colors.size());
+	const auto rectangle_light_colors = clamp_span(block.rectangle_light_colors, light_block_max_rectangle_light_count);
+	const auto rectangle_light_corners = clamp_span(block.rectangle_light_corners, rectangle_light_colors.size() * 4);
+	
+	gl::std140_write(buffer, offsets.directional_light_count, static_cast<unsigned int>(directional_light_colors.size()));
+	gl::std140_write(buffer, offsets.point_light_count, static_cast<unsigned int>(point_light_colors.size()));
+	gl::std140_write(buffer, offsets.spot_light_count, static_cast<unsigned int>(spot_light_colors.size()));
+	gl::std140_write(buffer, offsets.rectangle_light_count, static_cast<unsigned int>(rectangle_light_colors.size()));
+	gl::std140_write_array(buffer, offsets.directional_light_colors, directional_light_colors);
+	gl::std140_write_array(buffer, offsets.directional_light_directions, directional_light_directions);
+	gl::std140_write_array(buffer, offsets.point_light_colors, point_light_colors);
+	gl::std140_write_array(buffer, offsets.point_light_positions, point_light_positions);
+	gl::std140_write_array(buffer, offsets.spot_light_colors, spot_light_colors);
+	gl::std140_write_array(buffer, offsets.spot_light_positions, spot_light_positions);
+	gl::std140_write_array(buffer, offsets.spot_light_directions, spot_light_directions);
+	gl::std140_write_array(buffer, offsets.spot_light_cutoffs, spot_light_cutoffs);
+	gl::std140_write_array(buffer, offsets.rectangle_light_colors, rectangle_light_colors);
+	gl::std140_write_array(buffer, offsets.rectangle_light_corners, rectangle_light_corners);
+}
+
+void pack_shadow_block(const shadow_block& block, std::span<std::byte> buffer)
+{
+	const auto& offsets = shadow_block_offsets;
+	
+	const auto directional_shadow_splits = clamp_span(block.directional_shadow_splits, shadow_block_max_directional_shadow_count);
+	const auto directional_shadow_fade_ranges = clamp_span(block.directional_shadow_fade_ranges, directional_shadow_splits.size());
+	const auto directional_shadow_matrices = clamp_span(block.directional_shadow_matrices, directional_shadow_splits.size());
+	
+	gl::std140_write(buffer, offsets.directional_shadow_count, static_cast<unsigned int>(directional_shadow_splits.size()));
+	gl::std140_write_array(buffer, offsets.directional_shadow_splits, directional_shadow_splits);
+	gl::std140_write_array(buffer, offsets.directional_shadow_fade_ranges, directional_shadow_fade_ranges);
+	
+	// Write the cascade matrices of each shadow at fixed strides
+	constexpr std::size_t shadow_stride = gl::std140_array_stride<math::fmat4>() * shadow_block_max_cascade_count;
+	for (std::size_t i = 0; i < directional_shadow_matrices.size(); ++i)
+	{
+		gl::std140_write_array(buffer, offsets.directional_shadow_matrices + shadow_stride * i, clamp_span(directional_shadow_matrices[i], shadow_block_max_cascade_count));
+	}
+}
+
+void pack_skinning_block(const skinning_block& block, std::span<std::byte> buffer)
+{
+	const auto& offsets = skinning_block_offsets;
+
+	const auto skinning_matrices = clamp_span(block.skinning_matrices, skinning_block_max_bone_count);
+
+	// Write the first three rows of each matrix
+	for (std::size_t i = 0; i < skinning_matrices.size(); ++i)
+	{
+		const auto& matrix = skinning_matrices[i];
+		const std::size_t offset = offsets.skinning_palette + offsets.bone_stride * i;
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			gl::std140_write(buffer, offset + gl::std140_array_stride<math::fvec4>() * j, math::fvec4{matrix[0][j], matrix[1][j], matrix[2][j], matrix[3][j]});
+		}
+	}
+}
+
+} // namespace render
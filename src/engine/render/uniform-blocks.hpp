@@ -0,0 +1,381 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_RENDER_UNIFORM_BLOCKS_HPP
+#define ANTKEEPER_RENDER_UNIFORM_BLOCKS_HPP
+
+#include <engine/gl/std140.hpp>
+#include <engine/math/vector.hpp>
+#include <engine/math/matrix.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace render {
+
+/// @name Uniform block binding points
+/// @{
+
+/// Binding point of the camera uniform block.
+inline constexpr std::uint32_t camera_block_binding = 0;
+
+/// Binding point of the light uniform block.
+inline constexpr std::uint32_t light_block_binding = 1;
+
+/// Binding point of the shadow uniform block.
+inline constexpr std::uint32_t shadow_block_binding = 2;
+
+/// Binding point of the skinning uniform block.
+inline constexpr std::uint32_t skinning_block_binding = 3;
+
+/// @}
+
+/// @name Uniform block capacities
+/// @{
+
+/// Maximum number of directional lights in the light uniform block.
+inline constexpr std::size_t light_block_max_directional_light_count = 4;
+
+/// Maximum number of point lights in the light uniform block.
+inline constexpr std::size_t light_block_max_point_light_count = 256;
+
+/// Maximum number of spot lights in the light uniform block.
+inline constexpr std::size_t light_block_max_spot_light_count = 32;
+
+/// Maximum number of rectangle lights in the light uniform block.
+inline constexpr std::size_t light_block_max_rectangle_light_count = 8;
+
+/// Maximum number of directional shadows in the shadow uniform block.
+inline constexpr std::size_t shadow_block_max_directional_shadow_count = 4;
+
+/// Maximum number of cascades of each directional shadow in the shadow uniform block.
+inline constexpr std::size_t shadow_block_max_cascade_count = 4;
+
+/// Maximum number of bones in the skinning uniform block.
+inline constexpr std::size_t skinning_block_max_bone_count = 256;
+
+/// @}
+
+/**
+ * Camera data of the camera uniform block.
+ *
+ * Corresponds to the following GLSL declaration:
+ *
+ * @code{.glsl}
+ * layout(std140, binding = CAMERA_BLOCK_BINDING) uniform camera_block
+ * {
+ *     mat4 view;
+ *     mat4 inv_view;
+ *     mat4 projection;
+ *     mat4 inv_projection;
+ *     mat4 view_projection;
+ *     vec3 camera_position;
+ *     float camera_exposure;
+ *     float time;
+ *     float timestep;
+ *     float subframe;
+ *     uint frame;
+ * };
+ * @endcode
+ */
+struct camera_block
+{
+	math::fmat4 view;
+	math::fmat4 inv_view;
+	math::fmat4 projection;
+	math::fmat4 inv_projection;
+	math::fmat4 view_projection;
+	math::fvec3 camera_position;
+	float camera_exposure;
+	float time;
+	float timestep;
+	float subframe;
+	unsigned int frame;
+};
+
+/**
+ * Light data of the light uniform block.
+ *
+ * Light positions and directions are in camera-relative world space. Lights in excess of the block capacities are ignored.
+ *
+ * Corresponds to the following GLSL declaration:
+ *
+ * @code{.glsl}
+ * layout(std140, binding = LIGHT_BLOCK_BINDING) uniform light_block
+ * {
+ *     uint directional_light_count;
+ *     uint point_light_count;
+ *     uint spot_light_count;
+ *     uint rectangle_light_count;
+ *     vec3 directional_light_colors[MAX_DIRECTIONAL_LIGHT_COUNT];
+ *     vec3 directional_light_directions[MAX_DIRECTIONAL_LIGHT_COUNT];
+ *     vec3 point_light_colors[MAX_POINT_LIGHT_COUNT];
+ *     vec3 point_light_positions[MAX_POINT_LIGHT_COUNT];
+ *     vec3 spot_light_colors[MAX_SPOT_LIGHT_COUNT];
+ *     vec3 spot_light_positions[MAX_SPOT_LIGHT_COUNT];
+ *     vec3 spot_light_directions[MAX_SPOT_LIGHT_COUNT];
+ *     vec2 spot_light_cutoffs[MAX_SPOT_LIGHT_COUNT];
+ *     vec3 rectangle_light_colors[MAX_RECTANGLE_LIGHT_COUNT];
+ *     vec3 rectangle_light_corners[MAX_RECTANGLE_LIGHT_COUNT * 4];
+ * };
+ * @endcode
+ */
+struct light_block
+{
+	std::span<const math::fvec3> directional_light_colors;
+	std::span<const math::fvec3> directional_light_directions;
+	std::span<const math::fvec3> point_light_colors;
+	std::span<const math::fvec3> point_light_positions;
+	std::span<const math::fvec3> spot_light_colors;
+	std::span<const math::fvec3> spot_light_positions;
+	std::span<const math::fvec3> spot_light_directions;
+	std::span<const math::fvec2> spot_light_cutoffs;
+	std::span<const math::fvec3> rectangle_light_colors;
+	
+	/// Four corners per rectangle light.
+	std::span<const math::fvec3> rectangle_light_corners;
+};
+
+/**
+ * Shadow data of the shadow uniform block.
+ *
+ * Shadow maps are samplers, and are therefore not part of the block.
+ *
+ * Corresponds to the following GLSL declaration, in which the matrix of cascade `j` of shadow `i` is at index `i * MAX_SHADOW_CASCADE_COUNT + j`:
+ *
+ * @code{.glsl}
+ * layout(std140, binding = SHADOW_BLOCK_BINDING) uniform shadow_block
+ * {
+ *     uint directional_shadow_count;
+ *     vec4 directional_shadow_splits[MAX_DIRECTIONAL_SHADOW_COUNT];
+ *     float directional_shadow_fade_ranges[MAX_DIRECTIONAL_SHADOW_COUNT];
+ *     mat4 directional_shadow_matrices[MAX_DIRECTIONAL_SHADOW_COUNT * MAX_SHADOW_CASCADE_COUNT];
+ * };
+ * @endcode
+ */
+struct shadow_block
+{
+	std::span<const math::fvec4> directional_shadow_splits;
+	std::span<const float> directional_shadow_fade_ranges;
+	std::span<const std::span<const math::fmat4>> directional_shadow_matrices;
+};
+
+/**
+ * Skinning palette of the skinning uniform block.
+ *
+ * Skinning matrices are affine, so only their first three rows are stored, as three `vec4` rows per bone. Corresponds to the following GLSL declaration:
+ *
+ * @code{.glsl}
+ * layout(std140, binding = SKINNING_BLOCK_BINDING) uniform skinning_block
+ * {
+ *     vec4 skinning_palette[MAX_SKINNING_BONE_COUNT * 3];
+ * };
+ *
+ * mat4 skinning_matrix(uint bone)
+ * {
+ *     return transpose(mat4(skinning_palette[bone * 3], skinning_palette[bone * 3 + 1], skinning_palette[bone * 3 + 2], vec4(0.0, 0.0, 0.0, 1.0)));
+ * }
+ * @endcode
+ */
+struct skinning_block
+{
+	std::span<const math::fmat4> skinning_matrices;
+};
+
+/// Byte offsets of the members of the camera uniform block.
+struct camera_block_layout
+{
+	std::size_t view;
+	std::size_t inv_view;
+	std::size_t projection;
+	std::size_t inv_projection;
+	std::size_t view_projection;
+	std::size_t camera_position;
+	std::size_t camera_exposure;
+	std::size_t time;
+	std::size_t timestep;
+	std::size_t subframe;
+	std::size_t frame;
+	
+	/// Size of the block, in bytes.
+	std::size_t size;
+};
+
+/// Byte offsets of the members of the light uniform block.
+struct light_block_layout
+{
+	std::size_t directional_light_count;
+	std::size_t point_light_count;
+	std::size_t spot_light_count;
+	std::size_t rectangle_light_count;
+	std::size_t directional_light_colors;
+	std::size_t directional_light_directions;
+	std::size_t point_light_colors;
+	std::size_t point_light_positions;
+	std::size_t spot_light_colors;
+	std::size_t spot_light_positions;
+	std::size_t spot_light_directions;
+	std::size_t spot_light_cutoffs;
+	std::size_t rectangle_light_colors;
+	std::size_t rectangle_light_corners;
+	
+	/// Size of the block, in bytes.
+	std::size_t size;
+};
+
+/// Byte offsets of the members of the shadow uniform block.
+struct shadow_block_layout
+{
+	std::size_t directional_shadow_count;
+	std::size_t directional_shadow_splits;
+	std::size_t directional_shadow_fade_ranges;
+	std::size_t directional_shadow_matrices;
+
+	/// Size of the block, in bytes.
+	std::size_t size;
+};
+
+/// Byte offsets of the members of the skinning uniform block.
+struct skinning_block_layout
+{
+	std::size_t skinning_palette;
+
+	/// Size of the packed rows of a single bone, in bytes.
+	std::size_t bone_stride;
+	
+	/// Size of the block, in bytes.
+	std::size_t size;
+};
+
+/// Returns the std140 layout of the camera uniform block.
+[[nodiscard]] consteval camera_block_layout make_camera_block_layout() noexcept
+{
+	gl::std140_layout layout;
+	
+	camera_block_layout offsets{};
+	offsets.view = layout.append<math::fmat4>();
+	offsets.inv_view = layout.append<math::fmat4>();
+	offsets.projection = layout.append<math::fmat4>();
+	offsets.inv_projection = layout.append<math::fmat4>();
+	offsets.view_projection = layout.append<math::fmat4>();
+	offsets.camera_position = layout.append<math::fvec3>();
+	offsets.camera_exposure = layout.append<float>();
+	offsets.time = layout.append<float>();
+	offsets.timestep = layout.append<float>();
+	offsets.subframe = layout.append<float>();
+	offsets.frame = layout.append<unsigned int>();
+	offsets.size = layout.size();
+	
+	return offsets;
+}
+
+/// Returns the std140 layout of the light uniform block.
+[[nodiscard]] consteval light_block_layout make_light_block_layout() noexcept
+{
+	gl::std140_layout layout;
+	
+	light_block_layout offsets{};
+	offsets.directional_light_count = layout.append<unsigned int>();
+	offsets.point_light_count = layout.append<unsigned int>();
+	offsets.spot_light_count = layout.append<unsigned int>();
+	offsets.rectangle_light_count = layout.append<unsigned int>();
+	offsets.directional_light_colors = layout.append_array<math::fvec3>(light_block_max_directional_light_count);
+	offsets.directional_light_directions = layout.append_array<math::fvec3>(light_block_max_directional_light_count);
+	offsets.point_light_colors = layout.append_array<math::fvec3>(light_block_max_point_light_count);
+	offsets.point_light_positions = layout.append_array<math::fvec3>(light_block_max_point_light_count);
+	offsets.spot_light_colors = layout.append_array<math::fvec3>(light_block_max_spot_light_count);
+	offsets.spot_light_positions = layout.append_array<math::fvec3>(light_block_max_spot_light_count);
+	offsets.spot_light_directions = layout.append_array<math::fvec3>(light_block_max_spot_light_count);
+	offsets.spot_light_cutoffs = layout.append_array<math::fvec2>(light_block_max_spot_light_count);
+	offsets.rectangle_light_colors = layout.append_array<math::fvec3>(light_block_max_rectangle_light_count);
+	offsets.rectangle_light_corners = layout.append_array<math::fvec3>(light_block_max_rectangle_light_count * 4);
+	offsets.size = layout.size();
+	
+	return offsets;
+}
+
+/// Returns the std140 layout of the shadow uniform block.
+[[nodiscard]] consteval shadow_block_layout make_shadow_block_layout() noexcept
+{
+	gl::std140_layout layout;
+	
+	shadow_block_layout offsets{};
+	offsets.directional_shadow_count = layout.append<unsigned int>();
+	offsets.directional_shadow_splits = layout.append_array<math::fvec4>(shadow_block_max_directional_shadow_count);
+	offsets.directional_shadow_fade_ranges = layout.append_array<float>(shadow_block_max_directional_shadow_count);
+	offsets.directional_shadow_matrices = layout.append_array<math::fmat4>(shadow_block_max_directional_shadow_count * shadow_block_max_cascade_count);
+	offsets.size = layout.size();
+	
+	return offsets;
+}
+
+/// Returns the std140 layout of the skinning uniform block.
+[[nodiscard]] consteval skinning_block_layout make_skinning_block_layout() noexcept
+{
+	gl::std140_layout layout;
+
+	skinning_block_layout offsets{};
+	offsets.skinning_palette = layout.append_array<math::fvec4>(skinning_block_max_bone_count * 3);
+	offsets.bone_stride = gl::std140_array_stride<math::fvec4>() * 3;
+	offsets.size = layout.size();
+
+	return offsets;
+}
+
+/// std140 layout of the camera uniform block.
+inline constexpr camera_block_layout camera_block_offsets = make_camera_block_layout();
+
+/// std140 layout of the light uniform block.
+inline constexpr light_block_layout light_block_offsets = make_light_block_layout();
+
+/// std140 layout of the shadow uniform block.
+inline constexpr shadow_block_layout shadow_block_offsets = make_shadow_block_layout();
+
+/// std140 layout of the skinning uniform block.
+inline constexpr skinning_block_layout skinning_block_offsets = make_skinning_block_layout();
+
+/**
+ * Packs camera data into the std140 layout of the camera uniform block.
+ *
+ * @param block Camera data.
+ * @param buffer Buffer of at least `camera_block_offsets.size` bytes.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+void pack_camera_block(const camera_block& block, std::span<std::byte> buffer);
+
+/**
+ * Packs light data into the std140 layout of the light uniform block.
+ *
+ * @param block Light data.
+ * @param buffer Buffer of at least `light_block_offsets.size` bytes.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+void pack_light_block(const light_block& block, std::span<std::byte> buffer);
+
+/**
+ * Packs shadow data into the std140 layout of the shadow uniform block.
+ *
+ * @param block Shadow data.
+ * @param buffer Buffer of at least `shadow_block_offsets.size` bytes.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+void pack_shadow_block(const shadow_block& block, std::span<std::byte> buffer);
+
+/**
+ * Packs skinning matrices into the std140 layout of the skinning uniform block.
+ *
+ * Only the rows of bones in the palette are written, so @p buffer only needs to hold `skinning_block_offsets.bone_stride` bytes per bone.
+ *
+ * @param block Skinning data.
+ * @param buffer Buffer of at least `skinning_block_offsets.bone_stride` bytes per bone, up to `skinning_block_offsets.size` bytes.
+ *
+ * @exception std::out_of_range std140 write operation exceeded buffer bounds.
+ */
+void pack_skinning_block(const skinning_block& block, std::span<std::byte> buffer);
+
+} // namespace render
+
+#endif // ANTKEEPER_RENDER_UNIFORM_BLOCKS_HPP
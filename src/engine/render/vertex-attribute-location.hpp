@@ -38,7 +38,10 @@ namespace vertex_attribute_location
 		barycentric,
 		
 		/// Vertex morph target (vec3)
-		target
+		target,
+		
+		/// Instance transform (mat4), occupies four consecutive locations
+		instance_transform
 	};
 }
 
@@ -95,6 +95,11 @@ bool resource_manager::unmount(const std::filesystem::path& path)
 	return true;
 }
 
+bool resource_manager::exists(const std::filesystem::path& path) const
+{
+	return PHYSFS_exists(path.string().c_str());
+}
+
 bool resource_manager::set_write_path(const std::filesystem::path& path)
 {
 	const std::string path_string = path.string();
@@ -15,6 +15,11 @@
 #include <stdexcept>
 #include <unordered_map>
 
+namespace gl
+{
+	class image_streamer;
+}
+
 /**
  * Manages the loading, caching, and saving of resources.
  */
@@ -76,6 +81,15 @@ public:
 	template <class T>
 	bool save(const T& resource, const std::filesystem::path& path) const;
 	
+	/**
+	 * Checks whether a file exists in any mounted directory or archive.
+	 *
+	 * @param path Path to a file.
+	 *
+	 * @return `true` if the file exists, `false` otherwise.
+	 */
+	[[nodiscard]] bool exists(const std::filesystem::path& path) const;
+	
 	/**
 	 * Sets the path to a directory or archive where files can be written.
 	 *
@@ -92,6 +106,62 @@ public:
 	{
 		return write_path;
 	}
+	
+	/**
+	 * Constructs a deserialize context from a file path.
+	 *
+	 * Files may be opened and read from any thread.
+	 *
+	 * @param path Path to the file to open for reading.
+	 *
+	 * @return Unique pointer to a deserialize context, or `nullptr` if the file could not be opened for reading.
+	 */
+	[[nodiscard]] std::unique_ptr<deserialize_context> open_read(const std::filesystem::path& path) const;
+	
+	/**
+	 * Returns a cached resource, without loading it.
+	 *
+	 * @tparam T Resource type.
+	 *
+	 * @param path Path to the resource.
+	 *
+	 * @return Pointer to the cached resource, or `nullptr` if the resource is not loaded.
+	 */
+	template <class T>
+	[[nodiscard]] inline std::shared_ptr<T> find(const std::filesystem::path& path) const
+	{
+		return std::static_pointer_cast<T>(fetch(path));
+	}
+	
+	/**
+	 * Caches a resource which was loaded by other means, such that subsequent loads of its path return it.
+	 *
+	 * @tparam T Resource type.
+	 *
+	 * @param path Path to the resource.
+	 * @param resource Resource to cache.
+	 */
+	template <class T>
+	inline void insert(const std::filesystem::path& path, const std::shared_ptr<T>& resource)
+	{
+		resource_cache[path] = resource;
+	}
+	
+	/**
+	 * Sets the image streamer through which the images of 2D textures are loaded.
+	 *
+	 * @param streamer Image streamer, or `nullptr` if images should be loaded synchronously.
+	 */
+	inline void set_image_streamer(gl::image_streamer* streamer) noexcept
+	{
+		image_streamer = streamer;
+	}
+	
+	/// Returns the image streamer through which the images of 2D textures are loaded, or `nullptr` if images are loaded synchronously.
+	[[nodiscard]] inline gl::image_streamer* get_image_streamer() const noexcept
+	{
+		return image_streamer;
+	}
 
 private:
 	/**
@@ -103,15 +173,6 @@ private:
 	 */
 	[[nodiscard]] std::shared_ptr<void> fetch(const std::filesystem::path& path) const;
 	
-	/**
-	 * Constructs a deserialize context from a file path.
-	 *
-	 * @param path Path to the file to open for reading.
-	 *
-	 * @return Unique pointer to a deserialize context, or `nullptr` if the file could not be opened for reading.
-	 */
-	[[nodiscard]] std::unique_ptr<deserialize_context> open_read(const std::filesystem::path& path) const;
-	
 	/**
 	 * Constructs a serialize context from a file path.
 	 *
@@ -123,6 +184,7 @@ private:
 	
 	std::unordered_map<std::filesystem::path, std::weak_ptr<void>> resource_cache;
 	std::filesystem::path write_path;
+	gl::image_streamer* image_streamer{nullptr};
 };
 
 template <class T>
@@ -6,6 +6,7 @@
 #include <engine/render/vertex-attribute-location.hpp>
 #include <engine/geom/projection.hpp>
 #include <engine/scene/camera.hpp>
+#include <engine/render/sort-key.hpp>
 
 namespace scene {
 
@@ -36,19 +37,44 @@ namespace {
 	};
 	
 	constexpr std::size_t billboard_vertex_stride = 4 * sizeof(float);
+	
+	// Billboard quad as a triangle list, from which flat billboards may be batched.
+	constexpr float billboard_batch_vertex_data[] =
+	{
+		-1.0f,  1.0f, 0.0f, 1.0f,
+		-1.0f, -1.0f, 0.0f, 0.0f,
+		 1.0f,  1.0f, 1.0f, 1.0f,
+		 1.0f,  1.0f, 1.0f, 1.0f,
+		-1.0f, -1.0f, 0.0f, 0.0f,
+		 1.0f, -1.0f, 1.0f, 0.0f
+	};
+	
+	// Shared billboard quad geometry, which lives as long as any billboard.
+	std::weak_ptr<gl::vertex_array> billboard_vertex_array;
+	std::weak_ptr<gl::vertex_buffer> billboard_vertex_buffer;
 }
 
 billboard::billboard()
 {
-	// Construct vertex array
-	m_vertex_array = std::make_unique<gl::vertex_array>(billboard_vertex_attributes);
+	// Share vertex array, constructing it if necessary
+	m_vertex_array = billboard_vertex_array.lock();
+	if (!m_vertex_array)
+	{
+		m_vertex_array = std::make_shared<gl::vertex_array>(billboard_vertex_attributes);
+		billboard_vertex_array = m_vertex_array;
+	}
 	
-	// Construct vertex buffer
-	m_vertex_buffer = std::make_unique<gl::vertex_buffer>
-	(
-		gl::buffer_usage::static_draw,
-		std::as_bytes(std::span{billboard_vertex_data})
-	);
+	// Share vertex buffer, constructing it if necessary
+	m_vertex_buffer = billboard_vertex_buffer.lock();
+	if (!m_vertex_buffer)
+	{
+		m_vertex_buffer = std::make_shared<gl::vertex_buffer>
+		(
+			gl::buffer_usage::static_draw,
+			std::as_bytes(std::span{billboard_vertex_data})
+		);
+		billboard_vertex_buffer = m_vertex_buffer;
+	}
 	
 	// Init render operation
 	m_render_op.primitive_topology = gl::primitive_topology::triangle_strip;
@@ -60,6 +86,7 @@ billboard::billboard()
 	m_render_op.vertex_count = 4;
 	m_render_op.first_instance = 0;
 	m_render_op.instance_count = 1;
+	m_render_op.batch_vertex_data = std::as_bytes(std::span{billboard_batch_vertex_data});
 }
 
 void billboard::render(render::context& ctx) const
@@ -102,6 +129,7 @@ void billboard::render(render::context& ctx) const
 	
 	m_render_op.depth = ctx.camera->get_view_frustum().near().distance(get_translation());
 	m_render_op.layer_mask = get_layer_mask();
+	m_render_op.sort_key = render::make_material_sort_key(m_render_op);
 	
 	ctx.operations.emplace_back(&m_render_op);
 }
@@ -118,6 +146,12 @@ void billboard::set_billboard_type(billboard_type type)
 	if (m_billboard_type == scene::billboard_type::flat)
 	{
 		m_render_op.transform = get_transform().matrix();
+		m_render_op.batch_vertex_data = std::as_bytes(std::span{billboard_batch_vertex_data});
+	}
+	else
+	{
+		// Camera-aligned billboards can't be batched
+		m_render_op.batch_vertex_data = {};
 	}
 }
 
@@ -3,9 +3,16 @@
 
 #include <engine/scene/collection.hpp>
 #include <engine/debug/log.hpp>
+#include <algorithm>
+#include <iterator>
 
 namespace scene {
 
+collection::~collection()
+{
+	remove_objects();
+}
+
 void collection::add_object(object_base& object)
 {
 	if (m_object_set.contains(&object))
@@ -14,9 +21,19 @@ void collection::add_object(object_base& object)
 	}
 	else
 	{
+		object.m_collections.emplace_back(this, m_objects.size());
+
 		m_objects.emplace_back(&object);
 		m_object_set.emplace(&object);
 		m_object_map[object.get_object_type_id()].emplace_back(&object);
+
+		m_outdated_flags.emplace_back(std::uint8_t{0});
+		m_outdated_indices.emplace_back(std::size_t{0});
+		m_object_revisions.emplace_back(std::uint64_t{0});
+		m_index.insert(object);
+
+		// Report the object as changed in the next revision
+		invalidate(m_objects.size() - 1);
 	}
 }
 
@@ -28,16 +45,158 @@ void collection::remove_object(const object_base& object)
 	}
 	else
 	{
-		std::erase(m_objects, &object);
-		m_object_set.erase(&object);
+		const auto i = std::find_if(object.m_collections.begin(), object.m_collections.end(), [this](const auto& membership){return membership.first == this;});
+		erase_object(i->second);
 		std::erase(m_object_map[object.get_object_type_id()], &object);
 	}
 }
 
 void collection::remove_objects()
 {
+	for (object_base* object: m_objects)
+	{
+		std::erase_if(object->m_collections, [this](const auto& membership){return membership.first == this;});
+	}
+
 	m_objects.clear();
+	m_object_set.clear();
 	m_object_map.clear();
+	m_index.clear();
+	m_outdated_flags.clear();
+	m_outdated_indices.clear();
+	m_outdated_count = 0;
+	m_object_revisions.clear();
+	m_changed_objects.clear();
+	m_removal_pending = true;
+}
+
+void collection::query(const geom::view_frustum<float>& frustum, std::vector<object_base*>& objects) const
+{
+	query(std::span<const geom::plane<float>>{frustum.planes}, objects);
+}
+
+void collection::query(std::span<const geom::plane<float>> planes, std::vector<object_base*>& objects) const
+{
+	apply_changes();
+	m_index.query(planes, objects);
+}
+
+void collection::query(const geom::sphere<float>& sphere, std::vector<object_base*>& objects) const
+{
+	apply_changes();
+	m_index.query(sphere, objects);
+}
+
+void collection::query(const geom::box<float>& box, std::vector<object_base*>& objects) const
+{
+	apply_changes();
+	m_index.query(box, objects);
+}
+
+std::uint64_t collection::get_revision() const
+{
+	apply_changes();
+	return m_revision;
+}
+
+bool collection::changed_since(const object_base& object, std::uint64_t revision) const noexcept
+{
+	for (const auto& [collection, index]: object.m_collections)
+	{
+		if (collection == this)
+		{
+			return m_object_revisions[index] > revision;
+		}
+	}
+
+	return false;
+}
+
+void collection::detach(const object_base& object, std::size_t index)
+{
+	// Object type is unavailable during object destruction, so search all type maps
+	erase_object(index);
+	for (auto& [type_id, objects]: m_object_map)
+	{
+		std::erase(objects, &object);
+	}
+}
+
+void collection::erase_object(std::size_t index)
+{
+	object_base& object = *m_objects[index];
+	const std::size_t last_index = m_objects.size() - 1;
+
+	// Discard pending index update of the object
+	const auto outdated_end = m_outdated_indices.begin() + static_cast<std::ptrdiff_t>(m_outdated_count.load());
+	const auto outdated_last = std::remove(m_outdated_indices.begin(), outdated_end, index);
+	m_outdated_count = static_cast<std::size_t>(std::distance(m_outdated_indices.begin(), outdated_last));
+
+	// Move the last object into the place of the erased object
+	if (index != last_index)
+	{
+		object_base& moved_object = *m_objects[last_index];
+		for (auto& [collection, collection_index]: moved_object.m_collections)
+		{
+			if (collection == this)
+			{
+				collection_index = index;
+			}
+		}
+		std::replace(m_outdated_indices.begin(), outdated_last, last_index, index);
+
+		m_objects[index] = &moved_object;
+		m_outdated_flags[index] = m_outdated_flags[last_index];
+		m_object_revisions[index] = m_object_revisions[last_index];
+	}
+	std::erase_if(object.m_collections, [this](const auto& membership){return membership.first == this;});
+
+	m_index.erase(object);
+	m_objects.pop_back();
+	m_outdated_flags.pop_back();
+	m_outdated_indices.pop_back();
+	m_object_revisions.pop_back();
+	m_object_set.erase(&object);
+	std::erase(m_changed_objects, &object);
+	m_removal_pending = true;
+}
+
+void collection::invalidate(std::size_t index) noexcept
+{
+	// Append object to the outdated list only the first time it's flagged
+	if (!std::atomic_ref<std::uint8_t>(m_outdated_flags[index]).exchange(std::uint8_t{1}, std::memory_order_relaxed))
+	{
+		m_outdated_indices[m_outdated_count.fetch_add(1, std::memory_order_relaxed)] = index;
+	}
+}
+
+void collection::apply_changes() const
+{
+	const std::size_t count = m_outdated_count.load(std::memory_order_acquire);
+	if (!count && !m_removal_pending)
+	{
+		return;
+	}
+
+	// Begin new revision
+	++m_revision;
+	if (m_removal_pending)
+	{
+		m_removal_revision = m_revision;
+		m_removal_pending = false;
+	}
+
+	m_changed_objects.clear();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::size_t index = m_outdated_indices[i];
+		m_outdated_flags[index] = 0;
+		m_object_revisions[index] = m_revision;
+		m_changed_objects.emplace_back(m_objects[index]);
+		m_index.update(*m_objects[index]);
+	}
+
+	m_outdated_count.store(0, std::memory_order_release);
 }
 
 } // namespace scene
@@ -5,6 +5,11 @@
 #define ANTKEEPER_SCENE_COLLECTION_HPP
 
 #include <engine/scene/object.hpp>
+#include <engine/scene/spatial-index.hpp>
+#include <engine/geom/primitives/view-frustum.hpp>
+#include <atomic>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -17,6 +22,15 @@ namespace scene {
 class collection
 {
 public:
+	/** Constructs a collection. */
+	collection() = default;
+	
+	/** Destructs a collection, removing all of its objects. */
+	~collection();
+	
+	collection(const collection&) = delete;
+	collection& operator=(const collection&) = delete;
+	
 	/// @name Objects
 	/// @{
 	
@@ -55,6 +69,81 @@ public:
 		return m_object_map[type_id];
 	}
 	
+	/// @}
+	/// @name Spatial queries
+	/// @{
+	
+	/**
+	 * Finds all objects which intersect a view frustum.
+	 *
+	 * @param[in] frustum View frustum to test.
+	 * @param[out] objects Objects which intersect the view frustum are appended to this vector.
+	 */
+	void query(const geom::view_frustum<float>& frustum, std::vector<object_base*>& objects) const;
+	
+	/**
+	 * Finds all objects which intersect a convex region.
+	 *
+	 * @param[in] planes Planes which bound the region. Objects entirely behind any plane are excluded.
+	 * @param[out] objects Objects which intersect the region are appended to this vector.
+	 */
+	void query(std::span<const geom::plane<float>> planes, std::vector<object_base*>& objects) const;
+	
+	/**
+	 * Finds all objects which intersect a sphere.
+	 *
+	 * @param[in] sphere Sphere to test.
+	 * @param[out] objects Objects which intersect the sphere are appended to this vector.
+	 */
+	void query(const geom::sphere<float>& sphere, std::vector<object_base*>& objects) const;
+	
+	/**
+	 * Finds all objects which intersect a box.
+	 *
+	 * @param[in] box Box to test.
+	 * @param[out] objects Objects which intersect the box are appended to this vector.
+	 */
+	void query(const geom::box<float>& box, std::vector<object_base*>& objects) const;
+	
+	/// @}
+	/// @name Change tracking
+	/// @{
+	
+	/**
+	 * Applies pending object changes and returns the revision of the collection.
+	 *
+	 * The revision is incremented each time changes are applied after objects have been added, removed, transformed, or otherwise modified.
+	 */
+	[[nodiscard]] std::uint64_t get_revision() const;
+	
+	/**
+	 * Returns the objects which were added or changed in the latest revision.
+	 *
+	 * @warning Only valid after get_revision() has applied pending changes.
+	 */
+	[[nodiscard]] inline const std::vector<object_base*>& get_changed_objects() const noexcept
+	{
+		return m_changed_objects;
+	}
+	
+	/// Returns the latest revision in which objects were removed from the collection.
+	[[nodiscard]] inline std::uint64_t get_removal_revision() const noexcept
+	{
+		return m_removal_revision;
+	}
+	
+	/**
+	 * Checks if an object was added or changed after a revision.
+	 *
+	 * @param object Object in the collection.
+	 * @param revision Revision of the collection.
+	 *
+	 * @return `true` if the object was added or changed after the revision, `false` otherwise.
+	 *
+	 * @warning Only valid after get_revision() has applied pending changes.
+	 */
+	[[nodiscard]] bool changed_since(const object_base& object, std::uint64_t revision) const noexcept;
+	
 	/// @}
 	/// @name Settings
 	/// @{
@@ -78,10 +167,62 @@ public:
 	/// @}
 
 private:
+	friend class object_base;
+	
+	/**
+	 * Flags an object as changed, and its bounds as outdated.
+	 *
+	 * @param index Index of the object in the collection.
+	 *
+	 * @note Safe to call concurrently, but not concurrently with adding or removing objects.
+	 */
+	void invalidate(std::size_t index) noexcept;
+	
+	/**
+	 * Removes an object which is being destroyed from the collection.
+	 *
+	 * @param object Object being destroyed.
+	 * @param index Index of the object in the collection.
+	 */
+	void detach(const object_base& object, std::size_t index);
+	
+	/// Removes the object at an index from all containers except the type map, moving the last object into its place.
+	void erase_object(std::size_t index);
+	
+	/// Moves objects with outdated bounds within the spatial index, and begins a new revision if any objects were changed or removed.
+	void apply_changes() const;
+	
 	std::vector<object_base*> m_objects;
 	std::unordered_set<const object_base*> m_object_set;
 	mutable std::unordered_map<std::size_t, std::vector<object_base*>> m_object_map;
 	float m_scale{1.0f};
+	
+	/// Spatial index of the objects.
+	mutable spatial_index m_index;
+	
+	/// Per-object flags indicating the object's bounds are outdated in the spatial index.
+	mutable std::vector<std::uint8_t> m_outdated_flags;
+	
+	/// Indices of objects with outdated bounds, with capacity for every object.
+	mutable std::vector<std::size_t> m_outdated_indices;
+	
+	/// Number of objects with outdated bounds.
+	mutable std::atomic<std::size_t> m_outdated_count{0};
+	
+	/// Revision of the collection.
+	mutable std::uint64_t m_revision{0};
+	
+	/// Latest revision in which objects were removed.
+	mutable std::uint64_t m_removal_revision{0};
+	
+	/// `true` if objects have been removed since changes were last applied.
+	mutable bool m_removal_pending{false};
+	
+	/// Revision in which each object was last added or changed.
+	mutable std::vector<std::uint64_t> m_object_revisions;
+	
+	/// Objects which were added or changed in the latest revision.
+	mutable std::vector<object_base*> m_changed_objects;
 };
 
 } // namespace scene
@@ -2,9 +2,19 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <engine/scene/object.hpp>
+#include <engine/scene/collection.hpp>
 
 namespace scene {
 
+object_base::~object_base()
+{
+	while (!m_collections.empty())
+	{
+		const auto [collection, index] = m_collections.back();
+		collection->detach(*this, index);
+	}
+}
+
 std::size_t object_base::next_object_type_id()
 {
 	static std::atomic<std::size_t> id{0};
@@ -15,7 +25,21 @@ void object_base::look_at(const vector_type& position, const vector_type& target
 {
 	m_transform.translation = position;
 	m_transform.rotation = math::look_rotation(math::normalize(target - position), up);
+	notify_transformed();
+}
+
+void object_base::notify_transformed()
+{
 	transformed();
+	notify_changed();
+}
+
+void object_base::notify_changed() noexcept
+{
+	for (const auto& [collection, index]: m_collections)
+	{
+		collection->invalidate(index);
+	}
 }
 
 } // namespace scene
@@ -11,9 +11,13 @@
 #include <engine/render/context.hpp>
 #include <atomic>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace scene {
 
+class collection;
+
 /**
  * Abstract base class for scene objects.
  */
@@ -25,8 +29,8 @@ public:
 	using transform_type = math::transform<float>;
 	using aabb_type = geom::box<float>;
 	
-	/** Destructs a scene object base. */
-	virtual ~object_base() = default;
+	/** Destructs a scene object base, removing it from any collections which contain it. */
+	virtual ~object_base();
 	
 	/// Returns the type ID for this scene object type.
 	[[nodiscard]] virtual const std::size_t get_object_type_id() const noexcept = 0;
@@ -38,6 +42,16 @@ public:
 	 */
 	inline virtual void render([[maybe_unused]] render::context& ctx) const {}
 	
+	/**
+	 * Returns `true` if the render operations of the object only change when the object is transformed or otherwise modified, and don't depend on the camera or time.
+	 *
+	 * Renderers with persistent render queues reuse the render operations of such objects across frames, until the object notifies its collections of a change.
+	 */
+	[[nodiscard]] inline virtual bool has_static_operations() const noexcept
+	{
+		return false;
+	}
+
 	/**
 	 *
 	 */
@@ -48,9 +62,10 @@ public:
 	 *
 	 * @param mask 32-bit layer mask in which each set bit represents a layer in which the object is visible.
 	 */
-	inline constexpr void set_layer_mask(std::uint32_t mask) noexcept
+	inline void set_layer_mask(std::uint32_t mask) noexcept
 	{
 		m_layer_mask = mask;
+		notify_changed();
 	}
 	
 	/**
@@ -61,7 +76,7 @@ public:
 	inline void set_transform(const transform_type& transform)
 	{
 		m_transform = transform;
-		transformed();
+		notify_transformed();
 	}
 
 	/**
@@ -72,7 +87,7 @@ public:
 	inline void set_translation(const vector_type& translation)
 	{
 		m_transform.translation = translation;
-		transformed();
+		notify_transformed();
 	}
 	
 	/**
@@ -83,7 +98,7 @@ public:
 	inline void set_rotation(const quaternion_type& rotation)
 	{
 		m_transform.rotation = rotation;
-		transformed();
+		notify_transformed();
 	}
 	
 	/**
@@ -95,12 +110,12 @@ public:
 	inline void set_scale(const vector_type& scale)
 	{
 		m_transform.scale = scale;
-		transformed();
+		notify_transformed();
 	}
 	inline void set_scale(float scale)
 	{
 		m_transform.scale = {scale, scale, scale};
-		transformed();
+		notify_transformed();
 	}
 	/// @}
 	
@@ -145,8 +160,28 @@ protected:
 	 */
 	inline virtual void transformed() {}
 	
+	/**
+	 * Calls transformed(), then flags the bounds of the object as outdated in each collection which contains it.
+	 *
+	 * @note Safe to call concurrently for different objects.
+	 */
+	void notify_transformed();
+
+	/**
+	 * Flags the object as changed in each collection which contains it. Called when the layer mask, render operations, or materials of the object change.
+	 *
+	 * @note Safe to call concurrently for different objects.
+	 */
+	void notify_changed() noexcept;
+
 	std::uint32_t m_layer_mask{1};
 	transform_type m_transform{math::identity<transform_type>};
+
+private:
+	friend class collection;
+
+	/// Collections which contain the object, and the index of the object in each collection.
+	std::vector<std::pair<collection*, std::size_t>> m_collections;
 };
 
 /**
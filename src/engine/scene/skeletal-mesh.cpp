@@ -3,6 +3,12 @@
 
 #include <engine/scene/skeletal-mesh.hpp>
 #include <engine/scene/camera.hpp>
+#include <engine/render/sort-key.hpp>
+#include <engine/render/context.hpp>
+#include <engine/render/uniform-blocks.hpp>
+#include <engine/gl/stream-buffer.hpp>
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace scene {
@@ -23,6 +29,7 @@ void skeletal_mesh::set_model(std::shared_ptr<render::model> model)
 
 		m_model = std::move(model);
 		m_pose = skeleton_pose(*m_model->skeleton());
+		m_skinning_palette_stream_buffer = nullptr;
 		
 		m_operations.resize(m_model->get_groups().size());
 		for (std::size_t i = 0; i < m_operations.size(); ++i)
@@ -50,7 +57,7 @@ void skeletal_mesh::set_model(std::shared_ptr<render::model> model)
 		m_operations.clear();
 	}
 	
-	transformed();
+	notify_transformed();
 }
 
 void skeletal_mesh::set_material(std::size_t index, std::shared_ptr<render::material> material)
@@ -108,6 +115,7 @@ void skeletal_mesh::render(render::context& ctx) const
 {
 	// Update skinning matrices
 	m_pose.update_skinning_matrices();
+	update_skinning_palette(ctx);
 
 	const float depth = ctx.camera->get_view_frustum().near().distance(get_translation());
 
@@ -115,8 +123,42 @@ void skeletal_mesh::render(render::context& ctx) const
 	{
 		operation.depth = depth;
 		operation.layer_mask = get_layer_mask();
+		operation.sort_key = render::make_material_sort_key(operation);
 		ctx.operations.push_back(&operation);
 	}
 }
 
+void skeletal_mesh::update_skinning_palette(render::context& ctx) const
+{
+	// Repack skinning palette if the pose has changed
+	const std::uint64_t generation = m_pose.get_generation();
+	const bool repacked = m_skinning_palette_generation != generation || m_skinning_palette.empty();
+	if (repacked)
+	{
+		const auto& skinning_matrices = m_pose.get_skinning_matrices();
+		const std::size_t bone_count = std::min(skinning_matrices.size(), render::skinning_block_max_bone_count);
+		m_skinning_palette.resize(bone_count * render::skinning_block_offsets.bone_stride);
+		render::pack_skinning_block({skinning_matrices}, m_skinning_palette);
+		m_skinning_palette_generation = generation;
+	}
+
+	// Skinning palette is already in the stream buffer for this frame
+	if (!repacked && m_skinning_palette_frame == ctx.frame && m_skinning_palette_stream_buffer == ctx.stream_buffer)
+	{
+		return;
+	}
+
+	// Write skinning palette into the stream buffer. The block is allocated at full size, as it's bound at full size, but only the rows of posed bones are written.
+	const auto allocation = ctx.stream_buffer->allocate(render::skinning_block_offsets.size, ctx.uniform_buffer_offset_alignment);
+	std::memcpy(allocation.data.data(), m_skinning_palette.data(), m_skinning_palette.size());
+	m_skinning_palette_frame = ctx.frame;
+	m_skinning_palette_stream_buffer = ctx.stream_buffer;
+
+	for (auto& operation: m_operations)
+	{
+		operation.skinning_buffer = allocation.buffer;
+		operation.skinning_offset = allocation.offset;
+	}
+}
+
 } // namespace scene
@@ -8,8 +8,15 @@
 #include <engine/render/model.hpp>
 #include <engine/render/operation.hpp>
 #include <engine/animation/skeleton-pose.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+namespace gl
+{
+	class stream_buffer;
+}
+
 namespace scene {
 
 /**
@@ -91,10 +98,21 @@ private:
 	void update_bounds();
 	void transformed() override;
 	
+	/// Packs the skinning palette if the pose has changed, and writes it into the stream buffer once per frame.
+	void update_skinning_palette(render::context& ctx) const;
+	
 	std::shared_ptr<render::model> m_model;
 	mutable std::vector<render::operation> m_operations;
 	aabb_type m_bounds{{0, 0, 0}, {0, 0, 0}};
 	skeleton_pose m_pose;
+	
+	/// Skinning matrices packed into the skinning uniform block layout, and the pose generation from which they were packed.
+	mutable std::vector<std::byte> m_skinning_palette;
+	mutable std::uint64_t m_skinning_palette_generation{0};
+	
+	/// Frame and stream buffer into which the skinning palette was last written.
+	mutable unsigned int m_skinning_palette_frame{0};
+	mutable const gl::stream_buffer* m_skinning_palette_stream_buffer{nullptr};
 };
 
 } // namespace scene
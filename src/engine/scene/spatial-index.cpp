@@ -0,0 +1,442 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/scene/spatial-index.hpp>
+#include <engine/scene/object.hpp>
+#include <engine/geom/morton.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace scene {
+
+namespace {
+
+/// Node test results.
+inline constexpr int outside = 0;
+inline constexpr int intersecting = 1;
+inline constexpr int inside = 2;
+
+} // namespace
+
+void spatial_index::bounds_array::push_back(const geom::box<float>& bounds)
+{
+	min_x.emplace_back(bounds.min.x());
+	min_y.emplace_back(bounds.min.y());
+	min_z.emplace_back(bounds.min.z());
+	max_x.emplace_back(bounds.max.x());
+	max_y.emplace_back(bounds.max.y());
+	max_z.emplace_back(bounds.max.z());
+}
+
+void spatial_index::bounds_array::set(std::size_t index, const geom::box<float>& bounds) noexcept
+{
+	min_x[index] = bounds.min.x();
+	min_y[index] = bounds.min.y();
+	min_z[index] = bounds.min.z();
+	max_x[index] = bounds.max.x();
+	max_y[index] = bounds.max.y();
+	max_z[index] = bounds.max.z();
+}
+
+void spatial_index::bounds_array::swap_and_pop(std::size_t index) noexcept
+{
+	for (auto* array: {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z})
+	{
+		(*array)[index] = array->back();
+		array->pop_back();
+	}
+}
+
+spatial_index::spatial_index(const math::fvec3& center, float size, node_type max_depth):
+	m_min(center - size * 0.5f),
+	m_size(size),
+	m_max_depth(max_depth)
+{
+	if (max_depth > octree_type::max_depth)
+	{
+		throw std::invalid_argument(std::format("Spatial index maximum depth ({}) exceeds octree maximum depth ({}).", max_depth, octree_type::max_depth));
+	}
+}
+
+void spatial_index::insert(object_base& object)
+{
+	if (m_locations.contains(&object))
+	{
+		return;
+	}
+	
+	const auto& bounds = object.get_bounds();
+	link(object, bounds, fit(bounds));
+}
+
+void spatial_index::erase(const object_base& object)
+{
+	if (auto i = m_locations.find(&object); i != m_locations.end())
+	{
+		unlink(i->second);
+		m_locations.erase(i);
+	}
+}
+
+void spatial_index::update(object_base& object)
+{
+	auto i = m_locations.find(&object);
+	if (i == m_locations.end())
+	{
+		return;
+	}
+	
+	const auto& bounds = object.get_bounds();
+	const node_type node = fit(bounds);
+	
+	// Update bounds in place if the object still fits its node
+	if (node == i->second.node)
+	{
+		auto& container = (node == overflow_node) ? m_overflow : m_nodes[node];
+		container.bounds.set(i->second.index, bounds);
+		return;
+	}
+	
+	unlink(i->second);
+	link(object, bounds, node);
+}
+
+void spatial_index::clear()
+{
+	m_nodes.clear();
+	m_overflow = {};
+	m_locations.clear();
+}
+
+template <class NodeTest, class ObjectTest>
+void spatial_index::query_nodes(const NodeTest& node_test, const ObjectTest& object_test, std::vector<object_base*>& objects) const
+{
+	// Appends the objects of a container which pass the object test
+	const auto test_objects = [&](const node& container)
+	{
+		const std::size_t count = container.objects.size();
+		if (!count)
+		{
+			return;
+		}
+		
+		m_mask.resize(count);
+		object_test(container.bounds, m_mask.data());
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (m_mask[i])
+			{
+				objects.emplace_back(container.objects[i]);
+			}
+		}
+	};
+	
+	test_objects(m_overflow);
+	
+	m_stack.clear();
+	if (m_nodes.contains(octree_type::root))
+	{
+		m_stack.emplace_back(octree_type::root);
+	}
+	
+	while (!m_stack.empty())
+	{
+		const node_type node = m_stack.back();
+		m_stack.pop_back();
+		
+		const int result = node_test(loose_bounds(node));
+		if (result == outside)
+		{
+			continue;
+		}
+		
+		const auto& container = m_nodes.find(node)->second;
+		if (result == inside)
+		{
+			// Node is entirely inside the region, append all of its objects without testing
+			gather(container, node, objects);
+			continue;
+		}
+		
+		test_objects(container);
+		
+		// Visit non-empty children in reverse order, such that they're popped in order
+		for (unsigned int mask = container.children; mask;)
+		{
+			const unsigned int i = static_cast<unsigned int>(std::bit_width(mask)) - 1;
+			mask &= ~(1u << i);
+			m_stack.emplace_back(octree_type::child(node, i));
+		}
+	}
+}
+
+void spatial_index::query(std::span<const geom::plane<float>> planes, std::vector<object_base*>& objects) const
+{
+	const auto node_test = [&](const geom::box<float>& bounds) -> int
+	{
+		int result = inside;
+		for (const auto& plane: planes)
+		{
+			// Test the box corners farthest along and against the plane normal
+			const math::fvec3 p
+			{
+				(plane.normal.x() > 0.0f) ? bounds.max.x() : bounds.min.x(),
+				(plane.normal.y() > 0.0f) ? bounds.max.y() : bounds.min.y(),
+				(plane.normal.z() > 0.0f) ? bounds.max.z() : bounds.min.z()
+			};
+			if (plane.distance(p) < 0.0f)
+			{
+				return outside;
+			}
+			
+			const math::fvec3 n
+			{
+				(plane.normal.x() > 0.0f) ? bounds.min.x() : bounds.max.x(),
+				(plane.normal.y() > 0.0f) ? bounds.min.y() : bounds.max.y(),
+				(plane.normal.z() > 0.0f) ? bounds.min.z() : bounds.max.z()
+			};
+			if (plane.distance(n) < 0.0f)
+			{
+				result = intersecting;
+			}
+		}
+		
+		return result;
+	};
+	
+	const auto object_test = [&](const bounds_array& bounds, std::uint8_t* mask)
+	{
+		const std::size_t count = bounds.min_x.size();
+		std::fill_n(mask, count, std::uint8_t{1});
+		
+		// Test one plane at a time, so that the inner loop can be vectorized across objects
+		for (const auto& plane: planes)
+		{
+			const float* const x = (plane.normal.x() > 0.0f) ? bounds.max_x.data() : bounds.min_x.data();
+			const float* const y = (plane.normal.y() > 0.0f) ? bounds.max_y.data() : bounds.min_y.data();
+			const float* const z = (plane.normal.z() > 0.0f) ? bounds.max_z.data() : bounds.min_z.data();
+			const float nx = plane.normal.x();
+			const float ny = plane.normal.y();
+			const float nz = plane.normal.z();
+			const float d = plane.constant;
+			
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				mask[i] &= static_cast<std::uint8_t>(!(nx * x[i] + ny * y[i] + nz * z[i] + d < 0.0f));
+			}
+		}
+	};
+	
+	query_nodes(node_test, object_test, objects);
+}
+
+void spatial_index::query(const geom::sphere<float>& sphere, std::vector<object_base*>& objects) const
+{
+	const float sqr_radius = sphere.radius * sphere.radius;
+	
+	const auto node_test = [&](const geom::box<float>& bounds) -> int
+	{
+		// Find squared distance from the sphere center to the nearest and farthest points of the box
+		float sqr_nearest = 0.0f;
+		float sqr_farthest = 0.0f;
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			const float c = sphere.center[i];
+			const float nearest = c - std::clamp(c, bounds.min[i], bounds.max[i]);
+			const float farthest = std::max(c - bounds.min[i], bounds.max[i] - c);
+			sqr_nearest += nearest * nearest;
+			sqr_farthest += farthest * farthest;
+		}
+		
+		if (sqr_nearest > sqr_radius)
+		{
+			return outside;
+		}
+		
+		return (sqr_farthest <= sqr_radius) ? inside : intersecting;
+	};
+	
+	const auto object_test = [&](const bounds_array& bounds, std::uint8_t* mask)
+	{
+		const float cx = sphere.center.x();
+		const float cy = sphere.center.y();
+		const float cz = sphere.center.z();
+		
+		const std::size_t count = bounds.min_x.size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const float dx = cx - std::min(std::max(cx, bounds.min_x[i]), bounds.max_x[i]);
+			const float dy = cy - std::min(std::max(cy, bounds.min_y[i]), bounds.max_y[i]);
+			const float dz = cz - std::min(std::max(cz, bounds.min_z[i]), bounds.max_z[i]);
+			mask[i] = static_cast<std::uint8_t>(dx * dx + dy * dy + dz * dz <= sqr_radius);
+		}
+	};
+	
+	query_nodes(node_test, object_test, objects);
+}
+
+void spatial_index::query(const geom::box<float>& box, std::vector<object_base*>& objects) const
+{
+	const auto node_test = [&](const geom::box<float>& bounds) -> int
+	{
+		if (!box.intersects(bounds))
+		{
+			return outside;
+		}
+		
+		return box.contains(bounds) ? inside : intersecting;
+	};
+	
+	const auto object_test = [&](const bounds_array& bounds, std::uint8_t* mask)
+	{
+		const std::size_t count = bounds.min_x.size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			mask[i] = static_cast<std::uint8_t>
+			(
+				(bounds.min_x[i] <= box.max.x()) & (bounds.max_x[i] >= box.min.x()) &
+				(bounds.min_y[i] <= box.max.y()) & (bounds.max_y[i] >= box.min.y()) &
+				(bounds.min_z[i] <= box.max.z()) & (bounds.max_z[i] >= box.min.z())
+			);
+		}
+	};
+	
+	query_nodes(node_test, object_test, objects);
+}
+
+auto spatial_index::fit(const geom::box<float>& bounds) const noexcept -> node_type
+{
+	const math::fvec3 size = bounds.max - bounds.min;
+	const float extent = std::max(std::max(size.x(), size.y()), size.z());
+	const math::fvec3 center = (bounds.min + bounds.max) * 0.5f - m_min;
+	
+	// Objects with invalid bounds, objects larger than the root node, and objects centered outside of the root node overflow
+	if (!(size.x() >= 0.0f && size.y() >= 0.0f && size.z() >= 0.0f && extent <= m_size) ||
+		!(center.x() >= 0.0f && center.y() >= 0.0f && center.z() >= 0.0f) ||
+		!(center.x() <= m_size && center.y() <= m_size && center.z() <= m_size))
+	{
+		return overflow_node;
+	}
+	
+	// Find deepest node at least as large as the object
+	node_type depth = 0;
+	float cell_size = m_size;
+	while (depth < m_max_depth && cell_size * 0.5f >= extent)
+	{
+		cell_size *= 0.5f;
+		++depth;
+	}
+	
+	// Find cell containing the object's center
+	const node_type max_cell = (node_type{1} << depth) - 1;
+	const auto cell = [&](float x)
+	{
+		return std::min(static_cast<node_type>(x / cell_size), max_cell);
+	};
+	
+	return octree_type::node(depth, geom::morton_encode(cell(center.x()), cell(center.y()), cell(center.z())));
+}
+
+geom::box<float> spatial_index::loose_bounds(node_type node) const noexcept
+{
+	const auto [depth, location] = octree_type::split(node);
+	
+	node_type x;
+	node_type y;
+	node_type z;
+	geom::morton_decode(location, x, y, z);
+	
+	const float cell_size = m_size / static_cast<float>(node_type{1} << depth);
+	const math::fvec3 min = m_min + math::fvec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)} * cell_size - cell_size * 0.5f;
+	
+	return {min, min + cell_size * 2.0f};
+}
+
+void spatial_index::link(object_base& object, const geom::box<float>& bounds, node_type node)
+{
+	auto& container = (node == overflow_node) ? m_overflow : m_nodes[node];
+	m_locations[&object] = {node, container.objects.size()};
+	container.objects.emplace_back(&object);
+	container.bounds.push_back(bounds);
+	
+	if (node == overflow_node)
+	{
+		return;
+	}
+	
+	// Update subtree sizes and child masks of the node and its ancestors
+	for (std::uint8_t child_mask = 0;;)
+	{
+		auto& ancestor = m_nodes[node];
+		++ancestor.subtree_size;
+		ancestor.children |= child_mask;
+		if (node == octree_type::root)
+		{
+			break;
+		}
+		child_mask = child_bit(node);
+		node = octree_type::parent(node);
+	}
+}
+
+void spatial_index::unlink(const location& location)
+{
+	node_type node = location.node;
+	auto& container = (node == overflow_node) ? m_overflow : m_nodes[node];
+	
+	// Swap last object of the node into the vacated index
+	if (location.index + 1 != container.objects.size())
+	{
+		object_base* moved_object = container.objects.back();
+		container.objects[location.index] = moved_object;
+		m_locations[moved_object].index = location.index;
+	}
+	container.objects.pop_back();
+	container.bounds.swap_and_pop(location.index);
+	
+	if (node == overflow_node)
+	{
+		return;
+	}
+	
+	// Update subtree sizes and child masks of the node and its ancestors, destroying empty nodes
+	for (std::uint8_t child_mask = 0;;)
+	{
+		auto i = m_nodes.find(node);
+		i->second.children &= static_cast<std::uint8_t>(~child_mask);
+		if (!--i->second.subtree_size)
+		{
+			m_nodes.erase(i);
+			child_mask = child_bit(node);
+		}
+		else
+		{
+			child_mask = 0;
+		}
+		
+		if (node == octree_type::root)
+		{
+			break;
+		}
+		node = octree_type::parent(node);
+	}
+}
+
+void spatial_index::gather(const node& container, node_type node, std::vector<object_base*>& objects) const
+{
+	objects.insert(objects.end(), container.objects.begin(), container.objects.end());
+	
+	for (unsigned int mask = container.children; mask;)
+	{
+		const unsigned int i = static_cast<unsigned int>(std::countr_zero(mask));
+		mask &= mask - 1;
+		
+		const node_type child = octree_type::child(node, i);
+		gather(m_nodes.find(child)->second, child, objects);
+	}
+}
+
+} // namespace scene
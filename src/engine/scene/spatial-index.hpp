@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_SCENE_SPATIAL_INDEX_HPP
+#define ANTKEEPER_SCENE_SPATIAL_INDEX_HPP
+
+#include <engine/geom/octree.hpp>
+#include <engine/geom/primitives/box.hpp>
+#include <engine/geom/primitives/plane.hpp>
+#include <engine/geom/primitives/sphere.hpp>
+#include <engine/math/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace scene {
+
+class object_base;
+
+/**
+ * Loose octree of scene objects, for finding objects which intersect a region of space.
+ *
+ * Each object is stored in the deepest node which is at least as large as the object and contains the object's center. The loose bounds of a node are twice the size of the node, so they always enclose the objects stored in it. Objects with invalid bounds, or which lie outside of the loose bounds of the root node, are stored in an overflow list which is tested by every query.
+ *
+ * Queries are not thread-safe.
+ */
+class spatial_index
+{
+public:
+	/// Octree which defines the node identifiers of the index.
+	using octree_type = geom::unordered_octree64;
+	
+	/// Octree node identifier type.
+	using node_type = octree_type::node_type;
+	
+	/**
+	 * Constructs a spatial index.
+	 *
+	 * @param center Center of the root node.
+	 * @param size Edge length of the root node.
+	 * @param max_depth Maximum depth of a node. Deeper nodes fit small objects more tightly, but sparse scenes then spend more time traversing nodes than testing objects.
+	 *
+	 * @except std::invalid_argument Maximum depth exceeds the maximum depth of the octree.
+	 */
+	explicit spatial_index(const math::fvec3& center = {0.0f, 0.0f, 0.0f}, float size = 4096.0f, node_type max_depth = 6);
+	
+	/**
+	 * Inserts an object into the index.
+	 *
+	 * @param object Object to insert.
+	 */
+	void insert(object_base& object);
+	
+	/**
+	 * Removes an object from the index.
+	 *
+	 * @param object Object to remove.
+	 */
+	void erase(const object_base& object);
+	
+	/**
+	 * Moves an object to the node which fits its current bounds.
+	 *
+	 * @param object Object to update.
+	 */
+	void update(object_base& object);
+	
+	/// Removes all objects from the index.
+	void clear();
+	
+	/**
+	 * Finds all objects which intersect a convex region.
+	 *
+	 * @param[in] planes Planes which bound the region. Objects entirely behind any plane are excluded.
+	 * @param[out] objects Objects which intersect the region are appended to this vector.
+	 */
+	void query(std::span<const geom::plane<float>> planes, std::vector<object_base*>& objects) const;
+	
+	/**
+	 * Finds all objects which intersect a sphere.
+	 *
+	 * @param[in] sphere Sphere to test.
+	 * @param[out] objects Objects which intersect the sphere are appended to this vector.
+	 */
+	void query(const geom::sphere<float>& sphere, std::vector<object_base*>& objects) const;
+	
+	/**
+	 * Finds all objects which intersect a box.
+	 *
+	 * @param[in] box Box to test.
+	 * @param[out] objects Objects which intersect the box are appended to this vector.
+	 */
+	void query(const geom::box<float>& box, std::vector<object_base*>& objects) const;
+	
+	/// Returns the number of objects in the index.
+	[[nodiscard]] inline std::size_t size() const noexcept
+	{
+		return m_locations.size();
+	}
+
+private:
+	/// Object bounds, in structure-of-arrays form.
+	struct bounds_array
+	{
+		std::vector<float> min_x, min_y, min_z;
+		std::vector<float> max_x, max_y, max_z;
+		
+		void push_back(const geom::box<float>& bounds);
+		void set(std::size_t index, const geom::box<float>& bounds) noexcept;
+		void swap_and_pop(std::size_t index) noexcept;
+	};
+	
+	/// Objects stored in a node.
+	struct node
+	{
+		/// Objects stored in this node.
+		std::vector<object_base*> objects;
+		
+		/// Bounds of the objects stored in this node.
+		bounds_array bounds;
+		
+		/// Number of objects stored in this node and its descendants.
+		std::size_t subtree_size{0};
+		
+		/// Bit mask of non-empty child nodes.
+		std::uint8_t children{0};
+	};
+	
+	/// Node of an object and its index within that node.
+	struct location
+	{
+		node_type node;
+		std::size_t index;
+	};
+	
+	/// Identifier of the overflow list.
+	static constexpr node_type overflow_node = ~node_type{0};
+	
+	/// Returns the node which fits an object with the given bounds, or `overflow_node` if no node fits.
+	[[nodiscard]] node_type fit(const geom::box<float>& bounds) const noexcept;
+	
+	/// Returns the loose bounds of a node.
+	[[nodiscard]] geom::box<float> loose_bounds(node_type node) const noexcept;
+	
+	/// Adds an object to a node, creating the node and its ancestors as necessary.
+	void link(object_base& object, const geom::box<float>& bounds, node_type node);
+	
+	/// Removes an object from its node, destroying empty nodes.
+	void unlink(const location& location);
+	
+	/**
+	 * Visits the nodes whose loose bounds intersect a region, appending the objects which pass an object test.
+	 *
+	 * @param node_test Function which classifies loose node bounds as outside (`0`), intersecting (`1`), or inside (`2`) the region.
+	 * @param object_test Function which writes `1` for each object inside the region, and `0` otherwise, given a bounds array and an output mask.
+	 */
+	template <class NodeTest, class ObjectTest>
+	void query_nodes(const NodeTest& node_test, const ObjectTest& object_test, std::vector<object_base*>& objects) const;
+	
+	/// Appends the objects of a node and its descendants.
+	void gather(const node& container, node_type node, std::vector<object_base*>& objects) const;
+	
+	/// Returns the bit of a node in the child mask of its parent.
+	[[nodiscard]] static inline constexpr std::uint8_t child_bit(node_type node) noexcept
+	{
+		return static_cast<std::uint8_t>(1u << (octree_type::location(node) & octree_type::siblings_per_node));
+	}
+	
+	math::fvec3 m_min;
+	float m_size;
+	node_type m_max_depth;
+	std::unordered_map<node_type, node> m_nodes;
+	node m_overflow;
+	std::unordered_map<const object_base*, location> m_locations;
+	
+	/// Object test scratch buffer.
+	mutable std::vector<std::uint8_t> m_mask;
+	
+	/// Node traversal stack.
+	mutable std::vector<node_type> m_stack;
+};
+
+} // namespace scene
+
+#endif // ANTKEEPER_SCENE_SPATIAL_INDEX_HPP
@@ -5,7 +5,9 @@
 #include <engine/render/model.hpp>
 #include <engine/render/material.hpp>
 #include <engine/scene/camera.hpp>
+#include <engine/render/sort-key.hpp>
 #include <engine/debug/log.hpp>
+#include <algorithm>
 
 namespace scene {
 
@@ -35,6 +37,7 @@ void static_mesh::set_model(std::shared_ptr<render::model> model)
 			operation.vertex_count = group.vertex_count;
 			operation.first_instance = 0;
 			operation.instance_count = 1;
+			operation.material_overrides = m_material_overrides;
 
 			if (group.material_index < m_model->materials().size())
 			{
@@ -52,7 +55,7 @@ void static_mesh::set_model(std::shared_ptr<render::model> model)
 		m_operations.clear();
 	}
 	
-	transformed();
+	notify_transformed();
 }
 
 void static_mesh::set_material(std::size_t index, std::shared_ptr<render::material> material)
@@ -76,6 +79,8 @@ void static_mesh::set_material(std::size_t index, std::shared_ptr<render::materi
 			operation.material = nullptr;
 		}
 	}
+
+	notify_changed();
 }
 
 void static_mesh::reset_materials()
@@ -93,6 +98,47 @@ void static_mesh::reset_materials()
 			m_operations[i].material = nullptr;
 		}
 	}
+
+	notify_changed();
+}
+
+void static_mesh::set_material_override(hash::fnv1a32_t key, std::shared_ptr<render::material_variable_base> variable)
+{
+	auto i = std::find_if(m_material_overrides.begin(), m_material_overrides.end(), [key](const auto& material_override){return material_override.key == key;});
+	if (variable)
+	{
+		if (i != m_material_overrides.end())
+		{
+			i->variable = std::move(variable);
+		}
+		else
+		{
+			m_material_overrides.emplace_back(render::material_override{key, std::move(variable)});
+		}
+	}
+	else if (i != m_material_overrides.end())
+	{
+		m_material_overrides.erase(i);
+	}
+
+	for (auto& operation: m_operations)
+	{
+		operation.material_overrides = m_material_overrides;
+	}
+
+	notify_changed();
+}
+
+void static_mesh::reset_material_overrides()
+{
+	m_material_overrides.clear();
+
+	for (auto& operation: m_operations)
+	{
+		operation.material_overrides = {};
+	}
+
+	notify_changed();
 }
 
 void static_mesh::update_bounds()
@@ -133,6 +179,7 @@ void static_mesh::render(render::context& ctx) const
 	{
 		operation.depth = depth;
 		operation.layer_mask = get_layer_mask();
+		operation.sort_key = render::make_material_sort_key(operation);
 		ctx.operations.push_back(&operation);
 	}
 }
@@ -7,6 +7,8 @@
 #include <engine/scene/object.hpp>
 #include <engine/render/model.hpp>
 #include <engine/render/operation.hpp>
+#include <engine/render/material-override.hpp>
+#include <engine/hash/fnv1a.hpp>
 #include <vector>
 
 namespace scene {
@@ -52,6 +54,19 @@ public:
 	 */
 	void reset_materials();
 	
+	/**
+	 * Overrides the value of a material variable for all model groups of this model instance, without copying their materials.
+	 *
+	 * @param key Key of the material variable to override.
+	 * @param variable Variable whose value overrides the material variable. A value of `nullptr` removes the override.
+	 */
+	void set_material_override(hash::fnv1a32_t key, std::shared_ptr<render::material_variable_base> variable);
+	
+	/**
+	 * Removes all material variable overrides.
+	 */
+	void reset_material_overrides();
+	
 	[[nodiscard]] inline const aabb_type& get_bounds() const noexcept override
 	{
 		return m_bounds;
@@ -65,14 +80,26 @@ public:
 		return m_model;
 	}
 	
+	/// Returns the material variable overrides of the model instance.
+	[[nodiscard]] inline const std::vector<render::material_override>& get_material_overrides() const noexcept
+	{
+		return m_material_overrides;
+	}
+	
 	void render(render::context& ctx) const override;
 	
+	[[nodiscard]] inline bool has_static_operations() const noexcept override
+	{
+		return true;
+	}
+
 private:
 	void update_bounds();
 	void transformed() override;
 	
 	std::shared_ptr<render::model> m_model;
 	mutable std::vector<render::operation> m_operations;
+	std::vector<render::material_override> m_material_overrides;
 	aabb_type m_bounds{{0, 0, 0}, {0, 0, 0}};
 };
 
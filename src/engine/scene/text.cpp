@@ -5,8 +5,17 @@
 #include <engine/render/vertex-attribute-location.hpp>
 #include <engine/type/unicode/convert.hpp>
 #include <engine/scene/camera.hpp>
+#include <engine/render/sort-key.hpp>
+#include <engine/render/context.hpp>
+#include <engine/gl/vertex-buffer.hpp>
 #include <engine/debug/log.hpp>
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <span>
 
 namespace scene {
 
@@ -40,20 +49,146 @@ namespace {
 	
 	// Text vertex byte stride.
 	static const std::size_t text_vertex_stride = floats_per_text_vertex * sizeof(float);
+	
+	// Vertices per glyph quad.
+	static const std::size_t vertices_per_glyph = 6;
+	
+	// Floating-point elements per glyph quad.
+	static const std::size_t floats_per_glyph = vertices_per_glyph * floats_per_text_vertex;
+	
+	// Glyph quad byte size.
+	static const std::size_t glyph_vertex_data_size = vertices_per_glyph * text_vertex_stride;
+	
+	// Initial capacity of the text vertex pool, in glyphs.
+	static const std::size_t initial_text_vertex_pool_capacity = 4096;
+	
+	// Minimum number of glyphs sub-allocated for a text object.
+	static const std::size_t min_text_glyph_capacity = 16;
+	
+	// Batch revision counter shared by all text objects, such that no two text objects share a batch revision. Not synchronized, as text objects, like the shared text vertex pool they sub-allocate from and its vertex buffer, must be modified on the rendering thread.
+	std::uint32_t text_batch_revision = 0;
 }
 
-text::text()
+/**
+ * Vertex buffer shared by all text objects, sub-allocated in whole glyph quads.
+ *
+ * Text objects sharing the pool also share its vertex array and vertex buffer, such that their render operations differ only by vertex range and material.
+ */
+class text_vertex_pool
 {
-	// Construct vertex array
-	m_vertex_array = std::make_unique<gl::vertex_array>(text_vertex_attributes);
+public:
+	text_vertex_pool():
+		vertex_array(text_vertex_attributes),
+		vertex_buffer(gl::buffer_usage::dynamic_draw, initial_text_vertex_pool_capacity * glyph_vertex_data_size),
+		m_capacity(initial_text_vertex_pool_capacity)
+	{
+		m_free_ranges.emplace(0, m_capacity);
+	}
+	
+	/**
+	 * Sub-allocates a range of glyphs, enlarging the pool if no free range is large enough.
+	 *
+	 * @param glyph_count Number of glyphs to allocate.
+	 *
+	 * @return Index of the first allocated glyph.
+	 */
+	[[nodiscard]] std::size_t allocate(std::size_t glyph_count)
+	{
+		// First fit
+		for (auto i = m_free_ranges.begin(); i != m_free_ranges.end(); ++i)
+		{
+			if (i->second >= glyph_count)
+			{
+				const auto [first_glyph, free_count] = *i;
+				m_free_ranges.erase(i);
+				if (free_count > glyph_count)
+				{
+					m_free_ranges.emplace(first_glyph + glyph_count, free_count - glyph_count);
+				}
+				
+				return first_glyph;
+			}
+		}
+		
+		grow(glyph_count);
+		return allocate(glyph_count);
+	}
 	
-	// Construct empty vertex buffer
-	m_vertex_buffer = std::make_unique<gl::vertex_buffer>(gl::buffer_usage::static_draw);
+	/**
+	 * Frees a previously sub-allocated range of glyphs.
+	 *
+	 * @param first_glyph Index of the first glyph in the range.
+	 * @param glyph_count Number of glyphs in the range.
+	 */
+	void deallocate(std::size_t first_glyph, std::size_t glyph_count)
+	{
+		auto range = m_free_ranges.emplace(first_glyph, glyph_count).first;
+		
+		// Coalesce with the following free range
+		if (auto next = std::next(range); next != m_free_ranges.end() && range->first + range->second == next->first)
+		{
+			range->second += next->second;
+			m_free_ranges.erase(next);
+		}
+		
+		// Coalesce with the preceding free range
+		if (range != m_free_ranges.begin())
+		{
+			if (auto previous = std::prev(range); previous->first + previous->second == range->first)
+			{
+				previous->second += range->second;
+				m_free_ranges.erase(range);
+			}
+		}
+	}
+	
+	gl::vertex_array vertex_array;
+	gl::vertex_buffer vertex_buffer;
+
+private:
+	/**
+	 * Enlarges the pool, preserving the glyphs of all sub-allocations.
+	 *
+	 * @param glyph_count Minimum number of glyphs by which to enlarge the pool.
+	 */
+	void grow(std::size_t glyph_count)
+	{
+		const auto old_capacity = m_capacity;
+		m_capacity = std::max(m_capacity * 2, m_capacity + glyph_count);
+		
+		const gl::vertex_buffer old_vertex_buffer(vertex_buffer);
+		vertex_buffer.resize(m_capacity * glyph_vertex_data_size);
+		vertex_buffer.copy(old_vertex_buffer, old_vertex_buffer.size());
+		
+		deallocate(old_capacity, m_capacity - old_capacity);
+	}
+	
+	/// Free glyph ranges, mapping the index of the first glyph of each range to the number of glyphs in the range.
+	std::map<std::size_t, std::size_t> m_free_ranges;
+	
+	/// Capacity of the pool, in glyphs.
+	std::size_t m_capacity;
+};
+
+namespace {
+	
+	std::weak_ptr<text_vertex_pool> shared_text_vertex_pool;
+}
+
+text::text()
+{
+	// Share vertex pool with other text objects
+	m_vertex_pool = shared_text_vertex_pool.lock();
+	if (!m_vertex_pool)
+	{
+		m_vertex_pool = std::make_shared<text_vertex_pool>();
+		shared_text_vertex_pool = m_vertex_pool;
+	}
 	
 	// Init render operation
 	m_render_op.primitive_topology = gl::primitive_topology::triangle_list;
-	m_render_op.vertex_array = m_vertex_array.get();
-	m_render_op.vertex_buffer = m_vertex_buffer.get();
+	m_render_op.vertex_array = &m_vertex_pool->vertex_array;
+	m_render_op.vertex_buffer = &m_vertex_pool->vertex_buffer;
 	m_render_op.vertex_offset = 0;
 	m_render_op.vertex_stride = text_vertex_stride;
 	m_render_op.first_vertex = 0;
@@ -62,12 +197,33 @@ text::text()
 	m_render_op.instance_count = 1;
 }
 
+text::~text()
+{
+	if (m_glyph_capacity)
+	{
+		m_vertex_pool->deallocate(m_first_pool_glyph, m_glyph_capacity);
+	}
+}
+
 void text::render(render::context& ctx) const
 {
 	if (m_render_op.vertex_count)
 	{
+		// Upload changed glyphs into the vertex pool
+		if (m_dirty_glyph_begin != m_dirty_glyph_end)
+		{
+			const auto dirty_data = std::as_bytes(std::span{m_vertex_data}).subspan(m_dirty_glyph_begin * glyph_vertex_data_size, (m_dirty_glyph_end - m_dirty_glyph_begin) * glyph_vertex_data_size);
+			m_vertex_pool->vertex_buffer.write((m_first_pool_glyph + m_dirty_glyph_begin) * glyph_vertex_data_size, dirty_data);
+			m_dirty_glyph_begin = 0;
+			m_dirty_glyph_end = 0;
+		}
+		
+		// Expose vertex data for batching
+		m_render_op.batch_vertex_data = std::as_bytes(std::span{m_vertex_data}).first(m_render_op.vertex_count * text_vertex_stride);
+		
 		m_render_op.depth = ctx.camera->get_view_frustum().near().distance(get_translation());
 		m_render_op.layer_mask = get_layer_mask();
+		m_render_op.sort_key = render::make_material_sort_key(m_render_op);
 		ctx.operations.push_back(&m_render_op);
 	}
 }
@@ -119,18 +275,36 @@ void text::set_direction(type::text_direction direction)
 
 void text::set_content(std::string_view content)
 {
-	if (m_content_u8 != content)
+	if (m_content_u8 == content)
 	{
-		m_content_u8 = content;
-		m_content_u32 = type::unicode::u32(m_content_u8);
-		update_content();
+		return;
+	}
+	
+	auto content_u32 = type::unicode::u32(content);
+	
+	// Find the first changed glyph
+	const auto first_glyph = static_cast<std::size_t>(std::mismatch(m_content_u32.begin(), m_content_u32.end(), content_u32.begin(), content_u32.end()).first - m_content_u32.begin());
+	
+	// If the length is unchanged, find the unchanged suffix, the glyphs of which only need to be regenerated if their pen position moves
+	std::size_t unchanged_suffix = std::numeric_limits<std::size_t>::max();
+	if (content_u32.length() == m_content_u32.length())
+	{
+		const auto suffix_length = static_cast<std::size_t>(std::mismatch(m_content_u32.rbegin(), m_content_u32.rend() - first_glyph, content_u32.rbegin()).first - m_content_u32.rbegin());
+		unchanged_suffix = content_u32.length() - suffix_length;
 	}
+	
+	m_content_u8 = content;
+	m_content_u32 = std::move(content_u32);
+	update_content(first_glyph, unchanged_suffix);
 }
 
 void text::set_color(const math::fvec4& color)
 {
-	m_color = color;
-	update_colors();
+	if (m_color != color)
+	{
+		m_color = color;
+		update_colors();
+	}
 }
 
 void text::transformed()
@@ -147,7 +321,7 @@ void text::transformed()
 
 void text::update_uvs()
 {
-	if (!m_font || m_content_u32.empty() || m_vertex_data.size() < m_content_u32.length() * 6 * 8)
+	if (!m_font || !m_render_op.vertex_count || m_content_u32.length() > m_glyph_capacity)
 	{
 		return;
 	}
@@ -188,57 +362,55 @@ void text::update_uvs()
 		else
 		{
 			// Glyph not yet cached, skip it
-			v += 8 * 6;
+			v += floats_per_glyph;
 		}
 	}
 	
-	update_vertex_buffer();
+	mark_dirty(0, m_content_u32.length());
 }
 
 void text::update_colors()
 {
-	if (m_content_u32.empty() || m_vertex_data.size() < m_content_u32.length() * 6 * 8)
+	if (!m_render_op.vertex_count || m_content_u32.length() > m_glyph_capacity)
 	{
 		return;
 	}
 	
+	// Rewrite the color attribute of each vertex, leaving positions and UVs untouched
 	float* v = m_vertex_data.data() + 4;
-	for ([[maybe_unused]] auto code: m_content_u32)
+	for (std::size_t i = 0; i < m_content_u32.length() * vertices_per_glyph; ++i)
 	{
-		for (int i = 0; i < 6; ++i)
-		{
-			*(v++) = m_color[0];
-			*(v++) = m_color[1];
-			*(v++) = m_color[2];
-			*(v++) = m_color[3];
-			v += 4;
-		}
+		std::memcpy(v, m_color.data(), 4 * sizeof(float));
+		v += floats_per_text_vertex;
 	}
 	
-	update_vertex_buffer();
+	mark_dirty(0, m_content_u32.length());
 }
 
-void text::update_content()
+void text::update_content(std::size_t first_glyph, std::size_t unchanged_suffix)
 {
 	// If no valid font or no text, clear vertex count
 	if (!m_font || m_content_u32.empty())
 	{
 		m_render_op.vertex_count = 0;
 		m_local_bounds = {{0, 0, 0}, {0, 0, 0}};
-		transformed();
+		notify_transformed();
 		return;
 	}
 	
 	// Cache glyphs
 	m_font->cache_glyphs(m_content_u32);
 	
-	// Determine minimum size of vertex buffer, in bytes
-	std::size_t min_vertex_buffer_size = m_content_u32.length() * 6 * text_vertex_stride;
+	const std::size_t glyph_count = m_content_u32.length();
 	
-	// Reserve vertex data
-	if (m_vertex_data.size() < min_vertex_buffer_size / sizeof(float))
+	// Only glyphs generated by the previous update can be reused
+	const std::size_t generated_glyph_count = m_render_op.vertex_count / vertices_per_glyph;
+	first_glyph = std::min(first_glyph, generated_glyph_count);
+	
+	// Reserve glyphs in the vertex pool, uploading the reused glyphs if the text was moved
+	if (reserve_glyphs(glyph_count))
 	{
-		m_vertex_data.resize(min_vertex_buffer_size / sizeof(float));
+		mark_dirty(0, first_glyph);
 	}
 	
 	// Get font metrics and texture
@@ -252,18 +424,17 @@ void text::update_content()
 		1.0f / static_cast<float>(texture_dimensions[1])
 	};
 	
-	// Init pen position
-	math::fvec2 pen_position = {0.0f, 0.0f};
-	
-	// Reset local-space bounds
-	m_local_bounds.min = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), 0.0f};
-	m_local_bounds.max = {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0.0f};
+	// Resume pen position from the last unchanged glyph
+	math::fvec2 pen_position = first_glyph ? m_pen_positions[first_glyph - 1] : math::fvec2{0.0f, 0.0f};
+	char32_t previous_code = first_glyph ? m_content_u32[first_glyph - 1] : 0;
 	
-	// Generate vertex data
-	char32_t previous_code = 0;
-	float* v = m_vertex_data.data();
-	for (char32_t code: m_content_u32)
+	// Generate vertex data of changed glyphs
+	std::size_t last_glyph = glyph_count;
+	float* v = m_vertex_data.data() + first_glyph * floats_per_glyph;
+	for (std::size_t i = first_glyph; i < glyph_count; ++i)
 	{
+		const char32_t code = m_content_u32[i];
+		
 		// Get glyph from character code
 		const auto& glyph = *m_font->get_cached_glyph(code);
 		
@@ -291,23 +462,23 @@ void text::update_content()
 		uvs[4] = uvs[0];
 		uvs[5] = uvs[2];
 		
-		for (int i = 0; i < 6; ++i)
+		for (int j = 0; j < 6; ++j)
 		{
 			// Round positions
-			positions[i].x() = std::round(positions[i].x());
-			positions[i].y() = std::round(positions[i].y());
+			positions[j].x() = std::round(positions[j].x());
+			positions[j].y() = std::round(positions[j].y());
 			
 			// Normalize UVs
-			uvs[i] *= uv_scale;
+			uvs[j] *= uv_scale;
 		}
 		
 		// Add vertex to vertex data buffer
-		for (int i = 0; i < 6; ++i)
+		for (int j = 0; j < 6; ++j)
 		{
-			*(v++) = positions[i].x();
-			*(v++) = positions[i].y();
-			*(v++) = uvs[i].x();
-			*(v++) = uvs[i].y();
+			*(v++) = positions[j].x();
+			*(v++) = positions[j].y();
+			*(v++) = uvs[j].x();
+			*(v++) = uvs[j].y();
 			*(v++) = m_color[0];
 			*(v++) = m_color[1];
 			*(v++) = m_color[2];
@@ -317,17 +488,6 @@ void text::update_content()
 		// Advance pen position
 		pen_position.x() += glyph.horizontal_advance;
 		
-		// Update local-space bounds
-		for (int i = 0; i < 4; ++i)
-		{
-			const math::fvec2& position = positions[i];
-			for (int j = 0; j < 2; ++j)
-			{
-				m_local_bounds.min[j] = std::min<float>(m_local_bounds.min[j], position[j]);
-				m_local_bounds.max[j] = std::max<float>(m_local_bounds.max[j], position[j]);
-			}
-		}
-		
 		// Handle newlines
 		if (code == U'\n')
 		{
@@ -335,30 +495,90 @@ void text::update_content()
 			pen_position.y() -= font_metrics.linespace;
 		}
 		
+		// Stop once the pen position within the unchanged suffix has returned to its previous position, as the remaining glyphs are then unchanged
+		if (i >= unchanged_suffix && i < generated_glyph_count && m_pen_positions[i] == pen_position)
+		{
+			last_glyph = i + 1;
+			break;
+		}
+		
+		m_pen_positions[i] = pen_position;
+		
 		// Update previous UTF-32 character code
 		previous_code = code;
 	}
 	
-	// Upload vertex data to VBO, growing VBO size if necessary
-	if (m_vertex_buffer->size() < min_vertex_buffer_size)
+	mark_dirty(first_glyph, last_glyph);
+	
+	// Update render op
+	m_render_op.vertex_count = static_cast<std::uint32_t>(glyph_count * vertices_per_glyph);
+	
+	// Update local-space bounds
+	update_bounds();
+	
+	// Update world-space bounds
+	notify_transformed();
+}
+
+void text::update_bounds()
+{
+	m_local_bounds.min = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), 0.0f};
+	m_local_bounds.max = {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0.0f};
+	
+	// Extend bounds by the lower-left (second vertex) and upper-right (fourth vertex) corners of each glyph quad
+	const float* v = m_vertex_data.data();
+	for (std::size_t i = 0; i < m_content_u32.length(); ++i, v += floats_per_glyph)
 	{
-		m_vertex_buffer->resize(min_vertex_buffer_size, {reinterpret_cast<const std::byte*>(m_vertex_data.data()), m_content_u32.size() * 6 * text_vertex_stride});
+		for (int j = 0; j < 2; ++j)
+		{
+			m_local_bounds.min[j] = std::min<float>(m_local_bounds.min[j], v[floats_per_text_vertex + j]);
+			m_local_bounds.max[j] = std::max<float>(m_local_bounds.max[j], v[floats_per_text_vertex * 3 + j]);
+		}
 	}
-	else
+}
+
+bool text::reserve_glyphs(std::size_t glyph_count)
+{
+	if (glyph_count <= m_glyph_capacity)
 	{
-		update_vertex_buffer();
+		return false;
 	}
 	
-	// Update render op
-	m_render_op.vertex_count = static_cast<std::uint32_t>(m_content_u32.length() * 6);
+	// Move the text to a larger sub-allocation
+	if (m_glyph_capacity)
+	{
+		m_vertex_pool->deallocate(m_first_pool_glyph, m_glyph_capacity);
+	}
+	m_glyph_capacity = std::max(min_text_glyph_capacity, std::bit_ceil(glyph_count));
+	m_first_pool_glyph = m_vertex_pool->allocate(m_glyph_capacity);
 	
-	// Update world-space bounds
-	transformed();
+	m_vertex_data.resize(m_glyph_capacity * floats_per_glyph);
+	m_pen_positions.resize(m_glyph_capacity);
+	
+	m_render_op.first_vertex = static_cast<std::uint32_t>(m_first_pool_glyph * vertices_per_glyph);
+	
+	return true;
 }
 
-void text::update_vertex_buffer()
+void text::mark_dirty(std::size_t first_glyph, std::size_t last_glyph) noexcept
 {
-	m_vertex_buffer->write({reinterpret_cast<const std::byte*>(m_vertex_data.data()), m_content_u32.size() * 6 * text_vertex_stride});
+	if (first_glyph >= last_glyph)
+	{
+		return;
+	}
+	
+	m_render_op.batch_revision = ++text_batch_revision;
+	
+	if (m_dirty_glyph_begin == m_dirty_glyph_end)
+	{
+		m_dirty_glyph_begin = first_glyph;
+		m_dirty_glyph_end = last_glyph;
+	}
+	else
+	{
+		m_dirty_glyph_begin = std::min(m_dirty_glyph_begin, first_glyph);
+		m_dirty_glyph_end = std::max(m_dirty_glyph_end, last_glyph);
+	}
 }
 
 } // namespace scene
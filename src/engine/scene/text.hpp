@@ -7,16 +7,19 @@
 #include <engine/scene/object.hpp>
 #include <engine/math/vector.hpp>
 #include <engine/gl/vertex-array.hpp>
-#include <engine/gl/vertex-buffer.hpp>
 #include <engine/render/material.hpp>
 #include <engine/type/font.hpp>
 #include <engine/type/text-direction.hpp>
 #include <engine/event/subscription.hpp>
+#include <limits>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 namespace scene {
 
+class text_vertex_pool;
+
 /**
  * Text scene object.
  */
@@ -27,7 +30,7 @@ public:
 	text();
 	
 	/** Destructs a text object. */
-	~text() override = default;
+	~text() override;
 	
 	void render(render::context& ctx) const override;
 	
@@ -60,6 +63,8 @@ public:
 	/**
 	 * Sets the text content.
 	 *
+	 * Only the glyphs which differ from the current content are regenerated and uploaded.
+	 *
 	 * @param content UTF-8 string of text.
 	 */
 	void set_content(std::string_view content);
@@ -67,6 +72,8 @@ public:
 	/**
 	 * Sets the text color and opacity.
 	 *
+	 * Only the color attributes of the glyphs are rewritten; glyph positions and UVs are left untouched.
+	 *
 	 * @param color Text color and opacity.
 	 */
 	void set_color(const math::fvec4& color);
@@ -113,10 +120,33 @@ private:
 	/** Updates the colors of each character. */
 	void update_colors();
 	
-	void update_content();
+	/**
+	 * Regenerates the glyph quads of the text content.
+	 *
+	 * @param first_glyph Index of the first glyph to regenerate. Glyphs before this index must be unchanged.
+	 * @param unchanged_suffix Index of the first glyph of a suffix which is unchanged and at the same index as in the previous content. Regeneration stops once the pen position within this suffix matches its previous position.
+	 */
+	void update_content(std::size_t first_glyph = 0, std::size_t unchanged_suffix = std::numeric_limits<std::size_t>::max());
 	
-	/** Uploads character veretex data to the vertex buffer. */
-	void update_vertex_buffer();
+	/** Updates the local-space bounds of the text from its glyph quads. */
+	void update_bounds();
+	
+	/**
+	 * Ensures the text has a sub-allocation in the shared text vertex pool large enough for a number of glyphs.
+	 *
+	 * @param glyph_count Number of glyphs.
+	 *
+	 * @return `true` if the text was moved to a new sub-allocation, `false` otherwise.
+	 */
+	bool reserve_glyphs(std::size_t glyph_count);
+	
+	/**
+	 * Marks a range of glyphs to be uploaded into the shared text vertex pool the next time the text is rendered.
+	 *
+	 * @param first_glyph Index of the first glyph in the range.
+	 * @param last_glyph Index one past the last glyph in the range.
+	 */
+	void mark_dirty(std::size_t first_glyph, std::size_t last_glyph) noexcept;
 
 	void transformed() override;
 	
@@ -129,9 +159,25 @@ private:
 	std::string m_content_u8;
 	std::u32string m_content_u32;
 	math::fvec4 m_color{1.0f, 0.0f, 1.0f, 1.0f};
+	
+	/// Vertex pool shared by all text objects, from which the glyph quads of this text are sub-allocated.
+	std::shared_ptr<text_vertex_pool> m_vertex_pool;
+	
+	/// Index of the first glyph of the sub-allocation in the vertex pool.
+	std::size_t m_first_pool_glyph{0};
+	
+	/// Number of glyphs in the sub-allocation.
+	std::size_t m_glyph_capacity{0};
+	
+	/// Character vertex data, mirroring the sub-allocation in the vertex pool.
 	std::vector<float> m_vertex_data;
-	std::unique_ptr<gl::vertex_array> m_vertex_array;
-	std::unique_ptr<gl::vertex_buffer> m_vertex_buffer;
+	
+	/// Pen position following each glyph, from which glyph generation can be resumed.
+	std::vector<math::fvec2> m_pen_positions;
+	
+	/// Range of glyphs which have changed since the text was last uploaded.
+	mutable std::size_t m_dirty_glyph_begin{0};
+	mutable std::size_t m_dirty_glyph_end{0};
 };
 
 } // namespace scene
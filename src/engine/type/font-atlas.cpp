@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <engine/type/font-atlas.hpp>
+#include <engine/geom/skyline-pack.hpp>
+#include <engine/resources/serializer.hpp>
+#include <engine/resources/serialize-error.hpp>
+#include <engine/resources/deserializer.hpp>
+#include <engine/resources/deserialize-error.hpp>
+#include <engine/resources/resource-loader.hpp>
+#include <engine/debug/log.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <tuple>
+
+namespace {
+
+/// Font atlas file signature, `"AKFA"`.
+constexpr std::uint32_t font_atlas_magic = 0x41464b41;
+
+/// Font atlas file format version.
+constexpr std::uint32_t font_atlas_version = 1;
+
+/// Number of 32-bit words in a font atlas file header.
+constexpr std::size_t font_atlas_header_word_count = 17;
+
+/// Number of 32-bit words in a font atlas glyph record.
+constexpr std::size_t font_atlas_glyph_word_count = 15;
+
+/// Number of 32-bit words in a font atlas kerning record.
+constexpr std::size_t font_atlas_kerning_word_count = 4;
+
+/// Font atlas header flag indicating signed distance field glyphs.
+constexpr std::uint32_t font_atlas_sdf_flag = 1;
+
+/// Minimum width and height of a font atlas image, in pixels.
+constexpr std::uint32_t font_atlas_min_dimension = 256;
+
+/// Returns `true` if two kerning pairs are ordered by their character codes.
+[[nodiscard]] inline bool kerning_pair_less(const type::font_atlas_kerning_pair& lhs, const type::font_atlas_kerning_pair& rhs) noexcept
+{
+	return std::tie(lhs.first, lhs.second) < std::tie(rhs.first, rhs.second);
+}
+
+} // namespace
+
+namespace type {
+
+const glyph* font_atlas::find_glyph(char32_t code) const noexcept
+{
+	const auto it = std::lower_bound(glyphs.begin(), glyphs.end(), code, [](const auto& element, char32_t value){return element.first < value;});
+	return it != glyphs.end() && it->first == code ? &it->second : nullptr;
+}
+
+const font_atlas_kerning_pair* font_atlas::find_kerning_pair(char32_t first, char32_t second) const noexcept
+{
+	const font_atlas_kerning_pair key{first, second, {}};
+	if (auto it = std::lower_bound(kerning_pairs.begin(), kerning_pairs.end(), key, kerning_pair_less); it != kerning_pairs.end() && it->first == first && it->second == second)
+	{
+		return &*it;
+	}
+	
+	return nullptr;
+}
+
+font_atlas bake_font_atlas(const typeface& face, float size, bool sdf, std::u32string_view charset)
+{
+	font_atlas atlas;
+	atlas.size = size;
+	atlas.sdf = sdf;
+	atlas.metrics = face.get_font_metrics(size);
+	
+	// Sort and deduplicate character codes, replacing missing glyphs with the missing glyph
+	std::vector<char32_t> codes;
+	codes.reserve(charset.size() + 1);
+	codes.push_back(0);
+	for (auto code: charset)
+	{
+		if (face.has_glyph(code))
+		{
+			codes.push_back(code);
+		}
+	}
+	std::sort(codes.begin(), codes.end());
+	codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+	
+	// Rasterize glyphs
+	auto glyphs = face.get_glyphs(codes, size, sdf);
+	atlas.glyphs.reserve(codes.size());
+	for (std::size_t i = 0; i < codes.size(); ++i)
+	{
+		atlas.glyphs.emplace_back(codes[i], std::move(glyphs[i]));
+	}
+	
+	// Pack glyphs in order, doubling the atlas dimensions until all glyphs fit. Each attempt starts from an empty pack, so fonts can replay the pack at the final dimensions.
+	atlas.dimensions = {font_atlas_min_dimension, font_atlas_min_dimension};
+	for (;;)
+	{
+		geom::skyline_pack<std::uint32_t> pack({atlas.dimensions[0], atlas.dimensions[1]});
+		
+		bool packed = true;
+		for (auto& [code, g]: atlas.glyphs)
+		{
+			if (auto position = pack.insert({g.bitmap_dimensions[0], g.bitmap_dimensions[1]}))
+			{
+				g.bitmap_position[0] = position->x();
+				g.bitmap_position[1] = position->y();
+			}
+			else
+			{
+				packed = false;
+				break;
+			}
+		}
+		
+		if (packed)
+		{
+			break;
+		}
+		
+		if (atlas.dimensions[0] > atlas.dimensions[1])
+		{
+			atlas.dimensions[1] *= 2;
+		}
+		else
+		{
+			atlas.dimensions[0] *= 2;
+		}
+	}
+	
+	// Copy glyph bitmaps into the atlas image, then release them
+	atlas.pixels.resize(static_cast<std::size_t>(atlas.dimensions[0]) * atlas.dimensions[1]);
+	for (auto& [code, g]: atlas.glyphs)
+	{
+		if (g.bitmap_data)
+		{
+			for (std::uint32_t y = 0; y < g.bitmap_dimensions[1]; ++y)
+			{
+				std::memcpy
+				(
+					atlas.pixels.data() + (g.bitmap_position[1] + y) * atlas.dimensions[0] + g.bitmap_position[0],
+					g.bitmap_data.get() + y * g.bitmap_dimensions[0],
+					g.bitmap_dimensions[0]
+				);
+			}
+			
+			g.bitmap_data.reset();
+		}
+	}
+	
+	// Bake non-zero kerning offsets between all pairs of glyphs
+	if (face.has_kerning())
+	{
+		for (auto first: codes)
+		{
+			for (auto second: codes)
+			{
+				const auto offset = face.get_kerning(size, first, second);
+				if (offset[0] != 0.0f || offset[1] != 0.0f)
+				{
+					atlas.kerning_pairs.push_back({first, second, offset});
+				}
+			}
+		}
+	}
+	
+	debug::log_debug("Baked {} glyphs and {} kerning pairs into {}x{} font atlas", atlas.glyphs.size(), atlas.kerning_pairs.size(), atlas.dimensions[0], atlas.dimensions[1]);
+	
+	return atlas;
+}
+
+} // namespace type
+
+/**
+ * Serializes a font atlas.
+ *
+ * The header, glyph records, and kerning records are written as little-endian 32-bit words, followed by the atlas image.
+ *
+ * @param[in] atlas Font atlas to serialize.
+ * @param[in,out] ctx Serialize context.
+ *
+ * @throw serialize_error Write error.
+ * @throw serialize_error Invalid font atlas image size.
+ */
+template <>
+void serializer<type::font_atlas>::serialize(const type::font_atlas& atlas, serialize_context& ctx)
+{
+	if (atlas.pixels.size() != static_cast<std::size_t>(atlas.dimensions[0]) * atlas.dimensions[1])
+	{
+		throw serialize_error("Invalid font atlas image size.");
+	}
+	
+	std::vector<std::uint32_t> words;
+	words.reserve(font_atlas_header_word_count + atlas.glyphs.size() * font_atlas_glyph_word_count + atlas.kerning_pairs.size() * font_atlas_kerning_word_count);
+	
+	// Header
+	words.push_back(font_atlas_magic);
+	words.push_back(font_atlas_version);
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.size));
+	words.push_back(atlas.sdf ? font_atlas_sdf_flag : 0);
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.size));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.ascent));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.descent));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.linegap));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.linespace));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.underline_position));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.underline_thickness));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.max_horizontal_advance));
+	words.push_back(std::bit_cast<std::uint32_t>(atlas.metrics.max_vertical_advance));
+	words.push_back(atlas.dimensions[0]);
+	words.push_back(atlas.dimensions[1]);
+	words.push_back(static_cast<std::uint32_t>(atlas.glyphs.size()));
+	words.push_back(static_cast<std::uint32_t>(atlas.kerning_pairs.size()));
+	
+	// Glyph records
+	for (const auto& [code, g]: atlas.glyphs)
+	{
+		words.push_back(static_cast<std::uint32_t>(code));
+		words.push_back(std::bit_cast<std::uint32_t>(g.dimensions[0]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.dimensions[1]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.horizontal_bearings[0]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.horizontal_bearings[1]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.horizontal_advance));
+		words.push_back(std::bit_cast<std::uint32_t>(g.vertical_bearings[0]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.vertical_bearings[1]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.vertical_advance));
+		words.push_back(g.bitmap_position[0]);
+		words.push_back(g.bitmap_position[1]);
+		words.push_back(g.bitmap_dimensions[0]);
+		words.push_back(g.bitmap_dimensions[1]);
+		words.push_back(std::bit_cast<std::uint32_t>(g.bitmap_bearings[0]));
+		words.push_back(std::bit_cast<std::uint32_t>(g.bitmap_bearings[1]));
+	}
+	
+	// Kerning records
+	for (const auto& pair: atlas.kerning_pairs)
+	{
+		words.push_back(static_cast<std::uint32_t>(pair.first));
+		words.push_back(static_cast<std::uint32_t>(pair.second));
+		words.push_back(std::bit_cast<std::uint32_t>(pair.offset[0]));
+		words.push_back(std::bit_cast<std::uint32_t>(pair.offset[1]));
+	}
+	
+	ctx.write32<std::endian::little>(reinterpret_cast<const std::byte*>(words.data()), words.size());
+	
+	// Atlas image
+	ctx.write8(atlas.pixels.data(), atlas.pixels.size());
+}
+
+/**
+ * Deserializes a font atlas.
+ *
+ * Glyph and kerning records are each read with a single read operation, and the atlas image is read directly into its final storage.
+ *
+ * @param[out] atlas Font atlas to deserialize.
+ * @param[in,out] ctx Deserialize context.
+ *
+ * @throw deserialize_error Read error.
+ * @throw deserialize_error Invalid font atlas file.
+ * @throw deserialize_error Unsupported font atlas version.
+ */
+template <>
+void deserializer<type::font_atlas>::deserialize(type::font_atlas& atlas, deserialize_context& ctx)
+{
+	// Read header
+	std::array<std::uint32_t, font_atlas_header_word_count> header;
+	if (ctx.size() < header.size() * sizeof(std::uint32_t))
+	{
+		throw deserialize_error("Invalid font atlas file.");
+	}
+	ctx.read32<std::endian::little>(reinterpret_cast<std::byte*>(header.data()), header.size());
+	
+	if (header[0] != font_atlas_magic)
+	{
+		throw deserialize_error("Invalid font atlas file.");
+	}
+	if (header[1] != font_atlas_version)
+	{
+		throw deserialize_error(std::format("Unsupported font atlas version ({}).", header[1]));
+	}
+	
+	atlas.size = std::bit_cast<float>(header[2]);
+	atlas.sdf = header[3] & font_atlas_sdf_flag;
+	atlas.metrics.size = std::bit_cast<float>(header[4]);
+	atlas.metrics.ascent = std::bit_cast<float>(header[5]);
+	atlas.metrics.descent = std::bit_cast<float>(header[6]);
+	atlas.metrics.linegap = std::bit_cast<float>(header[7]);
+	atlas.metrics.linespace = std::bit_cast<float>(header[8]);
+	atlas.metrics.underline_position = std::bit_cast<float>(header[9]);
+	atlas.metrics.underline_thickness = std::bit_cast<float>(header[10]);
+	atlas.metrics.max_horizontal_advance = std::bit_cast<float>(header[11]);
+	atlas.metrics.max_vertical_advance = std::bit_cast<float>(header[12]);
+	atlas.dimensions = {header[13], header[14]};
+	const std::size_t glyph_count = header[15];
+	const std::size_t kerning_pair_count = header[16];
+	
+	// Validate file size before allocating
+	const std::size_t pixel_count = static_cast<std::size_t>(atlas.dimensions[0]) * atlas.dimensions[1];
+	const std::size_t record_word_count = glyph_count * font_atlas_glyph_word_count + kerning_pair_count * font_atlas_kerning_word_count;
+	if (ctx.size() != (font_atlas_header_word_count + record_word_count) * sizeof(std::uint32_t) + pixel_count)
+	{
+		throw deserialize_error("Invalid font atlas file.");
+	}
+	
+	// Read glyph and kerning records
+	std::vector<std::uint32_t> words(record_word_count);
+	ctx.read32<std::endian::little>(reinterpret_cast<std::byte*>(words.data()), words.size());
+	
+	// Decode glyph records
+	const std::uint32_t* w = words.data();
+	atlas.glyphs.clear();
+	atlas.glyphs.reserve(glyph_count);
+	for (std::size_t i = 0; i < glyph_count; ++i, w += font_atlas_glyph_word_count)
+	{
+		auto& [code, g] = atlas.glyphs.emplace_back();
+		code = static_cast<char32_t>(w[0]);
+		g.dimensions = {std::bit_cast<float>(w[1]), std::bit_cast<float>(w[2])};
+		g.horizontal_bearings = {std::bit_cast<float>(w[3]), std::bit_cast<float>(w[4])};
+		g.horizontal_advance = std::bit_cast<float>(w[5]);
+		g.vertical_bearings = {std::bit_cast<float>(w[6]), std::bit_cast<float>(w[7])};
+		g.vertical_advance = std::bit_cast<float>(w[8]);
+		g.bitmap_position = {w[9], w[10]};
+		g.bitmap_dimensions = {w[11], w[12]};
+		g.bitmap_bearings = {std::bit_cast<std::int32_t>(w[13]), std::bit_cast<std::int32_t>(w[14])};
+		
+		if (static_cast<std::uint64_t>(g.bitmap_position[0]) + g.bitmap_dimensions[0] > atlas.dimensions[0] ||
+			static_cast<std::uint64_t>(g.bitmap_position[1]) + g.bitmap_dimensions[1] > atlas.dimensions[1])
+		{
+			throw deserialize_error("Invalid font atlas file.");
+		}
+	}
+	
+	if (!std::is_sorted(atlas.glyphs.begin(), atlas.glyphs.end(), [](const auto& lhs, const auto& rhs){return lhs.first < rhs.first;}))
+	{
+		throw deserialize_error("Invalid font atlas file.");
+	}
+	
+	// Decode kerning records
+	atlas.kerning_pairs.clear();
+	atlas.kerning_pairs.reserve(kerning_pair_count);
+	for (std::size_t i = 0; i < kerning_pair_count; ++i, w += font_atlas_kerning_word_count)
+	{
+		atlas.kerning_pairs.push_back({static_cast<char32_t>(w[0]), static_cast<char32_t>(w[1]), {std::bit_cast<float>(w[2]), std::bit_cast<float>(w[3])}});
+	}
+	if (!std::is_sorted(atlas.kerning_pairs.begin(), atlas.kerning_pairs.end(), kerning_pair_less))
+	{
+		throw deserialize_error("Invalid font atlas file.");
+	}
+	
+	// Read atlas image
+	atlas.pixels.resize(pixel_count);
+	ctx.read8(atlas.pixels.data(), atlas.pixels.size());
+}
+
+template <>
+std::unique_ptr<type::font_atlas> resource_loader<type::font_atlas>::load([[maybe_unused]] ::resource_manager& resource_manager, std::shared_ptr<deserialize_context> ctx)
+{
+	auto resource = std::make_unique<type::font_atlas>();
+	deserializer<type::font_atlas>().deserialize(*resource, *ctx);
+	return resource;
+}
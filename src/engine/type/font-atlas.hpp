@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_TYPE_FONT_ATLAS_HPP
+#define ANTKEEPER_TYPE_FONT_ATLAS_HPP
+
+#include <engine/type/font-metrics.hpp>
+#include <engine/type/glyph.hpp>
+#include <engine/type/typeface.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace type {
+
+/**
+ * Kerning offset between a pair of glyphs in a font atlas.
+ */
+struct font_atlas_kerning_pair
+{
+	/** UTF-32 character code of the first glyph. */
+	char32_t first{};
+	
+	/** UTF-32 character code of the second glyph. */
+	char32_t second{};
+	
+	/** Kerning offset, in pixels. */
+	std::array<float, 2> offset{};
+};
+
+/**
+ * Glyph metrics, kerning pairs, and glyph bitmaps of a font, baked into a single atlas image ahead of time.
+ *
+ * Font atlases are baked offline with bake_font_atlas() and saved as binary resources, which can be loaded and uploaded without rasterizing any glyphs.
+ *
+ * @see font::font(std::shared_ptr<typeface>, std::shared_ptr<const font_atlas>)
+ */
+struct font_atlas
+{
+	/** Size of the font, in pixels. */
+	float size{};
+	
+	/** `true` if the glyph bitmaps are signed distance fields (SDF), `false` otherwise. */
+	bool sdf{};
+	
+	/** Metrics describing the font. */
+	font_metrics metrics{};
+	
+	/** Baked glyphs and their UTF-32 character codes, sorted by character code, which is also the order in which they were packed. Glyph bitmap data is not stored, as glyph bitmaps are located in the atlas image. */
+	std::vector<std::pair<char32_t, glyph>> glyphs;
+	
+	/** Non-zero kerning offsets between pairs of baked glyphs, sorted by character codes. */
+	std::vector<font_atlas_kerning_pair> kerning_pairs;
+	
+	/** Dimensions of the atlas image, in pixels. */
+	std::array<std::uint32_t, 2> dimensions{};
+	
+	/** Single-channel, 8-bit atlas image data. */
+	std::vector<std::byte> pixels;
+	
+	/**
+	 * Finds a baked glyph.
+	 *
+	 * @param code UTF-32 character code of the glyph.
+	 *
+	 * @return Pointer to the baked glyph, or `nullptr` if the glyph was not baked.
+	 */
+	[[nodiscard]] const glyph* find_glyph(char32_t code) const noexcept;
+	
+	/**
+	 * Finds the kerning pair for a pair of glyphs.
+	 *
+	 * @param first UTF-32 character code of the first glyph.
+	 * @param second UTF-32 character code of the second glyph.
+	 *
+	 * @return Pointer to the kerning pair, or `nullptr` if the glyphs are not kerned.
+	 */
+	[[nodiscard]] const font_atlas_kerning_pair* find_kerning_pair(char32_t first, char32_t second) const noexcept;
+};
+
+/**
+ * Rasterizes and packs glyphs of a typeface into a font atlas.
+ *
+ * @param face Typeface from which glyphs should be rasterized.
+ * @param size Size of the font, in pixels.
+ * @param sdf `true` if signed distance field (SDF) glyphs should be rasterized, `false` otherwise.
+ * @param charset UTF-32 character codes of the glyphs to bake. Character codes not contained in the typeface are ignored, and the missing glyph (character code 0) is always baked.
+ *
+ * @return Baked font atlas.
+ */
+[[nodiscard]] font_atlas bake_font_atlas(const typeface& face, float size, bool sdf, std::u32string_view charset);
+
+} // namespace type
+
+#endif // ANTKEEPER_TYPE_FONT_ATLAS_HPP
@@ -4,8 +4,13 @@
 #include <engine/type/font.hpp>
 #include <engine/debug/log.hpp>
 #include <engine/type/unicode/unicode.hpp>
+#include <algorithm>
 #include <bit>
+#include <cstring>
+#include <limits>
+#include <span>
 #include <stdexcept>
+#include <tuple>
 
 namespace {
 	
@@ -14,6 +19,31 @@ namespace {
 	{
 		return std::uint32_t{1} << std::bit_width(n);
 	}
+	
+	/** Constructs a single-channel font texture. */
+	std::shared_ptr<gl::texture_2d> make_font_texture(std::uint32_t width, std::uint32_t height)
+	{
+		return std::make_shared<gl::texture_2d>
+		(
+			std::make_shared<gl::image_view_2d>
+			(
+				std::make_shared<gl::image_2d>
+				(
+					gl::format::r8_unorm,
+					width,
+					height
+				)
+			),
+			std::make_shared<gl::sampler>
+			(
+				gl::sampler_filter::linear,
+				gl::sampler_filter::linear,
+				gl::sampler_mipmap_mode::linear,
+				gl::sampler_address_mode::clamp_to_edge,
+				gl::sampler_address_mode::clamp_to_edge
+			)
+		);
+	}
 }
 
 namespace type {
@@ -31,174 +61,106 @@ font::font(std::shared_ptr<typeface> face, float size, bool sdf):
 	// Get font metrics
 	m_metrics = m_typeface->get_font_metrics(m_size);
 	
-	// Allocate font texture
-	m_texture = std::make_shared<gl::texture_2d>
-	(
-		std::make_shared<gl::image_view_2d>
-		(
-			std::make_shared<gl::image_2d>
-			(
-				gl::format::r8_unorm,
-				256,
-				256
-			)
-		),
-		std::make_shared<gl::sampler>
-		(
-			gl::sampler_filter::linear,
-			gl::sampler_filter::linear,
-			gl::sampler_mipmap_mode::linear,
-			gl::sampler_address_mode::clamp_to_edge,
-			gl::sampler_address_mode::clamp_to_edge
-		)
-	);
+	// Allocate font texture and its pixels
+	m_texture = make_font_texture(256, 256);
+	m_pixels.resize(256 * 256);
+	
+	// Clear font texture
+	m_texture->get_image_view()->get_image()->write(0, 0, 0, 0, 256, 256, 1, gl::format::r8_unorm, m_pixels);
 	
 	// Init glyph pack
-	const auto& texture_dimensions = m_texture->get_image_view()->get_image()->get_dimensions();
-	m_glyph_pack.resize({texture_dimensions[0], texture_dimensions[1]});
+	m_glyph_pack.resize({256, 256});
 }
 
-std::size_t font::cache_glyph(char32_t code)
-{
-	return cache_glyphs(code, code);
-}
-
-std::size_t font::cache_glyphs(char32_t first, char32_t last)
+font::font(std::shared_ptr<typeface> face, std::shared_ptr<const font_atlas> atlas):
+	m_typeface(face),
+	m_atlas(atlas)
 {
-	std::vector<glyph*> cached_glyphs;
-	bool repack = false;
+	if (!m_typeface)
+	{
+		throw std::invalid_argument("Font has invalid typeface.");
+	}
+	if (!m_atlas || m_atlas->pixels.size() != static_cast<std::size_t>(m_atlas->dimensions[0]) * m_atlas->dimensions[1])
+	{
+		throw std::invalid_argument("Font has invalid atlas.");
+	}
 	
-	// Load glyphs
-	for (auto code = first; code <= last; ++code)
+	m_size = m_atlas->size;
+	m_sdf = m_atlas->sdf;
+	m_metrics = m_atlas->metrics;
+	
+	// Allocate font texture and upload the atlas image
+	m_texture = make_font_texture(m_atlas->dimensions[0], m_atlas->dimensions[1]);
+	m_pixels = m_atlas->pixels;
+	m_texture->get_image_view()->get_image()->write
+	(
+		0,
+		0,
+		0,
+		0,
+		m_atlas->dimensions[0],
+		m_atlas->dimensions[1],
+		1,
+		gl::format::r8_unorm,
+		m_pixels
+	);
+	
+	// Cache baked glyphs, replaying the atlas pack so glyphs rasterized later are packed around them
+	m_glyph_pack.resize({m_atlas->dimensions[0], m_atlas->dimensions[1]});
+	bool replayed = true;
+	for (const auto& [code, baked_glyph]: m_atlas->glyphs)
 	{
-		// Check if typeface contains glyph for the given character code
-		if (!m_typeface->has_glyph(code))
-		{
-			// Glyph not found, use missing glyph (character code 0)
-			code = 0;
-		}
-		
-		// Ignore glyph if already cached
-		if (auto it = m_glyph_map.find(code); it != m_glyph_map.end())
-		{
-			continue;
-		}
+		auto& g = m_glyph_map[code];
+		g.dimensions = baked_glyph.dimensions;
+		g.horizontal_bearings = baked_glyph.horizontal_bearings;
+		g.horizontal_advance = baked_glyph.horizontal_advance;
+		g.vertical_bearings = baked_glyph.vertical_bearings;
+		g.vertical_advance = baked_glyph.vertical_advance;
+		g.bitmap_position = baked_glyph.bitmap_position;
+		g.bitmap_dimensions = baked_glyph.bitmap_dimensions;
+		g.bitmap_bearings = baked_glyph.bitmap_bearings;
 		
-		// Load glyph from typeface and insert into glyph map
-		auto result = m_glyph_map.emplace(code, m_typeface->get_glyph(code, m_size, m_sdf));
-		if (result.second)
+		if (replayed)
 		{
-			// Append pointer to glyph to vector of newly-cached glyphs
-			auto g = cached_glyphs.emplace_back(&result.first->second);
-			
-			// Attempt to pack glyph
-			if (!repack)
-			{
-				if (auto node = m_glyph_pack.insert({g->bitmap_dimensions[0], g->bitmap_dimensions[1]}))
-				{
-					// Update texture coordinates of glyph
-					g->bitmap_position[0] = node->bounds.min.x();
-					g->bitmap_position[1] = node->bounds.min.y();
-				}
-				else
-				{
-					const auto& texture_dimensions = m_texture->get_image_view()->get_image()->get_dimensions();
-					debug::log_trace
-					(
-						"Failed to pack glyph for U+{:X} into {}x{} texture",
-						static_cast<std::uint32_t>(code),
-						texture_dimensions[0],
-						texture_dimensions[1]
-					);
-					
-					// Glyph pack failed, repack later
-					repack = true;
-				}
-			}
+			const auto position = m_glyph_pack.insert({g.bitmap_dimensions[0], g.bitmap_dimensions[1]});
+			replayed = position && position->x() == g.bitmap_position[0] && position->y() == g.bitmap_position[1];
 		}
 	}
 	
-	if (!repack)
-	{
-		// Write glyph bitmaps to font texture
-		write_bitmaps(cached_glyphs);
-	}
-	else
+	// Atlas was packed differently, reserve the whole atlas so glyphs rasterized later are packed outside of it
+	if (!replayed)
 	{
-		// Resize texture and repack all glyphs
-		repack_glyphs();
+		debug::log_warning("Font atlas glyph layout could not be replayed; glyphs will be packed outside of the atlas");
+		m_glyph_pack.clear();
+		std::ignore = m_glyph_pack.insert({m_atlas->dimensions[0], m_atlas->dimensions[1]});
 	}
-	
-	return cached_glyphs.size();
 }
 
-std::size_t font::cache_glyphs(std::u32string_view text)
+std::size_t font::cache_glyph(char32_t code)
 {
-	std::vector<glyph*> cached_glyphs;
-	bool repack = false;
-	
-	// Load glyphs
-	for (auto code: text)
+	return cache_glyphs(code, code);
+}
+
+std::size_t font::cache_glyphs(char32_t first, char32_t last)
+{
+	std::vector<char32_t> codes;
+	for (auto code = first; code <= last; ++code)
 	{
-		// Check if typeface contains glyph for the given character code
-		if (!m_typeface->has_glyph(code))
-		{
-			// Glyph not found, use missing glyph (character code 0)
-			code = 0;
-		}
+		codes.push_back(code);
 		
-		// Ignore glyph if already cached
-		if (auto it = m_glyph_map.find(code); it != m_glyph_map.end())
+		if (code == last)
 		{
-			continue;
+			break;
 		}
-		
-		// Load glyph from typeface and insert into glyph map
-		auto result = m_glyph_map.emplace(code, m_typeface->get_glyph(code, m_size, m_sdf));
-		if (result.second)
-		{
-			// Append pointer to glyph to vector of newly-cached glyphs
-			auto g = cached_glyphs.emplace_back(&result.first->second);
-			
-			// Attempt to pack glyph
-			if (!repack)
-			{
-				if (auto node = m_glyph_pack.insert({g->bitmap_dimensions[0], g->bitmap_dimensions[1]}))
-				{
-					// Update texture coordinates of glyph
-					g->bitmap_position[0] = node->bounds.min.x();
-					g->bitmap_position[1] = node->bounds.min.y();
-				}
-				else
-				{
-					const auto& texture_dimensions = m_texture->get_image_view()->get_image()->get_dimensions();
-					debug::log_trace
-					(
-						"Failed to pack glyph for U+{:X} into {}x{} texture",
-						static_cast<std::uint32_t>(code),
-						texture_dimensions[0],
-						texture_dimensions[1]
-					);
-					
-					// Glyph pack failed, repack later
-					repack = true;
-				}
-			}
-		}
-	}
-	
-	if (!repack)
-	{
-		// Write glyph bitmaps to font texture
-		write_bitmaps(cached_glyphs);
-	}
-	else
-	{
-		// Resize texture and repack all glyphs
-		repack_glyphs();
 	}
 	
-	return cached_glyphs.size();
+	return cache_new_glyphs(codes);
+}
+
+std::size_t font::cache_glyphs(std::u32string_view text)
+{
+	std::vector<char32_t> codes(text.begin(), text.end());
+	return cache_new_glyphs(codes);
 }
 
 std::size_t font::cache_glyphs(std::string_view text)
@@ -228,161 +190,196 @@ const glyph* font::get_cached_glyph(char32_t code) const
 
 std::array<float, 2> font::get_kerning(char32_t first, char32_t second) const
 {
+	// Look up kerning of baked glyph pairs in the font atlas
+	if (m_atlas && m_atlas->find_glyph(first) && m_atlas->find_glyph(second))
+	{
+		const auto pair = m_atlas->find_kerning_pair(first, second);
+		return pair ? pair->offset : std::array<float, 2>{};
+	}
+	
 	return m_typeface->get_kerning(m_size, first, second);
 }
 
-void font::write_bitmaps(std::span<glyph*> glyphs)
+std::size_t font::cache_new_glyphs(std::vector<char32_t>& codes)
 {
-	for (auto g: glyphs)
+	// Discard cached glyphs and duplicates, substituting the missing glyph (character code 0) for glyphs not in the typeface
+	for (auto& code: codes)
 	{
-		m_texture->get_image_view()->get_image()->write
-		(
-			0,
-			g->bitmap_position[0],
-			g->bitmap_position[1],
-			0,
-			g->bitmap_dimensions[0],
-			g->bitmap_dimensions[1],
-			1,
-			m_texture->get_image_view()->get_image()->get_format(),
-			{g->bitmap_data.get(), g->bitmap_dimensions[0] * g->bitmap_dimensions[1]}
-		);
+		if (!m_typeface->has_glyph(code))
+		{
+			code = 0;
+		}
+	}
+	std::erase_if(codes, [&](char32_t code){return m_glyph_map.contains(code);});
+	std::sort(codes.begin(), codes.end());
+	codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+	
+	if (codes.empty())
+	{
+		return 0;
 	}
-}
-
-void font::repack_glyphs()
-{
-	// Get font texture dimensions
-	const auto old_texture_dimensions = m_texture->get_image_view()->get_image()->get_dimensions();
 	
-	// Init new dimensions of font texture
-	auto new_texture_dimensions = old_texture_dimensions;
+	// Rasterize glyphs
+	auto glyphs = m_typeface->get_glyphs(codes, m_size, m_sdf);
 	
-	// Pack glyphs
-	bool packed = false;
-	do
+	// Pack glyphs, enlarging the font texture as necessary. Previously-packed glyphs are never moved.
+	const auto old_texture_dimensions = m_glyph_pack.get_dimensions();
+	for (std::size_t i = 0; i < glyphs.size(); ++i)
 	{
-		// Determine new dimensions of font texture
-		if (new_texture_dimensions[0] > new_texture_dimensions[1])
-		{
-			new_texture_dimensions[1] = next_power_of_two(new_texture_dimensions[1]);
-		}
-		else
+		auto& g = glyphs[i];
+		
+		auto position = m_glyph_pack.insert({g.bitmap_dimensions[0], g.bitmap_dimensions[1]});
+		while (!position)
 		{
-			new_texture_dimensions[0] = next_power_of_two(new_texture_dimensions[0]);
+			debug::log_trace
+			(
+				"Failed to pack glyph for U+{:X} into {}x{} texture",
+				static_cast<std::uint32_t>(codes[i]),
+				m_glyph_pack.get_dimensions().x(),
+				m_glyph_pack.get_dimensions().y()
+			);
+			
+			grow_glyph_pack();
+			position = m_glyph_pack.insert({g.bitmap_dimensions[0], g.bitmap_dimensions[1]});
 		}
 		
-		debug::log_trace
-		(
-			"Repacking {} glyphs into {}x{} texture...",
-			m_glyph_map.size(),
-			new_texture_dimensions[0],
-			new_texture_dimensions[1]
-		);
+		g.bitmap_position[0] = position->x();
+		g.bitmap_position[1] = position->y();
 		
-		// Resize glyph pack
-		m_glyph_pack.resize({new_texture_dimensions[0], new_texture_dimensions[1]});
+		// Copy glyph bitmap into the font pixels
+		const std::uint32_t texture_width = m_glyph_pack.get_dimensions().x();
+		for (std::uint32_t y = 0; y < g.bitmap_dimensions[1]; ++y)
+		{
+			std::memcpy
+			(
+				m_pixels.data() + (g.bitmap_position[1] + y) * texture_width + g.bitmap_position[0],
+				g.bitmap_data.get() + y * g.bitmap_dimensions[0],
+				g.bitmap_dimensions[0]
+			);
+		}
 		
-		// Attempt to pack glyphs
-		packed = true;
-		for (auto it = m_glyph_map.begin(); it != m_glyph_map.end(); ++it)
+		// Extend dirty region
+		if (g.bitmap_dimensions[0] && g.bitmap_dimensions[1])
 		{
-			// Pack glyph
-			if (auto pack_node = m_glyph_pack.insert({it->second.bitmap_dimensions[0], it->second.bitmap_dimensions[1]}))
-			{
-				// Update texture coordinates of glyph
-				it->second.bitmap_position[0] = pack_node->bounds.min.x();
-				it->second.bitmap_position[1] = pack_node->bounds.min.y();
-			}
-			else
-			{
-				debug::log_trace
-				(
-					"Failed to pack glyph for U+{:X} into {}x{} texture",
-					static_cast<std::uint32_t>(it->first),
-					new_texture_dimensions[0],
-					new_texture_dimensions[1]
-				);
-				
-				// Glyph pack failed
-				packed = false;
-				break;
-			}
+			m_dirty_bounds.extend(math::uvec2{g.bitmap_position[0], g.bitmap_position[1]});
+			m_dirty_bounds.extend(math::uvec2{g.bitmap_position[0] + g.bitmap_dimensions[0], g.bitmap_position[1] + g.bitmap_dimensions[1]});
 		}
+		
+		// Glyph bitmap is no longer needed once it has been copied into the font pixels
+		g.bitmap_data.reset();
+		
+		m_glyph_map.emplace(codes[i], std::move(g));
 	}
-	while (!packed);
 	
-	debug::log_trace
-	(
-		"Packed {} glyphs into {}x{} texture",
-		m_glyph_map.size(),
-		new_texture_dimensions[0],
-		new_texture_dimensions[1]
-	);
+	if (m_glyph_pack.get_dimensions() != old_texture_dimensions)
+	{
+		resize_texture();
+	}
 	
-	debug::log_trace
-	(
-		"Resizing font texture from {}x{} to {}x{}...",
-		old_texture_dimensions[0],
-		old_texture_dimensions[1],
-		new_texture_dimensions[0],
-		new_texture_dimensions[1]
-	);
+	upload_dirty_region();
 	
-	// Resize font texture image
-	m_texture->set_image_view
-	(
-		std::make_shared<gl::image_view_2d>
-		(
-			std::make_shared<gl::image_2d>
-			(
-				gl::format::r8_unorm,
-				new_texture_dimensions[0],
-				new_texture_dimensions[1]
-			)
-		)
-	);
+	return glyphs.size();
+}
+
+void font::grow_glyph_pack()
+{
+	const auto old_dimensions = m_glyph_pack.get_dimensions();
+	
+	// Determine new dimensions of font texture
+	auto new_dimensions = old_dimensions;
+	if (new_dimensions.x() > new_dimensions.y())
+	{
+		new_dimensions.y() = next_power_of_two(new_dimensions.y());
+	}
+	else
+	{
+		new_dimensions.x() = next_power_of_two(new_dimensions.x());
+	}
+	
+	// Enlarge glyph pack, keeping packed glyphs in place
+	m_glyph_pack.resize(new_dimensions);
+	
+	// Enlarge font pixels
+	std::vector<std::byte> pixels(static_cast<std::size_t>(new_dimensions.x()) * new_dimensions.y());
+	for (std::uint32_t y = 0; y < old_dimensions.y(); ++y)
+	{
+		std::memcpy(pixels.data() + y * new_dimensions.x(), m_pixels.data() + y * old_dimensions.x(), old_dimensions.x());
+	}
+	m_pixels = std::move(pixels);
+}
+
+void font::resize_texture()
+{
+	const auto& old_image = *m_texture->get_image_view()->get_image();
+	const auto old_texture_dimensions = old_image.get_dimensions();
+	const auto& new_texture_dimensions = m_glyph_pack.get_dimensions();
 	
 	debug::log_trace
 	(
-		"Resized font texture from {}x{} to {}x{}",
+		"Resizing font texture from {}x{} to {}x{}...",
 		old_texture_dimensions[0],
 		old_texture_dimensions[1],
-		new_texture_dimensions[0],
-		new_texture_dimensions[1]
+		new_texture_dimensions.x(),
+		new_texture_dimensions.y()
 	);
 	
-	debug::log_trace
+	auto new_image = std::make_shared<gl::image_2d>
 	(
-		"Writing {} glyphs to font texture...",
-		m_glyph_map.size()
+		gl::format::r8_unorm,
+		new_texture_dimensions.x(),
+		new_texture_dimensions.y()
 	);
 	
-	// Write glyph bitmaps to font texture image
-	for (auto it = m_glyph_map.begin(); it != m_glyph_map.end(); ++it)
+	// Copy previously-uploaded glyphs into the new image, on the GPU
+	old_image.copy(0, 0, 0, 0, *new_image, 0, 0, 0, 0, old_texture_dimensions[0], old_texture_dimensions[1], 1);
+	
+	// Upload the cleared pixels of the new area along with any new glyphs
+	if (new_texture_dimensions.x() > old_texture_dimensions[0])
 	{
-		m_texture->get_image_view()->get_image()->write
-		(
-			0,
-			it->second.bitmap_position[0],
-			it->second.bitmap_position[1],
-			0,
-			it->second.bitmap_dimensions[0],
-			it->second.bitmap_dimensions[1],
-			1,
-			m_texture->get_image_view()->get_image()->get_format(),
-			{it->second.bitmap_data.get(), it->second.bitmap_dimensions[0] * it->second.bitmap_dimensions[1]}
-		);
+		m_dirty_bounds.extend(math::uvec2{old_texture_dimensions[0], 0});
+		m_dirty_bounds.extend(new_texture_dimensions);
+	}
+	if (new_texture_dimensions.y() > old_texture_dimensions[1])
+	{
+		m_dirty_bounds.extend(math::uvec2{0, old_texture_dimensions[1]});
+		m_dirty_bounds.extend(new_texture_dimensions);
 	}
 	
-	debug::log_trace
-	(
-		"Wrote {} glyphs to font texture",
-		m_glyph_map.size()
-	);
+	m_texture->set_image_view(std::make_shared<gl::image_view_2d>(std::move(new_image)));
 	
 	// Generate font texture resized event
 	m_texture_resized_publisher.publish({this});
 }
 
+void font::upload_dirty_region()
+{
+	if (m_dirty_bounds.min.x() >= m_dirty_bounds.max.x() || m_dirty_bounds.min.y() >= m_dirty_bounds.max.y())
+	{
+		return;
+	}
+	
+	const std::uint32_t texture_width = m_glyph_pack.get_dimensions().x();
+	const std::uint32_t x = m_dirty_bounds.min.x();
+	const std::uint32_t y = m_dirty_bounds.min.y();
+	const std::uint32_t width = m_dirty_bounds.max.x() - x;
+	const std::uint32_t height = m_dirty_bounds.max.y() - y;
+	
+	// Gather rows of the dirty region, unless they're already contiguous
+	std::span<const std::byte> data{m_pixels.data() + y * texture_width, static_cast<std::size_t>(width) * height};
+	std::vector<std::byte> staging;
+	if (width != texture_width)
+	{
+		staging.resize(static_cast<std::size_t>(width) * height);
+		for (std::uint32_t row = 0; row < height; ++row)
+		{
+			std::memcpy(staging.data() + row * width, m_pixels.data() + (y + row) * texture_width + x, width);
+		}
+		data = staging;
+	}
+	
+	m_texture->get_image_view()->get_image()->write(0, x, y, 0, width, height, 1, gl::format::r8_unorm, data);
+	
+	m_dirty_bounds = {{std::numeric_limits<std::uint32_t>::max(), std::numeric_limits<std::uint32_t>::max()}, {0, 0}};
+}
+
 } // namespace type
@@ -4,16 +4,20 @@
 #ifndef ANTKEEPER_TYPE_FONT_HPP
 #define ANTKEEPER_TYPE_FONT_HPP
 
+#include <engine/type/font-atlas.hpp>
 #include <engine/type/font-metrics.hpp>
 #include <engine/type/typeface.hpp>
-#include <engine/geom/rect-pack.hpp>
+#include <engine/geom/skyline-pack.hpp>
+#include <engine/geom/primitives/rectangle.hpp>
 #include <engine/gl/texture.hpp>
 #include <engine/event/publisher.hpp>
 #include <array>
+#include <cstddef>
+#include <limits>
 #include <memory>
-#include <span>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace type {
 
@@ -41,6 +45,19 @@ public:
 	 */
 	font(std::shared_ptr<typeface> face, float size, bool sdf = false);
 	
+	/**
+	 * Constructs a font from a baked font atlas.
+	 *
+	 * The atlas image is uploaded to the font texture as-is and its glyphs are cached up front. Glyphs not contained in the atlas are rasterized by the typeface and packed around the baked glyphs on demand.
+	 *
+	 * @param face Typeface from which the font atlas was baked.
+	 * @param atlas Font atlas baked from the typeface.
+	 *
+	 * @exception std::invalid_argument Font has invalid typeface.
+	 * @exception std::invalid_argument Font has invalid atlas.
+	 */
+	font(std::shared_ptr<typeface> face, std::shared_ptr<const font_atlas> atlas);
+	
 	/// @name Glyphs
 	/// @{
 	
@@ -52,9 +69,8 @@ public:
 	 * @return Number of newly-cached glyphs.
 	 *
 	 * @warning Font texture view and texture image may be reconstructed.
-	 * @warning Texture coordinates of pre-cached glyphs may be modified.
 	 *
-	 * @note Caching groups of glyphs with the cache_glyphs() functions is more efficient.
+	 * @note Caching groups of glyphs with the cache_glyphs() functions is more efficient, as uncached glyphs are rasterized concurrently and uploaded together.
 	 */
 	std::size_t cache_glyph(char32_t code);
 	
@@ -67,7 +83,6 @@ public:
 	 * @return Number of newly-cached glyphs.
 	 *
 	 * @warning Font texture view and texture image may be reconstructed.
-	 * @warning Texture coordinates of pre-cached glyphs may be modified.
 	 */
 	std::size_t cache_glyphs(char32_t first, char32_t last);
 	
@@ -79,7 +94,6 @@ public:
 	 * @return Number of newly-cached glyphs.
 	 *
 	 * @warning Font texture view and texture image may be reconstructed.
-	 * @warning Texture coordinates of pre-cached glyphs may be modified.
 	 */
 	std::size_t cache_glyphs(std::u32string_view text);
 	
@@ -91,7 +105,6 @@ public:
 	 * @return Number of newly-cached glyphs.
 	 *
 	 * @warning Font texture view and texture image may be reconstructed.
-	 * @warning Texture coordinates of pre-cached glyphs may be modified.
 	 */
 	std::size_t cache_glyphs(std::string_view text);
 	
@@ -124,6 +137,24 @@ public:
 		return m_typeface;
 	}
 	
+	/** Returns the font atlas from which the font was constructed, if any. */
+	[[nodiscard]] inline constexpr const auto& get_atlas() const noexcept
+	{
+		return m_atlas;
+	}
+	
+	/** Returns the size of the font, in pixels. */
+	[[nodiscard]] inline constexpr float get_size() const noexcept
+	{
+		return m_size;
+	}
+	
+	/** Returns `true` if the font renders signed distance field (SDF) glyphs, `false` otherwise. */
+	[[nodiscard]] inline constexpr bool is_sdf() const noexcept
+	{
+		return m_sdf;
+	}
+	
 	/** Returns metrics describing the font. */
 	[[nodiscard]] inline constexpr const auto& get_metrics() const noexcept
 	{
@@ -144,22 +175,37 @@ public:
 	
 private:
 	/**
-	 * Writes glyph bitmaps to the font texture.
+	 * Rasterizes, packs, and uploads glyphs which have not yet been cached.
+	 *
+	 * @param[in,out] codes UTF-32 character codes of glyphs to cache. Modified to contain only the codes of newly-cached glyphs.
 	 *
-	 * @param glyphs Glyphs for which bitmaps should be written.
+	 * @return Number of newly-cached glyphs.
 	 */
-	void write_bitmaps(std::span<glyph*> glyphs);
+	std::size_t cache_new_glyphs(std::vector<char32_t>& codes);
+	
+	/** Enlarges the glyph pack and font pixels, keeping packed glyphs in place. */
+	void grow_glyph_pack();
+	
+	/** Replaces the font texture image with one the size of the glyph pack, copying the previous image into it. */
+	void resize_texture();
 	
-	/** Resizes the font texture size and repacks glyph bitmaps. */
-	void repack_glyphs();
+	/** Uploads the region of the font pixels in which glyphs have been packed since the last upload. */
+	void upload_dirty_region();
 	
 	std::shared_ptr<typeface> m_typeface;
+	std::shared_ptr<const font_atlas> m_atlas;
 	float m_size{};
 	bool m_sdf{};
 	font_metrics m_metrics;
 	std::shared_ptr<gl::texture_2d> m_texture;
 	std::unordered_map<char32_t, glyph> m_glyph_map;
-	geom::rect_pack<std::uint32_t> m_glyph_pack;
+	geom::skyline_pack<std::uint32_t> m_glyph_pack;
+	
+	/// Single-channel pixels of the font texture, in which glyph bitmaps are composed before upload.
+	std::vector<std::byte> m_pixels;
+	
+	/// Bounds of the font pixels modified since the last upload.
+	geom::rectangle<std::uint32_t> m_dirty_bounds{{std::numeric_limits<std::uint32_t>::max(), std::numeric_limits<std::uint32_t>::max()}, {0, 0}};
 	event::publisher<font_texture_resized_event> m_texture_resized_publisher;
 };
 
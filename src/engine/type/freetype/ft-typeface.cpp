@@ -5,16 +5,93 @@
 #include <engine/resources/resource-loader.hpp>
 #include <engine/resources/deserialize-error.hpp>
 #include <engine/debug/log.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <execution>
 #include <format>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 
 namespace type {
 
-ft_typeface::ft_typeface(FT_Library ft_library, FT_Face ft_face, std::unique_ptr<std::byte[]> file_buffer):
+namespace {
+
+/// Number of glyphs rasterized by each task of a concurrent glyph load.
+constexpr std::size_t glyph_batch_size = 32;
+
+/**
+ * Renders a glyph with a FreeType face of the required size.
+ *
+ * @param ft_face FreeType face with which to render the glyph.
+ * @param code UTF-32 character code of the glyph.
+ * @param sdf `true` to render a signed distance field (SDF) glyph bitmap, `false` otherwise.
+ *
+ * @return Rendered glyph.
+ *
+ * @exception std::runtime_error FreeType failed to load glyph.
+ */
+[[nodiscard]] glyph render_glyph(FT_Face ft_face, char32_t code, bool sdf)
+{
+	// Get index of glyph from character code
+	const FT_UInt glyph_index = FT_Get_Char_Index(ft_face, static_cast<FT_ULong>(code));
+	
+	// Determine glyph load flags
+	FT_Int32 ft_load_flags = FT_LOAD_RENDER;
+	if (sdf)
+	{
+		ft_load_flags |= FT_LOAD_TARGET_(FT_RENDER_MODE_SDF);
+	}
+	else
+	{
+		ft_load_flags |= FT_LOAD_TARGET_NORMAL;
+	}
+	
+	// Load glyph and render bitmap
+	if (const FT_Error error = FT_Load_Glyph(ft_face, glyph_index, ft_load_flags))
+	{
+		throw std::runtime_error(std::format("FreeType failed to load glyph (error code \"{}\")", error));
+	}
+	
+	// Allocate glyph
+	glyph g;
+	
+	// Calculate glyph metrics, in pixels
+	g.dimensions[0] = ft_face->glyph->metrics.width / 64.0f;
+	g.dimensions[1] = ft_face->glyph->metrics.height / 64.0f;
+	g.horizontal_bearings[0] = ft_face->glyph->metrics.horiBearingX / 64.0f;
+	g.horizontal_bearings[1] = ft_face->glyph->metrics.horiBearingY / 64.0f;
+	g.horizontal_advance = ft_face->glyph->metrics.horiAdvance / 64.0f;
+	g.vertical_bearings[0] = ft_face->glyph->metrics.vertBearingX / 64.0f;
+	g.vertical_bearings[1] = ft_face->glyph->metrics.vertBearingY / 64.0f;
+	g.vertical_advance = ft_face->glyph->metrics.vertAdvance / 64.0f;
+	g.bitmap_dimensions[0] = static_cast<std::uint32_t>(ft_face->glyph->bitmap.width);
+	g.bitmap_dimensions[1] = static_cast<std::uint32_t>(ft_face->glyph->bitmap.rows);
+	g.bitmap_bearings[0] = static_cast<std::int32_t>(ft_face->glyph->bitmap_left);
+	g.bitmap_bearings[1] = static_cast<std::int32_t>(ft_face->glyph->bitmap_top);
+	
+	// Allocate and copy glyph bitmap
+	g.bitmap_data = std::make_unique<std::byte[]>(g.bitmap_dimensions[0] * g.bitmap_dimensions[1]);
+	std::memcpy(g.bitmap_data.get(), ft_face->glyph->bitmap.buffer, g.bitmap_dimensions[0] * g.bitmap_dimensions[1]);
+	
+	return g;
+}
+
+} // namespace
+
+ft_typeface::worker_face::~worker_face()
+{
+	FT_Done_Face(ft_face);
+	FT_Done_FreeType(ft_library);
+}
+
+ft_typeface::ft_typeface(FT_Library ft_library, FT_Face ft_face, std::unique_ptr<std::byte[]> file_buffer, std::size_t file_size):
 	m_ft_library(ft_library),
 	m_ft_face(ft_face),
-	m_file_buffer{std::move(file_buffer)}
+	m_file_buffer{std::move(file_buffer)},
+	m_file_size{file_size}
 {
 	m_family_name = m_ft_face->family_name;
 	m_style_name = m_ft_face->style_name;
@@ -73,48 +150,62 @@ glyph ft_typeface::get_glyph(char32_t code, float size, bool sdf) const
 	// Set font size
 	set_face_pixel_size(size);
 	
-	// Get index of glyph from character code
-	const FT_UInt glyph_index = FT_Get_Char_Index(m_ft_face, static_cast<FT_ULong>(code));
-	
-	// Determine glyph load flags
-	FT_Int32 ft_load_flags = FT_LOAD_RENDER;
-	if (sdf)
-	{
-		ft_load_flags |= FT_LOAD_TARGET_(FT_RENDER_MODE_SDF);
-	}
-	else
+	return render_glyph(m_ft_face, code, sdf);
+}
+
+std::vector<glyph> ft_typeface::get_glyphs(std::span<const char32_t> codes, float size, bool sdf) const
+{
+	// Load small numbers of glyphs with the shared face
+	if (codes.size() <= glyph_batch_size)
 	{
-		ft_load_flags |= FT_LOAD_TARGET_NORMAL;
+		return typeface::get_glyphs(codes, size, sdf);
 	}
 	
-	// Load glyph and render bitmap
-	if (const FT_Error error = FT_Load_Glyph(m_ft_face, glyph_index, ft_load_flags))
-	{
-		throw std::runtime_error(std::format("FreeType failed to load glyph (error code \"{}\")", error));
-	}
+	std::vector<glyph> glyphs(codes.size());
 	
-	// Allocate glyph
-	glyph g;
+	// Split glyphs into batches
+	std::vector<std::size_t> batches((codes.size() + glyph_batch_size - 1) / glyph_batch_size);
+	std::iota(batches.begin(), batches.end(), std::size_t{0});
 	
-	// Calculate glyph metrics, in pixels
-	g.dimensions[0] = m_ft_face->glyph->metrics.width / 64.0f;
-	g.dimensions[1] = m_ft_face->glyph->metrics.height / 64.0f;
-	g.horizontal_bearings[0] = m_ft_face->glyph->metrics.horiBearingX / 64.0f;
-	g.horizontal_bearings[1] = m_ft_face->glyph->metrics.horiBearingY / 64.0f;
-	g.horizontal_advance = m_ft_face->glyph->metrics.horiAdvance / 64.0f;
-	g.vertical_bearings[0] = m_ft_face->glyph->metrics.vertBearingX / 64.0f;
-	g.vertical_bearings[1] = m_ft_face->glyph->metrics.vertBearingY / 64.0f;
-	g.vertical_advance = m_ft_face->glyph->metrics.vertAdvance / 64.0f;
-	g.bitmap_dimensions[0] = static_cast<std::uint32_t>(m_ft_face->glyph->bitmap.width);
-	g.bitmap_dimensions[1] = static_cast<std::uint32_t>(m_ft_face->glyph->bitmap.rows);
-	g.bitmap_bearings[0] = static_cast<std::int32_t>(m_ft_face->glyph->bitmap_left);
-	g.bitmap_bearings[1] = static_cast<std::int32_t>(m_ft_face->glyph->bitmap_top);
+	// Rasterize batches concurrently, as FreeType faces can't be shared between threads each task borrows a face of its own
+	std::exception_ptr exception;
+	std::mutex exception_mutex;
+	std::for_each
+	(
+		std::execution::par,
+		batches.begin(),
+		batches.end(),
+		[&](std::size_t batch)
+		{
+			try
+			{
+				auto face = acquire_worker_face(size);
+				
+				const std::size_t last = std::min(codes.size(), (batch + 1) * glyph_batch_size);
+				for (std::size_t i = batch * glyph_batch_size; i < last; ++i)
+				{
+					glyphs[i] = render_glyph(face->ft_face, codes[i], sdf);
+				}
+				
+				release_worker_face(std::move(face));
+			}
+			catch (...)
+			{
+				const std::lock_guard lock(exception_mutex);
+				if (!exception)
+				{
+					exception = std::current_exception();
+				}
+			}
+		}
+	);
 	
-	// Allocate and copy glyph bitmap
-	g.bitmap_data = std::make_unique<std::byte[]>(g.bitmap_dimensions[0] * g.bitmap_dimensions[1]);
-	std::memcpy(g.bitmap_data.get(), m_ft_face->glyph->bitmap.buffer, g.bitmap_dimensions[0] * g.bitmap_dimensions[1]);
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
 	
-	return g;
+	return glyphs;
 }
 
 std::array<float, 2> ft_typeface::get_kerning(float size, char32_t first, char32_t second) const
@@ -159,6 +250,56 @@ void ft_typeface::set_face_pixel_size(float size) const
 	}
 }
 
+std::unique_ptr<ft_typeface::worker_face> ft_typeface::acquire_worker_face(float size) const
+{
+	std::unique_ptr<worker_face> face;
+	
+	// Reuse an idle worker face
+	{
+		const std::lock_guard lock(m_worker_face_mutex);
+		if (!m_worker_faces.empty())
+		{
+			face = std::move(m_worker_faces.back());
+			m_worker_faces.pop_back();
+		}
+	}
+	
+	// Load a new worker face from the file buffer, with a library of its own
+	if (!face)
+	{
+		face = std::make_unique<worker_face>();
+		if (const FT_Error error = FT_Init_FreeType(&face->ft_library))
+		{
+			face->ft_library = nullptr;
+			throw std::runtime_error(std::format("Failed to init FreeType library (error code \"{}\")", error));
+		}
+		if (const FT_Error error = FT_New_Memory_Face(face->ft_library, reinterpret_cast<const FT_Byte*>(m_file_buffer.get()), static_cast<FT_Long>(m_file_size), 0, &face->ft_face))
+		{
+			face->ft_face = nullptr;
+			throw std::runtime_error(std::format("Failed to load FreeType face (error code \"{}\")", error));
+		}
+	}
+	
+	// Set font size
+	if (face->size != size)
+	{
+		if (const FT_Error error = FT_Set_Pixel_Sizes(face->ft_face, 0, static_cast<FT_UInt>(std::round(size))))
+		{
+			throw std::runtime_error(std::format("FreeType failed to set face size (error code \"{}\")", error));
+		}
+		
+		face->size = size;
+	}
+	
+	return face;
+}
+
+void ft_typeface::release_worker_face(std::unique_ptr<worker_face> face) const
+{
+	const std::lock_guard lock(m_worker_face_mutex);
+	m_worker_faces.emplace_back(std::move(face));
+}
+
 } // namespace type
 
 template <>
@@ -183,5 +324,5 @@ std::unique_ptr<type::typeface> resource_loader<type::typeface>::load([[maybe_un
 		throw deserialize_error(std::format("Failed to load FreeType face (error code \"{}\")", error));
 	}
 	
-	return std::make_unique<type::ft_typeface>(ft_library, ft_face, std::move(file_buffer));
+	return std::make_unique<type::ft_typeface>(ft_library, ft_face, std::move(file_buffer), ctx->size());
 }
@@ -7,8 +7,11 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <engine/type/typeface.hpp>
-#include <vector>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
 
 namespace type {
 
@@ -26,8 +29,9 @@ public:
 	 * @param ft_library Pointer to a FreeType library instance.
 	 * @param ft_face Pointer to the FreeType object instance.
 	 * @param file_buffer File buffer containing FreeType face data.
+	 * @param file_size Size of the file buffer, in bytes.
 	 */
-	ft_typeface(FT_Library ft_library, FT_Face ft_face, std::unique_ptr<std::byte[]> file_buffer);
+	ft_typeface(FT_Library ft_library, FT_Face ft_face, std::unique_ptr<std::byte[]> file_buffer, std::size_t file_size);
 	
 	/** Destructs a FreeType typeface. */
 	~ft_typeface() override;
@@ -35,14 +39,42 @@ public:
 	[[nodiscard]] font_metrics get_font_metrics(float size) const override;
 	[[nodiscard]] bool has_glyph(char32_t code) const override;
 	[[nodiscard]] glyph get_glyph(char32_t code, float size, bool sdf) const override;
+
+	/**
+	 * @copydoc typeface::get_glyphs
+	 *
+	 * Glyphs are rasterized in parallel batches. Each batch is rendered with a worker face loaded from the same file buffer, as FreeType faces can't be used by multiple threads at once. Worker faces are kept for reuse by subsequent loads.
+	 */
+	[[nodiscard]] std::vector<glyph> get_glyphs(std::span<const char32_t> codes, float size, bool sdf) const override;
+
 	[[nodiscard]] std::array<float, 2> get_kerning(float size, char32_t first, char32_t second) const override;
 	
 private:
+	/// FreeType library and face used to rasterize glyphs on a worker thread.
+	struct worker_face
+	{
+		/// Destroys the FreeType face and library.
+		~worker_face();
+
+		FT_Library ft_library{nullptr};
+		FT_Face ft_face{nullptr};
+		float size{-1.0f};
+	};
+
 	void set_face_pixel_size(float height) const;
+
+	/// Takes an idle worker face, or loads a new one, and sets its pixel size.
+	[[nodiscard]] std::unique_ptr<worker_face> acquire_worker_face(float size) const;
+
+	/// Returns a worker face to the set of idle worker faces.
+	void release_worker_face(std::unique_ptr<worker_face> face) const;
 	
 	FT_Library m_ft_library;
 	FT_Face m_ft_face;
 	std::unique_ptr<std::byte[]> m_file_buffer;
+	std::size_t m_file_size{0};
+	mutable std::vector<std::unique_ptr<worker_face>> m_worker_faces;
+	mutable std::mutex m_worker_face_mutex;
 	mutable float m_face_size{-1.0f};
 };
 
@@ -6,5 +6,16 @@
 
 namespace type {
 
+std::vector<glyph> typeface::get_glyphs(std::span<const char32_t> codes, float size, bool sdf) const
+{
+	std::vector<glyph> glyphs;
+	glyphs.reserve(codes.size());
+	for (auto code: codes)
+	{
+		glyphs.emplace_back(get_glyph(code, size, sdf));
+	}
+
+	return glyphs;
+}
 
 } // namespace type
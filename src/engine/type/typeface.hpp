@@ -8,7 +8,9 @@
 #include <engine/type/glyph.hpp>
 #include <engine/type/typeface-style.hpp>
 #include <array>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace type {
 
@@ -60,6 +62,19 @@ public:
 	 */
 	[[nodiscard]] virtual glyph get_glyph(char32_t code, float size, bool sdf = false) const = 0;
 	
+	/**
+	 * Loads multiple glyphs.
+	 *
+	 * The default implementation loads each glyph in turn with get_glyph(). Implementations may load glyphs concurrently.
+	 *
+	 * @param codes UTF-32 character codes of the glyphs.
+	 * @param size Font size, in pixels.
+	 * @param sdf `true` to render signed distance field (SDF) glyph bitmaps, `false` otherwise.
+	 * 
+	 * @return Loaded glyphs, in the order of their character codes.
+	 */
+	[[nodiscard]] virtual std::vector<glyph> get_glyphs(std::span<const char32_t> codes, float size, bool sdf = false) const;
+	
 	/// @}
 	
 	/// @name Kerning
@@ -27,7 +27,7 @@ struct larva_component
 	/// ID of the cocoon entity.
 	entity::id cocoon_eid{entt::null};
 	
-	/// Material variable associated with the cocoon-spinning phase.
+	/// Material variable override associated with the cocoon-spinning phase.
 	std::shared_ptr<render::matvar_float> spinning_phase_matvar;
 };
 
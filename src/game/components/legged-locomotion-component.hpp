@@ -6,8 +6,12 @@
 
 #include <engine/math/vector.hpp>
 #include <engine/animation/skeleton-pose.hpp>
+#include <engine/animation/pose-blend-tree.hpp>
 #include <engine/animation/locomotion/gait.hpp>
+#include <engine/animation/locomotion/step-keypose.hpp>
+#include <engine/animation/ik/ik-chain-solver.hpp>
 #include <memory>
+#include <optional>
 #include <vector>
 
 /**
@@ -18,14 +22,24 @@ struct legged_locomotion_component
 	/// Force vector.
 	math::fvec3 force{0.0f, 0.0f, 0.0f};
 	
+	/// Pose of the body bone.
 	std::shared_ptr<skeleton_pose> midstance_pose{};
-	std::shared_ptr<skeleton_pose> midswing_pose{};
-	std::shared_ptr<skeleton_pose> liftoff_pose{};
-	std::shared_ptr<skeleton_pose> touchdown_pose{};
+	
+	/// Leg keyposes, sorted by ascending step phase. Legs are blended between the keyposes adjacent to their step phase.
+	std::vector<step_keypose> step_keyposes;
+	
+	/// Blends the leg keyposes of each leg into the current pose. Built from the step keyposes on the first update.
+	pose_blend_tree leg_pose_tree;
 	
 	/// Indices of the the final bones in the legs.
 	std::vector<std::size_t> tip_bones;
 	
+	/// IK solvers which plant the feet during the stance phase, one per leg in the order of the tip bones, or empty if the feet are not planted.
+	std::vector<std::shared_ptr<ik_chain_solver>> foot_ik_solvers;
+	
+	/// World-space positions at which the feet were planted at the start of their stance phase, or `std::nullopt` for feet in the swing phase.
+	std::vector<std::optional<math::fvec3>> foot_plant_positions;
+	
 	std::size_t body_bone{};
 	
 	/// Number of bones per leg.
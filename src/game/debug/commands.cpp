@@ -4,10 +4,21 @@
 #include "game/debug/commands.hpp"
 #include "game/debug/shell-buffer.hpp"
 #include "game/world.hpp"
+#include "game/fonts.hpp"
 #include <engine/config.hpp>
 #include "game/systems/astronomy-system.hpp"
 #include <engine/physics/time/constants.hpp>
 #include <engine/debug/log.hpp>
+#include <engine/gl/image-container.hpp>
+#include <engine/render/renderer.hpp>
+#include <engine/render/passes/bloom-pass.hpp>
+#include <engine/render/passes/clear-pass.hpp>
+#include <engine/render/passes/composite-pass.hpp>
+#include <engine/render/passes/material-pass.hpp>
+#include <engine/render/passes/sky-pass.hpp>
+#include <chrono>
+#include <filesystem>
+#include <format>
 
 namespace {
 	
@@ -117,6 +128,127 @@ namespace {
 		return 1;
 	}
 	
+	/** Prints the render statistics of the previous frame. */
+	int command_stats(std::span<const std::string> arguments, [[maybe_unused]] std::istream& cin, std::ostream& cout, [[maybe_unused]] std::ostream& cerr, const ::game* ctx)
+	{
+		if (arguments.size() != 1 || !ctx->renderer)
+		{
+			return 1;
+		}
+		
+		const auto ms = [](std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration<double, std::milli>(duration).count();
+		};
+		
+		const auto print_pipeline_statistics = [&](const gl::pipeline_statistics& statistics)
+		{
+			cout << std::format("  draws: {}; vertices: {}; instances: {}; clears: {}\n", statistics.draw_count, statistics.vertex_count, statistics.instance_count, statistics.clear_count);
+			cout << std::format("  framebuffer binds: {} ({} redundant); program binds: {} ({} redundant)\n", statistics.framebuffer_bind_count, statistics.redundant_framebuffer_bind_count, statistics.shader_program_bind_count, statistics.redundant_shader_program_bind_count);
+			cout << std::format("  vertex array binds: {}; vertex buffer binds: {}; uniform buffer binds: {}; state changes: {} ({} redundant)\n", statistics.vertex_array_bind_count, statistics.vertex_buffer_bind_count, statistics.uniform_buffer_bind_count, statistics.state_change_count, statistics.redundant_state_change_count);
+		};
+		
+		// Print frame statistics
+		const auto& frame = ctx->renderer->get_statistics();
+		cout << std::format("frame: {:.3f}ms; cameras: {}; objects: {}; operations: {}\n", ms(frame.cpu_time), frame.camera_count, frame.object_count, frame.operation_count);
+		cout << std::format("  light probe: {:.3f}ms; culling: {:.3f}ms; skinning: {:.3f}ms; shadows: {:.3f}ms; queue: {:.3f}ms; batching: {:.3f}ms; instancing: {:.3f}ms; compositors: {:.3f}ms\n", ms(frame.light_probe_stage_cpu_time), ms(frame.culling_stage_cpu_time), ms(frame.skinning_stage_cpu_time), ms(frame.cascaded_shadow_map_stage_cpu_time), ms(frame.queue_stage_cpu_time), ms(frame.batching_stage_cpu_time), ms(frame.instancing_stage_cpu_time), ms(frame.compositor_cpu_time));
+		print_pipeline_statistics(frame.pipeline);
+		
+		// Print pass statistics
+		const auto print_pass_statistics = [&](const char* name, const render::pass* pass)
+		{
+			if (!pass)
+			{
+				return;
+			}
+			
+			const auto& statistics = pass->get_statistics();
+			cout << std::format("{}: {:.3f}ms; operations: {}; uniforms: {}; textures: {}\n", name, ms(statistics.cpu_time), statistics.operation_count, statistics.uniform_upload_count, statistics.texture_bind_count);
+			print_pipeline_statistics(statistics.pipeline);
+		};
+		print_pass_statistics("clear pass", ctx->clear_pass.get());
+		print_pass_statistics("sky pass", ctx->sky_pass.get());
+		print_pass_statistics("scene material pass", ctx->scene_material_pass.get());
+		print_pass_statistics("bloom pass", ctx->bloom_pass.get());
+		print_pass_statistics("composite pass", ctx->composite_pass.get());
+		print_pass_statistics("ui material pass", ctx->ui_material_pass.get());
+		
+		// Print shader cache statistics
+		const auto& shader_cache = ctx->window->get_graphics_pipeline().get_shader_cache();
+		cout << std::format("shader cache hits: {}; misses: {}\n", shader_cache.get_hit_count(), shader_cache.get_miss_count());
+		
+		return 0;
+	}
+	
+	/** Bakes font atlases of the current fonts and language. */
+	int command_bakefonts(std::span<const std::string> arguments, [[maybe_unused]] std::istream& cin, std::ostream& cout, [[maybe_unused]] std::ostream& cerr, ::game* ctx)
+	{
+		if (arguments.size() != 1)
+		{
+			return 1;
+		}
+		
+		cout << std::format("baked {} font atlases to \"{}\"\n", bake_fonts(*ctx), ctx->resource_manager->get_write_path().string());
+		return 0;
+	}
+	
+	/** Bakes an image file into a pre-mipmapped image container, with the same path and the extension `.img`, in the write path. */
+	int command_bakeimage(std::span<const std::string> arguments, [[maybe_unused]] std::istream& cin, std::ostream& cout, std::ostream& cerr, ::game* ctx)
+	{
+		if (arguments.size() < 2)
+		{
+			return 1;
+		}
+		
+		// Parse options
+		bool srgb = false;
+		bool cube = false;
+		for (const auto& option: arguments.subspan(2))
+		{
+			if (option == "srgb")
+			{
+				srgb = true;
+			}
+			else if (option == "cube")
+			{
+				cube = true;
+			}
+			else
+			{
+				return 1;
+			}
+		}
+		
+		const std::filesystem::path image_path = arguments[1];
+		auto image_file = ctx->resource_manager->open_read(image_path);
+		if (!image_file)
+		{
+			return 404;
+		}
+		
+		// Decode image and generate its mip levels
+		gl::image_container container;
+		try
+		{
+			container = gl::bake_image_container(gl::decode_image(*image_file), 2, cube, srgb);
+		}
+		catch (const std::exception& e)
+		{
+			cerr << e.what() << '\n';
+			return 1;
+		}
+		
+		auto container_path = image_path;
+		container_path.replace_extension(".img");
+		if (!ctx->resource_manager->save(container, container_path))
+		{
+			return 1;
+		}
+		
+		cout << std::format("baked {} mip levels to \"{}\"\n", container.mip_levels, (ctx->resource_manager->get_write_path() / container_path).string());
+		return 0;
+	}
+	
 	int command_sound([[maybe_unused]] std::span<const std::string> arguments, [[maybe_unused]] std::istream& cin, [[maybe_unused]] std::ostream& cout, [[maybe_unused]] std::ostream& cerr, [[maybe_unused]] ::game* ctx)
 	{
 		// ctx->test_sound->play();
@@ -133,4 +265,7 @@ void register_commands(::shell& shell, ::game& ctx)
 	shell.set_command("time", std::bind_back(command_time, &ctx));
 	shell.set_command("timescale", std::bind_back(command_timescale, &ctx));
 	shell.set_command("sound", std::bind_back(command_sound, &ctx));
+	shell.set_command("stats", std::bind_back(command_stats, &ctx));
+	shell.set_command("bakefonts", std::bind_back(command_bakefonts, &ctx));
+	shell.set_command("bakeimage", std::bind_back(command_bakeimage, &ctx));
 }
@@ -3,12 +3,42 @@
 
 #include "game/fonts.hpp"
 #include <engine/type/font.hpp>
+#include <engine/type/font-atlas.hpp>
+#include <engine/type/unicode/convert.hpp>
 #include <engine/resources/resource-manager.hpp>
 #include <engine/render/material.hpp>
 #include <engine/render/material-flags.hpp>
 #include <engine/hash/fnv1a.hpp>
 #include "game/strings.hpp"
 #include <codecvt>
+#include <cmath>
+#include <format>
+
+namespace {
+	
+	/** Returns the path of the font atlas baked from a typeface at a given size. */
+	std::filesystem::path get_font_atlas_path(const std::filesystem::path& typeface_path, float size)
+	{
+		return std::format("{}-{}px.font", typeface_path.stem().string(), static_cast<int>(std::round(size)));
+	}
+	
+	/** Constructs a font from its baked font atlas, if one exists, otherwise constructs a font which rasterizes its glyphs at runtime. */
+	std::shared_ptr<type::font> make_font(::game& ctx, hash::fnv1a32_t typeface_name, float size)
+	{
+		const auto& typeface = ctx.typefaces[typeface_name];
+		
+		const auto atlas_path = get_font_atlas_path(ctx.typeface_paths[typeface_name], size);
+		if (ctx.resource_manager->exists(atlas_path))
+		{
+			if (auto atlas = ctx.resource_manager->load<type::font_atlas>(atlas_path); atlas && !atlas->sdf && atlas->size == std::round(size))
+			{
+				return std::make_shared<type::font>(typeface, std::move(atlas));
+			}
+		}
+		
+		return std::make_shared<type::font>(typeface, size);
+	}
+}
 
 void build_font_material(render::material& material, const type::font& font, std::shared_ptr<gl::shader_template> shader_template)
 {
@@ -40,7 +70,8 @@ void load_fonts(::game& ctx)
 		const auto& dyslexia_font_path = language["font_dyslexia"];
 		if (!dyslexia_font_path.is_null())
 		{
-			ctx.typefaces["dyslexia"] = ctx.resource_manager->load<type::typeface>(dyslexia_font_path);
+			ctx.typeface_paths["dyslexia"] = dyslexia_font_path.get<std::string>();
+			ctx.typefaces["dyslexia"] = ctx.resource_manager->load<type::typeface>(ctx.typeface_paths["dyslexia"]);
 			dyslexia_font_loaded = true;
 		}
 	}
@@ -52,17 +83,20 @@ void load_fonts(::game& ctx)
 		ctx.typefaces["serif"] = ctx.typefaces["dyslexia"];
 		ctx.typefaces["sans_serif"] = ctx.typefaces["dyslexia"];
 		ctx.typefaces["monospace"] = ctx.typefaces["dyslexia"];
+		ctx.typeface_paths["serif"] = ctx.typeface_paths["dyslexia"];
+		ctx.typeface_paths["sans_serif"] = ctx.typeface_paths["dyslexia"];
+		ctx.typeface_paths["monospace"] = ctx.typeface_paths["dyslexia"];
 	}
 	else
 	{
 		// Load standard typefaces
-		const auto serif_font_path = language["font_serif"];
-		const auto sans_serif_font_path = language["font_sans_serif"];
-		const auto monospace_font_path = language["font_monospace"];
+		ctx.typeface_paths["serif"] = language["font_serif"].get<std::string>();
+		ctx.typeface_paths["sans_serif"] = language["font_sans_serif"].get<std::string>();
+		ctx.typeface_paths["monospace"] = language["font_monospace"].get<std::string>();
 		
-		ctx.typefaces["serif"] = ctx.resource_manager->load<type::typeface>(serif_font_path);
-		ctx.typefaces["sans_serif"] = ctx.resource_manager->load<type::typeface>(sans_serif_font_path);
-		ctx.typefaces["monospace"] = ctx.resource_manager->load<type::typeface>(monospace_font_path);
+		ctx.typefaces["serif"] = ctx.resource_manager->load<type::typeface>(ctx.typeface_paths["serif"]);
+		ctx.typefaces["sans_serif"] = ctx.resource_manager->load<type::typeface>(ctx.typeface_paths["sans_serif"]);
+		ctx.typefaces["monospace"] = ctx.resource_manager->load<type::typeface>(ctx.typeface_paths["monospace"]);
 	}
 	
 	// Load bitmap font shader
@@ -75,21 +109,57 @@ void load_fonts(::game& ctx)
 	// Build debug font
 	if (auto it = ctx.typefaces.find("monospace"); it != ctx.typefaces.end())
 	{
-		ctx.debug_font = std::make_shared<type::font>(it->second, ctx.debug_font_size_pt * pt_to_px);
+		ctx.debug_font = make_font(ctx, "monospace", ctx.debug_font_size_pt * pt_to_px);
 		build_font_material(*ctx.debug_font_material, *ctx.debug_font, font_shader_template);
 	}
 	
 	// Build menu font
 	if (auto it = ctx.typefaces.find("sans_serif"); it != ctx.typefaces.end())
 	{
-		ctx.menu_font = std::make_shared<type::font>(it->second, ctx.menu_font_size_pt * pt_to_px);
+		ctx.menu_font = make_font(ctx, "sans_serif", ctx.menu_font_size_pt * pt_to_px);
 		build_font_material(*ctx.menu_font_material, *ctx.menu_font, font_shader_template);
 	}
 	
 	// Build title font
 	if (auto it = ctx.typefaces.find("serif"); it != ctx.typefaces.end())
 	{
-		ctx.title_font = std::make_shared<type::font>(it->second, ctx.title_font_size_pt * pt_to_px);
+		ctx.title_font = make_font(ctx, "serif", ctx.title_font_size_pt * pt_to_px);
 		build_font_material(*ctx.title_font_material, *ctx.title_font, font_shader_template);
 	}
 }
+
+std::size_t bake_fonts(::game& ctx)
+{
+	// Gather the characters of all strings in the current language, along with printable ASCII characters
+	std::u32string charset;
+	for (char32_t code = U' '; code <= U'~'; ++code)
+	{
+		charset += code;
+	}
+	for (const auto& string: *ctx.string_map)
+	{
+		if (string.is_string())
+		{
+			charset += type::unicode::u32(string.get_ref<const std::string&>());
+		}
+	}
+	
+	// Bake and save font atlases
+	std::size_t atlas_count = 0;
+	const auto bake_font = [&](const std::shared_ptr<type::font>& font, hash::fnv1a32_t typeface_name)
+	{
+		if (font && !font->is_sdf())
+		{
+			const auto atlas = type::bake_font_atlas(*font->get_typeface(), std::round(font->get_size()), false, charset);
+			if (ctx.resource_manager->save(atlas, get_font_atlas_path(ctx.typeface_paths[typeface_name], font->get_size())))
+			{
+				++atlas_count;
+			}
+		}
+	};
+	bake_font(ctx.debug_font, "monospace");
+	bake_font(ctx.menu_font, "sans_serif");
+	bake_font(ctx.title_font, "serif");
+	
+	return atlas_count;
+}
@@ -9,5 +9,14 @@
 
 void load_fonts(::game& ctx);
 
+/**
+ * Bakes the glyphs required by the current language into font atlases for the debug, menu, and title fonts, and saves them to the write path.
+ *
+ * Saved font atlases are loaded by load_fonts() in place of rasterizing glyphs at runtime, as long as the font sizes are unchanged.
+ *
+ * @return Number of font atlases saved.
+ */
+std::size_t bake_fonts(::game& ctx);
+
 
 #endif // ANTKEEPER_GAME_FONTS_HPP
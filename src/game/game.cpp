@@ -45,6 +45,7 @@
 #include <engine/config.hpp>
 #include <engine/debug/log.hpp>
 #include <engine/gl/framebuffer.hpp>
+#include <engine/gl/image-streamer.hpp>
 #include <engine/gl/pixel-format.hpp>
 #include <engine/gl/pixel-type.hpp>
 #include <engine/gl/texture.hpp>
@@ -149,7 +150,9 @@ game::~game()
 	(*settings)["maximized"] = maximized;
 	(*settings)["fullscreen"] = fullscreen;
 	
-	// Destruct window
+	// Stop streaming images, then destruct window
+	resource_manager->set_image_streamer(nullptr);
+	image_streamer.reset();
 	window.reset();
 	
 	// Save settings
@@ -627,6 +630,15 @@ void game::setup_rendering()
 	read_or_write_setting(*this, "anti_aliasing_method", *reinterpret_cast<std::underlying_type_t<render::anti_aliasing_method>*>(&anti_aliasing_method));
 	read_or_write_setting(*this, "shadow_map_resolution", shadow_map_resolution);
 	
+	// Cache shader program binaries under the write path, and pre-warm binaries cached in previous sessions
+	auto& shader_cache = window->get_graphics_pipeline().get_shader_cache();
+	shader_cache.set_directory(resource_manager->get_write_path() / "cache" / "shaders");
+	shader_cache.prewarm();
+	
+	// Decode 2D images on worker threads, uploading them between frames
+	image_streamer = std::make_unique<gl::image_streamer>(*resource_manager);
+	resource_manager->set_image_streamer(image_streamer.get());
+	
 	// Create framebuffers
 	::graphics::create_framebuffers(*this);
 	
@@ -1316,7 +1328,6 @@ void game::fixed_update(::frame_scheduler::duration_type fixed_update_time, ::fr
 	behavior_system->update(t, dt);
 	steering_system->update(t, dt);
 	locomotion_system->update(t, dt);
-	ik_system->update(t, dt);
 	reproductive_system->update(t, dt);
 	metabolic_system->update(t, dt);
 	metamorphosis_system->update(t, dt);
@@ -1352,6 +1363,12 @@ void game::variable_update([[maybe_unused]] ::frame_scheduler::duration_type fix
 	// Interpolate animation
 	animation_system->interpolate(alpha);
 	
+	// Solve IK on interpolated poses
+	ik_system->interpolate(alpha);
+	
+	// Upload streamed images
+	image_streamer->update();
+	
 	// Render
 	camera_system->interpolate(alpha);
 	render_system->draw(alpha);
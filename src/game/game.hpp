@@ -54,6 +54,11 @@ class resource_manager;
 class shell;
 class shell_buffer;
 
+namespace gl
+{
+	class image_streamer;
+}
+
 namespace render
 {
 	class bloom_pass;
@@ -127,6 +132,7 @@ public:
 	
 	// Resource management and paths
 	std::unique_ptr<resource_manager> resource_manager;
+	std::unique_ptr<gl::image_streamer> image_streamer;
 	std::filesystem::path data_package_path;
 	std::filesystem::path mods_path;
 	std::filesystem::path local_config_path;
@@ -164,6 +170,7 @@ public:
 	
 	// Fonts
 	std::unordered_map<hash::fnv1a32_t, std::shared_ptr<type::typeface>> typefaces;
+	std::unordered_map<hash::fnv1a32_t, std::filesystem::path> typeface_paths;
 	std::shared_ptr<type::font> debug_font;
 	std::shared_ptr<type::font> menu_font;
 	std::shared_ptr<type::font> title_font;
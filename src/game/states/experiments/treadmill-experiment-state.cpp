@@ -76,6 +76,7 @@
 #include <engine/geom/coordinates.hpp>
 #include <engine/ai/navmesh.hpp>
 #include <engine/animation/ik/constraints/euler-ik-constraint.hpp>
+#include <engine/animation/ik/solvers/fabrik-ik-solver.hpp>
 
 treadmill_experiment_state::treadmill_experiment_state(::game& ctx):
 	game_state(ctx)
@@ -237,9 +238,18 @@ treadmill_experiment_state::treadmill_experiment_state(::game& ctx):
 	
 	legged_locomotion_component worker_locomotion_component;
 	worker_locomotion_component.midstance_pose = generate_ant_midstance_pose(*worker_model->skeleton());
-	worker_locomotion_component.midswing_pose = generate_ant_midswing_pose(*worker_model->skeleton());
-	worker_locomotion_component.liftoff_pose = generate_ant_liftoff_pose(*worker_model->skeleton());
-	worker_locomotion_component.touchdown_pose = generate_ant_touchdown_pose(*worker_model->skeleton());
+	{
+		const std::shared_ptr<skeleton_pose> liftoff_pose = generate_ant_liftoff_pose(*worker_model->skeleton());
+		const std::shared_ptr<skeleton_pose> midswing_pose = generate_ant_midswing_pose(*worker_model->skeleton());
+		const std::shared_ptr<skeleton_pose> touchdown_pose = generate_ant_touchdown_pose(*worker_model->skeleton());
+		worker_locomotion_component.step_keyposes =
+		{
+			{-1.0f, touchdown_pose},
+			{0.0f, liftoff_pose},
+			{0.5f, midswing_pose},
+			{1.0f, touchdown_pose}
+		};
+	}
 	worker_locomotion_component.body_bone = worker_skeleton->bones().at("mesosoma").index();
 	worker_locomotion_component.tip_bones =
 	{
@@ -251,6 +261,18 @@ treadmill_experiment_state::treadmill_experiment_state(::game& ctx):
 		worker_skeleton->bones().at("metatarsomere1_r").index()
 	};
 	worker_locomotion_component.leg_bone_count = 4;
+	
+	// Plant worker feet by solving the coxa, femur, and tibia of each leg with FABRIK
+	for (const auto tip_bone: worker_locomotion_component.tip_bones)
+	{
+		const auto& tibia = *worker_skeleton->bones()[tip_bone].parent();
+		const auto& coxa = *tibia.parent()->parent();
+		
+		auto solver = std::make_shared<fabrik_ik_solver>(*worker_ik_rig, coxa.index(), tibia.index());
+		solver->set_effector_position(worker_skeleton->rest_pose().get_relative_transform(tip_bone).translation);
+		worker_ik_rig->add_solver(solver);
+		worker_locomotion_component.foot_ik_solvers.emplace_back(std::move(solver));
+	}
 	worker_locomotion_component.gait = std::make_shared<::gait>();
 	worker_locomotion_component.gait->frequency = 4.0f;
 	worker_locomotion_component.gait->steps.resize(6);
@@ -278,6 +300,7 @@ treadmill_experiment_state::treadmill_experiment_state(::game& ctx):
 	ctx.entity_registry->emplace<navmesh_agent_component>(worker_eid, std::move(worker_navmesh_agent_component));
 	ctx.entity_registry->emplace<pose_component>(worker_eid, std::move(worker_pose_component));
 	ctx.entity_registry->emplace<legged_locomotion_component>(worker_eid, std::move(worker_locomotion_component));
+	ctx.entity_registry->emplace<ik_component>(worker_eid, worker_ik_rig);
 	ctx.entity_registry->emplace<ant_caste_component>(worker_eid, std::move(worker_caste_component));
 	ctx.entity_registry->emplace<rigid_body_component>(worker_eid, std::move(worker_rigid_body_component));
 	ctx.entity_registry->emplace<ovary_component>(worker_eid, std::move(worker_ovary_component));
@@ -11,6 +11,7 @@
 #include <engine/render/material-flags.hpp>
 #include <engine/resources/resource-manager.hpp>
 #include <engine/gl/pipeline.hpp>
+#include <engine/gl/image-streamer.hpp>
 
 splash_state::splash_state(::game& ctx):
 	game_state(ctx)
@@ -20,8 +21,12 @@ splash_state::splash_state(::game& ctx):
 	const math::fvec2 viewport_size = math::fvec2(ctx.window->get_viewport_size());
 	const math::fvec2 viewport_center = viewport_size * 0.5f;
 	
-	// Load splash texture
+	// Load splash texture, waiting for its image to finish streaming
 	auto splash_texture = ctx.resource_manager->load<gl::texture_2d>("splash.tex");
+	if (ctx.image_streamer)
+	{
+		ctx.image_streamer->flush();
+	}
 	
 	// Get splash texture dimensions
 	const auto& splash_dimensions = splash_texture->get_image_view()->get_image()->get_dimensions();
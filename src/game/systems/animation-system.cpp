@@ -42,21 +42,9 @@ void animation_system::interpolate(float alpha)
 			auto& pose = pose_group.get<pose_component>(entity_id);
 			auto& scene = pose_group.get<scene_component>(entity_id);
 			
+			// Interpolate bone poses between previous and current states
 			auto& skeletal_mesh = static_cast<scene::skeletal_mesh&>(*scene.object);
-			for (std::size_t i = 0; i < skeletal_mesh.get_skeleton()->bones().size(); ++i)
-			{
-				const auto& previous_transform = pose.previous_pose.get_relative_transform(i);
-				const auto& current_transform = pose.current_pose.get_relative_transform(i);
-				
-				// Interpolate bone pose between previous and current states
-				math::transform<float> interpolated_transform;
-				interpolated_transform.translation = math::lerp(previous_transform.translation, current_transform.translation, alpha);
-				interpolated_transform.rotation = math::nlerp(previous_transform.rotation, current_transform.rotation, alpha);
-				interpolated_transform.scale = math::lerp(previous_transform.scale, current_transform.scale, alpha);
-				
-				// Update skeletal mesh bone pose with interpolated transform
-				skeletal_mesh.get_pose().set_relative_transform(i, interpolated_transform);
-			}
+			skeletal_mesh.get_pose().blend(pose.previous_pose, pose.current_pose, alpha);
 		}
 	);
 
@@ -65,21 +53,52 @@ void animation_system::interpolate(float alpha)
 
 	const auto dt = std::max(0.0f, m_render_time - m_previous_render_time);
 
+	// Collect playing animation players
+	m_concurrent_players.clear();
+	m_serial_players.clear();
 	auto animation_view = m_registry.view<animation_component>();
+	for (auto entity: animation_view)
+	{
+		auto& player = animation_view.get<animation_component>(entity).player;
+		if (!player.is_playing())
+		{
+			continue;
+		}
+
+		// Bind skeletal mesh pose to animation context
+		player.context().pose = nullptr;
+		if (auto scene = m_registry.try_get<scene_component>(entity); scene && scene->object && scene->object->get_object_type_id() == scene::skeletal_mesh::object_type_id)
+		{
+			player.context().pose = &static_cast<scene::skeletal_mesh&>(*scene->object).get_pose();
+		}
+
+		if (player.can_advance_concurrently())
+		{
+			m_concurrent_players.emplace_back(&player);
+		}
+		else
+		{
+			m_serial_players.emplace_back(&player);
+		}
+	}
+
+	// Advance players which only write to their own poses concurrently
 	std::for_each
 	(
-		std::execution::seq,
-		animation_view.begin(),
-		animation_view.end(),
-		[&](auto entity)
+		std::execution::par,
+		m_concurrent_players.begin(),
+		m_concurrent_players.end(),
+		[dt](animation_player* player)
 		{
-			auto& player = animation_view.get<animation_component>(entity).player;
-			if (player.is_playing())
-			{
-				player.advance(dt);
-			}
+			player->advance(dt);
 		}
 	);
+
+	// Advance players with output functions or cues serially
+	for (animation_player* player: m_serial_players)
+	{
+		player->advance(dt);
+	}
 }
 
 void animation_system::on_animation_construct(entity::registry& registry, entity::id entity)
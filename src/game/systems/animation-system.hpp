@@ -32,6 +32,9 @@ private:
 
 	float m_previous_render_time{};
 	float m_render_time{};
+
+	std::vector<animation_player*> m_concurrent_players;
+	std::vector<animation_player*> m_serial_players;
 };
 
 #endif // ANTKEEPER_GAME_ANIMATION_SYSTEM_HPP
@@ -12,18 +12,81 @@ ik_system::ik_system(entity::registry& registry):
 {}
 
 void ik_system::update([[maybe_unused]] float t, [[maybe_unused]] float dt)
+{}
+
+void ik_system::interpolate([[maybe_unused]] float alpha)
 {
+	// Collect IK rigs and the solvers of batchable rigs
+	m_rigs.clear();
+	m_batched_solvers.clear();
 	auto view = m_registry.view<ik_component>();
+	for (const auto entity_id: view)
+	{
+		const auto& component = view.get<ik_component>(entity_id);
+		if (!component.rig)
+		{
+			continue;
+		}
+
+		m_rigs.emplace_back(component.rig.get());
+		if (component.rig->is_batchable())
+		{
+			for (const auto& solver: component.rig->get_solvers())
+			{
+				m_batched_solvers.emplace_back(solver.get());
+			}
+		}
+	}
+
+	// Gather bone transforms of batchable rigs, serially within each rig
+	std::for_each
+	(
+		std::execution::par,
+		m_rigs.begin(),
+		m_rigs.end(),
+		[](auto rig)
+		{
+			if (rig->is_batchable())
+			{
+				for (const auto& solver: rig->get_solvers())
+				{
+					solver->gather();
+				}
+			}
+		}
+	);
+
+	// Solve all batched chains of all rigs in a single pass
+	std::for_each
+	(
+		std::execution::par,
+		m_batched_solvers.begin(),
+		m_batched_solvers.end(),
+		[](auto solver)
+		{
+			solver->solve_local();
+		}
+	);
+
+	// Write solutions back to the poses of batchable rigs, and solve other rigs in order
 	std::for_each
 	(
-		std::execution::par_unseq,
-		view.begin(),
-		view.end(),
-		[&](auto entity_id)
+		std::execution::par,
+		m_rigs.begin(),
+		m_rigs.end(),
+		[](auto rig)
 		{
-			const auto& component = view.get<ik_component>(entity_id);
-			
-			component.rig->solve();
+			if (rig->is_batchable())
+			{
+				for (const auto& solver: rig->get_solvers())
+				{
+					solver->scatter();
+				}
+			}
+			else
+			{
+				rig->solve();
+			}
 		}
 	);
 }
@@ -5,9 +5,19 @@
 #define ANTKEEPER_GAME_IK_SYSTEM_HPP
 
 #include "game/systems/updatable-system.hpp"
+#include <vector>
+
+class ik_rig;
+class ik_solver;
 
 /**
- * 
+ * Solves the IK rigs of all entities.
+ *
+ * IK rigs are solved on interpolated poses, after the animation system has interpolated them, such that their solutions are not overwritten.
+ *
+ * Solvers of batchable rigs are solved together in a single parallel pass, between serial gather and scatter phases within each rig. Rigs which are not batchable, because they have unbatchable solvers or dependent bone chains, are solved in order.
+ *
+ * @see ik_rig::is_batchable()
  */
 class ik_system:
 	public updatable_system
@@ -16,6 +26,17 @@ public:
 	explicit ik_system(entity::registry& registry);
 	~ik_system() override = default;
 	void update(float t, float dt) override;
+
+	/**
+	 * Solves the IK rigs of all entities.
+	 *
+	 * @param alpha Subframe interpolation factor.
+	 */
+	void interpolate(float alpha);
+
+private:
+	std::vector<ik_rig*> m_rigs;
+	std::vector<ik_solver*> m_batched_solvers;
 };
 
 #endif // ANTKEEPER_GAME_IK_SYSTEM_HPP
@@ -16,6 +16,46 @@
 #include <algorithm>
 #include <execution>
 
+namespace {
+
+/**
+ * Builds a pose blend tree which blends the step keyposes of each leg onto the current pose.
+ *
+ * Node `0` samples the current pose. Each leg `i` is followed by one pose node per step keypose, starting at node `1 + i * (keypose_count + 1)`, and a node which blends them. Each leg is then layered onto the current pose. The blend and layer nodes of a leg are masked to the bones of the leg, so each leg only blends its own bones.
+ */
+void build_leg_pose_tree(legged_locomotion_component& locomotion, const skeleton& skeleton)
+{
+	auto& tree = locomotion.leg_pose_tree;
+	tree = pose_blend_tree(skeleton);
+	
+	const auto base_node = tree.add_pose_node(nullptr);
+	
+	// Mask each leg to its chain of bones, such that its keyposes are only blended for the bones of the leg
+	std::vector<std::shared_ptr<bone_mask>> leg_masks;
+	std::vector<std::size_t> leg_nodes;
+	std::vector<std::size_t> keypose_nodes;
+	for (std::size_t i = 0; i < locomotion.tip_bones.size(); ++i)
+	{
+		auto& mask = leg_masks.emplace_back(std::make_shared<bone_mask>(skeleton));
+		mask->set_chain_weight(skeleton.bones()[locomotion.tip_bones[i]], locomotion.leg_bone_count, 1.0f);
+		
+		keypose_nodes.clear();
+		for (const auto& keypose: locomotion.step_keyposes)
+		{
+			keypose_nodes.emplace_back(tree.add_pose_node(keypose.pose.get()));
+		}
+		leg_nodes.emplace_back(tree.add_blend_node(keypose_nodes, mask));
+	}
+	
+	auto layer_node = base_node;
+	for (std::size_t i = 0; i < leg_nodes.size(); ++i)
+	{
+		layer_node = tree.add_layer_node(layer_node, leg_nodes[i], pose_blend_mode::override, std::move(leg_masks[i]));
+	}
+}
+
+} // namespace
+
 locomotion_system::locomotion_system(entity::registry& registry):
 	updatable_system(registry)
 {}
@@ -139,39 +179,43 @@ void locomotion_system::update_legged([[maybe_unused]] float t, float dt)
 				body_xf.translation.y() += locomotion.standing_height;// - std::sin(locomotion.gait_phase * math::four_pi<float>) * 0.025f;
 				pose_component.current_pose.set_relative_transform(locomotion.body_bone, body_xf);
 				
+				// Build leg pose blend tree
+				const auto keypose_count = locomotion.step_keyposes.size();
+				if (keypose_count < 2)
+				{
+					return;
+				}
+				if (locomotion.leg_pose_tree.empty())
+				{
+					build_leg_pose_tree(locomotion, *pose_component.current_pose.get_skeleton());
+				}
+				
 				// For each leg
 				for (std::size_t i = 0; i < locomotion.tip_bones.size(); ++i)
 				{
 					// Determine step phase
 					float step_phase = locomotion.gait->steps[i].phase(locomotion.gait_phase);
 					
-					// Determine leg pose
-					const skeleton_pose* pose_a;
-					const skeleton_pose* pose_b;
-					float t;
-					if (step_phase < 0.0f)
+					// Find keyposes adjacent to the step phase
+					std::size_t k = 0;
+					while (k + 2 < keypose_count && step_phase >= locomotion.step_keyposes[k + 1].phase)
 					{
-						pose_b = locomotion.touchdown_pose.get();
-						pose_a = locomotion.liftoff_pose.get();
-						t = std::abs(step_phase);
+						++k;
 					}
-					else
+					const auto phase_a = locomotion.step_keyposes[k].phase;
+					const auto phase_b = locomotion.step_keyposes[k + 1].phase;
+					const auto t = std::clamp((step_phase - phase_a) / (phase_b - phase_a), 0.0f, 1.0f);
+					
+					// Weight leg keypose nodes
+					const auto first_keypose_node = 1 + i * (keypose_count + 1);
+					for (std::size_t j = 0; j < keypose_count; ++j)
 					{
-						if (step_phase < 0.5f)
-						{
-							pose_a = locomotion.liftoff_pose.get();
-							pose_b = locomotion.midswing_pose.get();
-							t = step_phase * 2.0f;
-						}
-						else
-						{
-							pose_a = locomotion.midswing_pose.get();
-							pose_b = locomotion.touchdown_pose.get();
-							t = (step_phase - 0.5f) * 2.0f;
-						}
+						locomotion.leg_pose_tree.set_weight(first_keypose_node + j, 0.0f);
 					}
+					locomotion.leg_pose_tree.set_weight(first_keypose_node + k, 1.0f - t);
+					locomotion.leg_pose_tree.set_weight(first_keypose_node + k + 1, t);
 					
-					// Update leg bones
+					// Update previous pose of leg bones
 					auto bone_index = locomotion.tip_bones[i];
 					for (std::uint8_t j = 0; j < locomotion.leg_bone_count; ++j)
 					{
@@ -180,15 +224,39 @@ void locomotion_system::update_legged([[maybe_unused]] float t, float dt)
 							bone_index = pose_component.current_pose.get_skeleton()->bones()[bone_index].parent()->index();
 						}
 						
-						// Update previous pose of leg bone
 						pose_component.previous_pose.set_relative_transform(bone_index, pose_component.current_pose.get_relative_transform(bone_index));
+					}
+				}
+				
+				// Blend leg keyposes into current pose
+				locomotion.leg_pose_tree.set_pose(0, &pose_component.current_pose);
+				locomotion.leg_pose_tree.evaluate(pose_component.current_pose);
+				
+				// Plant feet during the stance phase
+				if (!locomotion.foot_ik_solvers.empty())
+				{
+					const auto& body_transform = legged_group.get<rigid_body_component>(entity_id).body->get_transform();
+					locomotion.foot_plant_positions.resize(locomotion.tip_bones.size());
+					for (std::size_t i = 0; i < locomotion.tip_bones.size(); ++i)
+					{
+						const auto foot_position = body_transform * pose_component.current_pose.get_absolute_transform(locomotion.tip_bones[i]).translation;
+						
+						auto& plant_position = locomotion.foot_plant_positions[i];
+						if (locomotion.gait->steps[i].phase(locomotion.gait_phase) < 0.0f)
+						{
+							// Keep foot where it touched down
+							if (!plant_position)
+							{
+								plant_position = foot_position;
+							}
+						}
+						else
+						{
+							plant_position.reset();
+						}
 						
-						// Update current pose of leg bone
-						auto transform = pose_a->get_relative_transform(bone_index);
-						const auto rotation_a = pose_a->get_relative_transform(bone_index).rotation;
-						const auto rotation_b = pose_b->get_relative_transform(bone_index).rotation;
-						transform.rotation = math::nlerp(rotation_a, rotation_b, t);
-						pose_component.current_pose.set_relative_transform(bone_index, transform);
+						// Follow the animated foot while it swings
+						locomotion.foot_ik_solvers[i]->set_goal_center(plant_position ? *plant_position : foot_position);
 					}
 				}
 			}
@@ -109,15 +109,9 @@ void metamorphosis_system::update([[maybe_unused]] float t, float dt)
 					auto cocoon_mesh = std::make_shared<scene::static_mesh>(genome.pupa->phenes.front().cocoon_model);
 					cocoon_mesh->set_transform(rigid_body.get_transform());
 					
-					// Construct copy of cocoon material
-					auto cocoon_material = std::make_shared<render::material>(*cocoon_mesh->get_model()->materials().front());
-					
-					// Store cocoon material spinning phase variable
-					larva.spinning_phase_matvar = std::static_pointer_cast<render::matvar_float>(cocoon_material->get_variable("spinning_phase"));
-					larva.spinning_phase_matvar->set(0.0f);
-					
-					// Replace cocoon mesh material
-					cocoon_mesh->set_material(0, std::move(cocoon_material));
+					// Override spinning phase of the shared cocoon material
+					larva.spinning_phase_matvar = std::make_shared<render::matvar_float>(1, 0.0f);
+					cocoon_mesh->set_material_override("spinning_phase", larva.spinning_phase_matvar);
 					
 					// Construct cocoon entity
 					larva.cocoon_eid = m_registry.create();
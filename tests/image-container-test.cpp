@@ -0,0 +1,392 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Verifies that image containers survive a serialize and deserialize round trip unchanged, for 2D, 2D array, and cube images of non-power-of-two sizes, and that container files whose size overflows are rejected.
+
+#include "test.hpp"
+#include <engine/gl/image-container.hpp>
+#include <engine/gl/image-data.hpp>
+#include <engine/resources/deserialize-context.hpp>
+#include <engine/resources/deserialize-error.hpp>
+#include <engine/resources/deserializer.hpp>
+#include <engine/resources/serialize-context.hpp>
+#include <engine/resources/serializer.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// Serialize context which writes to memory.
+class memory_serialize_context: public serialize_context
+{
+public:
+	[[nodiscard]] const std::filesystem::path& path() const noexcept override
+	{
+		return m_path;
+	}
+	
+	[[nodiscard]] bool error() const noexcept override
+	{
+		return false;
+	}
+	
+	std::size_t write8(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::native>(data, count, 1);
+	}
+	
+	std::size_t write16_le(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::little>(data, count, 2);
+	}
+	
+	std::size_t write16_be(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::big>(data, count, 2);
+	}
+	
+	std::size_t write32_le(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::little>(data, count, 4);
+	}
+	
+	std::size_t write32_be(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::big>(data, count, 4);
+	}
+	
+	std::size_t write64_le(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::little>(data, count, 8);
+	}
+	
+	std::size_t write64_be(const std::byte* data, std::size_t count) override
+	{
+		return write<std::endian::big>(data, count, 8);
+	}
+	
+	/// Written bytes.
+	std::vector<std::byte> bytes;
+	
+private:
+	template <std::endian Endian>
+	std::size_t write(const std::byte* data, std::size_t count, std::size_t word_size)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const auto first = bytes.size();
+			bytes.insert(bytes.end(), data + i * word_size, data + (i + 1) * word_size);
+			if constexpr (Endian != std::endian::native)
+			{
+				std::reverse(bytes.begin() + static_cast<std::ptrdiff_t>(first), bytes.end());
+			}
+		}
+		
+		return count;
+	}
+	
+	std::filesystem::path m_path{"image.img"};
+};
+
+/// Deserialize context which reads from memory.
+class memory_deserialize_context: public deserialize_context
+{
+public:
+	explicit memory_deserialize_context(std::vector<std::byte> bytes):
+		m_bytes(std::move(bytes))
+	{}
+	
+	[[nodiscard]] const std::filesystem::path& path() const noexcept override
+	{
+		return m_path;
+	}
+	
+	[[nodiscard]] bool error() const noexcept override
+	{
+		return false;
+	}
+	
+	[[nodiscard]] bool eof() const noexcept override
+	{
+		return m_position == m_bytes.size();
+	}
+	
+	[[nodiscard]] std::size_t size() const noexcept override
+	{
+		return m_bytes.size();
+	}
+	
+	[[nodiscard]] std::size_t tell() const override
+	{
+		return m_position;
+	}
+	
+	void seek(std::size_t offset) override
+	{
+		m_position = std::min(offset, m_bytes.size());
+	}
+	
+	std::size_t read8(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::native>(data, count, 1);
+	}
+	
+	std::size_t read16_le(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::little>(data, count, 2);
+	}
+	
+	std::size_t read16_be(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::big>(data, count, 2);
+	}
+	
+	std::size_t read32_le(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::little>(data, count, 4);
+	}
+	
+	std::size_t read32_be(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::big>(data, count, 4);
+	}
+	
+	std::size_t read64_le(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::little>(data, count, 8);
+	}
+	
+	std::size_t read64_be(std::byte* data, std::size_t count) override
+	{
+		return read<std::endian::big>(data, count, 8);
+	}
+	
+private:
+	template <std::endian Endian>
+	std::size_t read(std::byte* data, std::size_t count, std::size_t word_size)
+	{
+		if (count > (m_bytes.size() - m_position) / word_size)
+		{
+			throw deserialize_error("Read past end of memory.");
+		}
+		
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			std::memcpy(data + i * word_size, m_bytes.data() + m_position, word_size);
+			if constexpr (Endian != std::endian::native)
+			{
+				std::reverse(data + i * word_size, data + (i + 1) * word_size);
+			}
+			m_position += word_size;
+		}
+		
+		return count;
+	}
+	
+	std::vector<std::byte> m_bytes;
+	std::size_t m_position{0};
+	std::filesystem::path m_path{"image.img"};
+};
+
+/// Returns the bytes of an image container file.
+[[nodiscard]] std::vector<std::byte> serialize(const gl::image_container& container)
+{
+	memory_serialize_context ctx;
+	serializer<gl::image_container>().serialize(container, ctx);
+	return std::move(ctx.bytes);
+}
+
+/// Deserializes an image container file.
+[[nodiscard]] gl::image_container deserialize(std::vector<std::byte> bytes)
+{
+	memory_deserialize_context ctx(std::move(bytes));
+	gl::image_container container;
+	deserializer<gl::image_container>().deserialize(container, ctx);
+	return container;
+}
+
+/// Fills bytes with a pattern which differs between neighboring bytes.
+void fill_pattern(std::span<std::byte> bytes)
+{
+	for (std::size_t i = 0; i < bytes.size(); ++i)
+	{
+		bytes[i] = static_cast<std::byte>(i * 31 + 7);
+	}
+}
+
+/// Returns decoded image data filled with a pattern.
+[[nodiscard]] gl::image_data make_image_data(gl::format format, std::size_t texel_size, std::uint32_t width, std::uint32_t height)
+{
+	gl::image_data data;
+	data.format = format;
+	data.dimensions = {width, height};
+	data.pixels.resize(texel_size * width * height);
+	fill_pattern(data.pixels);
+	return data;
+}
+
+/// Checks that an image container is unchanged by a serialize and deserialize round trip.
+void check_round_trip(const gl::image_container& container, std::string_view name)
+{
+	gl::image_container result;
+	try
+	{
+		result = deserialize(serialize(container));
+	}
+	catch (const std::exception& e)
+	{
+		test::check(false, std::format("{} round trip: {}", name, e.what()));
+		return;
+	}
+	
+	test::check(result.format == container.format, std::format("{} format round trips", name));
+	test::check(result.dimensionality == container.dimensionality, std::format("{} dimensionality round trips", name));
+	test::check(result.dimensions == container.dimensions, std::format("{} dimensions round trip", name));
+	test::check(result.mip_levels == container.mip_levels, std::format("{} mip level count round trips", name));
+	test::check(result.array_layers == container.array_layers, std::format("{} array layer count round trips", name));
+	test::check(result.cube == container.cube, std::format("{} cube flag round trips", name));
+	
+	if (result.mip_levels != container.mip_levels || result.data.size() != container.data.size())
+	{
+		test::check(false, std::format("{} data size round trips", name));
+		return;
+	}
+	
+	for (std::uint32_t level = 0; level < container.mip_levels; ++level)
+	{
+		const auto expected = container.get_mip_data(level);
+		const auto actual = result.get_mip_data(level);
+		test::check(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()), std::format("{} mip level {} round trips", name, level));
+	}
+}
+
+void test_2d()
+{
+	// Non-power-of-two dimensions, whose mip levels round down
+	const auto rgba = gl::bake_image_container(make_image_data(gl::format::r8g8b8a8_unorm, 4, 37, 23), 2);
+	test::check(rgba.mip_levels == 6, "complete mipmap chain of a 37x23 image has 6 levels");
+	test::check(rgba.get_mip_dimensions(5) == std::array<std::uint32_t, 3>{1, 1, 1}, "last mip level of a 37x23 image is 1x1");
+	check_round_trip(rgba, "37x23 r8g8b8a8_unorm");
+	
+	const auto column = gl::bake_image_container(make_image_data(gl::format::r32_sfloat, 4, 1, 13), 2);
+	check_round_trip(column, "1x13 r32_sfloat");
+	
+	const auto srgb = gl::bake_image_container(make_image_data(gl::format::r8g8b8_srgb, 3, 100, 60), 2, false, false, 3);
+	test::check(srgb.mip_levels == 3, "requested mip level count is baked");
+	check_round_trip(srgb, "100x60 r8g8b8_srgb");
+}
+
+void test_2d_array()
+{
+	gl::image_container container;
+	container.format = gl::format::r16g16_unorm;
+	container.dimensionality = 2;
+	container.dimensions = {12, 5, 1};
+	container.mip_levels = 4;
+	container.array_layers = 3;
+	container.data.resize(container.get_mip_offset(container.mip_levels));
+	fill_pattern(container.data);
+	
+	test::check(container.get_mip_size(0) == 12 * 5 * 3 * 4, "mip level size includes all array layers");
+	check_round_trip(container, "12x5x3 r16g16_unorm array");
+}
+
+void test_cube()
+{
+	constexpr std::uint32_t face_width = 6;
+	
+	struct cube_layout
+	{
+		std::string_view name;
+		std::uint32_t width;
+		std::uint32_t height;
+	};
+	
+	const cube_layout layouts[] =
+	{
+		{"column", face_width, face_width * 6},
+		{"row", face_width * 6, face_width},
+		{"vertical cross", face_width * 3, face_width * 4},
+		{"horizontal cross", face_width * 4, face_width * 3}
+	};
+	
+	for (const auto& layout: layouts)
+	{
+		const auto name = std::format("{} cube", layout.name);
+		
+		gl::image_container container;
+		try
+		{
+			container = gl::bake_image_container(make_image_data(gl::format::r8g8b8a8_srgb, 4, layout.width, layout.height), 2, true);
+		}
+		catch (const std::exception& e)
+		{
+			test::check(false, std::format("{} bakes: {}", name, e.what()));
+			continue;
+		}
+		
+		test::check(container.cube && container.array_layers == 6, std::format("{} has six faces", name));
+		test::check(container.dimensions == std::array<std::uint32_t, 3>{face_width, face_width, 1}, std::format("{} has the dimensions of a face", name));
+		check_round_trip(container, name);
+	}
+}
+
+void test_invalid_files()
+{
+	// Dimensions whose size overflows
+	gl::image_container overflowing;
+	overflowing.format = gl::format::r32g32b32a32_sfloat;
+	overflowing.dimensions = {std::uint32_t{1} << 31, std::uint32_t{1} << 31, 1};
+	overflowing.array_layers = std::uint32_t{1} << 31;
+	test::check(overflowing.get_mip_size(0) == 0, "mip level size which overflows is zero");
+	
+	// Header of a file whose data size wraps around to zero, without any data
+	const std::uint32_t header[10] =
+	{
+		0x4d494b41,
+		1,
+		static_cast<std::uint32_t>(gl::format::r32g32b32a32_sfloat),
+		2,
+		std::uint32_t{1} << 31,
+		std::uint32_t{1} << 31,
+		1,
+		1,
+		std::uint32_t{1} << 31,
+		0
+	};
+	memory_serialize_context header_ctx;
+	header_ctx.write32<std::endian::little>(reinterpret_cast<const std::byte*>(header), 10);
+	test::check_throws<deserialize_error>([&](){(void)deserialize(header_ctx.bytes);}, "file whose data size overflows is rejected");
+	
+	// Truncated and padded files
+	const auto valid = gl::bake_image_container(make_image_data(gl::format::r8_unorm, 1, 9, 7), 2);
+	auto truncated = serialize(valid);
+	truncated.pop_back();
+	test::check_throws<deserialize_error>([&](){(void)deserialize(truncated);}, "truncated file is rejected");
+	auto padded = serialize(valid);
+	padded.emplace_back();
+	test::check_throws<deserialize_error>([&](){(void)deserialize(padded);}, "padded file is rejected");
+}
+
+} // namespace
+
+int main()
+{
+	test_2d();
+	test_2d_array();
+	test_cube();
+	test_invalid_files();
+	
+	return test::result();
+}
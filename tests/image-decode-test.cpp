@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Verifies that images decoded concurrently on worker threads, as by the image streamer, match images decoded synchronously, for a directory of images in each supported file format.
+
+#include "test.hpp"
+#include <engine/gl/image-data.hpp>
+#include <engine/resources/resource-manager.hpp>
+#include <stb/stb_image_write.h>
+#include <tinyexr.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Dimensions of the test images, which are not powers of two.
+constexpr int image_width = 37;
+constexpr int image_height = 23;
+
+/// Number of worker threads which decode images.
+constexpr std::size_t worker_count = 4;
+
+/// Returns the value of a component of a pixel in a test image, such that every row differs.
+[[nodiscard]] constexpr std::uint8_t pattern(int x, int y, int component) noexcept
+{
+	return static_cast<std::uint8_t>(x * 7 + y * 13 + component * 61);
+}
+
+/// Returns an 8-bit test image, ordered top row first.
+[[nodiscard]] std::vector<std::uint8_t> make_ldr_pixels(int components)
+{
+	std::vector<std::uint8_t> pixels(static_cast<std::size_t>(image_width * image_height * components));
+	for (int y = 0; y < image_height; ++y)
+	{
+		for (int x = 0; x < image_width; ++x)
+		{
+			for (int c = 0; c < components; ++c)
+			{
+				pixels[static_cast<std::size_t>((y * image_width + x) * components + c)] = pattern(x, y, c);
+			}
+		}
+	}
+	
+	return pixels;
+}
+
+/// Returns a floating-point test image, ordered top row first.
+[[nodiscard]] std::vector<float> make_hdr_pixels(int components)
+{
+	const auto ldr_pixels = make_ldr_pixels(components);
+	std::vector<float> pixels(ldr_pixels.size());
+	std::transform
+	(
+		ldr_pixels.begin(),
+		ldr_pixels.end(),
+		pixels.begin(),
+		[](std::uint8_t value)
+		{
+			return static_cast<float>(value) / 16.0f;
+		}
+	);
+	return pixels;
+}
+
+/// Writes a directory of test images, returning their file names.
+[[nodiscard]] std::vector<std::string> write_images(const std::filesystem::path& directory)
+{
+	std::vector<std::string> file_names;
+	const auto path = [&](const std::string& file_name)
+	{
+		file_names.emplace_back(file_name);
+		return (directory / file_name).string();
+	};
+	
+	for (int components = 1; components <= 4; ++components)
+	{
+		const auto pixels = make_ldr_pixels(components);
+		stbi_write_png(path(std::format("image-{}.png", components)).c_str(), image_width, image_height, components, pixels.data(), image_width * components);
+		stbi_write_tga(path(std::format("image-{}.tga", components)).c_str(), image_width, image_height, components, pixels.data());
+	}
+	
+	const auto rgb_pixels = make_ldr_pixels(3);
+	stbi_write_bmp(path("image.bmp").c_str(), image_width, image_height, 3, rgb_pixels.data());
+	stbi_write_jpg(path("image.jpg").c_str(), image_width, image_height, 3, rgb_pixels.data(), 90);
+	
+	const auto hdr_pixels = make_hdr_pixels(3);
+	stbi_write_hdr(path("image.hdr").c_str(), image_width, image_height, 3, hdr_pixels.data());
+	
+	const auto exr_pixels = make_hdr_pixels(4);
+	const char* error = nullptr;
+	if (SaveEXR(exr_pixels.data(), image_width, image_height, 4, 0, path("image.exr").c_str(), &error) != TINYEXR_SUCCESS)
+	{
+		test::check(false, std::format("write OpenEXR image: {}", error ? error : ""));
+		FreeEXRErrorMessage(error);
+		file_names.pop_back();
+	}
+	
+	return file_names;
+}
+
+/// Decodes an image file.
+[[nodiscard]] gl::image_data decode(const resource_manager& resources, const std::string& file_name)
+{
+	auto ctx = resources.open_read(file_name);
+	if (!ctx)
+	{
+		throw std::runtime_error("Failed to open image file.");
+	}
+	
+	return gl::decode_image(*ctx);
+}
+
+void test_decode(const std::filesystem::path& directory)
+{
+	const auto file_names = write_images(directory);
+	
+	resource_manager resources;
+	test::check(resources.mount(directory), "mount image directory");
+	
+	// Decode images synchronously
+	std::vector<gl::image_data> sync_images(file_names.size());
+	for (std::size_t i = 0; i < file_names.size(); ++i)
+	{
+		try
+		{
+			sync_images[i] = decode(resources, file_names[i]);
+		}
+		catch (const std::exception& e)
+		{
+			test::check(false, std::format("{} decoded synchronously: {}", file_names[i], e.what()));
+		}
+	}
+	
+	// Decode images concurrently, with each worker taking the next undecoded image
+	std::vector<gl::image_data> async_images(file_names.size());
+	std::vector<std::string> async_errors(file_names.size());
+	std::atomic<std::size_t> next_image{0};
+	{
+		std::vector<std::jthread> workers;
+		for (std::size_t i = 0; i < worker_count; ++i)
+		{
+			workers.emplace_back
+			(
+				[&]()
+				{
+					for (std::size_t j = next_image++; j < file_names.size(); j = next_image++)
+					{
+						try
+						{
+							async_images[j] = decode(resources, file_names[j]);
+						}
+						catch (const std::exception& e)
+						{
+							async_errors[j] = e.what();
+						}
+					}
+				}
+			);
+		}
+	}
+	
+	for (std::size_t i = 0; i < file_names.size(); ++i)
+	{
+		const auto& sync_image = sync_images[i];
+		const auto& async_image = async_images[i];
+		const auto& file_name = file_names[i];
+		
+		test::check(async_errors[i].empty(), std::format("{} decoded on a worker thread: {}", file_name, async_errors[i]));
+		test::check(sync_image.format != gl::format::undefined, std::format("{} has a format", file_name));
+		test::check(sync_image.dimensions[0] == static_cast<std::uint32_t>(image_width) && sync_image.dimensions[1] == static_cast<std::uint32_t>(image_height), std::format("{} has the dimensions of the written image", file_name));
+		test::check(async_image.format == sync_image.format, std::format("{} has the same format when decoded on a worker thread", file_name));
+		test::check(async_image.dimensions == sync_image.dimensions, std::format("{} has the same dimensions when decoded on a worker thread", file_name));
+		test::check(async_image.pixels == sync_image.pixels, std::format("{} has the same pixels when decoded on a worker thread", file_name));
+	}
+	
+	// Lossless 8-bit images are decoded exactly, bottom row first
+	const auto rgba_pixels = make_ldr_pixels(4);
+	for (std::size_t i = 0; i < file_names.size(); ++i)
+	{
+		if (file_names[i] != "image-4.png" && file_names[i] != "image-4.tga")
+		{
+			continue;
+		}
+		
+		const auto& pixels = async_images[i].pixels;
+		const std::size_t row_size = static_cast<std::size_t>(image_width) * 4;
+		const std::size_t row_count = static_cast<std::size_t>(image_height);
+		bool flipped = pixels.size() == rgba_pixels.size();
+		for (std::size_t y = 0; flipped && y < row_count; ++y)
+		{
+			flipped = !std::memcmp(pixels.data() + y * row_size, rgba_pixels.data() + (row_count - 1 - y) * row_size, row_size);
+		}
+		test::check(flipped, std::format("{} has the written pixels, bottom row first", file_names[i]));
+	}
+}
+
+} // namespace
+
+int main()
+{
+	const auto directory = std::filesystem::temp_directory_path() / "antkeeper-image-decode-test";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	
+	test_decode(directory);
+	
+	std::filesystem::remove_all(directory);
+	
+	return test::result();
+}
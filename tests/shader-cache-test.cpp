@@ -0,0 +1,294 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Verifies shader cache keys, the validation and removal of cache files, and the pre-warming of binaries stored by earlier sessions, headless with the null OpenGL backend.
+
+#include "test.hpp"
+#include <engine/gl/null-backend.hpp>
+#include <engine/gl/shader-cache.hpp>
+#include <engine/gl/shader-program-binary.hpp>
+#include <engine/gl/shader-template.hpp>
+#include <engine/utility/text-file.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace {
+
+/// Identity of the graphics driver which writes cache files.
+constexpr const char* driver_identity = "Vendor A, Renderer A, 4.6.0";
+
+/// Returns a shader program binary whose bytes differ from those of other keys.
+[[nodiscard]] gl::shader_program_binary make_binary(std::uint32_t format, std::size_t size)
+{
+	gl::shader_program_binary binary;
+	binary.format = format;
+	binary.data.resize(size);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		binary.data[i] = static_cast<std::byte>(i * 31 + format);
+	}
+	
+	return binary;
+}
+
+/// Checks whether a loaded binary equals a stored binary.
+[[nodiscard]] bool equal(const std::optional<gl::shader_program_binary>& loaded, const gl::shader_program_binary& stored)
+{
+	return loaded && loaded->format == stored.format && loaded->data == stored.data;
+}
+
+/// Returns the path to the cache file of a cache key.
+[[nodiscard]] std::filesystem::path cache_file_path(const gl::shader_cache& cache, std::uint64_t key)
+{
+	return cache.get_directory() / std::format("{:016x}.bin", key);
+}
+
+void test_make_key()
+{
+	const gl::shader_cache cache(driver_identity);
+	
+	// Same definitions, inserted in opposite orders into maps of different bucket counts
+	gl::shader_template::dictionary_type definitions;
+	definitions["POINT_LIGHT_COUNT"] = "4";
+	definitions["SPOT_LIGHT_COUNT"] = "2";
+	definitions["DIRECTIONAL_LIGHT_COUNT"] = "1";
+	definitions["CLUSTERED_LIGHTING"] = "1";
+	gl::shader_template::dictionary_type reordered_definitions;
+	reordered_definitions.reserve(64);
+	reordered_definitions["CLUSTERED_LIGHTING"] = "1";
+	reordered_definitions["DIRECTIONAL_LIGHT_COUNT"] = "1";
+	reordered_definitions["SPOT_LIGHT_COUNT"] = "2";
+	reordered_definitions["POINT_LIGHT_COUNT"] = "4";
+	
+	const auto key = cache.make_key(0x1234, definitions);
+	test::check(cache.make_key(0x1234, reordered_definitions) == key, "key is independent of the order of definitions");
+	test::check(cache.make_key(0x1234, definitions) == key, "key is deterministic");
+	
+	auto changed_definitions = definitions;
+	changed_definitions["SPOT_LIGHT_COUNT"] = "3";
+	test::check(cache.make_key(0x1234, changed_definitions) != key, "key changes with a definition value");
+	
+	auto added_definitions = definitions;
+	added_definitions["LIGHT_BLOCK_BINDING"] = "2";
+	test::check(cache.make_key(0x1234, added_definitions) != key, "key changes with an added definition");
+	
+	test::check(cache.make_key(0x1235, definitions) != key, "key changes with the template hash");
+	
+	const gl::shader_cache other_driver_cache("Vendor B, Renderer B, 4.6.0");
+	test::check(other_driver_cache.make_key(0x1234, definitions) != key, "key changes with the driver identity");
+}
+
+void test_store_load(const std::filesystem::path& directory)
+{
+	const auto binary = make_binary(7, 300);
+	const std::uint64_t key = 0x0123456789abcdef;
+	
+	// Without a cache directory, nothing is stored
+	gl::shader_cache disabled_cache(driver_identity);
+	test::check(!disabled_cache.store(key, binary), "binary is not stored without a cache directory");
+	test::check(!disabled_cache.load(key), "binary is not loaded without a cache directory");
+	
+	gl::shader_cache cache(driver_identity);
+	cache.set_directory(directory);
+	test::check(cache.get_directory() == directory, "cache directory is set");
+	test::check(!cache.store(key, {}), "empty binary is not stored");
+	test::check(!cache.load(key), "binary which was not stored is a miss");
+	test::check(cache.store(key, binary), "binary is stored");
+	test::check(std::filesystem::exists(cache_file_path(cache, key)), "cache file is written");
+	test::check(equal(cache.load(key), binary), "stored binary round trips");
+	
+	// Cache files outlive the session which wrote them
+	gl::shader_cache next_session_cache(driver_identity);
+	next_session_cache.set_directory(directory);
+	test::check(equal(next_session_cache.load(key), binary), "stored binary is loaded by a later session");
+	
+	// Replaced binaries are overwritten
+	const auto replacement = make_binary(9, 17);
+	test::check(cache.store(key, replacement), "binary is replaced");
+	test::check(equal(cache.load(key), replacement), "replaced binary round trips");
+	
+	// A file written by a different driver under the same key is a miss, and removed
+	gl::shader_cache other_driver_cache("Vendor B, Renderer B, 4.6.0");
+	other_driver_cache.set_directory(directory);
+	test::check(!other_driver_cache.load(key), "binary written by a different driver is a miss");
+	test::check(!std::filesystem::exists(cache_file_path(cache, key)), "cache file of a different driver is removed");
+	test::check(!cache.load(key), "removed cache file is a miss for the driver which wrote it");
+}
+
+void test_invalid_files(const std::filesystem::path& directory)
+{
+	gl::shader_cache cache(driver_identity);
+	cache.set_directory(directory);
+	
+	const auto binary = make_binary(3, 128);
+	
+	// Truncated file
+	const std::uint64_t truncated_key = 1;
+	cache.store(truncated_key, binary);
+	const auto truncated_path = cache_file_path(cache, truncated_key);
+	std::filesystem::resize_file(truncated_path, std::filesystem::file_size(truncated_path) - 1);
+	test::check(!cache.load(truncated_key), "truncated cache file is a miss");
+	test::check(!std::filesystem::exists(truncated_path), "truncated cache file is removed");
+	
+	// File truncated within its header
+	const std::uint64_t header_key = 2;
+	cache.store(header_key, binary);
+	const auto header_path = cache_file_path(cache, header_key);
+	std::filesystem::resize_file(header_path, 8);
+	test::check(!cache.load(header_key), "cache file truncated within its header is a miss");
+	test::check(!std::filesystem::exists(header_path), "cache file truncated within its header is removed");
+	
+	// File whose size exceeds the size in its header
+	const std::uint64_t padded_key = 3;
+	cache.store(padded_key, binary);
+	const auto padded_path = cache_file_path(cache, padded_key);
+	{
+		std::ofstream stream(padded_path, std::ios::binary | std::ios::app);
+		stream.put('\0');
+	}
+	test::check(!cache.load(padded_key), "cache file whose size does not match its header is a miss");
+	test::check(!std::filesystem::exists(padded_path), "cache file whose size does not match its header is removed");
+	
+	// File whose key does not match its file name
+	const std::uint64_t renamed_key = 4;
+	const std::uint64_t original_key = 5;
+	cache.store(original_key, binary);
+	const auto renamed_path = cache_file_path(cache, renamed_key);
+	std::filesystem::rename(cache_file_path(cache, original_key), renamed_path);
+	test::check(!cache.load(renamed_key), "cache file whose key does not match its file name is a miss");
+	test::check(!std::filesystem::exists(renamed_path), "cache file whose key does not match its file name is removed");
+}
+
+void test_discard(const std::filesystem::path& directory)
+{
+	gl::shader_cache cache(driver_identity);
+	cache.set_directory(directory);
+	
+	const std::uint64_t key = 42;
+	cache.store(key, make_binary(1, 64));
+	cache.discard(key);
+	test::check(!std::filesystem::exists(cache_file_path(cache, key)), "discarded cache file is removed");
+	test::check(!cache.load(key), "discarded binary is a miss");
+	
+	// Discarding a binary which is not cached is harmless
+	cache.discard(key);
+	
+	// Discarding a pre-warmed binary removes it from memory as well
+	cache.store(key, make_binary(1, 64));
+	cache.prewarm();
+	cache.wait();
+	cache.discard(key);
+	test::check(!cache.load(key), "discarded pre-warmed binary is a miss");
+}
+
+void test_prewarm(const std::filesystem::path& directory)
+{
+	const auto first_binary = make_binary(1, 256);
+	const auto second_binary = make_binary(2, 1000);
+	const std::uint64_t first_key = 0x10;
+	const std::uint64_t second_key = 0xfedcba9876543210;
+	
+	// Earlier session stores binaries
+	{
+		gl::shader_cache cache(driver_identity);
+		cache.set_directory(directory);
+		cache.store(first_key, first_binary);
+		cache.store(second_key, second_binary);
+	}
+	
+	// Files which are not cache files are ignored
+	{
+		std::ofstream stream(directory / "readme.txt");
+		stream << "not a cache file";
+	}
+	{
+		std::ofstream stream(directory / "not-a-key.bin", std::ios::binary);
+		stream << "not a cache file";
+	}
+	
+	// Later session pre-warms binaries into memory, such that they load even after their files are gone
+	gl::shader_cache cache(driver_identity);
+	cache.set_directory(directory);
+	cache.prewarm();
+	cache.wait();
+	std::filesystem::remove(cache_file_path(cache, first_key));
+	std::filesystem::remove(cache_file_path(cache, second_key));
+	test::check(equal(cache.load(first_key), first_binary), "first binary is pre-warmed");
+	test::check(equal(cache.load(second_key), second_binary), "second binary is pre-warmed");
+	test::check(!cache.load(first_key), "pre-warmed binary is released from memory once loaded");
+	test::check(std::filesystem::exists(directory / "readme.txt"), "files which are not cache files are kept");
+	
+	// Pre-warmed binaries of a different driver are skipped
+	gl::shader_cache store_cache(driver_identity);
+	store_cache.set_directory(directory);
+	store_cache.store(first_key, first_binary);
+	gl::shader_cache other_driver_cache("Vendor B, Renderer B, 4.6.0");
+	other_driver_cache.set_directory(directory);
+	other_driver_cache.prewarm();
+	other_driver_cache.wait();
+	std::filesystem::remove(cache_file_path(store_cache, first_key));
+	test::check(!other_driver_cache.load(first_key), "binary of a different driver is not pre-warmed");
+}
+
+void test_build(const std::filesystem::path& directory)
+{
+	const gl::shader_template shader_template
+	(
+		text_file
+		{{
+			"#version 330 core",
+			"#pragma vertex",
+			"#pragma fragment",
+			"#pragma define LIGHT_COUNT",
+			"void main() {}"
+		}}
+	);
+	const gl::shader_template::dictionary_type definitions{{"LIGHT_COUNT", "3"}};
+	
+	gl::shader_cache cache(driver_identity);
+	cache.set_directory(directory);
+	
+	// Uncached programs are compiled and linked
+	const auto compiled_program = cache.build(shader_template, definitions);
+	test::check(compiled_program && compiled_program->linked(), "uncached program is linked");
+	test::check(cache.get_miss_count() == 1 && cache.get_hit_count() == 0, "uncached program is a miss");
+	
+	// Cached programs are loaded from their binaries
+	const auto key = cache.make_key(shader_template.hash(), definitions);
+	cache.store(key, make_binary(5, 32));
+	const auto loaded_program = cache.build(shader_template, definitions);
+	test::check(loaded_program && loaded_program->linked(), "cached program is linked");
+	test::check(cache.get_miss_count() == 1 && cache.get_hit_count() == 1, "cached program is a hit");
+}
+
+} // namespace
+
+int main()
+{
+	if (!gl::load_null_backend(1, 1))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	const auto directory = std::filesystem::temp_directory_path() / "antkeeper-shader-cache-test";
+	std::filesystem::remove_all(directory);
+	
+	test_make_key();
+	test_store_load(directory / "store-load");
+	test_invalid_files(directory / "invalid-files");
+	test_discard(directory / "discard");
+	test_prewarm(directory / "prewarm");
+	test_build(directory / "build");
+	
+	std::filesystem::remove_all(directory);
+	
+	return test::result();
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Verifies the placement, fence retirement, and growth of stream buffer allocations, headless with the null OpenGL backend.
+
+#include "test.hpp"
+#include <engine/gl/null-backend.hpp>
+#include <engine/gl/stream-buffer.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+/// Capacity of the stream buffers under test, in bytes.
+constexpr std::size_t capacity = 1024;
+
+void test_alignment()
+{
+	gl::stream_buffer buffer(capacity);
+	
+	const auto first = buffer.allocate(1);
+	const auto second = buffer.allocate(8, 256);
+	const auto third = buffer.allocate(4, 4);
+	
+	test::check(first.offset == 0, "first allocation at offset 0");
+	test::check(second.offset == 256, "allocation aligned to 256 bytes");
+	test::check(third.offset == 264, "allocation aligned to 4 bytes follows the previous allocation");
+	test::check(second.data.size() == 8, "allocation data has the requested size");
+	test::check(buffer.get_frame_size() == 268, "frame size includes alignment padding");
+	
+	buffer.fence();
+	test::check(buffer.get_frame_size() == 0, "fence ends the frame");
+}
+
+void test_write()
+{
+	gl::stream_buffer buffer(capacity);
+	
+	const std::array<std::byte, 3> data = {std::byte{1}, std::byte{2}, std::byte{3}};
+	const auto allocation = buffer.write(data);
+	
+	test::check(std::equal(data.begin(), data.end(), allocation.data.begin(), allocation.data.end()), "written data is copied into mapped memory");
+	
+	buffer.fence();
+}
+
+void test_wraparound()
+{
+	gl::stream_buffer buffer(capacity);
+	
+	// Fences are signaled immediately, so frames are retired when the next frame begins
+	const auto first = buffer.allocate(400);
+	buffer.fence();
+	const auto second = buffer.allocate(400);
+	buffer.fence();
+	const auto third = buffer.allocate(400);
+	buffer.fence();
+	
+	test::check(first.offset == 0, "first frame at offset 0");
+	test::check(second.offset == 400, "second frame follows the first frame");
+	test::check(third.offset == 0, "allocation which would cross the end of the buffer wraps around to its beginning");
+	test::check(third.buffer == first.buffer, "wrapped allocation is in the same buffer");
+	test::check(buffer.get_pending_frame_count() == 0, "signaled frames are retired by fence()");
+	test::check(buffer.get_wait_count() == 0, "signaled frames are reused without waiting");
+	test::check(buffer.get_grow_count() == 0, "wrapping around does not grow the buffer");
+}
+
+void test_fence_retirement()
+{
+	gl::set_null_backend_auto_signal_fences(false);
+	gl::reset_null_backend_statistics();
+	
+	gl::stream_buffer buffer(capacity);
+	
+	// Frames whose fences have not been signaled remain pending
+	const auto first = buffer.allocate(512);
+	buffer.fence();
+	const auto second = buffer.allocate(512);
+	buffer.fence();
+	test::check(buffer.get_pending_frame_count() == 2, "unsignaled frames remain pending");
+	
+	// Reusing the memory of the first frame waits for its fence, but not for the fence of the second frame
+	const auto third = buffer.allocate(512);
+	test::check(first.offset == 0 && second.offset == 512 && third.offset == 0, "third frame reuses the memory of the first frame");
+	test::check(buffer.get_wait_count() == 1, "reusing the memory of an unsignaled frame waits for its fence");
+	test::check(gl::get_null_backend_statistics().fence_wait_count == 1, "wait blocks on the fence of the oldest frame only");
+	test::check(buffer.get_pending_frame_count() == 1, "waited frame is retired");
+	buffer.fence();
+	test::check(buffer.get_pending_frame_count() == 2, "fence() does not retire unsignaled frames");
+	
+	// Signaled frames are retired by the next fence, even without allocations
+	gl::signal_null_backend_fences();
+	buffer.fence();
+	test::check(buffer.get_pending_frame_count() == 0, "fence() retires signaled frames");
+	
+	// Empty frames are not fenced
+	const auto fence_count = gl::get_null_backend_statistics().fence_count;
+	buffer.fence();
+	test::check(gl::get_null_backend_statistics().fence_count == fence_count, "empty frames are not fenced");
+	
+	test::check(buffer.get_grow_count() == 0, "waiting for fences does not grow the buffer");
+	
+	gl::set_null_backend_auto_signal_fences(true);
+}
+
+void test_large_allocation()
+{
+	gl::stream_buffer buffer(capacity);
+	
+	const auto small = buffer.allocate(16);
+	const auto large = buffer.allocate(capacity * 3);
+	
+	test::check(buffer.get_grow_count() == 1, "allocation larger than the buffer grows the buffer");
+	test::check(buffer.get_capacity() == capacity * 4, "buffer grows to the next power of two of the allocation size");
+	test::check(large.buffer != small.buffer, "large allocation is in the replacement buffer");
+	test::check(large.offset == 0 && large.data.size() == capacity * 3, "large allocation spans the beginning of the replacement buffer");
+	
+	buffer.fence();
+}
+
+void test_frame_overflow()
+{
+	gl::set_null_backend_auto_signal_fences(false);
+	
+	gl::stream_buffer buffer(capacity);
+	
+	// Allocations of a single frame which exceed the capacity grow the buffer, rather than waiting for the frame to end
+	const auto first = buffer.allocate(400);
+	const auto second = buffer.allocate(400);
+	const auto third = buffer.allocate(400);
+	
+	test::check(buffer.get_grow_count() == 1, "frame which exceeds the capacity grows the buffer");
+	test::check(buffer.get_capacity() == capacity * 2, "buffer doubles in capacity");
+	test::check(buffer.get_wait_count() == 0, "growing does not wait for fences");
+	test::check(first.buffer == second.buffer && third.buffer != first.buffer, "overflowing allocation is in the replacement buffer");
+	test::check(third.offset == 0, "overflowing allocation begins the replacement buffer");
+	
+	// Previous frames in the replaced buffer are no longer fenced
+	buffer.fence();
+	test::check(buffer.get_pending_frame_count() == 1, "only the frame in the replacement buffer is pending");
+	
+	gl::signal_null_backend_fences();
+	gl::set_null_backend_auto_signal_fences(true);
+	buffer.fence();
+}
+
+} // namespace
+
+int main()
+{
+	if (!gl::load_null_backend(1, 1))
+	{
+		std::cerr << "Failed to load null OpenGL backend\n";
+		return EXIT_FAILURE;
+	}
+	
+	test_alignment();
+	test_write();
+	test_wraparound();
+	test_fence_retirement();
+	test_large_allocation();
+	test_frame_overflow();
+	
+	return test::result();
+}
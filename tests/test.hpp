@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANTKEEPER_TESTS_TEST_HPP
+#define ANTKEEPER_TESTS_TEST_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <source_location>
+#include <string_view>
+
+/// Helpers shared by tests.
+namespace test {
+
+/// Number of checks which have failed.
+inline std::size_t failure_count = 0;
+
+/**
+ * Checks a condition, printing a message if it is false.
+ *
+ * @param condition Condition to check.
+ * @param description Description of the condition.
+ * @param location Location of the check.
+ */
+inline void check(bool condition, std::string_view description, const std::source_location& location = std::source_location::current())
+{
+	if (!condition)
+	{
+		++failure_count;
+		std::cerr << std::format("{}:{}: check failed: {}\n", location.file_name(), location.line(), description);
+	}
+}
+
+/**
+ * Checks that a function throws an exception of a given type.
+ *
+ * @tparam Exception Type of the expected exception.
+ *
+ * @param function Function to call.
+ * @param description Description of the check.
+ * @param location Location of the check.
+ */
+template <class Exception, class Function>
+void check_throws(Function&& function, std::string_view description, const std::source_location& location = std::source_location::current())
+{
+	bool thrown = false;
+	try
+	{
+		function();
+	}
+	catch (const Exception&)
+	{
+		thrown = true;
+	}
+	
+	check(thrown, description, location);
+}
+
+/// Returns the exit status of a test executable, which indicates whether all checks passed.
+[[nodiscard]] inline int result() noexcept
+{
+	return failure_count ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace test
+
+#endif // ANTKEEPER_TESTS_TEST_HPP
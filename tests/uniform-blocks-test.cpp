@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: 2023 C. J. Howard
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Verifies the bytes written by the std140 uniform block packing functions.
+
+#include "test.hpp"
+#include <engine/render/uniform-blocks.hpp>
+#include <engine/math/matrix.hpp>
+#include <engine/math/vector.hpp>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// Value of bytes which have not been written.
+constexpr std::byte unwritten{0xAB};
+
+/// Returns a buffer of unwritten bytes.
+[[nodiscard]] std::vector<std::byte> make_buffer(std::size_t size)
+{
+	return std::vector<std::byte>(size, unwritten);
+}
+
+/// Reads a value from a buffer.
+template <class T>
+[[nodiscard]] T read(std::span<const std::byte> buffer, std::size_t offset)
+{
+	T value;
+	std::memcpy(&value, buffer.data() + offset, sizeof(T));
+	return value;
+}
+
+/// Returns `true` if a range of bytes has not been written.
+[[nodiscard]] bool is_unwritten(std::span<const std::byte> buffer, std::size_t offset, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		if (buffer[offset + i] != unwritten)
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/// Returns a matrix whose elements are unique, and offset by a value.
+[[nodiscard]] math::fmat4 make_matrix(float offset)
+{
+	math::fmat4 matrix;
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		for (std::size_t j = 0; j < 4; ++j)
+		{
+			matrix[i][j] = offset + static_cast<float>(i * 4 + j);
+		}
+	}
+	
+	return matrix;
+}
+
+/// Returns `true` if a matrix was written as four consecutive 16-byte columns.
+[[nodiscard]] bool is_matrix(std::span<const std::byte> buffer, std::size_t offset, const math::fmat4& matrix)
+{
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		if (read<math::fvec4>(buffer, offset + i * 16) != matrix[i])
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+void test_camera_block()
+{
+	render::camera_block block;
+	block.view = make_matrix(0.0f);
+	block.inv_view = make_matrix(100.0f);
+	block.projection = make_matrix(200.0f);
+	block.inv_projection = make_matrix(300.0f);
+	block.view_projection = make_matrix(400.0f);
+	block.camera_position = {1.0f, 2.0f, 3.0f};
+	block.camera_exposure = 4.0f;
+	block.time = 5.0f;
+	block.timestep = 6.0f;
+	block.subframe = 7.0f;
+	block.frame = 8;
+	
+	auto buffer = make_buffer(render::camera_block_offsets.size);
+	render::pack_camera_block(block, buffer);
+	
+	test::check(is_matrix(buffer, 0, block.view), "view at byte 0");
+	test::check(is_matrix(buffer, 64, block.inv_view), "inv_view at byte 64");
+	test::check(is_matrix(buffer, 128, block.projection), "projection at byte 128");
+	test::check(is_matrix(buffer, 192, block.inv_projection), "inv_projection at byte 192");
+	test::check(is_matrix(buffer, 256, block.view_projection), "view_projection at byte 256");
+	test::check(read<math::fvec3>(buffer, 320) == block.camera_position, "camera_position at byte 320");
+	test::check(read<float>(buffer, 332) == block.camera_exposure, "camera_exposure packed into the padding of camera_position");
+	test::check(read<float>(buffer, 336) == block.time, "time at byte 336");
+	test::check(read<float>(buffer, 340) == block.timestep, "timestep at byte 340");
+	test::check(read<float>(buffer, 344) == block.subframe, "subframe at byte 344");
+	test::check(read<unsigned int>(buffer, 348) == block.frame, "frame at byte 348");
+	
+	auto small_buffer = make_buffer(render::camera_block_offsets.size - 4);
+	test::check_throws<std::out_of_range>([&](){render::pack_camera_block(block, small_buffer);}, "camera block overflowing its buffer throws");
+}
+
+void test_light_block()
+{
+	const std::array<math::fvec3, 2> point_light_colors = {math::fvec3{1.0f, 2.0f, 3.0f}, math::fvec3{4.0f, 5.0f, 6.0f}};
+	const std::array<math::fvec3, 2> point_light_positions = {math::fvec3{7.0f, 8.0f, 9.0f}, math::fvec3{10.0f, 11.0f, 12.0f}};
+	const std::array<math::fvec3, 1> spot_light_colors = {math::fvec3{13.0f, 14.0f, 15.0f}};
+	const std::array<math::fvec3, 1> spot_light_positions = {math::fvec3{16.0f, 17.0f, 18.0f}};
+	const std::array<math::fvec3, 1> spot_light_directions = {math::fvec3{19.0f, 20.0f, 21.0f}};
+	const std::array<math::fvec2, 1> spot_light_cutoffs = {math::fvec2{22.0f, 23.0f}};
+	const std::array<math::fvec3, 1> rectangle_light_colors = {math::fvec3{24.0f, 25.0f, 26.0f}};
+	std::array<math::fvec3, 4> rectangle_light_corners;
+	for (std::size_t i = 0; i < rectangle_light_corners.size(); ++i)
+	{
+		rectangle_light_corners[i] = math::fvec3{27.0f, 28.0f, 29.0f} + static_cast<float>(i);
+	}
+	
+	render::light_block block{};
+	block.point_light_colors = point_light_colors;
+	block.point_light_positions = point_light_positions;
+	block.spot_light_colors = spot_light_colors;
+	block.spot_light_positions = spot_light_positions;
+	block.spot_light_directions = spot_light_directions;
+	block.spot_light_cutoffs = spot_light_cutoffs;
+	block.rectangle_light_colors = rectangle_light_colors;
+	block.rectangle_light_corners = rectangle_light_corners;
+	
+	auto buffer = make_buffer(render::light_block_offsets.size);
+	render::pack_light_block(block, buffer);
+	
+	test::check(read<unsigned int>(buffer, 0) == 0, "directional_light_count at byte 0");
+	test::check(read<unsigned int>(buffer, 4) == 2, "point_light_count at byte 4");
+	test::check(read<unsigned int>(buffer, 8) == 1, "spot_light_count at byte 8");
+	test::check(read<unsigned int>(buffer, 12) == 1, "rectangle_light_count at byte 12");
+	test::check(is_unwritten(buffer, 16, 128), "empty directional light arrays are not written");
+	
+	// vec3 array elements are padded to 16 bytes
+	test::check(read<math::fvec3>(buffer, 144) == point_light_colors[0], "point_light_colors[0] at byte 144");
+	test::check(is_unwritten(buffer, 156, 4), "point_light_colors[0] padding is not written");
+	test::check(read<math::fvec3>(buffer, 160) == point_light_colors[1], "point_light_colors[1] at byte 160");
+	test::check(is_unwritten(buffer, 176, 16), "point_light_colors[2] is not written");
+	test::check(read<math::fvec3>(buffer, 4240) == point_light_positions[0], "point_light_positions[0] at byte 4240");
+	test::check(read<math::fvec3>(buffer, 4256) == point_light_positions[1], "point_light_positions[1] at byte 4256");
+	test::check(read<math::fvec3>(buffer, 8336) == spot_light_colors[0], "spot_light_colors[0] at byte 8336");
+	test::check(read<math::fvec3>(buffer, 8848) == spot_light_positions[0], "spot_light_positions[0] at byte 8848");
+	test::check(read<math::fvec3>(buffer, 9360) == spot_light_directions[0], "spot_light_directions[0] at byte 9360");
+	
+	// vec2 array elements are also padded to 16 bytes
+	test::check(read<math::fvec2>(buffer, 9872) == spot_light_cutoffs[0], "spot_light_cutoffs[0] at byte 9872");
+	test::check(is_unwritten(buffer, 9880, 8), "spot_light_cutoffs[0] padding is not written");
+	
+	test::check(read<math::fvec3>(buffer, 10384) == rectangle_light_colors[0], "rectangle_light_colors[0] at byte 10384");
+	for (std::size_t i = 0; i < rectangle_light_corners.size(); ++i)
+	{
+		test::check(read<math::fvec3>(buffer, 10512 + i * 16) == rectangle_light_corners[i], "rectangle_light_corners at 16-byte strides from byte 10512");
+	}
+}
+
+void test_light_block_capacity()
+{
+	// Lights in excess of the block capacities are ignored
+	const std::vector<math::fvec3> point_light_colors(render::light_block_max_point_light_count + 10, math::fvec3{1.0f, 2.0f, 3.0f});
+	const std::vector<math::fvec3> point_light_positions(point_light_colors.size(), math::fvec3{4.0f, 5.0f, 6.0f});
+	
+	render::light_block block{};
+	block.point_light_colors = point_light_colors;
+	block.point_light_positions = point_light_positions;
+	
+	auto buffer = make_buffer(render::light_block_offsets.size);
+	render::pack_light_block(block, buffer);
+	
+	test::check(read<unsigned int>(buffer, 4) == render::light_block_max_point_light_count, "point_light_count is clamped to the block capacity");
+	test::check(read<math::fvec3>(buffer, 4240 - 16) == point_light_colors.back(), "last point light color fills point_light_colors");
+	test::check(read<math::fvec3>(buffer, 8336 - 16) == point_light_positions.back(), "last point light position fills point_light_positions");
+	test::check(is_unwritten(buffer, 8336, 16), "excess point light positions do not overflow into spot_light_colors");
+}
+
+void test_shadow_block()
+{
+	const std::array<math::fvec4, 2> splits = {math::fvec4{1.0f, 2.0f, 3.0f, 4.0f}, math::fvec4{5.0f, 6.0f, 7.0f, 8.0f}};
+	const std::array<float, 2> fade_ranges = {9.0f, 10.0f};
+	const std::array<math::fmat4, 2> shadow_0_matrices = {make_matrix(0.0f), make_matrix(100.0f)};
+	const std::array<math::fmat4, 3> shadow_1_matrices = {make_matrix(200.0f), make_matrix(300.0f), make_matrix(400.0f)};
+	const std::array<std::span<const math::fmat4>, 2> matrices = {shadow_0_matrices, shadow_1_matrices};
+	
+	render::shadow_block block;
+	block.directional_shadow_splits = splits;
+	block.directional_shadow_fade_ranges = fade_ranges;
+	block.directional_shadow_matrices = matrices;
+	
+	auto buffer = make_buffer(render::shadow_block_offsets.size);
+	render::pack_shadow_block(block, buffer);
+	
+	test::check(read<unsigned int>(buffer, 0) == 2, "directional_shadow_count at byte 0");
+	test::check(read<math::fvec4>(buffer, 16) == splits[0], "directional_shadow_splits[0] at byte 16");
+	test::check(read<math::fvec4>(buffer, 32) == splits[1], "directional_shadow_splits[1] at byte 32");
+	
+	// float array elements are padded to 16 bytes
+	test::check(read<float>(buffer, 80) == fade_ranges[0], "directional_shadow_fade_ranges[0] at byte 80");
+	test::check(is_unwritten(buffer, 84, 12), "directional_shadow_fade_ranges[0] padding is not written");
+	test::check(read<float>(buffer, 96) == fade_ranges[1], "directional_shadow_fade_ranges[1] at byte 96");
+	
+	// Cascades of each shadow start at multiples of the maximum cascade count
+	test::check(is_matrix(buffer, 144, shadow_0_matrices[0]), "matrix of shadow 0 cascade 0 at byte 144");
+	test::check(is_matrix(buffer, 208, shadow_0_matrices[1]), "matrix of shadow 0 cascade 1 at byte 208");
+	test::check(is_unwritten(buffer, 272, 128), "unused cascades of shadow 0 are not written");
+	test::check(is_matrix(buffer, 400, shadow_1_matrices[0]), "matrix of shadow 1 cascade 0 at byte 400");
+	test::check(is_matrix(buffer, 528, shadow_1_matrices[2]), "matrix of shadow 1 cascade 2 at byte 528");
+}
+
+void test_skinning_block()
+{
+	const std::array<math::fmat4, 2> matrices = {make_matrix(0.0f), make_matrix(100.0f)};
+	
+	render::skinning_block block;
+	block.skinning_matrices = matrices;
+	
+	// Only the bones in the palette need to fit in the buffer
+	auto buffer = make_buffer(render::skinning_block_offsets.bone_stride * matrices.size());
+	render::pack_skinning_block(block, buffer);
+	
+	// Each bone is stored as the first three rows of its matrix
+	for (std::size_t i = 0; i < matrices.size(); ++i)
+	{
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			const auto& matrix = matrices[i];
+			const math::fvec4 row = {matrix[0][j], matrix[1][j], matrix[2][j], matrix[3][j]};
+			test::check(read<math::fvec4>(buffer, i * 48 + j * 16) == row, "skinning_palette rows at 16-byte strides, 48 bytes per bone");
+		}
+	}
+	
+	auto small_buffer = make_buffer(render::skinning_block_offsets.bone_stride * matrices.size() - 1);
+	test::check_throws<std::out_of_range>([&](){render::pack_skinning_block(block, small_buffer);}, "skinning block overflowing its buffer throws");
+}
+
+} // namespace
+
+int main()
+{
+	test_camera_block();
+	test_light_block();
+	test_light_block_capacity();
+	test_shadow_block();
+	test_skinning_block();
+	
+	return test::result();
+}